@@ -0,0 +1,62 @@
+/********************************************************************************
+*                                                                               *
+*                       U n i c o d e   C o l l a t i o n                       *
+*                                                                               *
+*********************************************************************************
+* Copyright (C) 2022 by Sander Jansen.   All Rights Reserved.                   *
+*********************************************************************************
+* This library is free software; you can redistribute it and/or modify          *
+* it under the terms of the GNU Lesser General Public License as published by   *
+* the Free Software Foundation; either version 3 of the License, or             *
+* (at your option) any later version.                                           *
+*                                                                               *
+* This library is distributed in the hope that it will be useful,               *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                 *
+* GNU Lesser General Public License for more details.                           *
+*                                                                               *
+* You should have received a copy of the GNU Lesser General Public License      *
+* along with this program.  If not, see <http://www.gnu.org/licenses/>          *
+********************************************************************************/
+#ifndef FXCOLLATE_H
+#define FXCOLLATE_H
+
+namespace FX {
+
+/**
+* Language independent collation of UTF8 strings.
+* Strings are compared on three levels: first by base letters, then by
+* accents and finally by case, so that "elan" < "Elan" < "élan" < "Élan" < "emu".
+* A sort key encodes all three levels; sort keys compare like the strings
+* they were made from, using a plain binary comparison.
+*/
+namespace FXCollate {
+
+  /// Return sort key of string
+  extern FXAPI FXString sortKey(const FXchar* str,FXint num);
+
+  /// Return sort key of string
+  extern FXAPI FXString sortKey(const FXchar* str);
+
+  /// Return sort key of string
+  extern FXAPI FXString sortKey(const FXString& str);
+
+  /// Compare two sort keys
+  extern FXAPI FXint compareKeys(const FXString& k1,const FXString& k2);
+
+  /// Compare two sort keys
+  extern FXAPI FXint compareKeys(const FXchar* k1,FXint n1,const FXchar* k2,FXint n2);
+
+  /// Collate two strings
+  extern FXAPI FXint compare(const FXchar* s1,FXint n1,const FXchar* s2,FXint n2);
+
+  /// Collate two strings
+  extern FXAPI FXint compare(const FXchar* s1,const FXchar* s2);
+
+  /// Collate two strings
+  extern FXAPI FXint compare(const FXString& s1,const FXString& s2);
+  }
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+/********************************************************************************
+*                                                                               *
+*                      D i r e c t o r y   W a l k e r                          *
+*                                                                               *
+*********************************************************************************
+* Copyright (C) 2022 by Sander Jansen.   All Rights Reserved.                   *
+*********************************************************************************
+* This library is free software; you can redistribute it and/or modify          *
+* it under the terms of the GNU Lesser General Public License as published by   *
+* the Free Software Foundation; either version 3 of the License, or             *
+* (at your option) any later version.                                           *
+*                                                                               *
+* This library is distributed in the hope that it will be useful,               *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                 *
+* GNU Lesser General Public License for more details.                           *
+*                                                                               *
+* You should have received a copy of the GNU Lesser General Public License      *
+* along with this program.  If not, see <http://www.gnu.org/licenses/>          *
+********************************************************************************/
+#ifndef FXDIRWALKER_H
+#define FXDIRWALKER_H
+
+namespace FX {
+
+
+/**
+* Directory walker walks a directory tree like FXDirVisitor, but reads
+* each directory only once.
+* Subdirectories are opened relative to their parent, and entries are
+* classified by the file type the directory listing reports, so in the
+* common case no entry is stat'ed at all.  Only symbolic links and entries
+* of unknown type are stat'ed, relative to the open directory.
+* Files are matched against a wild card pattern which is compiled once
+* per walk; a pattern listing extensions, like "*.(ogg,flac,mp3)", is
+* matched by comparing suffixes only.
+*
+* For each directory, enter() is called first.  If it returns 1, the
+* subdirectories are walked, then visit() is called for each matching
+* file, followed by leave().  Thus all files visited between enter() and
+* leave() are in the same directory.
+* As with FXDirVisitor, the callbacks return 0 to skip, 1 to continue,
+* or 2 to abandon the walk.
+* Symbolic links to files are followed, symbolic links to directories are
+* not.  Directories already being walked are skipped.
+* The function info() stats the file being visited; valid only while in
+* visit().
+*/
+class FXAPI FXDirWalker {
+private:
+  struct Level;
+private:
+  Level*            current;    // Directory being walked
+  FXArray<FXString> suffixes;   // Compiled extension list
+  FXString          wildcard;   // Pattern, if not compiled
+  FXuint            options;    // Matching options
+private:
+  FXuint walk(FXint fd,const FXString& path,FXint depth);
+  FXbool compile(const FXString& pattern);
+  FXbool match(const FXchar* name,FXint len) const;
+private:
+  FXDirWalker(const FXDirWalker&);
+  FXDirWalker& operator=(const FXDirWalker&);
+public:
+
+  /// Initialize directory walker
+  FXDirWalker():current(nullptr),options(0){}
+
+  /**
+  * Walk path, visiting files matching the pattern.  The options
+  * FXDir::HiddenFiles and FXDir::HiddenDirs include hidden files and
+  * directories, FXDir::CaseFold matches case-insensitive.
+  */
+  FXuint walk(const FXString& path,const FXString& wild="*",FXuint opts=FXDir::MatchAll,FXint limit=1000);
+
+  /// Return true if we're actively walking directories
+  FXbool walking() const { return current!=nullptr; }
+
+  /// Stat the file being visited
+  FXbool info(FXStat& data) const;
+
+  /// Enter directory
+  virtual FXuint enter(const FXString& path);
+
+  /// Visit file name in directory path
+  virtual FXuint visit(const FXString& path,const FXString& name);
+
+  /// Leave directory
+  virtual FXuint leave(const FXString& path);
+
+  /// Destructor
+  virtual ~FXDirWalker();
+  };
+
+}
+
+#endif
@@ -61,12 +61,28 @@ namespace FX {
 *
 * Patterns which cause inordinate amounts of recursion may cause FXRex to fail where
 * otherwise it would succeed to match.
+* Passing the match flag Linear selects a non-backtracking matcher which simulates all
+* alternatives in lock-step, and whose running time is linear in the length of the subject
+* string.  It finds the same matches as the backtracking matcher, and while it is slower
+* for ordinary patterns, it can not be brought to a crawl by patterns like "(a|aa)*b".
+* It is only available for patterns without backreferences, lookaround, counted repeats,
+* and possessive or atomic subexpressions; other patterns silently use the backtracking
+* matcher.
+* When a pattern is compiled, the characters a match may start with and the longest literal
+* string any match must contain are determined; these are used to quickly skip over parts
+* of the subject string where the pattern can not match.
 * FXRex uses no global variables, and thus multiple threads may simultaneously use it;
 * moreover, multiple threads may use the same instance to perform a match.
 */
 class FXAPI FXRex {
 private:
-  FXString code;
+  FXString code;        // Compiled program
+  FXString must;        // Literal which any match must contain
+  FXuchar  first[32];   // Characters a match may start with
+  FXint    lead;        // Only character a match may start with, or -1
+  FXuint   hints;       // Properties of the program
+private:
+  void analyze();
 private:
   static const FXchar *const errors[];
 public:
@@ -91,7 +107,8 @@ public:
 
     /// Regular expression match flags
     NotBol     = 1024,  /// Start of string is NOT begin of line
-    NotEol     = 2048   /// End of string is NOT end of line
+    NotEol     = 2048,  /// End of string is NOT end of line
+    Linear     = 4096   /// Use non-backtracking matcher if possible
     };
 
   /// Regular expression error codes
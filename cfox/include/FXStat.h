@@ -29,6 +29,7 @@ class FXFile;
 
 /// Statistics about a file or directory
 class FXAPI FXStat {
+  friend class FXDirWalker;
 private:
   FXuint  modeFlags;            /// Mode bits
   FXuint  userNumber;           /// User number
@@ -107,10 +107,12 @@
 #include "FXObject.h"
 #include "FXDelegator.h"
 #include "FXPath.h"
+#include "FXCollate.h"
 #include "FXSystem.h"
 #include "FXStat.h"
 #include "FXDir.h"
 #include "FXDirVisitor.h"
+#include "FXDirWalker.h"
 #include "FXDate.h"
 #include "FXURL.h"
 #include "FXStringDictionary.h"
@@ -0,0 +1,315 @@
+/********************************************************************************
+*                                                                               *
+*                       U n i c o d e   C o l l a t i o n                       *
+*                                                                               *
+*********************************************************************************
+* Copyright (C) 2022 by Sander Jansen.   All Rights Reserved.                   *
+*********************************************************************************
+* This library is free software; you can redistribute it and/or modify          *
+* it under the terms of the GNU Lesser General Public License as published by   *
+* the Free Software Foundation; either version 3 of the License, or             *
+* (at your option) any later version.                                           *
+*                                                                               *
+* This library is distributed in the hope that it will be useful,               *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                 *
+* GNU Lesser General Public License for more details.                           *
+*                                                                               *
+* You should have received a copy of the GNU Lesser General Public License      *
+* along with this program.  If not, see <http://www.gnu.org/licenses/>          *
+********************************************************************************/
+#include "xincs.h"
+#include "fxver.h"
+#include "fxdefs.h"
+#include "fxchar.h"
+#include "fxascii.h"
+#include "fxunicode.h"
+#include "FXArray.h"
+#include "FXHash.h"
+#include "FXStream.h"
+#include "FXString.h"
+#include "FXCollate.h"
+
+
+/*
+  Notes:
+
+  - Simplified version of the Unicode Collation Algorithm (UTS #10), without
+    language specific tailoring.
+
+  - Each character is fully decomposed (compatibility decomposition), so
+    precomposed letters, ligatures and width variants sort with their base
+    letters. Letters that have no decomposition but are commonly seen as a
+    variant of a latin letter (ß, æ, ø, ł, ...) are expanded using a small table.
+
+  - Primary level is the case folded base letters, encoded as UTF8 which
+    preserves code point order. Secondary level has a common weight for every
+    base letter followed by the weights of its combining marks. Tertiary level
+    has a weight for the case of every base letter.
+
+  - Trailing common weights are dropped from secondary and tertiary levels, so
+    for plain lower case text the key is just the text plus two separators.
+
+  - Levels are separated by a byte lower than any weight, and no weight is zero,
+    so a sort key is a valid C string.
+
+  - Control and format characters are ignored.
+*/
+
+using namespace FX;
+
+/*******************************************************************************/
+
+namespace FX {
+
+// Weights
+enum {
+  LevelSeparator = 0x01,        // Between levels
+  Common         = 0x05,        // Base letter without accent, lower case
+  Upper          = 0x06,        // Upper or title case
+  MarkBase       = 0x10,        // Combining diacritical marks U+0300..U+036F
+  MarkOther      = 0xF0,        // Other combining marks
+  Variant        = 0xF8         // Expanded letter
+  };
+
+
+// Letters without decomposition, sorted with their base letter(s)
+struct Expansion {
+  FXwchar ucs;
+  FXwchar base[2];
+  };
+
+static const Expansion expansions[]={
+  {0x00DF,{'s','s'}},           // ß
+  {0x00E6,{'a','e'}},           // æ
+  {0x00F0,{'d',0}},             // ð
+  {0x00F8,{'o',0}},             // ø
+  {0x00FE,{'t','h'}},           // þ
+  {0x0111,{'d',0}},             // đ
+  {0x0127,{'h',0}},             // ħ
+  {0x0131,{'i',0}},             // ı
+  {0x0142,{'l',0}},             // ł
+  {0x0153,{'o','e'}}            // œ
+  };
+
+
+// Find expansion for lower case letter
+static inline const Expansion* expansion(FXwchar w){
+  if(0x00DF<=w && w<=0x0153){
+    for(FXuint i=0; i<sizeof(expansions)/sizeof(expansions[0]); i++){
+      if(expansions[i].ucs==w) return &expansions[i];
+      }
+    }
+  return nullptr;
+  }
+
+
+// Recursive compatibility decomposition; worst case is 18 characters
+static FXint decompose(FXwchar* result,FXwchar w){
+  const FXwchar* decomposition=Unicode::charDecompose(w);
+  if(decomposition[-2]){
+    FXint n=0;
+    for(FXwchar p=0; p<decomposition[-1]; p++){
+      n+=decompose(result+n,decomposition[p]);
+      }
+    return n;
+    }
+  result[0]=w;
+  return 1;
+  }
+
+
+// Writes key into a buffer of given size, and counts how much space it needs
+struct KeyWriter {
+  FXuchar* dst;
+  FXival   room;
+  FXival   len;
+  FXival   pending;
+
+  KeyWriter(FXuchar* d,FXival r):dst(d),room(r),len(0),pending(0){}
+
+  // Add common weight; only written if another weight follows on the same level
+  void common(){ pending++; }
+
+  // Add weight
+  void put(FXuchar c){
+    while(pending){ if(len<room) dst[len]=Common; len++; pending--; }
+    if(len<room) dst[len]=c;
+    len++;
+    }
+
+  // Add character as UTF8
+  void put(FXwchar w){
+    FXchar buf[4];
+    FXival n=wc2utf(buf,w);
+    for(FXival i=0; i<n; i++) put((FXuchar)buf[i]);
+    }
+
+  // Start next level
+  void next(){ pending=0; put((FXuchar)LevelSeparator); }
+  };
+
+
+// Add weights of ascii character to given level
+static inline void ascii(KeyWriter& key,FXint level,FXwchar c){
+  if(c<0x20 || c==0x7F) return;
+  FXwchar lc=Ascii::toLower(c);
+  switch(level){
+    case 0: key.put((FXuchar)lc); break;
+    case 1: key.common(); break;
+    case 2: if(c!=lc) key.put((FXuchar)Upper); else key.common(); break;
+    }
+  }
+
+
+// Add weights of character to given level
+static void element(KeyWriter& key,FXint level,FXwchar c){
+  FXuint cat=Unicode::charCategory(c);
+
+  // Ignorable
+  if(cat==CatControl || cat==CatFormat) return;
+
+  // Combining mark
+  if(cat==CatMarkNonSpacing || Unicode::charCombining(c)){
+    if(level==1){
+      key.put((FXuchar)((0x0300<=c && c<0x0370) ? MarkBase+(c-0x0300) : MarkOther));
+      }
+    return;
+    }
+
+  // Base letter
+  FXwchar lc=Unicode::toLower(c);
+  const Expansion* x=expansion(lc);
+  switch(level){
+    case 0:
+      if(x){
+        key.put(x->base[0]);
+        if(x->base[1]) key.put(x->base[1]);
+        }
+      else{
+        key.put(lc);
+        }
+      break;
+    case 1:
+      key.common();
+      if(x){
+        key.put((FXuchar)Variant);
+        if(x->base[1]) key.common();
+        }
+      break;
+    case 2:
+      if(c!=lc){
+        key.put((FXuchar)Upper);
+        if(x && x->base[1]) key.put((FXuchar)Upper);
+        }
+      else{
+        key.common();
+        if(x && x->base[1]) key.common();
+        }
+      break;
+    }
+  }
+
+
+// Write sort key of str into dst, up to given number of levels; returns size of the key even if it didn't fit
+static FXival collatekey(FXuchar* dst,FXival room,const FXchar* str,FXival num,FXint levels=3){
+  FXwchar chars[18];
+  KeyWriter key(dst,room);
+  for(FXint level=0; level<levels; level++){
+    const FXchar* ptr=str;
+    const FXchar* end=str+num;
+    if(level) key.next();
+    while(ptr<end && ptr+wclen(ptr)<=end){
+      FXwchar w=wcnxt(ptr);
+      if(w<0x80){
+        ascii(key,level,w);
+        continue;
+        }
+      FXint n=decompose(chars,w);
+      for(FXint i=0; i<n; i++){
+        element(key,level,chars[i]);
+        }
+      }
+    }
+  return key.len;
+  }
+
+
+// Return sort key of string
+FXString FXCollate::sortKey(const FXchar* str,FXint num){
+  FXString result;
+  FXuchar buffer[256];
+  FXival len=collatekey(buffer,sizeof(buffer),str,num);
+  if(len<=(FXival)sizeof(buffer)){
+    result.assign((const FXchar*)buffer,len);
+    }
+  else if(result.length(len)){
+    collatekey((FXuchar*)result.text(),len,str,num);
+    }
+  return result;
+  }
+
+
+// Return sort key of string
+FXString FXCollate::sortKey(const FXchar* str){
+  return FXCollate::sortKey(str,strlen(str));
+  }
+
+
+// Return sort key of string
+FXString FXCollate::sortKey(const FXString& str){
+  return FXCollate::sortKey(str.text(),str.length());
+  }
+
+
+// Compare two byte strings
+static inline FXint comparebytes(const FXuchar* k1,FXival n1,const FXuchar* k2,FXival n2){
+  FXint c=memcmp(k1,k2,FXMIN(n1,n2));
+  if(c) return c;
+  return (n1>n2) - (n1<n2);
+  }
+
+
+// Compare two sort keys
+FXint FXCollate::compareKeys(const FXString& k1,const FXString& k2){
+  return comparebytes((const FXuchar*)k1.text(),k1.length(),(const FXuchar*)k2.text(),k2.length());
+  }
+
+
+// Compare two sort keys
+FXint FXCollate::compareKeys(const FXchar* k1,FXint n1,const FXchar* k2,FXint n2){
+  return comparebytes((const FXuchar*)k1,n1,(const FXuchar*)k2,n2);
+  }
+
+
+// Collate two strings; most strings differ in their base letters so try that level first
+FXint FXCollate::compare(const FXchar* s1,FXint n1,const FXchar* s2,FXint n2){
+  FXuchar b1[256];
+  FXuchar b2[256];
+  FXival l1=collatekey(b1,sizeof(b1),s1,n1,1);
+  FXival l2=collatekey(b2,sizeof(b2),s2,n2,1);
+  if(l1<=(FXival)sizeof(b1) && l2<=(FXival)sizeof(b2)){
+    FXint c=comparebytes(b1,l1,b2,l2);
+    if(c) return c;
+    l1=collatekey(b1,sizeof(b1),s1,n1);
+    l2=collatekey(b2,sizeof(b2),s2,n2);
+    if(l1<=(FXival)sizeof(b1) && l2<=(FXival)sizeof(b2)){
+      return comparebytes(b1,l1,b2,l2);
+      }
+    }
+  return FXCollate::compareKeys(FXCollate::sortKey(s1,n1),FXCollate::sortKey(s2,n2));
+  }
+
+
+// Collate two strings
+FXint FXCollate::compare(const FXchar* s1,const FXchar* s2){
+  return FXCollate::compare(s1,strlen(s1),s2,strlen(s2));
+  }
+
+
+// Collate two strings
+FXint FXCollate::compare(const FXString& s1,const FXString& s2){
+  return FXCollate::compare(s1.text(),s1.length(),s2.text(),s2.length());
+  }
+
+}
@@ -0,0 +1,412 @@
+/********************************************************************************
+*                                                                               *
+*                      D i r e c t o r y   W a l k e r                          *
+*                                                                               *
+*********************************************************************************
+* Copyright (C) 2022 by Sander Jansen.   All Rights Reserved.                   *
+*********************************************************************************
+* This library is free software; you can redistribute it and/or modify          *
+* it under the terms of the GNU Lesser General Public License as published by   *
+* the Free Software Foundation; either version 3 of the License, or             *
+* (at your option) any later version.                                           *
+*                                                                               *
+* This library is distributed in the hope that it will be useful,               *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of                *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                 *
+* GNU Lesser General Public License for more details.                           *
+*                                                                               *
+* You should have received a copy of the GNU Lesser General Public License      *
+* along with this program.  If not, see <http://www.gnu.org/licenses/>          *
+********************************************************************************/
+#include "xincs.h"
+#include "fxver.h"
+#include "fxdefs.h"
+#include "fxmath.h"
+#include "FXArray.h"
+#include "FXHash.h"
+#include "FXStream.h"
+#include "FXString.h"
+#include "FXIO.h"
+#include "FXStat.h"
+#include "FXFile.h"
+#include "FXPath.h"
+#include "FXDir.h"
+#include "FXDirWalker.h"
+
+/*
+  Notes:
+
+  - Each directory is read once.  Names of subdirectories and matching files
+    are collected first; subdirectories are walked next, and files are visited
+    last, so that the visits of one directory are not interleaved with those
+    of its subdirectories.
+
+  - On Unix, directories stay open while being walked.  Subdirectories are
+    opened with openat() and entries are stat'ed with fstatat(), relative to
+    the open directory, so the kernel doesn't have to resolve the full path
+    each time.  Entries are classified by d_type where available; only links
+    and entries of unknown type are stat'ed.  Entries that can't be used are
+    skipped before stat'ing them.
+
+  - Directories are recognized by volume and index; a directory already
+    being walked is skipped.  Since links to directories aren't followed,
+    this only happens with bind mounts.
+
+  - Patterns of the form "*.ext", "*.(ext,ext)" and alternatives thereof are
+    compiled to a list of suffixes.  Other patterns are matched with
+    FXPath::match().
+*/
+
+#ifndef O_DIRECTORY
+#define O_DIRECTORY 0
+#endif
+#ifndef O_NOFOLLOW
+#define O_NOFOLLOW 0
+#endif
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+
+using namespace FX;
+
+/*******************************************************************************/
+
+namespace FX {
+
+
+// Directory being walked
+struct FXDirWalker::Level {
+  FXlong          volume;       // File volume
+  FXlong          index;        // File index
+  FXint           fd;           // Open directory
+  const FXString* path;         // Path of directory
+  const FXString* name;         // File being visited
+  Level**         current;      // Current one
+  Level*          last;         // Link to parent directory
+
+  // Save old value of current, point it here
+  Level(Level** cur):volume(0),index(0),fd(-1),path(nullptr),name(nullptr),current(cur),last(*cur){ *current=this; }
+
+  // Restore old value of current
+ ~Level(){ *current=last; }
+  };
+
+
+// Characters that can't be part of a compiled extension
+static const FXchar special[]="*?[]()|,\\";
+
+
+// Append name to list, growing it geometrically
+static void append(FXArray<FXString>& list,FXival& n,const FXchar* name){
+  if(n==list.no()) list.no(FXMAX(16,n*2));
+  list[n++]=name;
+  }
+
+
+// Join directory and name
+static inline FXString join(const FXString& path,const FXString& name){
+  return path+(ISPATHSEP(path.tail())?"":PATHSEPSTRING)+name;
+  }
+
+
+// Compile a pattern like "*.mp3", "*.(ogg,flac)" or "*.ogg|*.flac" to a list of suffixes
+FXbool FXDirWalker::compile(const FXString& pattern){
+  const FXchar* p=pattern.text();
+  const FXchar* s;
+  suffixes.clear();
+  while(*p){
+    if(p[0]!='*' || p[1]!='.') goto x;
+    p+=2;
+    if(*p=='('){
+      do{
+        s=++p;
+        while(*p && !strchr(special,*p)) p++;
+        if(p==s) goto x;
+        suffixes.append("."+FXString(s,p-s));
+        }
+      while(*p==',' || *p=='|');
+      if(*p++!=')') goto x;
+      }
+    else{
+      s=p;
+      while(*p && !strchr(special,*p)) p++;
+      if(p==s) goto x;
+      suffixes.append("."+FXString(s,p-s));
+      }
+    if(*p==',' || *p=='|'){
+      if(*++p=='\0') goto x;
+      }
+    else if(*p){
+      goto x;
+      }
+    }
+  return 0<suffixes.no();
+x:suffixes.clear();
+  return false;
+  }
+
+
+// Match file name
+FXbool FXDirWalker::match(const FXchar* name,FXint len) const {
+  if(suffixes.no()){
+    for(FXival i=0; i<suffixes.no(); i++){
+      const FXint n=suffixes[i].length();
+      if(n<=len){
+        if(options&FXDir::CaseFold){
+          if(FXString::comparecase(name+len-n,suffixes[i].text(),n)==0) return true;
+          }
+        else{
+          if(memcmp(name+len-n,suffixes[i].text(),n)==0) return true;
+          }
+        }
+      }
+    return false;
+    }
+  if(wildcard[0]=='*' && wildcard[1]=='\0') return true;
+  return FXPath::match(name,wildcard.text(),(options&FXDir::CaseFold)?(FXPath::PathName|FXPath::NoEscape|FXPath::CaseFold):(FXPath::PathName|FXPath::NoEscape));
+  }
+
+
+// Walk path
+FXuint FXDirWalker::walk(const FXString& path,const FXString& wild,FXuint opts,FXint limit){
+  options=opts;
+  wildcard=compile(wild)?FXString::null:wild;
+  if(0<limit && !path.empty()){
+#ifdef WIN32
+    return walk(-1,path,limit);
+#else
+    FXint fd=::open(path.text(),O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+    if(0<=fd){
+      return walk(fd,path,limit);
+      }
+#endif
+    }
+  return 0;
+  }
+
+
+// Walk directory path, open at fd, closing it when done
+FXuint FXDirWalker::walk(FXint fd,const FXString& path,FXint depth){
+  FXArray<FXString> dirs;
+  FXArray<FXString> files;
+  FXival ndirs=0;
+  FXival nfiles=0;
+  FXuint code;
+  Level node(&current);
+  node.fd=fd;
+  node.path=&path;
+
+#ifdef WIN32
+
+  // Identify directory
+  FXStat data;
+  if(!FXStat::statFile(path,data)) return 0;
+  node.volume=data.volume();
+  node.index=data.index();
+
+  // Bail if already walking this directory
+  for(Level *l=node.last; l; l=l->last){
+    if(node.index==l->index && node.volume==l->volume) return 0;
+    }
+
+  // Conditionally enter directory
+  if((code=enter(path))!=1) return code;
+
+  // Collect subdirectories and matching files
+  FXDir directory(path);
+  FXString name;
+  while(directory.next(name)){
+    if(name[0]=='.' && (name[1]=='\0' || (name[1]=='.' && name[2]=='\0'))) continue;
+    if(FXStat::statLink(join(path,name),data)){
+      if(data.isDirectory()){
+        if(1<depth && ((options&FXDir::HiddenDirs) || !data.isHidden())) append(dirs,ndirs,name.text());
+        }
+      else if(!data.isLink() || FXStat::statFile(join(path,name),data)){
+        if(data.isFile() && ((options&FXDir::HiddenFiles) || !data.isHidden()) && match(name.text(),name.length())) append(files,nfiles,name.text());
+        }
+      }
+    }
+  directory.close();
+
+  // Walk subdirectories
+  for(FXival i=0; i<ndirs; i++){
+    if(walk(-1,join(path,dirs[i]),depth-1)==2){
+      leave(path);
+      return 2;
+      }
+    }
+
+#else
+
+  // Identify directory
+  struct stat data;
+  if(::fstat(fd,&data)!=0){
+    ::close(fd);
+    return 0;
+    }
+  node.volume=(FXlong)data.st_dev;
+  node.index=(FXlong)data.st_ino;
+
+  // Bail if already walking this directory
+  for(Level *l=node.last; l; l=l->last){
+    if(node.index==l->index && node.volume==l->volume){
+      ::close(fd);
+      return 0;
+      }
+    }
+
+  // Conditionally enter directory
+  if((code=enter(path))!=1){
+    ::close(fd);
+    return code;
+    }
+
+  // Read directory
+  DIR* dir=::fdopendir(fd);
+  if(dir==nullptr){
+    ::close(fd);
+    return leave(path);
+    }
+
+  // Collect subdirectories and matching files
+  struct dirent* dp;
+  while((dp=::readdir(dir))!=nullptr){
+    const FXchar* name=dp->d_name;
+    if(name[0]=='.' && (name[1]=='\0' || (name[1]=='.' && name[2]=='\0'))) continue;
+
+    // Skip what we'd never use, before looking at it any closer
+    const FXbool usedir=(1<depth) && (name[0]!='.' || (options&FXDir::HiddenDirs));
+    const FXbool usefile=(name[0]!='.' || (options&FXDir::HiddenFiles)) && match(name,strlen(name));
+    if(!usedir && !usefile) continue;
+
+#if defined(_DIRENT_HAVE_D_TYPE)
+    if(dp->d_type==DT_DIR){
+      if(usedir) append(dirs,ndirs,name);
+      continue;
+      }
+    if(dp->d_type==DT_REG){
+      if(usefile) append(files,nfiles,name);
+      continue;
+      }
+    if(dp->d_type==DT_LNK){
+      if(usefile && ::fstatat(fd,name,&data,0)==0 && S_ISREG(data.st_mode)) append(files,nfiles,name);
+      continue;
+      }
+    if(dp->d_type!=DT_UNKNOWN) continue;
+#endif
+
+    // Unknown type
+    if(::fstatat(fd,name,&data,AT_SYMLINK_NOFOLLOW)==0){
+      if(S_ISDIR(data.st_mode)){
+        if(usedir) append(dirs,ndirs,name);
+        }
+      else if(S_ISREG(data.st_mode)){
+        if(usefile) append(files,nfiles,name);
+        }
+      else if(S_ISLNK(data.st_mode)){
+        if(usefile && ::fstatat(fd,name,&data,0)==0 && S_ISREG(data.st_mode)) append(files,nfiles,name);
+        }
+      }
+    }
+
+  // Walk subdirectories
+  for(FXival i=0; i<ndirs; i++){
+    FXint sub=::openat(fd,dirs[i].text(),O_RDONLY|O_DIRECTORY|O_NOFOLLOW|O_CLOEXEC);
+    if(0<=sub && walk(sub,join(path,dirs[i]),depth-1)==2){
+      ::closedir(dir);
+      leave(path);
+      return 2;
+      }
+    }
+
+#endif
+
+  // Visit files
+  for(FXival i=0; i<nfiles; i++){
+    node.name=&files[i];
+    if(visit(path,files[i])==2){
+#ifndef WIN32
+      ::closedir(dir);
+#endif
+      leave(path);
+      return 2;
+      }
+    }
+  node.name=nullptr;
+
+#ifndef WIN32
+  ::closedir(dir);
+#endif
+
+  // Leave directory
+  return leave(path);
+  }
+
+
+// Stat the file being visited
+FXbool FXDirWalker::info(FXStat& result) const {
+  if(current && current->name){
+#ifdef WIN32
+    return FXStat::statFile(join(*current->path,*current->name),result);
+#else
+    const FXTime seconds=1000000000;
+    struct stat data;
+    if(::fstatat(current->fd,current->name->text(),&data,0)==0){
+      result.modeFlags=(data.st_mode&FXIO::AllFull);
+      if(S_ISDIR(data.st_mode)) result.modeFlags|=FXIO::Directory;
+      if(S_ISREG(data.st_mode)) result.modeFlags|=FXIO::File;
+      if(S_ISLNK(data.st_mode)) result.modeFlags|=FXIO::SymLink;
+      if(S_ISCHR(data.st_mode)) result.modeFlags|=FXIO::Character;
+      if(S_ISBLK(data.st_mode)) result.modeFlags|=FXIO::Block;
+      if(S_ISFIFO(data.st_mode)) result.modeFlags|=FXIO::Fifo;
+      if(S_ISSOCK(data.st_mode)) result.modeFlags|=FXIO::Socket;
+      if(data.st_mode&S_ISUID) result.modeFlags|=FXIO::SetUser;
+      if(data.st_mode&S_ISGID) result.modeFlags|=FXIO::SetGroup;
+      if(data.st_mode&S_ISVTX) result.modeFlags|=FXIO::Sticky;
+      result.userNumber=data.st_uid;
+      result.groupNumber=data.st_gid;
+      result.linkCount=data.st_nlink;
+#if (_POSIX_C_SOURCE >= 200809L) || (_XOPEN_SOURCE >= 700)
+      result.accessTime=data.st_atim.tv_sec*seconds+data.st_atim.tv_nsec;
+      result.modifyTime=data.st_mtim.tv_sec*seconds+data.st_mtim.tv_nsec;
+      result.createTime=data.st_ctim.tv_sec*seconds+data.st_ctim.tv_nsec;
+#else
+      result.accessTime=data.st_atime*seconds;
+      result.modifyTime=data.st_mtime*seconds;
+      result.createTime=data.st_ctime*seconds;
+#endif
+      result.fileVolume=(FXlong)data.st_dev;
+      result.fileIndex=(FXlong)data.st_ino;
+      result.fileSize=(FXlong)data.st_size;
+      return true;
+      }
+#endif
+    }
+  return false;
+  }
+
+
+// Enter directory
+FXuint FXDirWalker::enter(const FXString&){
+  return 1;
+  }
+
+
+// Visit file
+FXuint FXDirWalker::visit(const FXString&,const FXString&){
+  return 1;
+  }
+
+
+// Leave directory
+FXuint FXDirWalker::leave(const FXString&){
+  return 1;
+  }
+
+
+// Destructor
+FXDirWalker::~FXDirWalker(){
+  }
+
+}
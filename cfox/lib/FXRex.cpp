@@ -2445,11 +2445,16 @@ class FXExecute {
   FXint          npar;              // Number of capturing parentheses
   FXint          recs;              // Recursions
   FXint          mode;              // Match mode
+  const FXuchar *set;               // Possible starting characters
+  FXint          lead;              // Only possible starting character
 public:
 
   // Construct match engine
   FXExecute(const FXchar* sbeg,const FXchar* send,FXint* b,FXint* e,FXint p,FXint m);
 
+  // Skip start positions using starting characters
+  void prefilter(const FXuchar* s,FXint l){ set=s; lead=l; }
+
   // Attempt to match
   FXbool attempt(const FXchar* prog,const FXchar* ptr);
 
@@ -2466,7 +2471,7 @@ public:
 
 
 // Construct match engine
-FXExecute::FXExecute(const FXchar* sbeg,const FXchar* send,FXint* b,FXint* e,FXint p,FXint m):anc(nullptr),str(nullptr),str_beg(sbeg),str_end(send),sub_beg(b),sub_end(e),npar(p),recs(0),mode(m){
+FXExecute::FXExecute(const FXchar* sbeg,const FXchar* send,FXint* b,FXint* e,FXint p,FXint m):anc(nullptr),str(nullptr),str_beg(sbeg),str_end(send),sub_beg(b),sub_end(e),npar(p),recs(0),mode(m),set(nullptr),lead(-1){
   bak_beg[0]=bak_end[0]=nullptr;
   bak_beg[1]=bak_end[1]=nullptr;
   bak_beg[2]=bak_end[2]=nullptr;
@@ -4636,8 +4641,8 @@ FXint FXExecute::search(const FXchar* prog,const FXchar* fm,const FXchar* to){
       if(prog[0]==OP_CHAR || prog[0]==OP_CHARS){
         ch=(prog[0]==OP_CHAR)?prog[1]:prog[3];
         if(to==str_end) to--;
-        while(fm<=to){
-          if((*fm==ch) && attempt(prog,fm)) return fm-str_beg;
+        while(fm<=to && (fm=(const FXchar*)memchr(fm,ch,to-fm+1))!=nullptr){
+          if(attempt(prog,fm)) return fm-str_beg;
           fm++;
           }
         return -1;
@@ -4654,6 +4659,26 @@ FXint FXExecute::search(const FXchar* prog,const FXchar* fm,const FXchar* to){
         return -1;
         }
 
+      // Only one possible starting character
+      if(0<=lead){
+        if(to==str_end) to--;
+        while(fm<=to && (fm=(const FXchar*)memchr(fm,lead,to-fm+1))!=nullptr){
+          if(attempt(prog,fm)) return fm-str_beg;
+          fm++;
+          }
+        return -1;
+        }
+
+      // Known set of starting characters
+      if(set){
+        if(to==str_end) to--;
+        while(fm<=to){
+          if(ISIN(set,(FXuchar)*fm) && attempt(prog,fm)) return fm-str_beg;
+          fm++;
+          }
+        return -1;
+        }
+
       // General case
       while(fm<=to){
         if(attempt(prog,fm)) return fm-str_beg;
@@ -4776,6 +4801,591 @@ FXint FXExecute::search(const FXchar* prog,const FXchar* fm,const FXchar* to){
   return -1;
   }
 
+
+/*******************************************************************************/
+
+// Program properties
+enum {
+  HINT_LINEAR = 1,          // Program can run on lock-step matcher
+  HINT_FIRST  = 2           // Set of starting characters is known
+  };
+
+
+// Size of single character match instruction, or 0 if it is not one
+static FXint onesize(const FXchar* prog){
+  switch((FXuchar)*prog){
+    case OP_IN:
+    case OP_NOT_IN:
+      return 33;
+    case OP_ANY_OF:
+    case OP_ANY_BUT:
+      return 2+(FXuchar)prog[1];
+    case OP_CHAR:
+    case OP_CHAR_CI:
+      return 2;
+    }
+  if(OP_ANY<=(FXuchar)*prog && (FXuchar)*prog<=OP_NOT_WORD_NL) return 1;
+  return 0;
+  }
+
+
+// Match character against single character match instruction
+static FXbool onematch(const FXchar* prog,FXuchar ch){
+  switch((FXuchar)*prog){
+    case OP_ANY: return ch!='\n';
+    case OP_ANY_NL: return true;
+    case OP_IN: return ISIN((prog+1),ch)!=0;
+    case OP_NOT_IN: return ISIN((prog+1),ch)==0;
+    case OP_ANY_OF: return INLIST(prog+1,ch);
+    case OP_ANY_BUT: return !INLIST(prog+1,ch);
+    case OP_UPPER: return Ascii::isUpper(ch);
+    case OP_LOWER: return Ascii::isLower(ch);
+    case OP_SPACE: return ch!='\n' && Ascii::isSpace(ch);
+    case OP_SPACE_NL: return Ascii::isSpace(ch);
+    case OP_NOT_SPACE: return !Ascii::isSpace(ch);
+    case OP_DIGIT: return Ascii::isDigit(ch);
+    case OP_NOT_DIGIT: return ch!='\n' && !Ascii::isDigit(ch);
+    case OP_NOT_DIGIT_NL: return !Ascii::isDigit(ch);
+    case OP_HEX: return Ascii::isHexDigit(ch);
+    case OP_NOT_HEX: return ch!='\n' && !Ascii::isHexDigit(ch);
+    case OP_NOT_HEX_NL: return !Ascii::isHexDigit(ch);
+    case OP_LETTER: return Ascii::isLetter(ch);
+    case OP_NOT_LETTER: return ch!='\n' && !Ascii::isLetter(ch);
+    case OP_NOT_LETTER_NL: return !Ascii::isLetter(ch);
+    case OP_PUNCT: return Ascii::isDelim(ch);
+    case OP_NOT_PUNCT: return ch!='\n' && !Ascii::isDelim(ch);
+    case OP_NOT_PUNCT_NL: return !Ascii::isDelim(ch);
+    case OP_WORD: return Ascii::isWord(ch);
+    case OP_NOT_WORD: return ch!='\n' && !Ascii::isWord(ch);
+    case OP_NOT_WORD_NL: return !Ascii::isWord(ch);
+    case OP_CHAR: return prog[1]==(FXchar)ch;
+    case OP_CHAR_CI: return prog[1]==Ascii::toLower(ch);
+    }
+  return false;
+  }
+
+
+// Add characters matched by single character match instruction to set
+static void onechars(const FXchar* prog,FXuchar set[]){
+  for(FXint ch=0; ch<256; ++ch){
+    if(onematch(prog,ch)) INCL(set,ch);
+    }
+  }
+
+
+// Collect the characters a match can start with, following all paths from pc.
+// Fails if the match could be empty, or if the program is too complicated.
+static FXbool startset(const FXchar* prog,FXint pc,FXuchar set[],FXuchar visited[]){
+  const FXchar* p;
+  while(!visited[pc]){
+    visited[pc]=1;
+    p=prog+pc;
+    switch((FXuchar)*p){
+      case OP_FAIL:
+        return true;
+      case OP_JUMP:
+        pc+=1+GETARG(p+1);
+        continue;
+      case OP_BRANCH:
+      case OP_BRANCHREV:
+        if(!startset(prog,pc+3,set,visited)) return false;
+        pc+=1+GETARG(p+1);
+        continue;
+      case OP_NOT_EMPTY:
+      case OP_STR_BEG:
+      case OP_STR_END:
+      case OP_LINE_BEG:
+      case OP_LINE_END:
+      case OP_WORD_BEG:
+      case OP_WORD_END:
+      case OP_WORD_BND:
+      case OP_WORD_INT:
+        pc+=1;
+        continue;
+      case OP_CHARS:
+        INCL(set,(FXuchar)p[3]);
+        return true;
+      case OP_CHARS_CI:
+        INCL(set,(FXuchar)p[3]);
+        INCL(set,(FXuchar)Ascii::toUpper(p[3]));
+        return true;
+      case OP_PLUS:
+      case OP_MIN_PLUS:
+      case OP_POS_PLUS:
+        onechars(p+1,set);
+        return true;
+      case OP_STAR:
+      case OP_MIN_STAR:
+      case OP_POS_STAR:
+      case OP_QUEST:
+      case OP_MIN_QUEST:
+      case OP_POS_QUEST:
+        onechars(p+1,set);
+        pc+=1+onesize(p+1);
+        continue;
+      case OP_REP:
+      case OP_MIN_REP:
+      case OP_POS_REP:
+        onechars(p+5,set);
+        if(0<GETARG(p+1)) return true;
+        pc+=5+onesize(p+5);
+        continue;
+      default:
+        if(OP_SUB_BEG_0<=(FXuchar)*p && (FXuchar)*p<=OP_SUB_END_9){
+          pc+=1;
+          continue;
+          }
+        if(onesize(p)){
+          onechars(p,set);
+          return true;
+          }
+        return false;
+      }
+    }
+  return true;
+  }
+
+
+// Find the longest literal string which any match must contain; only
+// the code up to the first alternation or loop is considered.
+static void mustcontain(const FXchar* prog,FXString& lit){
+  FXString run;
+  FXint len;
+  lit.clear();
+  while(1){
+    switch((FXuchar)*prog){
+      case OP_CHARS:
+        len=GETARG(prog+1);
+        run.append(prog+3,len);
+        prog+=3+len;
+        continue;
+      case OP_CHAR:
+        run.append(prog[1]);
+        prog+=2;
+        continue;
+      case OP_NOT_EMPTY:
+      case OP_STR_BEG:
+      case OP_STR_END:
+      case OP_LINE_BEG:
+      case OP_LINE_END:
+      case OP_WORD_BEG:
+      case OP_WORD_END:
+      case OP_WORD_BND:
+      case OP_WORD_INT:
+        prog+=1;
+        continue;
+      case OP_CHARS_CI:
+        len=3+GETARG(prog+1);
+        break;
+      case OP_STAR:
+      case OP_MIN_STAR:
+      case OP_POS_STAR:
+      case OP_PLUS:
+      case OP_MIN_PLUS:
+      case OP_POS_PLUS:
+      case OP_QUEST:
+      case OP_MIN_QUEST:
+      case OP_POS_QUEST:
+        len=1+onesize(prog+1);
+        break;
+      case OP_REP:
+      case OP_MIN_REP:
+      case OP_POS_REP:
+        len=5+onesize(prog+5);
+        break;
+      default:
+        if(OP_SUB_BEG_0<=(FXuchar)*prog && (FXuchar)*prog<=OP_SUB_END_9){
+          prog+=1;
+          continue;
+          }
+        len=onesize(prog);
+        break;
+      }
+    if(lit.length()<run.length()) lit=run;
+    if(len==0) return;
+    run.clear();
+    prog+=len;
+    }
+  }
+
+
+// Check if program can be run by the lock-step matcher; this excludes
+// backreferences, lookaround, counters, and the possessive constructs
+static FXbool linearizable(const FXchar* prog,FXint size){
+  const FXchar* end=prog+size;
+  FXint len;
+  while(prog<end){
+    switch((FXuchar)*prog){
+      case OP_FAIL:
+      case OP_PASS:
+      case OP_NOT_EMPTY:
+      case OP_STR_BEG:
+      case OP_STR_END:
+      case OP_LINE_BEG:
+      case OP_LINE_END:
+      case OP_WORD_BEG:
+      case OP_WORD_END:
+      case OP_WORD_BND:
+      case OP_WORD_INT:
+        prog+=1;
+        continue;
+      case OP_JUMP:
+      case OP_BRANCH:
+      case OP_BRANCHREV:
+        prog+=3;
+        continue;
+      case OP_CHARS:
+      case OP_CHARS_CI:
+        prog+=3+GETARG(prog+1);
+        continue;
+      case OP_STAR:
+      case OP_MIN_STAR:
+      case OP_PLUS:
+      case OP_MIN_PLUS:
+      case OP_QUEST:
+      case OP_MIN_QUEST:
+        if((len=onesize(prog+1))==0) return false;
+        prog+=1+len;
+        continue;
+      default:
+        if(OP_SUB_BEG_0<=(FXuchar)*prog && (FXuchar)*prog<=OP_SUB_END_9){
+          prog+=1;
+          continue;
+          }
+        if((len=onesize(prog))==0) return false;
+        prog+=len;
+        continue;
+      }
+    }
+  return true;
+  }
+
+
+// Check if literal string occurs in the range
+static FXbool hasliteral(const FXchar* beg,const FXchar* end,const FXchar* lit,FXint n){
+  const FXchar* last=end-n;
+  while(beg<=last){
+    if((beg=(const FXchar*)memchr(beg,lit[0],last-beg+1))==nullptr) return false;
+    if(memcmp(beg,lit,n)==0) return true;
+    beg++;
+    }
+  return false;
+  }
+
+/*******************************************************************************/
+
+// Strand of execution of the lock-step matcher
+struct FXStrand {
+  FXint          pc;                // Instruction
+  FXint          ix;                // Position in literal run, or repeat iteration
+  FXint          rp;                // Repeat to return to after matching its operand, or -1
+  const FXchar  *anc;               // Anchor point
+  const FXchar  *sub[2*NSUBEXP];    // Captured substrings
+  };
+
+
+// Lock-step matcher.  Rather than trying alternatives one after another,
+// all alternatives advance over the subject string together; strands which
+// reach an instruction already visited by a strand of higher priority are
+// dropped, so matching takes time linear in the length of the subject string.
+// The strands are kept in order of preference, which yields the same match
+// as the backtracking matcher.
+class FXSimulate {
+  enum { NLOCAL=32 };               // Small programs don't need heap memory
+  const FXchar  *prog;              // Program
+  const FXchar  *str_beg;           // Begin of string
+  const FXchar  *str_end;           // End of string
+  const FXuchar *set;               // Possible starting characters
+  FXint          lead;              // Only possible starting character
+  FXint         *sub_beg;           // Begin of substring i
+  FXint         *sub_end;           // End of substring i
+  FXint          npar;              // Number of capturing parentheses
+  FXint          mode;              // Match mode
+  FXStrand      *cur;               // Strands at current position
+  FXStrand      *nxt;               // Strands at next position
+  FXuint        *mark;              // Last generation each state was visited
+  FXuint         gen;               // Generation
+  FXStrand       local[2][NLOCAL];  // Strands for small programs
+  FXuint         localmark[2*NLOCAL];
+private:
+  FXbool assertion(FXuchar op,const FXchar* str) const;
+  void add(FXStrand* list,FXint& n,FXint pc,FXint ix,FXint rp,const FXStrand& s,const FXchar* str);
+  void copy(FXStrand& dst,const FXStrand& src) const;
+public:
+
+  // Construct lock-step matcher
+  FXSimulate(const FXchar* p,FXint size,const FXchar* sbeg,const FXchar* send,FXint* b,FXint* e,FXint np,FXint m);
+
+  // Skip start positions using starting characters
+  void prefilter(const FXuchar* s,FXint l){ set=s; lead=l; }
+
+  // Search in string, trying start positions fm...to
+  FXint search(const FXchar* fm,const FXchar* to);
+
+  // Destroy
+ ~FXSimulate();
+  };
+
+
+// Construct lock-step matcher; there is at most one strand per
+// program location, and two states per location
+FXSimulate::FXSimulate(const FXchar* p,FXint size,const FXchar* sbeg,const FXchar* send,FXint* b,FXint* e,FXint np,FXint m):prog(p),str_beg(sbeg),str_end(send),set(nullptr),lead(-1),sub_beg(b),sub_end(e),npar(FXMIN(np,NSUBEXP)),mode(m),cur(local[0]),nxt(local[1]),mark(localmark),gen(0){
+  if(NLOCAL<size+1){
+    allocElms(cur,size+1);
+    allocElms(nxt,size+1);
+    allocElms(mark,2*size+2);
+    }
+  fillElms(mark,0,2*FXMAX(size+1,NLOCAL));
+  for(FXint i=0; i<npar; ++i){
+    sub_beg[i]=sub_end[i]=-1;
+    }
+  }
+
+
+// Check zero-width assertion at str
+FXbool FXSimulate::assertion(FXuchar op,const FXchar* str) const {
+  switch(op){
+    case OP_STR_BEG:
+      return str==str_beg;
+    case OP_STR_END:
+      return str==str_end;
+    case OP_LINE_BEG:
+      if(str_beg<str) return *(str-1)=='\n';
+      return !(mode&FXRex::NotBol);
+    case OP_LINE_END:
+      if(str<str_end) return *str=='\n';
+      return !(mode&FXRex::NotEol);
+    case OP_WORD_BEG:
+      return str<str_end && Ascii::isWord(*str) && (str<=str_beg || !Ascii::isWord(*(str-1)));
+    case OP_WORD_END:
+      return str_beg<str && Ascii::isWord(*(str-1)) && (str_end<=str || !Ascii::isWord(*str));
+    case OP_WORD_BND:
+      return (str<str_end && Ascii::isWord(*str)) != (str_beg<str && Ascii::isWord(*(str-1)));
+    case OP_WORD_INT:
+      return str_beg<str && str<str_end && Ascii::isWord(*str) && Ascii::isWord(*(str-1));
+    }
+  return false;
+  }
+
+
+// Copy anchor and those captures we're going to report
+void FXSimulate::copy(FXStrand& dst,const FXStrand& src) const {
+  dst.anc=src.anc;
+  for(FXint i=2; i<2*npar; ++i){
+    dst.sub[i]=src.sub[i];
+    }
+  }
+
+
+// Add strand to list, following empty transitions in order of preference
+void FXSimulate::add(FXStrand* list,FXint& n,FXint pc,FXint ix,FXint rp,const FXStrand& s,const FXchar* str){
+  const FXchar* p=prog+pc;
+  FXuchar op=*p;
+  FXStrand t;
+  FXint key,no;
+
+  // Each state is visited only once per generation
+  if(0<=rp) key=2*pc+1;
+  else if(op==OP_CHARS || op==OP_CHARS_CI) key=2*(pc+(ix?ix+2:0));
+  else key=2*pc+ix;
+  if(mark[key]==gen) return;
+  mark[key]=gen;
+
+  // Operand of repeat
+  if(0<=rp) goto x;
+
+  switch(op){
+    case OP_JUMP:
+      add(list,n,pc+1+GETARG(p+1),0,-1,s,str);
+      return;
+    case OP_BRANCH:                             // Following code first
+      add(list,n,pc+3,0,-1,s,str);
+      add(list,n,pc+1+GETARG(p+1),0,-1,s,str);
+      return;
+    case OP_BRANCHREV:                          // Jump first
+      add(list,n,pc+1+GETARG(p+1),0,-1,s,str);
+      add(list,n,pc+3,0,-1,s,str);
+      return;
+    case OP_NOT_EMPTY:
+      if(str==s.anc) return;
+      add(list,n,pc+1,0,-1,s,str);
+      return;
+    case OP_STR_BEG:
+    case OP_STR_END:
+    case OP_LINE_BEG:
+    case OP_LINE_END:
+    case OP_WORD_BEG:
+    case OP_WORD_END:
+    case OP_WORD_BND:
+    case OP_WORD_INT:
+      if(!assertion(op,str)) return;
+      add(list,n,pc+1,0,-1,s,str);
+      return;
+    case OP_PLUS:                               // First iteration is required
+    case OP_MIN_PLUS:
+      if(ix==0){
+        add(list,n,pc+1,0,pc,s,str);
+        return;
+        }
+      /*FALL*/
+    case OP_STAR:
+    case OP_MIN_STAR:
+      if(op==OP_STAR || op==OP_PLUS){
+        add(list,n,pc+1,0,pc,s,str);
+        add(list,n,pc+1+onesize(p+1),0,-1,s,str);
+        }
+      else{
+        add(list,n,pc+1+onesize(p+1),0,-1,s,str);
+        add(list,n,pc+1,0,pc,s,str);
+        }
+      return;
+    case OP_QUEST:
+      add(list,n,pc+1,0,-1,s,str);
+      add(list,n,pc+1+onesize(p+1),0,-1,s,str);
+      return;
+    case OP_MIN_QUEST:
+      add(list,n,pc+1+onesize(p+1),0,-1,s,str);
+      add(list,n,pc+1,0,-1,s,str);
+      return;
+    }
+
+  // Capturing parentheses
+  if(OP_SUB_BEG_0<=op && op<=OP_SUB_END_9){
+    no=(op<=OP_SUB_BEG_9)?2*(op-OP_SUB_BEG_0):2*(op-OP_SUB_END_0)+1;
+    if(no<2*npar){
+      copy(t,s);
+      t.sub[no]=str;
+      add(list,n,pc+1,0,-1,t,str);
+      return;
+      }
+    add(list,n,pc+1,0,-1,s,str);
+    return;
+    }
+
+  // Literals, single characters, and success
+x:list[n].pc=pc;
+  list[n].ix=ix;
+  list[n].rp=rp;
+  copy(list[n],s);
+  n++;
+  }
+
+
+// Search in string, trying start positions fm...to
+FXint FXSimulate::search(const FXchar* fm,const FXchar* to){
+  const FXchar* str=fm;
+  const FXchar* end=nullptr;
+  const FXchar* p;
+  FXStrand best;
+  FXStrand s;
+  FXStrand* tmp;
+  FXint ncur=0;
+  FXint nnxt;
+  FXint no,i;
+  FXuchar ch;
+
+  // No captures yet
+  for(i=0; i<2*NSUBEXP; ++i) s.sub[i]=nullptr;
+
+  while(1){
+
+    // Start a new strand here unless we already have a match
+    if(!end && str<=to){
+      if(ncur==0){
+        if(0<=lead){
+          if(str>=str_end) break;
+          if((str=(const FXchar*)memchr(str,lead,FXMIN(to+1,str_end)-str))==nullptr) break;
+          }
+        else if(set){
+          while(str<=to && str<str_end && !ISIN(set,(FXuchar)*str)) str++;
+          if(str>to || str>=str_end) break;
+          }
+        gen++;
+        }
+      if(!set || (str<str_end && ISIN(set,(FXuchar)*str))){
+        s.anc=str;
+        add(cur,ncur,0,0,-1,s,str);
+        }
+      }
+
+    // Nothing to advance; try next start position
+    if(ncur==0){
+      if(end || to<=str || str_end<=str) break;
+      str++;
+      continue;
+      }
+
+    // Advance the strands over the next character
+    gen++;
+    nnxt=0;
+    for(i=0; i<ncur; ++i){
+      const FXStrand& c=cur[i];
+      p=prog+c.pc;
+      if(c.rp<0 && *p==OP_PASS){                // Match; drop strands of lower priority
+        copy(best,c);
+        end=str;
+        break;
+        }
+      if(str>=str_end) continue;
+      ch=(FXuchar)*str;
+      if(c.rp<0 && (*p==OP_CHARS || *p==OP_CHARS_CI)){
+        no=GETARG(p+1);
+        if(*p==OP_CHARS_CI) ch=Ascii::toLower(ch);
+        if((FXuchar)p[3+c.ix]!=ch) continue;
+        if(c.ix+1<no){
+          add(nxt,nnxt,c.pc,c.ix+1,-1,c,str+1);
+          }
+        else{
+          add(nxt,nnxt,c.pc+3+no,0,-1,c,str+1);
+          }
+        continue;
+        }
+      if(!onematch(p,ch)) continue;
+      if(0<=c.rp){                              // Back to repeat
+        add(nxt,nnxt,c.rp,1,-1,c,str+1);
+        }
+      else{
+        add(nxt,nnxt,c.pc+onesize(p),0,-1,c,str+1);
+        }
+      }
+
+    // End of string
+    if(str>=str_end) break;
+
+    tmp=cur;
+    cur=nxt;
+    nxt=tmp;
+    ncur=nnxt;
+    str++;
+    }
+
+  // Record matched range and subexpressions
+  if(end){
+    if(0<npar){
+      sub_beg[0]=best.anc-str_beg;
+      sub_end[0]=end-str_beg;
+      for(i=1; i<npar; ++i){
+        if(best.sub[2*i] && best.sub[2*i+1]){
+          sub_beg[i]=best.sub[2*i]-str_beg;
+          sub_end[i]=best.sub[2*i+1]-str_beg;
+          }
+        }
+      }
+    return best.anc-str_beg;
+    }
+  return -1;
+  }
+
+
+// Destroy
+FXSimulate::~FXSimulate(){
+  if(mark!=localmark){
+    freeElms(cur);
+    freeElms(nxt);
+    freeElms(mark);
+    }
+  }
+
 }
 
 /*******************************************************************************/
@@ -4805,19 +5415,20 @@ const FXchar *const FXRex::errors[]={
 
 
 // Construct empty regular expression object
-FXRex::FXRex(){
+FXRex::FXRex():lead(-1),hints(0){
   FXTRACE((TOPIC_CONSTRUCT,"FXRex::FXRex()\n"));
   }
 
 
 // Copy regex object
-FXRex::FXRex(const FXRex& orig):code(orig.code){
+FXRex::FXRex(const FXRex& orig):code(orig.code),must(orig.must),lead(orig.lead),hints(orig.hints){
+  memcpy(first,orig.first,sizeof(first));
   FXTRACE((TOPIC_CONSTRUCT,"FXRex::FXRex(FXRex)\n"));
   }
 
 
 // Compile expression from pattern; fail if error
-FXRex::FXRex(const FXchar* pattern,FXint mode,FXRex::Error* error){
+FXRex::FXRex(const FXchar* pattern,FXint mode,FXRex::Error* error):lead(-1),hints(0){
   FXTRACE((TOPIC_CONSTRUCT,"FXRex::FXRex(%s,%u,%p)\n",pattern,mode,error));
   FXRex::Error err=parse(pattern,mode);
   if(error){ *error=err; }
@@ -4825,7 +5436,7 @@ FXRex::FXRex(const FXchar* pattern,FXint mode,FXRex::Error* error){
 
 
 // Compile expression from pattern; fail if error
-FXRex::FXRex(const FXString& pattern,FXint mode,FXRex::Error* error){
+FXRex::FXRex(const FXString& pattern,FXint mode,FXRex::Error* error):lead(-1),hints(0){
   FXTRACE((TOPIC_CONSTRUCT,"FXRex::FXRex(%s,%u,%p)\n",pattern.text(),mode,error));
   FXRex::Error err=parse(pattern.text(),mode);
   if(error){ *error=err; }
@@ -4875,6 +5486,9 @@ FXRex::Error FXRex::parse(const FXchar* pattern,FXint mode){
 #ifdef TOPIC_REXDUMP
                 if(getTraceTopic(TOPIC_REXDUMP)){ dump(adjustedpattern.text(),code.text()); }
 #endif
+                // Find ways to speed up the search
+                analyze();
+
                 FXTRACE((TOPIC_DETAIL,"FXRex::parse: OK\n\n"));
                 return ErrOK;
                 }
@@ -4895,10 +5509,40 @@ FXRex::Error FXRex::parse(const FXString& pattern,FXint mode){
   return parse(pattern.text(),mode);
   }
 
+
+// Determine starting characters, required literal, and matcher
+void FXRex::analyze(){
+  must.clear();
+  memset(first,0,sizeof(first));
+  lead=-1;
+  hints=0;
+  if(!code.empty()){
+    FXString visited('\0',code.length());
+    if(startset(code.text(),0,first,(FXuchar*)visited.text())){
+      FXint count=0;
+      for(FXint ch=0; ch<256; ++ch){
+        if(ISIN(first,ch)){ lead=ch; count++; }
+        }
+      if(count!=1) lead=-1;
+      hints|=HINT_FIRST;
+      }
+    if(linearizable(code.text(),code.length())){
+      hints|=HINT_LINEAR;
+      }
+    mustcontain(code.text(),must);
+    if(must.length()==1 && (FXuchar)must[0]==lead) must.clear();
+    }
+  }
+
 /*******************************************************************************/
 
 // Match pattern in string at position pos
 FXbool FXRex::amatch(const FXchar* string,FXint len,FXint pos,FXint mode,FXint* beg,FXint* end,FXint npar) const {
+  if((mode&Linear) && (hints&HINT_LINEAR) && !(mode&Unicode)){
+    FXSimulate ms(code.text(),code.length(),string,string+len,beg,end,npar,mode);
+    ms.prefilter((hints&HINT_FIRST)?first:nullptr,lead);
+    return ms.search(string+pos,string+pos)==pos;
+    }
   FXExecute ms(string,string+len,beg,end,npar,mode);
   return ms.attempt(code.text(),string+pos);
   }
@@ -4906,23 +5550,38 @@ FXbool FXRex::amatch(const FXchar* string,FXint len,FXint pos,FXint mode,FXint*
 
 // Match pattern in string at position pos
 FXbool FXRex::amatch(const FXString& string,FXint pos,FXint mode,FXint* beg,FXint* end,FXint npar) const {
-  FXExecute ms(string.text(),string.text()+string.length(),beg,end,npar,mode);
-  return ms.attempt(code.text(),string.text()+pos);
+  return amatch(string.text(),string.length(),pos,mode,beg,end,npar);
   }
 
 /*******************************************************************************/
 
 // Search for pattern in string, starting at fm; return position or -1
 FXint FXRex::search(const FXchar* string,FXint len,FXint fm,FXint to,FXint mode,FXint* beg,FXint* end,FXint npar) const {
+  const FXuchar* set=(hints&HINT_FIRST)?first:nullptr;
+
+  // Lock-step matcher
+  if((mode&Linear) && (hints&HINT_LINEAR) && !(mode&Unicode) && fm<=to){
+    FXSimulate ms(code.text(),code.length(),string,string+len,beg,end,npar,mode);
+    if(must.empty() || hasliteral(string+fm,string+len,must.text(),must.length())){
+      ms.prefilter(set,lead);
+      return ms.search(string+fm,string+to);
+      }
+    return -1;
+    }
+
+  // Backtracking matcher
   FXExecute ms(string,string+len,beg,end,npar,mode);
-  return ms.search(code.text(),string+fm,string+to);
+  if(must.empty() || hasliteral(string+FXMIN(fm,to),string+len,must.text(),must.length())){
+    ms.prefilter(set,lead);
+    return ms.search(code.text(),string+fm,string+to);
+    }
+  return -1;
   }
 
 
 // Search for pattern in string, starting at fm; return position or -1
 FXint FXRex::search(const FXString& string,FXint fm,FXint to,FXint mode,FXint* beg,FXint* end,FXint npar) const {
-  FXExecute ms(string.text(),string.text()+string.length(),beg,end,npar,mode);
-  return ms.search(code.text(),string.text()+fm,string.text()+to);
+  return search(string.text(),string.length(),fm,to,mode,beg,end,npar);
   }
 
 /*******************************************************************************/
@@ -5027,6 +5686,10 @@ FXString FXRex::substitute(const FXString& string,FXint* beg,FXint* end,const FX
 // Assignment
 FXRex& FXRex::operator=(const FXRex& orig){
   code=orig.code;
+  must=orig.must;
+  memcpy(first,orig.first,sizeof(first));
+  lead=orig.lead;
+  hints=orig.hints;
   return *this;
   }
 
@@ -5053,6 +5716,7 @@ FXStream& operator<<(FXStream& store,const FXRex& s){
 // Load
 FXStream& operator>>(FXStream& store,FXRex& s){
   store >> s.code;
+  s.analyze();
   return store;
   }
 
@@ -5060,6 +5724,9 @@ FXStream& operator>>(FXStream& store,FXRex& s){
 // Clear program
 void FXRex::clear(){
   code.clear();
+  must.clear();
+  lead=-1;
+  hints=0;
   }
 
 
@@ -17,10 +17,14 @@
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
 #include "ap_defs.h"
+#include <FXAtomic.h>
+#include "ap_utils.h"
 #include "ap_thread_queue.h"
+#include "ap_input_plugin.h"
 
 
 #ifndef _WIN32
+#include <poll.h>
 #include <unistd.h> // for close()
 #include <fcntl.h>
 #include <errno.h>
@@ -72,45 +76,148 @@ Socket * ConnectionFactory::create(FXint domain,FXint type,FXint protocol) {
   }
 
 
-FXIO* ConnectionFactory::open(const FXString & hostname,FXint port,FXbool ssl) {
-  struct addrinfo   hints;
-  struct addrinfo * list=nullptr;
-  struct addrinfo * item=nullptr;
-  FXint result;
+// Resolved address
+struct SocketAddress {
+  struct sockaddr_storage address;
+  FXint                   length;
+  FXint                   family;
+  FXint                   socktype;
+  FXint                   protocol;
+  };
+
 
+// Convert address list. Address families are interleaved, starting with the preferred family.
+static void copy_addresses(const struct addrinfo * list,SocketAddressList & addresses) {
+  SocketAddressList primary;
+  SocketAddressList secondary;
+  SocketAddress     entry;
+  for (const struct addrinfo * item=list;item;item=item->ai_next) {
+    if (item->ai_addrlen>sizeof(struct sockaddr_storage))
+      continue;
+    memset(&entry,0,sizeof(SocketAddress));
+    memcpy(&entry.address,item->ai_addr,item->ai_addrlen);
+    entry.length   = (FXint)item->ai_addrlen;
+    entry.family   = item->ai_family;
+    entry.socktype = item->ai_socktype;
+    entry.protocol = item->ai_protocol;
+    if (primary.no()==0 || primary[0].family==entry.family)
+      primary.append(entry);
+    else
+      secondary.append(entry);
+    }
+  addresses.clear();
+  for (FXint i=0;i<primary.no() || i<secondary.no();i++) {
+    if (i<primary.no()) addresses.append(primary[i]);
+    if (i<secondary.no()) addresses.append(secondary[i]);
+    }
+  }
+
+
+static void init_hints(struct addrinfo & hints) {
   memset(&hints,0,sizeof(struct addrinfo));
   hints.ai_family=AF_UNSPEC;
   hints.ai_socktype=SOCK_STREAM;
   hints.ai_flags|=(AI_NUMERICSERV|AI_ADDRCONFIG);
+  }
 
-  // Automatically enable ssl for 443
-#if defined(HAVE_OPENSSL) || defined(HAVE_GNUTLS)
-  use_ssl = ssl;
-  if (use_ssl) GM_DEBUG_PRINT("[connection] using SSL on port %d\n",port);
-#else
-  if (ssl) {
-    GM_DEBUG_PRINT("[connection] no support for SSL\n");
-    return nullptr;
+//------------------------------------------------------------------------------
+
+// getaddrinfo doesn't tell us the record ttl, so entries expire after a fixed time
+static const FXTime  DNS_CACHE_TTL  = 60_s;
+static const FXint   DNS_CACHE_SIZE = 16;
+
+
+struct DNSCacheEntry {
+  FXString          key;
+  SocketAddressList addresses;
+  FXTime            expires = 0;
+  };
+
+static FXMutex                dns_cache_mutex;
+static FXArray<DNSCacheEntry> dns_cache;
+
+
+static FXString dns_cache_key(const FXString & hostname,FXint port) {
+  return FXString::value("%s:%d",hostname.text(),port);
+  }
+
+
+static FXbool dns_cache_lookup(const FXString & key,SocketAddressList & addresses) {
+  FXScopedMutex lock(dns_cache_mutex);
+  const FXTime now = FXThread::steadytime();
+  for (FXint i=0;i<dns_cache.no();i++) {
+    if (dns_cache[i].key==key) {
+      if (dns_cache[i].expires>now) {
+        addresses = dns_cache[i].addresses;
+        return true;
+        }
+      dns_cache.erase(i);
+      break;
+      }
     }
-#endif
+  return false;
+  }
+
+
+static void dns_cache_insert(const FXString & key,const SocketAddressList & addresses) {
+  FXScopedMutex lock(dns_cache_mutex);
+  const FXTime now = FXThread::steadytime();
+
+  // Drop expired entries and the previous entry for this key
+  for (FXint i=dns_cache.no()-1;i>=0;i--) {
+    if (dns_cache[i].expires<=now || dns_cache[i].key==key)
+      dns_cache.erase(i);
+    }
+
+  // Oldest entry goes first
+  if (dns_cache.no()>=DNS_CACHE_SIZE)
+    dns_cache.erase(0);
+
+  DNSCacheEntry entry;
+  entry.key       = key;
+  entry.addresses = addresses;
+  entry.expires   = now + DNS_CACHE_TTL;
+  dns_cache.append(entry);
+  }
+
+
+static void dns_cache_remove(const FXString & key) {
+  FXScopedMutex lock(dns_cache_mutex);
+  for (FXint i=0;i<dns_cache.no();i++) {
+    if (dns_cache[i].key==key) {
+      dns_cache.erase(i);
+      break;
+      }
+    }
+  }
+
+//------------------------------------------------------------------------------
+
+FXbool ConnectionFactory::resolve(const FXString & hostname,FXint port,SocketAddressList & addresses) {
+  struct addrinfo   hints;
+  struct addrinfo * list=nullptr;
+  init_hints(hints);
+  if (getaddrinfo(hostname.text(),FXString::value(port).text(),&hints,&list))
+    return false;
+  copy_addresses(list,addresses);
+  freeaddrinfo(list);
+  return addresses.no()>0;
+  }
 
-  result=getaddrinfo(hostname.text(),FXString::value(port).text(),&hints,&list);
-  if (result) return nullptr;
 
-  for (item=list;item;item=item->ai_next){
-    Socket * io = create(item->ai_family,item->ai_socktype,item->ai_protocol);
+FXIO * ConnectionFactory::connect(const SocketAddressList & addresses) {
+  for (FXint i=0;i<addresses.no();i++){
+    Socket * io = create(addresses[i].family,addresses[i].socktype,addresses[i].protocol);
     if (io==nullptr)
       continue;
 
-    switch(io->connect((const struct sockaddr*)item->ai_addr,(FXint)item->ai_addrlen)){
+    switch(io->connect((const struct sockaddr*)&addresses[i].address,addresses[i].length)){
       case  0: // connected
-        freeaddrinfo(list);
         return io;
         break;
 
       case 1:  // user interrupt, give up
         delete io;
-        freeaddrinfo(list);
         return nullptr;
         break;
 
@@ -119,17 +226,230 @@ FXIO* ConnectionFactory::open(const FXString & hostname,FXint port,FXbool ssl) {
         break;
       }
     }
-  if (list) freeaddrinfo(list);
   return nullptr;
   }
 
+
+FXIO* ConnectionFactory::open(const FXString & hostname,FXint port,FXbool ssl) {
+  SocketAddressList addresses;
+
+  // Automatically enable ssl for 443
+#if defined(HAVE_OPENSSL) || defined(HAVE_GNUTLS)
+  use_ssl = ssl;
+  if (use_ssl) GM_DEBUG_PRINT("[connection] using SSL on port %d\n",port);
+#else
+  if (ssl) {
+    GM_DEBUG_PRINT("[connection] no support for SSL\n");
+    return nullptr;
+    }
+#endif
+
+  const FXString key = dns_cache_key(hostname,port);
+  if (!dns_cache_lookup(key,addresses)) {
+    if (!resolve(hostname,port,addresses))
+      return nullptr;
+    dns_cache_insert(key,addresses);
+    }
+  else {
+    GM_DEBUG_PRINT("[connection] using cached address for %s\n",key.text());
+    }
+
+  FXIO * io = connect(addresses);
+
+  // Addresses may be stale, resolve again next time
+  if (io==nullptr)
+    dns_cache_remove(key);
+
+  return io;
+  }
+
 //------------------------------------------------------------------------------
 
+// Resolves a hostname on its own thread. Resolver is shared with the thread that
+// started it, and the last one to let go deletes it. getaddrinfo can't be interrupted,
+// so on abort the resolver is simply left to finish in the background.
+class Resolver : public FXThread {
+protected:
+  FXString          hostname;
+  FXString          service;
+  volatile FXint    refcount = 2;
+public:
+  SocketAddressList addresses;
+  Signal            done;
+protected:
+  FXint run() override {
+    struct addrinfo   hints;
+    struct addrinfo * list=nullptr;
+    ap_set_thread_name("ap_resolver");
+    init_hints(hints);
+    if (getaddrinfo(hostname.text(),service.text(),&hints,&list)==0) {
+      copy_addresses(list,addresses);
+      freeaddrinfo(list);
+      }
+    done.set();
+    unref();
+    return 0;
+    }
+public:
+  Resolver(const FXString & host,FXint port) : hostname(host), service(FXString::value(port)) {
+    done.create();
+    }
+
+  void unref() {
+    if (atomicAdd(&refcount,-1)==1)
+      delete this;
+    }
+
+  ~Resolver() {
+    done.close();
+    }
+  };
+
+
 ThreadConnectionFactory::ThreadConnectionFactory(IOContext * ctx)
   : context(ctx) {
   }
 
 
+FXbool ThreadConnectionFactory::resolve(const FXString & hostname,FXint port,SocketAddressList & addresses) {
+  Resolver * resolver = new Resolver(hostname,port);
+  if (!resolver->start()) {
+    delete resolver;
+    return ConnectionFactory::resolve(hostname,port,addresses);
+    }
+  resolver->detach();
+
+  WaitEvent event;
+  do {
+    event = context->signal().wait(resolver->done.handle(),WaitMode::Read,30_s);
+    if (event==WaitEvent::Input) {
+      addresses = resolver->addresses;
+      resolver->unref();
+      return addresses.no()>0;
+      }
+    }
+  while(event==WaitEvent::Signal && !context->aborted());
+  GM_DEBUG_PRINT("[connection] resolving %s %s\n",hostname.text(),(event==WaitEvent::Signal) ? "interrupted" : "failed");
+  resolver->unref();
+  return false;
+  }
+
+
+
+#ifndef _WIN32
+
+// Delay before starting the next connection attempt
+static const FXTime CONNECTION_ATTEMPT_DELAY = 250_ms;
+
+// Give up on a single connection attempt after
+static const FXTime CONNECTION_TIMEOUT       = 10_s;
+
+// Max connection attempts in flight
+static const FXint  MAX_CONNECTION_ATTEMPTS  = 8;
+
+
+FXIO * ThreadConnectionFactory::connect(const SocketAddressList & addresses) {
+  struct pollfd handles[MAX_CONNECTION_ATTEMPTS+1];
+  Socket *      pending[MAX_CONNECTION_ATTEMPTS];
+  FXTime        deadline[MAX_CONNECTION_ATTEMPTS];
+  FXint         npending = 0;
+  FXint         next     = 0;
+  FXTime        attempt  = 0;
+  Socket *      io       = nullptr;
+  FXbool        interrupted = false;
+
+  while(io==nullptr && !interrupted) {
+    FXTime now = FXThread::steadytime();
+
+    // Start next attempt when none are in flight or the previous one is taking too long
+    if (next<addresses.no() && npending<MAX_CONNECTION_ATTEMPTS && (npending==0 || now>=attempt)) {
+      const SocketAddress & address = addresses[next++];
+      Socket * socket = create(address.family,address.socktype,address.protocol);
+      if (socket) {
+        switch(socket->beginConnect((const struct sockaddr*)&address.address,address.length)) {
+          case 0:
+          case FXIO::Again:
+            pending[npending]  = socket;
+            deadline[npending] = now + CONNECTION_TIMEOUT;
+            npending++;
+            break;
+          default:
+            delete socket;
+            break;
+          }
+        }
+      attempt = now + CONNECTION_ATTEMPT_DELAY;
+      continue;
+      }
+
+    // Nothing left to try
+    if (npending==0)
+      break;
+
+    // Wait until one of the attempts completes, the user interrupts or it's time for the next attempt
+    FXTime timeout = deadline[0];
+    for (FXint i=1;i<npending;i++) timeout = FXMIN(timeout,deadline[i]);
+    if (next<addresses.no() && npending<MAX_CONNECTION_ATTEMPTS) timeout = FXMIN(timeout,attempt);
+    timeout = FXMAX(0,timeout-now);
+
+    for (FXint i=0;i<npending;i++) {
+      handles[i].fd      = pending[i]->handle();
+      handles[i].events  = POLLOUT;
+      handles[i].revents = 0;
+      }
+    handles[npending].fd      = context->signal().handle();
+    handles[npending].events  = POLLIN;
+    handles[npending].revents = 0;
+
+    FXint n = poll(handles,npending+1,(FXint)(timeout/1_ms)+1);
+    if (n<0) {
+      if (errno==EAGAIN || errno==EINTR)
+        continue;
+      break;
+      }
+
+    if (handles[npending].revents) {
+      if (context->aborted()) {
+        interrupted = true;
+        break;
+        }
+      }
+
+    // Check attempts. Failed and timed out attempts are removed.
+    now = FXThread::steadytime();
+    for (FXint i=npending-1;i>=0;i--) {
+      FXbool failed = false;
+      if (handles[i].revents) {
+        switch(pending[i]->finishConnect()) {
+          case 0 : io = pending[i]; break;
+          case 1 : interrupted = true; break;
+          default: failed = true; break;
+          }
+        }
+      else if (now>=deadline[i]) {
+        failed = true;
+        }
+      if (failed || io==pending[i]) {
+        if (failed) delete pending[i];
+        pending[i]  = pending[npending-1];
+        deadline[i] = deadline[npending-1];
+        handles[i]  = handles[npending-1];
+        npending--;
+        }
+      if (io || interrupted) break;
+      }
+    }
+
+  // Cancel the remaining attempts
+  for (FXint i=0;i<npending;i++) {
+    delete pending[i];
+    }
+  return io;
+  }
+
+#endif
+
+
 Socket * ThreadConnectionFactory::create(FXint domain,FXint type,FXint protocol) {
   Socket * io = nullptr;
 
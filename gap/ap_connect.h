@@ -25,7 +25,16 @@ class Socket;
 class ThreadQueue;
 struct IOContext;
 
-/* Connection Factory */
+struct SocketAddress;
+
+typedef FXArray<SocketAddress> SocketAddressList;
+
+/*
+  Connection Factory
+
+  Resolved addresses are kept in a small cache shared by all factories.
+  Addresses are tried in order, alternating between address families.
+*/
 class ConnectionFactory {
 #if defined(HAVE_OPENSSL) || defined(HAVE_GNUTLS)
 protected:
@@ -33,6 +42,12 @@ protected:
 #endif
 protected:
 	virtual Socket * create(FXint domain,FXint type,FXint protocol);
+
+  // Resolve hostname and port
+  virtual FXbool resolve(const FXString & hostname,FXint port,SocketAddressList & addresses);
+
+  // Connect to one of the addresses
+  virtual FXIO * connect(const SocketAddressList & addresses);
 public:
 	ConnectionFactory();
 
@@ -42,11 +57,24 @@ public:
 	virtual ~ConnectionFactory();
 	};
 
+/*
+  Connection Factory for the input thread
+
+  Name resolution runs on a separate thread so it can be interrupted
+  through the IOContext. Connection attempts are started 250ms apart
+  and the first one to succeed wins (RFC 8305, Happy Eyeballs).
+*/
 class ThreadConnectionFactory : public ConnectionFactory {
 protected:
 	IOContext * context;
 protected:
 	Socket * create(FXint domain,FXint type,FXint protocol) override;
+
+  FXbool resolve(const FXString & hostname,FXint port,SocketAddressList & addresses) override;
+
+#ifndef _WIN32
+  FXIO * connect(const SocketAddressList & addresses) override;
+#endif
 public:
 	ThreadConnectionFactory(IOContext*);
   };
@@ -17,6 +17,7 @@
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
 #include "ap_defs.h"
+#include "ap_format.h"
 #include "ap_convert.h"
 
 #define INT8_MIN (-128)
@@ -116,21 +117,29 @@ void s16_to_s32(const FXuchar *buffer,FXuint nsamples,MemoryBuffer & out) {
   out.wroteBytes(nsamples*4);
   }
 
-void s24le3_to_s16(FXuchar * input,FXuint nsamples) {
-  FXshort * output = reinterpret_cast<FXshort*>(input);
+void s24le3_to_s16(const FXuchar * input,FXuint nsamples,FXuchar * out) {
+  FXshort * output = reinterpret_cast<FXshort*>(out);
   for (FXuint i=0;i<nsamples;i++,input+=3) {
     output[i] = input[1] | (input[2]<<8);
     }
   }
 
-void float_to_s16(FXuchar * buffer,FXuint nsamples){
-  FXfloat * input  = reinterpret_cast<FXfloat*>(buffer);
-  FXshort * output = reinterpret_cast<FXshort*>(buffer);
+void s24le3_to_s16(FXuchar * buffer,FXuint nsamples) {
+  s24le3_to_s16(buffer,nsamples,buffer);
+  }
+
+void float_to_s16(const FXuchar * buffer,FXuint nsamples,FXuchar * out){
+  const FXfloat * input  = reinterpret_cast<const FXfloat*>(buffer);
+  FXshort * output = reinterpret_cast<FXshort*>(out);
   for (FXuint i=0;i<nsamples;i++) {
     output[i]=float_to_s16(input[i]);
     }
   }
 
+void float_to_s16(FXuchar * buffer,FXuint nsamples){
+  float_to_s16(buffer,nsamples,buffer);
+  }
+
 
 void s16_to_float(FXuchar * buffer, FXuint nsamples, MemoryBuffer & out){
   out.clear();
@@ -154,22 +163,108 @@ void s24le3_to_float(FXuchar * input,FXuint nsamples, MemoryBuffer & out){
   }
 
 
-void s24le3_to_s32(const FXuchar * input,FXuint nsamples,MemoryBuffer & out){
-  out.clear();
-  out.reserve(nsamples*4);
-  FXint * output = out.s32();
+void s24le3_to_s32(const FXuchar * input,FXuint nsamples,FXuchar * out){
+  FXint * output = reinterpret_cast<FXint*>(out);
   for (FXuint i=0;i<nsamples;i++,input+=3) {
     output[i] = s24_to_s32(input[0]|input[1]<<8|input[2]<<16);
     }
+  }
+
+void s24le3_to_s32(const FXuchar * input,FXuint nsamples,MemoryBuffer & out){
+  out.clear();
+  out.reserve(nsamples*4);
+  s24le3_to_s32(input,nsamples,out.ptr());
   out.wroteBytes(nsamples*4);
   }
 
-void float_to_s32(FXuchar * buffer,FXuint nsamples){
-  FXfloat * input = reinterpret_cast<FXfloat*>(buffer);
-  FXint *  output = reinterpret_cast<FXint*>(buffer);
+void float_to_s32(const FXuchar * buffer,FXuint nsamples,FXuchar * out){
+  const FXfloat * input = reinterpret_cast<const FXfloat*>(buffer);
+  FXint *  output = reinterpret_cast<FXint*>(out);
   for (FXuint i=0;i<nsamples;i++) {
     output[i]=float_to_s32(input[i]);
     }
   }
 
+void float_to_s32(FXuchar * buffer,FXuint nsamples){
+  float_to_s32(buffer,nsamples,buffer);
+  }
+
+
+// Work backwards, so each sample is read before it's overwritten
+void mono_to_stereo(FXuchar * buffer,FXuint nframes,FXuint bps) {
+  for (FXuint i=nframes;i>0;i--) {
+    memmove(buffer+(2*i-1)*bps,buffer+(i-1)*bps,bps);
+    memmove(buffer+(2*i-2)*bps,buffer+(i-1)*bps,bps);
+    }
+  }
+
+
+
+FXbool to_float(const AudioFormat & af,const FXuchar * input,FXuint nsamples,FXfloat * output) {
+  const FXbool swap = (af.byteorder()!=(Format::Native>>Format::Order_Shift)) && af.packing()>1;
+  switch(af.datatype()) {
+    case Format::Float:
+      if (af.packing()!=4) return false;
+      if (swap) {
+        const FXuint * in = reinterpret_cast<const FXuint*>(input);
+        FXuint * out = reinterpret_cast<FXuint*>(output);
+        for (FXuint i=0;i<nsamples;i++) out[i]=swap32(in[i]);
+        }
+      else {
+        memcpy(output,input,nsamples*4);
+        }
+      return true;
+      break;
+    case Format::Unsigned:
+      if (af.packing()!=1) return false;
+      for (FXuint i=0;i<nsamples;i++) output[i]=((FXint)input[i]-128) / 128.0f;
+      return true;
+      break;
+    case Format::Signed:
+      switch(af.packing()) {
+        case 1:
+          for (FXuint i=0;i<nsamples;i++) output[i]=((FXchar)input[i]) / 128.0f;
+          return true;
+          break;
+        case 2:
+          {
+            const FXshort * in = reinterpret_cast<const FXshort*>(input);
+            if (swap)
+              for (FXuint i=0;i<nsamples;i++) output[i]=s16_to_float((FXshort)swap16(in[i]));
+            else
+              for (FXuint i=0;i<nsamples;i++) output[i]=s16_to_float(in[i]);
+            return true;
+          } break;
+        case 3:
+          if (swap)
+            for (FXuint i=0;i<nsamples;i++,input+=3) output[i]=s24_to_float(input[2]|input[1]<<8|input[0]<<16);
+          else
+            for (FXuint i=0;i<nsamples;i++,input+=3) output[i]=s24_to_float(input[0]|input[1]<<8|input[2]<<16);
+          return true;
+          break;
+        case 4:
+          {
+            const FXint * in = reinterpret_cast<const FXint*>(input);
+            if (af.bps()==24) {
+              if (swap)
+                for (FXuint i=0;i<nsamples;i++) output[i]=s24_to_float(swap32(in[i]));
+              else
+                for (FXuint i=0;i<nsamples;i++) output[i]=s24_to_float(in[i]);
+              }
+            else {
+              if (swap)
+                for (FXuint i=0;i<nsamples;i++) output[i]=((FXint)swap32(in[i])) / 2147483648.0f;
+              else
+                for (FXuint i=0;i<nsamples;i++) output[i]=in[i] / 2147483648.0f;
+              }
+            return true;
+          } break;
+        default: break;
+        }
+      break;
+    default: break;
+    }
+  return false;
+  }
+
 }
@@ -23,6 +23,8 @@
 
 namespace ap {
 
+class AudioFormat;
+
 extern void s16_to_float(FXuchar * buffer, FXuint nsamples, MemoryBuffer & out);
 extern void s24le3_to_float(FXuchar * buffer,FXuint nsamples, MemoryBuffer & out);
 
@@ -33,6 +35,18 @@ extern void  float_to_s16(FXuchar * buffer,FXuint nsamples);
 extern void s24le3_to_s32(const FXuchar * buffer,FXuint nsamples,MemoryBuffer & out);
 extern void  float_to_s32(FXuchar * buffer,FXuint nsamples);
 
+// Convert into output. Conversions to a smaller or equal sample size may be done in place.
+extern void s24le3_to_s16(const FXuchar * input,FXuint nsamples,FXuchar * output);
+extern void  float_to_s16(const FXuchar * input,FXuint nsamples,FXuchar * output);
+extern void s24le3_to_s32(const FXuchar * input,FXuint nsamples,FXuchar * output);
+extern void  float_to_s32(const FXuchar * input,FXuint nsamples,FXuchar * output);
+
+// Duplicate mono samples of bps bytes in place, buffer must have room for 2*nframes samples
+extern void mono_to_stereo(FXuchar * buffer,FXuint nframes,FXuint bps);
+
+// Convert linear pcm in any byte order to native float. Returns false if format is not supported.
+extern GMAPI FXbool to_float(const AudioFormat & af,const FXuchar * input,FXuint nsamples,FXfloat * output);
+
 }
 #endif
 
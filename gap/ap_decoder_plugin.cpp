@@ -17,6 +17,7 @@
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
 #include "ap_defs.h"
+#include "ap_event_private.h"
 #include "ap_decoder_plugin.h"
 
 
@@ -25,8 +26,10 @@ namespace ap {
 DecoderPlugin::DecoderPlugin(DecoderContext * ctx) : context(ctx),stream_decode_offset(0) {
   }
 
-FXbool DecoderPlugin::init(ConfigureEvent*){
+FXbool DecoderPlugin::init(ConfigureEvent * event){
   stream_decode_offset = 0;
+  stream_offset_start  = event->stream_offset_start;
+  stream_offset_end    = event->stream_offset_end;
   return true;
   }
 
@@ -37,6 +40,21 @@ FXbool DecoderPlugin::flush(FXlong offset) {
   }
 
 
+FXint DecoderPlugin::trim_begin(FXlong position,FXint nframes) const {
+  const FXlong begin = FXMAX((FXlong)stream_offset_start,stream_decode_offset);
+  if (nframes>0 && position<begin)
+    return (FXint)FXMIN((FXlong)nframes,begin-position);
+  return 0;
+  }
+
+
+FXint DecoderPlugin::trim_end(FXlong position,FXint nframes,FXlong end) const {
+  if (end>=0 && position+nframes>end)
+    return (FXint)FXMAX(0,end-position);
+  return nframes;
+  }
+
+
 }
 
 #include "ap_config.h"
@@ -46,7 +64,7 @@ namespace ap {
 extern DecoderPlugin * ap_flac_decoder(DecoderContext*);
 extern DecoderPlugin * ap_pcm_decoder(DecoderContext*);
 extern DecoderPlugin * ap_vorbis_decoder(DecoderContext*);
-extern DecoderPlugin * ap_mad_decoder(DecoderContext*);
+extern DecoderPlugin * ap_mpeg_decoder(DecoderContext*);
 extern DecoderPlugin * ap_aac_decoder(DecoderContext*);
 extern DecoderPlugin * ap_alac_decoder(DecoderContext*);
 extern DecoderPlugin * ap_opus_decoder(DecoderContext*);
@@ -62,8 +80,8 @@ DecoderPlugin* DecoderPlugin::open(DecoderContext * ctx,FXuchar codec) {
 #ifdef HAVE_FLAC
     case Codec::FLAC    : return ap_flac_decoder(ctx); break;
 #endif
-#ifdef HAVE_MAD
-    case Codec::MPEG    : return ap_mad_decoder(ctx); break;
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
+    case Codec::MPEG    : return ap_mpeg_decoder(ctx); break;
 #endif
 #ifdef HAVE_FAAD
     case Codec::AAC     : return ap_aac_decoder(ctx); break;
@@ -43,12 +43,26 @@ public:
   };
 
 
+/*
+  Gapless playback. Readers pass the frames to drop at the start (encoder
+  delay plus any fixed decoder delay) and at the end (padding) of a stream
+  in the ConfigureEvent. Decoders count stream positions from the first
+  decoded frame and use trim_begin and trim_end to only output the frames
+  in between, so consecutive tracks play back without inserted silence.
+*/
 class DecoderPlugin {
 protected:
   DecoderContext * context;
   AudioFormat   af;
   FXlong        stream_decode_offset;
-public:
+  FXint         stream_offset_start = 0;
+  FXint         stream_offset_end   = 0;
+protected:
+  /// Frames to drop of nframes decoded at position, for the encoder delay or a seek
+  FXint trim_begin(FXlong position,FXint nframes) const;
+
+  /// Frames to keep of nframes decoded at position, for a stream ending at end (-1 if unknown)
+  FXint trim_end(FXlong position,FXint nframes,FXlong end) const;
 public:
   DecoderPlugin(DecoderContext*);
 
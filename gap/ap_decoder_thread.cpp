@@ -53,6 +53,7 @@ void DecoderThread::free() {
 
 
 void DecoderThread::configure(ConfigureEvent * event) {
+  replaygain = event->replaygain;
   if (plugin) {
     if (plugin->codec() == event->codec) {
       plugin->init(event);
@@ -75,6 +76,7 @@ void DecoderThread::configure(ConfigureEvent * event) {
 forward:
   /// Forward to output
   if (!event->af.undefined()) {
+    packetpool.configure(event->af);
     engine->output->post(event);
     }
   else {
@@ -180,6 +182,8 @@ void DecoderThread::post_output_packet(Packet *& packet,FXbool eos/*=false*/) {
   }
 
 void DecoderThread::post_configuration(ConfigureEvent * event) {
+  if (event->replaygain.empty()) event->replaygain = replaygain;
+  packetpool.configure(event->af);
   engine->output->post(event);
   }
 }
@@ -34,6 +34,7 @@ class DecoderThread : public EngineThread, public DecoderContext {
 protected:
   PacketPool      packetpool;
   DecoderPlugin * plugin = nullptr;
+  ReplayGain      replaygain;  // of the stream, for configurations posted by the decoder
 protected:
   FXuint stream = 0;
 protected:
@@ -34,7 +34,14 @@ static const FXchar * const plugin_names[DeviceLast]={
   "pulse",
   "jack",
   "wav",
-  "sndio"
+  "sndio",
+  "stream"
+  };
+
+static const FXchar * const profile_names[ProfileLast]={
+  "default",
+  "low-latency",
+  "power-saving"
   };
 
 static FXbool ap_has_plugin(FXuchar device) {
@@ -116,7 +123,24 @@ void SndioConfig::save(FXSettings & settings) const {
   }
 
 
-OutputConfig::OutputConfig() {
+StreamConfig::StreamConfig() : port(8000), format(FormatWav) {
+  }
+
+StreamConfig::~StreamConfig(){
+  }
+
+void StreamConfig::load(FXSettings & settings) {
+  port=(FXushort)settings.readUIntEntry("stream","port",port);
+  format=(settings.readStringEntry("stream","format","wav")==FXString("flac")) ? FormatFlac : FormatWav;
+  }
+
+void StreamConfig::save(FXSettings & settings) const {
+  settings.writeUIntEntry("stream","port",port);
+  settings.writeStringEntry("stream","format",(format==FormatFlac) ? "flac" : "wav");
+  }
+
+
+OutputConfig::OutputConfig() : profile(ProfileDefault) {
 #if defined(__linux__) && defined(HAVE_ALSA)
   device=DeviceAlsa;
 #elif defined(HAVE_OSS)
@@ -160,6 +184,8 @@ FXuint OutputConfig::devices() {
 #endif
   if (ap_has_plugin(DeviceWav))
     AP_ENABLE_PLUGIN(plugins,DeviceWav);
+  if (ap_has_plugin(DeviceStream))
+    AP_ENABLE_PLUGIN(plugins,DeviceStream);
   return plugins;
   }
 
@@ -178,9 +204,18 @@ void OutputConfig::load(FXSettings & settings) {
       break;
       }
     }
+  FXString name=settings.readStringEntry("engine","profile",profile_names[ProfileDefault]);
+  profile=ProfileDefault;
+  for (FXint i=ProfileDefault;i<ProfileLast;i++) {
+    if (name==profile_names[i]){
+      profile=i;
+      break;
+      }
+    }
   alsa.load(settings);
   oss.load(settings);
   sndio.load(settings);
+  stream.load(settings);
   }
 
 void OutputConfig::save(FXSettings & settings) const {
@@ -196,9 +231,12 @@ void OutputConfig::save(FXSettings & settings) const {
   else
     settings.deleteEntry("engine","output");
 
+  settings.writeStringEntry("engine","profile",profile_names[(profile<ProfileLast) ? profile : 0]);
+
   alsa.save(settings);
   oss.save(settings);
   sndio.save(settings);
+  stream.save(settings);
   }
 
 
@@ -62,6 +62,13 @@ ControlEvent::ControlEvent(FXuchar t,FXuint id) : Event(t) {
 ControlEvent::~ControlEvent() {
   }
 
+
+CtrlOpenEvent::CtrlOpenEvent(FXuchar t,const FXString & url,const ReplayGain & gain) : ControlEvent(t,url),replaygain(gain) {
+  }
+
+CtrlOpenEvent::~CtrlOpenEvent() {
+  }
+
 ErrorMessage::ErrorMessage(const FXString & text) : Event(AP_ERROR),msg(text) {
   }
 ErrorMessage::~ErrorMessage() {
@@ -87,6 +94,12 @@ VolumeNotify::VolumeNotify(FXfloat v) : Event(AP_VOLUME_NOTIFY),volume(v) {
 VolumeNotify::~VolumeNotify() {
   }
 
+OutputInfo::OutputInfo(FXuchar p,FXuint l,FXuint w) : Event(AP_OUTPUT_INFO),profile(p),latency(l),wakeups(w) {
+  }
+
+OutputInfo::~OutputInfo() {
+  }
+
 
 CtrlSeekEvent::CtrlSeekEvent(FXdouble p) : Event(Ctrl_Seek), pos(p) {
   }
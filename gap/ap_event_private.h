@@ -89,6 +89,15 @@ public:
   ControlEvent(FXuchar type,FXuint id);
   };
 
+class CtrlOpenEvent : public ControlEvent {
+public:
+  ReplayGain replaygain;  // used when the stream doesn't have any
+protected:
+  virtual ~CtrlOpenEvent();
+public:
+  CtrlOpenEvent(FXuchar type,const FXString & url,const ReplayGain & gain);
+  };
+
 
 class SetCrossFade : public Event {
 public:
@@ -220,8 +229,8 @@ public:
   FXuchar        codec               = Codec::Invalid;
   FXint          stream_length       = -1;
   void*          data                = nullptr;
-  FXshort        stream_offset_start = 0;
-  FXshort        stream_offset_end   = 0;
+  FXint          stream_offset_start = 0;
+  FXint          stream_offset_end   = 0;
   ReplayGain     replaygain;
 protected:
   virtual ~ConfigureEvent();
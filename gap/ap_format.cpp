@@ -346,7 +346,7 @@ extern FXString ap_get_gogglesmm_all_supported_files() {
 #if defined(HAVE_VORBIS) || defined(HAVE_TREMOR)
   "ogg,"
 #endif
-#if defined(HAVE_MAD)
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
   "mp3,"
 #endif
 #if defined(HAVE_MP4)
@@ -376,7 +376,7 @@ extern FXString ap_get_gogglesmm_supported_files() {
 #if defined(HAVE_VORBIS) || defined(HAVE_TREMOR)
   "ogg,"
 #endif
-#if defined(HAVE_MAD)
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
   "mp3,"
 #endif
 #if defined(HAVE_MP4)
@@ -409,7 +409,7 @@ extern FXString ap_get_gogglesmm_filepatterns() {
 #if defined(HAVE_VORBIS) || defined(HAVE_TREMOR)
   "*.ogg,"
 #endif
-#if defined(HAVE_MAD)
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
   "*.mp3,"
 #endif
 #if defined(HAVE_MP4)
@@ -435,7 +435,7 @@ extern FXString ap_get_gogglesmm_filepatterns() {
 #if defined(HAVE_VORBIS) || defined(HAVE_TREMOR)
   "*.ogg,"
 #endif
-#if defined(HAVE_MAD)
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
   "*.mp3,"
 #endif
 #if defined(HAVE_MP4)
@@ -458,7 +458,7 @@ extern FXString ap_get_gogglesmm_filepatterns() {
 #if defined(HAVE_VORBIS) || defined(HAVE_TREMOR)
   "Ogg Vorbis (*.ogg)\n"
 #endif
-#if defined(HAVE_MAD)
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
   "MPEG-1 Audio Layer 3 (*.mp3)\n"
 #endif
 #if defined(HAVE_MP4)
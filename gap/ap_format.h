@@ -22,18 +22,6 @@
 namespace ap {
 
 
-struct ReplayGain{
-  FXdouble album      = NAN;
-  FXdouble album_peak = NAN;
-  FXdouble track      = NAN;
-  FXdouble track_peak = NAN;
-
-  FXbool empty() const { return isnan(album) && isnan(track); }
-
-  void reset() { album=NAN; album_peak=NAN; track=NAN; track_peak=NAN; }
-  };
-
-
 namespace Codec {
 
   enum {
@@ -46,6 +46,16 @@ struct ZIO {
     }
   };
 
+struct ZBody {
+  z_stream stream;
+  FXuchar  buffer[4096];
+  FXbool   done = false;
+
+  ZBody() {
+    memset(&stream,0,sizeof(stream));
+    }
+  };
+
 #endif
 
 
@@ -422,6 +432,7 @@ HttpResponse::HttpResponse() :
   content_length(-1),
   content_remaining(-1),
   chunk_remaining(-1),
+  zbody(nullptr),
   flags(0){
   }
 
@@ -434,6 +445,13 @@ void HttpResponse::clear() {
   content_length=-1;
   content_remaining=-1;
   chunk_remaining=-1;
+#ifdef HAVE_ZLIB
+  if (zbody) {
+    inflateEnd(&zbody->stream);
+    delete zbody;
+    zbody=nullptr;
+    }
+#endif
   clear_headers();
   }
 
@@ -726,7 +744,7 @@ FXString HttpResponse::textBody() {
   }
 
 
-FXival HttpResponse::readBody(void * ptr,FXival len) {
+FXival HttpResponse::read_body_raw(void * ptr,FXival len) {
   if (flags&HeadRequest)
     return 0;
   else if (flags&ChunkedResponse)
@@ -736,13 +754,68 @@ FXival HttpResponse::readBody(void * ptr,FXival len) {
   }
 
 
+#ifdef HAVE_ZLIB
+FXival HttpResponse::read_body_gzip(void * ptr,FXival len) {
+
+  // Initialize inflater on first call
+  if (zbody==nullptr) {
+    zbody = new ZBody;
+    if (inflateInit2(&zbody->stream,15+16)!=Z_OK) {
+      delete zbody;
+      zbody=nullptr;
+      return -1;
+      }
+    }
+
+  zbody->stream.next_out  = (FXuchar*)ptr;
+  zbody->stream.avail_out = len;
+
+  while(zbody->stream.avail_out && !zbody->done) {
+
+    // Refill input
+    if (zbody->stream.avail_in==0) {
+      FXival n = read_body_raw(zbody->buffer,sizeof(zbody->buffer));
+      if (n<0) return -1;
+      if (n==0) break;
+      zbody->stream.next_in  = zbody->buffer;
+      zbody->stream.avail_in = n;
+      }
+
+    int zerror = inflate(&zbody->stream,Z_NO_FLUSH);
+    if (zerror==Z_STREAM_END)
+      zbody->done=true;
+    else if (zerror!=Z_OK && zerror!=Z_BUF_ERROR)
+      return -1;
+    }
+  return len-zbody->stream.avail_out;
+  }
+#else
+FXival HttpResponse::read_body_gzip(void*,FXival) {
+  return -1;
+  }
+#endif
+
+
+FXival HttpResponse::readBody(void * ptr,FXival len) {
+  if (flags&ContentEncodingGZip)
+    return read_body_gzip(ptr,len);
+  else
+    return read_body_raw(ptr,len);
+  }
+
+
 void HttpResponse::discard() {
   if (!(flags&ConnectionClose) && !(flags&HeadRequest)) {
     FXchar b[1024];
-    while(readBody(b,1024)==1024) ;
+    while(read_body_raw(b,1024)==1024) ;
     }
   }
 
+void HttpResponse::abort() {
+  flags|=ConnectionClose;
+  discard();
+  }
+
 FXString HttpResponse::getHeader(const FXString & key) const {
   return headers[key];
   }
@@ -67,6 +67,11 @@ public:
   //// Read ncount preview bytes. Position of stream doesn't change
   virtual FXival preview(void*data,FXival ncount) = 0;
 
+  /// Return up to ncount bytes at the current position without copying them, or nullptr
+  /// if the input isn't memory mapped. Position of stream doesn't change and the bytes
+  /// stay valid until the input is closed.
+  virtual const FXuchar * span(FXival & ncount) { ncount=0; return nullptr; }
+
   /// Set Position
   virtual FXlong position(FXlong offset,FXuint from)=0;
 
@@ -91,7 +91,8 @@ FXint InputThread::run(){
                             break;
 
       case Ctrl_Open_Flush: ctrl_flush(); // fallthrough -  intentional no break
-      case Ctrl_Open      : ctrl_open_input(static_cast<ControlEvent*>(event)->text);
+      case Ctrl_Open      : replaygain = static_cast<CtrlOpenEvent*>(event)->replaygain;
+                            ctrl_open_input(static_cast<CtrlOpenEvent*>(event)->text);
                             break;
 
       case Ctrl_Quit      : ctrl_close_input(true);
@@ -293,6 +294,7 @@ void InputThread::ctrl_flush(FXbool close){
   }
 
 void InputThread::post_configuration(ConfigureEvent* event) {
+  if (event->replaygain.empty()) event->replaygain = replaygain;
   engine->decoder->post(event);
   }
 
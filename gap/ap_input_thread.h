@@ -37,6 +37,7 @@ protected:
   PacketPool     packetpool;
   InputPlugin  * input;
   ReaderPlugin * reader;
+  ReplayGain     replaygain;  // from the open request, used when the stream has none
   FXuchar        state;
 
 protected:
@@ -0,0 +1,605 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include "ap_defs.h"
+#include "ap_utils.h"
+#include "ap_interleave.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <immintrin.h>
+#include <fxcpuid.h>
+#define HAVE_X86_KERNELS 1
+#define AP_SSE2  __attribute__((target("sse2")))
+#define AP_SSSE3 __attribute__((target("ssse3")))
+#define AP_AVX2  __attribute__((target("avx2")))
+#endif
+
+/*
+  Notes:
+
+    - Decoders hand us one buffer per channel, we interleave and convert in
+      one pass. The generic code is unrolled for up to 8 channels. Mono and
+      stereo, which is nearly everything, get their own SIMD kernels, 3 to 8
+      channels share one that transposes 4 channels at a time. Kernels only
+      do whole blocks, the generic code takes care of the remainder.
+
+    - Kernels are picked at first use from the cpu features. Set
+      GOGGLESMM_SIMD to none, sse2, ssse3 or avx2 to limit them.
+
+    - Rounding is done as (x>>shift) plus the last bit shifted out, which is
+      (x+half)>>shift without the overflow for samples close to the limits.
+*/
+
+namespace ap {
+
+static const FXint S24_MIN = -8388608;
+static const FXint S24_MAX =  8388607;
+
+static inline FXint round_shift(FXint x,FXint shift) {
+  return shift ? (x>>shift)+((x>>(shift-1))&1) : x;
+  }
+
+static inline FXint clip(FXint x,FXint lo,FXint hi) {
+  return (x<lo) ? lo : (x>hi) ? hi : x;
+  }
+
+
+struct StoreFloat {
+  FXfloat * out;
+  StoreFloat(FXfloat * o) : out(o) {}
+  void put(FXfloat x) { *out++ = x; }
+  };
+
+struct StoreFixed {
+  FXfloat * out;
+  FXfloat   scale;
+  StoreFixed(FXfloat * o,FXfloat s) : out(o),scale(s) {}
+  void put(FXint x) { *out++ = (FXfloat)x*scale; }
+  };
+
+struct StoreS8 {
+  FXchar * out;
+  FXint    shift;
+  StoreS8(FXchar * o,FXint s) : out(o),shift(s) {}
+  void put(FXint x) { *out++ = clip(round_shift(x,shift),-128,127); }
+  };
+
+struct StoreS16 {
+  FXshort * out;
+  FXint     shift;
+  StoreS16(FXshort * o,FXint s) : out(o),shift(s) {}
+  void put(FXint x) { *out++ = clip(round_shift(x,shift),-32768,32767); }
+  };
+
+struct StoreS24 {
+  FXuchar * out;
+  FXint     shift;
+  StoreS24(FXuchar * o,FXint s) : out(o),shift(s) {}
+  void put(FXint x) {
+    x = clip(round_shift(x,shift),S24_MIN,S24_MAX);
+    out[0] = (x&0xFF);
+    out[1] = (x&0xFF00)>>8;
+    out[2] = (x&0xFF0000)>>16;
+    out+=3;
+    }
+  };
+
+struct StoreS32 {
+  FXint * out;
+  StoreS32(FXint * o) : out(o) {}
+  void put(FXint x) { *out++ = x; }
+  };
+
+
+// Local copies of the channel pointers and store stay in registers, even for byte output
+template<FXuint N,typename T,typename Store>
+static void interleave_n(const T * const input[],FXuint offset,FXuint nframes,Store store) {
+  const T * in[N];
+  for (FXuint c=0;c<N;c++)
+    in[c] = input[c]+offset;
+  for (FXuint s=0;s<nframes;s++)
+    for (FXuint c=0;c<N;c++)
+      store.put(in[c][s]);
+  }
+
+template<typename T,typename Store>
+static void interleave(const T * const input[],FXuint nchannels,FXuint offset,FXuint nframes,Store store) {
+  switch(nchannels) {
+    case 1: interleave_n<1>(input,offset,nframes,store); break;
+    case 2: interleave_n<2>(input,offset,nframes,store); break;
+    case 3: interleave_n<3>(input,offset,nframes,store); break;
+    case 4: interleave_n<4>(input,offset,nframes,store); break;
+    case 5: interleave_n<5>(input,offset,nframes,store); break;
+    case 6: interleave_n<6>(input,offset,nframes,store); break;
+    case 7: interleave_n<7>(input,offset,nframes,store); break;
+    case 8: interleave_n<8>(input,offset,nframes,store); break;
+    default:
+      for (FXuint s=offset;s<offset+nframes;s++)
+        for (FXuint c=0;c<nchannels;c++)
+          store.put(input[c][s]);
+      break;
+    }
+  }
+
+
+// Kernels interleave left and right, or just convert left if right is null. They return the number of frames done.
+typedef FXuint (*Copy32Kernel)(const void * left,const void * right,FXuint nframes,void * output);
+typedef FXuint (*FixedKernel)(const FXint * left,const FXint * right,FXuint nframes,FXfloat scale,FXfloat * output);
+typedef FXuint (*S16Kernel)(const FXint * left,const FXint * right,FXuint nframes,FXint shift,FXshort * output);
+typedef FXuint (*S24Kernel)(const FXint * left,const FXint * right,FXuint nframes,FXint shift,FXuchar * output);
+
+// Multichannel kernels handle 3 to 8 channels and return the number of frames done, or 0 for any other count.
+typedef FXuint (*Copy32NKernel)(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,void * output);
+typedef FXuint (*FixedNKernel)(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXfloat scale,FXfloat * output);
+typedef FXuint (*S16NKernel)(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXshort * output);
+typedef FXuint (*S24NKernel)(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXuchar * output);
+
+
+#ifdef HAVE_X86_KERNELS
+
+AP_SSE2 static inline __m128i sse2_round_shift(__m128i x,__m128i c1,__m128i one,__m128i c2) {
+  return _mm_add_epi32(_mm_sra_epi32(x,c2),_mm_and_si128(_mm_sra_epi32(x,c1),one));
+  }
+
+AP_SSE2 static inline __m128i sse2_load(const FXint * src) {
+  return _mm_loadu_si128((const __m128i*)src);
+  }
+
+AP_SSE2 static FXuint sse2_copy32(const void * left,const void * right,FXuint nframes,void * output) {
+  const FXint * l = (const FXint*)left;
+  const FXint * r = (const FXint*)right;
+  FXint * out = (FXint*)output;
+  FXuint s=0;
+  for (;s+4<=nframes;s+=4,out+=8) {
+    const __m128i a = sse2_load(l+s);
+    const __m128i b = sse2_load(r+s);
+    _mm_storeu_si128((__m128i*)(out),_mm_unpacklo_epi32(a,b));
+    _mm_storeu_si128((__m128i*)(out+4),_mm_unpackhi_epi32(a,b));
+    }
+  return s;
+  }
+
+AP_SSE2 static FXuint sse2_fixed_to_float(const FXint * l,const FXint * r,FXuint nframes,FXfloat scale,FXfloat * out) {
+  const __m128 m = _mm_set1_ps(scale);
+  FXuint s=0;
+  if (r) {
+    for (;s+4<=nframes;s+=4,out+=8) {
+      const __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(sse2_load(l+s)),m);
+      const __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(sse2_load(r+s)),m);
+      _mm_storeu_ps(out,_mm_unpacklo_ps(a,b));
+      _mm_storeu_ps(out+4,_mm_unpackhi_ps(a,b));
+      }
+    }
+  else {
+    for (;s+4<=nframes;s+=4,out+=4) {
+      _mm_storeu_ps(out,_mm_mul_ps(_mm_cvtepi32_ps(sse2_load(l+s)),m));
+      }
+    }
+  return s;
+  }
+
+AP_SSE2 static FXuint sse2_s16(const FXint * l,const FXint * r,FXuint nframes,FXint shift,FXshort * out) {
+  const __m128i c1  = _mm_cvtsi32_si128(shift ? shift-1 : 0);
+  const __m128i c2  = _mm_cvtsi32_si128(shift);
+  const __m128i one = _mm_set1_epi32(shift ? 1 : 0);
+  FXuint s=0;
+  if (r) {
+    for (;s+4<=nframes;s+=4,out+=8) {
+      const __m128i a = sse2_round_shift(sse2_load(l+s),c1,one,c2);
+      const __m128i b = sse2_round_shift(sse2_load(r+s),c1,one,c2);
+      _mm_storeu_si128((__m128i*)out,_mm_packs_epi32(_mm_unpacklo_epi32(a,b),_mm_unpackhi_epi32(a,b)));
+      }
+    }
+  else {
+    for (;s+8<=nframes;s+=8,out+=8) {
+      const __m128i a = sse2_round_shift(sse2_load(l+s),c1,one,c2);
+      const __m128i b = sse2_round_shift(sse2_load(l+s+4),c1,one,c2);
+      _mm_storeu_si128((__m128i*)out,_mm_packs_epi32(a,b));
+      }
+    }
+  return s;
+  }
+
+
+/*
+  Multichannel kernels load 4 frames of every channel and transpose groups
+  of 4 channels, which gives 4 frames of up to 4 channels each. Only the
+  channels in the group are stored, so nothing is written past the output.
+  Convert turns 4 samples into 4 output values, Store writes the first n.
+*/
+template<FXuint N,typename Convert,typename Store>
+AP_SSE2 static FXuint sse2_interleave_n(const FXint * const input[],FXuint offset,FXuint nframes,const Convert & convert,Store store) {
+  const FXint * in[N];
+  for (FXuint c=0;c<N;c++)
+    in[c] = input[c]+offset;
+  FXuint s=0;
+  for (;s+4<=nframes;s+=4) {
+    for (FXuint c=0;c<N;c+=4) {
+      const FXuint n = (N-c<4) ? N-c : 4;
+      // Channel index stays in range for the loads that are skipped
+      __m128 r0 = _mm_castsi128_ps(convert(in[c]+s));
+      __m128 r1 = (n>1) ? _mm_castsi128_ps(convert(in[c+(n>1)]+s)) : r0;
+      __m128 r2 = (n>2) ? _mm_castsi128_ps(convert(in[c+2*(n>2)]+s)) : r0;
+      __m128 r3 = (n>3) ? _mm_castsi128_ps(convert(in[c+3*(n>3)]+s)) : r0;
+      _MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+      store.put(c,_mm_castps_si128(r0),n);
+      store.put(N+c,_mm_castps_si128(r1),n);
+      store.put(2*N+c,_mm_castps_si128(r2),n);
+      store.put(3*N+c,_mm_castps_si128(r3),n);
+      }
+    store.advance(4*N);
+    }
+  return s;
+  }
+
+struct SSE2Copy32 {
+  AP_SSE2 __m128i operator()(const FXint * src) const { return sse2_load(src); }
+  };
+
+struct SSE2Fixed {
+  __m128 scale;
+  AP_SSE2 SSE2Fixed(FXfloat s) : scale(_mm_set1_ps(s)) {}
+  AP_SSE2 __m128i operator()(const FXint * src) const { return _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(sse2_load(src)),scale)); }
+  };
+
+struct SSE2Shift {
+  __m128i c1,one,c2;
+  AP_SSE2 SSE2Shift(FXint shift) : c1(_mm_cvtsi32_si128(shift ? shift-1 : 0)),one(_mm_set1_epi32(shift ? 1 : 0)),c2(_mm_cvtsi32_si128(shift)) {}
+  AP_SSE2 __m128i operator()(const FXint * src) const { return sse2_round_shift(sse2_load(src),c1,one,c2); }
+  };
+
+struct SSE2Clip24 : SSE2Shift {
+  __m128i lo,hi;
+  AP_SSE2 SSE2Clip24(FXint shift) : SSE2Shift(shift),lo(_mm_set1_epi32(S24_MIN)),hi(_mm_set1_epi32(S24_MAX)) {}
+  AP_SSE2 __m128i operator()(const FXint * src) const {
+    __m128i x = SSE2Shift::operator()(src);
+    __m128i m = _mm_cmpgt_epi32(x,hi);
+    x = _mm_or_si128(_mm_and_si128(m,hi),_mm_andnot_si128(m,x));
+    m = _mm_cmplt_epi32(x,lo);
+    return _mm_or_si128(_mm_and_si128(m,lo),_mm_andnot_si128(m,x));
+    }
+  };
+
+struct SSE2Store32 {
+  FXint * out;
+  SSE2Store32(void * o) : out((FXint*)o) {}
+  AP_SSE2 void put(FXuint i,__m128i v,FXuint n) {
+    FXint tmp[4];
+    _mm_storeu_si128((__m128i*)tmp,v);
+    memcpy(out+i,tmp,n*4);
+    }
+  void advance(FXuint n) { out+=n; }
+  };
+
+struct SSE2Store16 {
+  FXshort * out;
+  SSE2Store16(FXshort * o) : out(o) {}
+  AP_SSE2 void put(FXuint i,__m128i v,FXuint n) {
+    FXshort tmp[8];
+    _mm_storeu_si128((__m128i*)tmp,_mm_packs_epi32(v,v));
+    memcpy(out+i,tmp,n*2);
+    }
+  void advance(FXuint n) { out+=n; }
+  };
+
+// Pack the low 3 bytes of each sample into the first 12 bytes
+struct SSE2Store24 {
+  FXuchar * out;
+  SSE2Store24(FXuchar * o) : out(o) {}
+  AP_SSE2 void put(FXuint i,__m128i v,FXuint n) {
+    const __m128i low = _mm_set_epi32(0,0xFFFFFF,0,0xFFFFFF);
+    const __m128i mid = _mm_set_epi32(0xFFFFFF,0,0xFFFFFF,0);
+    const __m128i m0  = _mm_set_epi32(0,0,0xFFFF,-1);
+    const __m128i m1  = _mm_set_epi32(0,-1,0xFFFF0000,0);
+    const __m128i x   = _mm_or_si128(_mm_and_si128(v,low),_mm_srli_epi64(_mm_and_si128(v,mid),8));
+    const __m128i p   = _mm_or_si128(_mm_and_si128(x,m0),_mm_and_si128(_mm_srli_si128(x,2),m1));
+    const FXuint lo = _mm_cvtsi128_si32(p);
+    const FXuint hi = _mm_cvtsi128_si32(_mm_srli_si128(p,4));
+    FXuchar * o = out+i*3;
+    switch(n) {
+      case 4: _mm_storel_epi64((__m128i*)o,p); store32(o+8,_mm_cvtsi128_si32(_mm_srli_si128(p,8))); break;
+      case 3: _mm_storel_epi64((__m128i*)o,p); o[8]=_mm_cvtsi128_si32(_mm_srli_si128(p,8)); break;
+      case 2: store32(o,lo); store16(o+4,hi); break;
+      case 1: store16(o,lo); o[2]=lo>>16; break;
+      }
+    }
+  static void store32(FXuchar * o,FXuint x) { memcpy(o,&x,4); }
+  static void store16(FXuchar * o,FXuint x) { const FXushort y=x; memcpy(o,&y,2); }
+  void advance(FXuint n) { out+=n*3; }
+  };
+
+template<typename Convert,typename Store>
+AP_SSE2 static FXuint sse2_interleave(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,const Convert & convert,Store store) {
+  switch(nchannels) {
+    case 3: return sse2_interleave_n<3>(input,offset,nframes,convert,store);
+    case 4: return sse2_interleave_n<4>(input,offset,nframes,convert,store);
+    case 5: return sse2_interleave_n<5>(input,offset,nframes,convert,store);
+    case 6: return sse2_interleave_n<6>(input,offset,nframes,convert,store);
+    case 7: return sse2_interleave_n<7>(input,offset,nframes,convert,store);
+    case 8: return sse2_interleave_n<8>(input,offset,nframes,convert,store);
+    }
+  return 0;
+  }
+
+AP_SSE2 static FXuint sse2_copy32_n(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,void * output) {
+  return sse2_interleave(input,nchannels,offset,nframes,SSE2Copy32(),SSE2Store32(output));
+  }
+
+AP_SSE2 static FXuint sse2_fixed_to_float_n(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXfloat scale,FXfloat * output) {
+  return sse2_interleave(input,nchannels,offset,nframes,SSE2Fixed(scale),SSE2Store32(output));
+  }
+
+AP_SSE2 static FXuint sse2_s16_n(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXshort * output) {
+  return sse2_interleave(input,nchannels,offset,nframes,SSE2Shift(shift),SSE2Store16(output));
+  }
+
+AP_SSE2 static FXuint sse2_s24_n(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXuchar * output) {
+  return sse2_interleave(input,nchannels,offset,nframes,SSE2Clip24(shift),SSE2Store24(output));
+  }
+
+
+AP_SSSE3 static inline __m128i ssse3_s24(const FXint * src,__m128i c1,__m128i one,__m128i c2) {
+  const __m128i lo = _mm_set1_epi32(S24_MIN);
+  const __m128i hi = _mm_set1_epi32(S24_MAX);
+  __m128i x = _mm_loadu_si128((const __m128i*)src);
+  x = _mm_add_epi32(_mm_sra_epi32(x,c2),_mm_and_si128(_mm_sra_epi32(x,c1),one));
+  __m128i m = _mm_cmpgt_epi32(x,hi);
+  x = _mm_or_si128(_mm_and_si128(m,hi),_mm_andnot_si128(m,x));
+  m = _mm_cmplt_epi32(x,lo);
+  return _mm_or_si128(_mm_and_si128(m,lo),_mm_andnot_si128(m,x));
+  }
+
+// Pack 16 samples into 48 bytes
+AP_SSSE3 static inline void ssse3_store24(FXuchar * out,__m128i v0,__m128i v1,__m128i v2,__m128i v3) {
+  const __m128i pack = _mm_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+  v0 = _mm_shuffle_epi8(v0,pack);
+  v1 = _mm_shuffle_epi8(v1,pack);
+  v2 = _mm_shuffle_epi8(v2,pack);
+  v3 = _mm_shuffle_epi8(v3,pack);
+  _mm_storeu_si128((__m128i*)(out),_mm_or_si128(v0,_mm_slli_si128(v1,12)));
+  _mm_storeu_si128((__m128i*)(out+16),_mm_or_si128(_mm_srli_si128(v1,4),_mm_slli_si128(v2,8)));
+  _mm_storeu_si128((__m128i*)(out+32),_mm_or_si128(_mm_srli_si128(v2,8),_mm_slli_si128(v3,4)));
+  }
+
+AP_SSSE3 static FXuint ssse3_s24(const FXint * l,const FXint * r,FXuint nframes,FXint shift,FXuchar * out) {
+  const __m128i c1  = _mm_cvtsi32_si128(shift ? shift-1 : 0);
+  const __m128i c2  = _mm_cvtsi32_si128(shift);
+  const __m128i one = _mm_set1_epi32(shift ? 1 : 0);
+  FXuint s=0;
+  if (r) {
+    for (;s+8<=nframes;s+=8,out+=48) {
+      const __m128i a0 = ssse3_s24(l+s,c1,one,c2);
+      const __m128i b0 = ssse3_s24(r+s,c1,one,c2);
+      const __m128i a1 = ssse3_s24(l+s+4,c1,one,c2);
+      const __m128i b1 = ssse3_s24(r+s+4,c1,one,c2);
+      ssse3_store24(out,_mm_unpacklo_epi32(a0,b0),_mm_unpackhi_epi32(a0,b0),_mm_unpacklo_epi32(a1,b1),_mm_unpackhi_epi32(a1,b1));
+      }
+    }
+  else {
+    for (;s+16<=nframes;s+=16,out+=48) {
+      ssse3_store24(out,ssse3_s24(l+s,c1,one,c2),ssse3_s24(l+s+4,c1,one,c2),ssse3_s24(l+s+8,c1,one,c2),ssse3_s24(l+s+12,c1,one,c2));
+      }
+    }
+  return s;
+  }
+
+// Interleave 16 frames to 32 bit first, then pack them 16 samples at a time
+AP_SSSE3 static FXuint ssse3_s24_n(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXuchar * out) {
+  const SSE2Clip24 clip(shift);
+  FXint tmp[16*8];
+  FXuint s=0;
+  for (;s+16<=nframes;s+=16,out+=48*nchannels) {
+    if (!sse2_interleave(input,nchannels,offset+s,16,clip,SSE2Store32(tmp)))
+      break;
+    for (FXuint i=0;i<16*nchannels;i+=16)
+      ssse3_store24(out+i*3,sse2_load(tmp+i),sse2_load(tmp+i+4),sse2_load(tmp+i+8),sse2_load(tmp+i+12));
+    }
+  return s;
+  }
+
+
+AP_AVX2 static inline __m256i avx2_round_shift(__m256i x,__m128i c1,__m256i one,__m128i c2) {
+  return _mm256_add_epi32(_mm256_sra_epi32(x,c2),_mm256_and_si256(_mm256_sra_epi32(x,c1),one));
+  }
+
+AP_AVX2 static inline __m256i avx2_load(const FXint * src) {
+  return _mm256_loadu_si256((const __m256i*)src);
+  }
+
+// Unpack works within 128 bit lanes, so the halves need to be swapped around
+AP_AVX2 static FXuint avx2_copy32(const void * left,const void * right,FXuint nframes,void * output) {
+  const FXint * l = (const FXint*)left;
+  const FXint * r = (const FXint*)right;
+  FXint * out = (FXint*)output;
+  FXuint s=0;
+  for (;s+8<=nframes;s+=8,out+=16) {
+    const __m256i a  = avx2_load(l+s);
+    const __m256i b  = avx2_load(r+s);
+    const __m256i lo = _mm256_unpacklo_epi32(a,b);
+    const __m256i hi = _mm256_unpackhi_epi32(a,b);
+    _mm256_storeu_si256((__m256i*)(out),_mm256_permute2x128_si256(lo,hi,0x20));
+    _mm256_storeu_si256((__m256i*)(out+8),_mm256_permute2x128_si256(lo,hi,0x31));
+    }
+  return s;
+  }
+
+AP_AVX2 static FXuint avx2_fixed_to_float(const FXint * l,const FXint * r,FXuint nframes,FXfloat scale,FXfloat * out) {
+  const __m256 m = _mm256_set1_ps(scale);
+  FXuint s=0;
+  if (r) {
+    for (;s+8<=nframes;s+=8,out+=16) {
+      const __m256 a  = _mm256_mul_ps(_mm256_cvtepi32_ps(avx2_load(l+s)),m);
+      const __m256 b  = _mm256_mul_ps(_mm256_cvtepi32_ps(avx2_load(r+s)),m);
+      const __m256 lo = _mm256_unpacklo_ps(a,b);
+      const __m256 hi = _mm256_unpackhi_ps(a,b);
+      _mm256_storeu_ps(out,_mm256_permute2f128_ps(lo,hi,0x20));
+      _mm256_storeu_ps(out+8,_mm256_permute2f128_ps(lo,hi,0x31));
+      }
+    }
+  else {
+    for (;s+8<=nframes;s+=8,out+=8) {
+      _mm256_storeu_ps(out,_mm256_mul_ps(_mm256_cvtepi32_ps(avx2_load(l+s)),m));
+      }
+    }
+  return s;
+  }
+
+AP_AVX2 static FXuint avx2_s16(const FXint * l,const FXint * r,FXuint nframes,FXint shift,FXshort * out) {
+  const __m128i c1  = _mm_cvtsi32_si128(shift ? shift-1 : 0);
+  const __m128i c2  = _mm_cvtsi32_si128(shift);
+  const __m256i one = _mm256_set1_epi32(shift ? 1 : 0);
+  FXuint s=0;
+  if (r) {
+    for (;s+8<=nframes;s+=8,out+=16) {
+      const __m256i a = avx2_round_shift(avx2_load(l+s),c1,one,c2);
+      const __m256i b = avx2_round_shift(avx2_load(r+s),c1,one,c2);
+      _mm256_storeu_si256((__m256i*)out,_mm256_packs_epi32(_mm256_unpacklo_epi32(a,b),_mm256_unpackhi_epi32(a,b)));
+      }
+    }
+  else {
+    for (;s+16<=nframes;s+=16,out+=16) {
+      const __m256i a = avx2_round_shift(avx2_load(l+s),c1,one,c2);
+      const __m256i b = avx2_round_shift(avx2_load(l+s+8),c1,one,c2);
+      _mm256_storeu_si256((__m256i*)out,_mm256_permute4x64_epi64(_mm256_packs_epi32(a,b),0xD8));
+      }
+    }
+  return s;
+  }
+
+#endif
+
+
+struct Kernels {
+  const FXchar * name             = "none";
+  Copy32Kernel   copy32           = nullptr;
+  FixedKernel    fixed_to_float   = nullptr;
+  S16Kernel      s16              = nullptr;
+  S24Kernel      s24              = nullptr;
+  Copy32NKernel  copy32_n         = nullptr;
+  FixedNKernel   fixed_to_float_n = nullptr;
+  S16NKernel     s16_n            = nullptr;
+  S24NKernel     s24_n            = nullptr;
+  Kernels();
+  };
+
+Kernels::Kernels() {
+#ifdef HAVE_X86_KERNELS
+  const FXString limit    = ap_get_environment("GOGGLESMM_SIMD","avx2");
+  const FXuint   features = fxCPUFeatures();
+  if (limit=="none") return;
+  if (features&CPU_HAS_SSE2) {
+    name             = "sse2";
+    copy32           = sse2_copy32;
+    fixed_to_float   = sse2_fixed_to_float;
+    s16              = sse2_s16;
+    copy32_n         = sse2_copy32_n;
+    fixed_to_float_n = sse2_fixed_to_float_n;
+    s16_n            = sse2_s16_n;
+    s24_n            = sse2_s24_n;
+    }
+  if (limit=="sse2") return;
+  if (features&CPU_HAS_SSSE3) {
+    name             = "ssse3";
+    s24              = ssse3_s24;
+    s24_n            = ssse3_s24_n;
+    }
+  if (limit=="ssse3") return;
+  if (features&CPU_HAS_AVX2) {
+    name             = "avx2";
+    copy32           = avx2_copy32;
+    fixed_to_float   = avx2_fixed_to_float;
+    s16              = avx2_s16;
+    }
+#endif
+  }
+
+static const Kernels & kernels() {
+  static const Kernels k;
+  return k;
+  }
+
+
+const FXchar * interleave_kernels() {
+  return kernels().name;
+  }
+
+
+void interleave_float(const FXfloat * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXfloat * output) {
+  FXuint n = 0;
+  if (nchannels==1) {
+    memcpy(output,input[0]+offset,sizeof(FXfloat)*nframes);
+    return;
+    }
+  if (nchannels==2 && kernels().copy32)
+    n = kernels().copy32(input[0]+offset,input[1]+offset,nframes,output);
+  else if (nchannels>2 && kernels().copy32_n)
+    n = kernels().copy32_n(reinterpret_cast<const FXint * const *>(input),nchannels,offset,nframes,output);
+  interleave(input,nchannels,offset+n,nframes-n,StoreFloat(output+n*nchannels));
+  }
+
+
+void interleave_fixed_to_float(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint fracbits,FXfloat * output) {
+  const FXfloat scale = ldexpf(1.0f,-fracbits);
+  FXuint n = 0;
+  if (nchannels<=2 && kernels().fixed_to_float)
+    n = kernels().fixed_to_float(input[0]+offset,(nchannels==2) ? input[1]+offset : nullptr,nframes,scale,output);
+  else if (nchannels>2 && kernels().fixed_to_float_n)
+    n = kernels().fixed_to_float_n(input,nchannels,offset,nframes,scale,output);
+  interleave(input,nchannels,offset+n,nframes-n,StoreFixed(output+n*nchannels,scale));
+  }
+
+
+void interleave_s8(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXchar * output) {
+  interleave(input,nchannels,offset,nframes,StoreS8(output,shift));
+  }
+
+
+void interleave_s16(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXshort * output) {
+  FXuint n = 0;
+  if (nchannels<=2 && kernels().s16)
+    n = kernels().s16(input[0]+offset,(nchannels==2) ? input[1]+offset : nullptr,nframes,shift,output);
+  else if (nchannels>2 && kernels().s16_n)
+    n = kernels().s16_n(input,nchannels,offset,nframes,shift,output);
+  interleave(input,nchannels,offset+n,nframes-n,StoreS16(output+n*nchannels,shift));
+  }
+
+
+void interleave_s24le3(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXuchar * output) {
+  FXuint n = 0;
+  if (nchannels<=2 && kernels().s24)
+    n = kernels().s24(input[0]+offset,(nchannels==2) ? input[1]+offset : nullptr,nframes,shift,output);
+  else if (nchannels>2 && kernels().s24_n)
+    n = kernels().s24_n(input,nchannels,offset,nframes,shift,output);
+  interleave(input,nchannels,offset+n,nframes-n,StoreS24(output+n*nchannels*3,shift));
+  }
+
+
+void interleave_s32(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint * output) {
+  FXuint n = 0;
+  if (nchannels==1) {
+    memcpy(output,input[0]+offset,sizeof(FXint)*nframes);
+    return;
+    }
+  if (nchannels==2 && kernels().copy32)
+    n = kernels().copy32(input[0]+offset,input[1]+offset,nframes,output);
+  else if (nchannels>2 && kernels().copy32_n)
+    n = kernels().copy32_n(input,nchannels,offset,nframes,output);
+  interleave(input,nchannels,offset+n,nframes-n,StoreS32(output+n*nchannels));
+  }
+
+}
@@ -0,0 +1,41 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef AP_INTERLEAVE_H
+#define AP_INTERLEAVE_H
+
+namespace ap {
+
+/*
+  Interleave nframes from planar channel buffers, starting at frame offset in
+  each plane. Integer samples are shifted right by shift bits with rounding
+  and clipped to the output size. Fixed point samples with fracbits fraction
+  bits are scaled to float. Up to 8 channels use SIMD where the cpu supports it.
+*/
+extern void interleave_float(const FXfloat * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXfloat * output);
+extern void interleave_fixed_to_float(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint fracbits,FXfloat * output);
+extern void interleave_s8(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXchar * output);
+extern void interleave_s16(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXshort * output);
+extern void interleave_s24le3(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint shift,FXuchar * output);
+extern void interleave_s32(const FXint * const input[],FXuint nchannels,FXuint offset,FXuint nframes,FXint * output);
+
+// Name of the instruction set used by the interleave kernels
+extern const FXchar * interleave_kernels();
+
+}
+#endif
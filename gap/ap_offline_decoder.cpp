@@ -0,0 +1,488 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include "ap_defs.h"
+#include "ap_utils.h"
+#include "ap_event_private.h"
+#include "ap_packet.h"
+#include "ap_format.h"
+#include "ap_convert.h"
+#include "ap_input_plugin.h"
+#include "ap_reader_plugin.h"
+#include "ap_decoder_plugin.h"
+#include "ap_offline_decoder.h"
+
+namespace ap {
+
+/*
+  Takes the place of the input and decoder threads. Events posted by the
+  reader are queued and handed to the decoder on the same thread. Decoded
+  packets are converted to float straight away and returned to the pool, so
+  the pools never run dry and nothing ever blocks.
+*/
+class OfflineContext : public IOContext, public InputContext, public DecoderContext {
+public:
+  PacketPool      inputpool;
+  PacketPool      outputpool;
+  Signal          abortsignal;
+  InputPlugin   * input   = nullptr;
+  ReaderPlugin  * reader  = nullptr;
+  DecoderPlugin * decoder = nullptr;
+  Event         * head    = nullptr;
+  Event         * tail    = nullptr;
+  MemoryBuffer    samples;
+  AudioFormat     af;
+  ReplayGain      replaygain;
+  FXlong          length   = -1;
+  FXlong          position = 0;
+  FXlong          npackets = 0;
+  FXbool          reading  = false;
+  FXbool          eos      = false;
+  FXbool          error    = false;
+  FXbool          decoding = false;
+  volatile FXbool stop     = false;
+public:
+  OfflineContext();
+
+  FXbool init();
+
+  FXbool open(const FXString & url);
+
+  FXbool open(const FXStringList & urls);
+
+  void close();
+
+  FXbool step();
+
+  FXbool seek(FXdouble pos);
+
+  void dispatch(Event*);
+
+  void configure(ConfigureEvent*);
+
+  void configure_output(ConfigureEvent*);
+
+  void push(Event*);
+
+  Event * pop();
+
+  void clear();
+
+  virtual ~OfflineContext();
+
+public: // IOContext
+
+  const Signal & signal() override { return abortsignal; }
+
+  FXbool aborted() override { return stop; }
+
+public: // InputContext and DecoderContext
+
+  void post_configuration(ConfigureEvent*) override;
+
+public: // InputContext
+
+  void post_meta(MetaInfo*) override;
+
+  void post_packet(Packet*) override;
+
+public: // DecoderContext
+
+  Packet * get_input_packet() override;
+
+  Packet * get_output_packet() override;
+
+  void post_output_packet(Packet*&,FXbool eos) override;
+  };
+
+
+OfflineContext::OfflineContext() : samples(65536) {
+  }
+
+OfflineContext::~OfflineContext() {
+  close();
+  inputpool.free();
+  outputpool.free();
+  abortsignal.close();
+  }
+
+
+FXbool OfflineContext::init() {
+  if (!abortsignal.create())
+    return false;
+
+  // Same packet size as the input thread, the readers expect it
+  if (!inputpool.init(8192,8))
+    return false;
+
+  // Decoded packets are consumed right away, so a few large ones will do
+  if (!outputpool.init(65536,4))
+    return false;
+
+  return true;
+  }
+
+
+void OfflineContext::push(Event * event) {
+  event->next = nullptr;
+  if (tail)
+    tail->next = event;
+  else
+    head = event;
+  tail = event;
+  }
+
+
+Event * OfflineContext::pop() {
+  Event * event = head;
+  if (event) {
+    head = event->next;
+    if (head==nullptr) tail=nullptr;
+    event->next = nullptr;
+    }
+  return event;
+  }
+
+
+void OfflineContext::clear() {
+  Event * event;
+  while((event=pop())!=nullptr) {
+    event->unref();
+    }
+  }
+
+
+FXbool OfflineContext::open(const FXString & url) {
+  GM_DEBUG_PRINT("[offline] open %s\n",url.text());
+
+  input = InputPlugin::open(this,url);
+  if (input==nullptr)
+    return false;
+
+  reader = ReaderPlugin::open(this,input->plugin());
+  if (reader==nullptr || !reader->init(input)) {
+    delete reader;
+    delete input;
+    reader=nullptr;
+    input=nullptr;
+    return false;
+    }
+  reading=true;
+  return true;
+  }
+
+
+FXbool OfflineContext::open(const FXStringList & urls) {
+  for (FXint i=0;i<urls.no() && !stop;i++) {
+    if (!urls[i].empty() && open(urls[i]))
+      return true;
+    }
+  return false;
+  }
+
+
+void OfflineContext::close() {
+  clear();
+  delete decoder;
+  delete reader;
+  delete input;
+  decoder=nullptr;
+  reader=nullptr;
+  input=nullptr;
+  samples.clear();
+  af.reset();
+  replaygain.reset();
+  length=-1;
+  position=0;
+  npackets=0;
+  reading=false;
+  eos=false;
+  error=false;
+  }
+
+
+// Do one unit of work. Returns false if there's nothing left to do.
+FXbool OfflineContext::step() {
+  if (stop || error || eos)
+    return false;
+
+  // Pending events from the reader first
+  if (head) {
+    dispatch(pop());
+    return true;
+    }
+
+  if (reading) {
+    Packet * packet = inputpool.wait(abortsignal);
+    if (packet==nullptr)
+      return false;
+
+    switch(reader->process(packet)) {
+      case ReadError   : GM_DEBUG_PRINT("[offline] read error\n");
+                         error=true;
+                         reading=false;
+                         break;
+      case ReadDone    : reading=false;
+                         break;
+      case ReadRedirect:
+        {
+          FXStringList urls;
+          reader->redirect(urls);
+          delete reader;
+          delete input;
+          reader=nullptr;
+          input=nullptr;
+          reading=false;
+          if (!open(urls)) error=true;
+        } break;
+      default          : break;
+      }
+    return true;
+    }
+  return false;
+  }
+
+
+// Same as the input thread, except the decoder is flushed right away
+FXbool OfflineContext::seek(FXdouble pos) {
+  if (reader==nullptr || decoder==nullptr || input->serial() || !reader->can_seek())
+    return false;
+
+  const FXlong offset = reader->seek_offset(pos);
+  if (offset<0 || !reader->seek(offset))
+    return false;
+
+  clear();
+  decoder->flush(offset);
+  samples.clear();
+  position=offset;
+  reading=true;
+  eos=false;
+  return true;
+  }
+
+
+void OfflineContext::dispatch(Event * event) {
+  switch(event->type) {
+    case Configure: configure(static_cast<ConfigureEvent*>(event));
+                    return;
+                    break;
+    case Buffer   : if (decoder) {
+                      npackets++;
+                      decoding=true;
+                      FXbool ok = decoder->process(static_cast<Packet*>(event));
+                      decoding=false;
+                      if (!ok) {
+                        GM_DEBUG_PRINT("[offline] decoder error\n");
+                        error=true;
+                        }
+                      return;
+                      }
+                    break;
+    default       : break;
+    }
+  event->unref();
+  }
+
+
+void OfflineContext::configure(ConfigureEvent * event) {
+  if (decoder && decoder->codec()!=event->codec) {
+    delete decoder;
+    decoder=nullptr;
+    }
+
+  if (decoder==nullptr) {
+    decoder = DecoderPlugin::open(this,event->codec);
+    if (decoder==nullptr) {
+      GM_DEBUG_PRINT("[offline] no decoder for %s\n",Codec::name(event->codec));
+      error=true;
+      event->unref();
+      return;
+      }
+    }
+
+  decoding=true;
+  decoder->init(event);
+  decoding=false;
+
+  if (!event->af.undefined())
+    configure_output(event);
+  else
+    event->unref();
+  }
+
+
+void OfflineContext::configure_output(ConfigureEvent * event) {
+  af         = event->af;
+  replaygain = event->replaygain;
+  if (event->stream_length>0) length = event->stream_length;
+  event->unref();
+  }
+
+
+// Readers configure the decoder, decoders configure the output
+void OfflineContext::post_configuration(ConfigureEvent * event) {
+  if (decoding)
+    configure_output(event);
+  else
+    push(event);
+  }
+
+void OfflineContext::post_meta(MetaInfo * meta) {
+  meta->unref();
+  }
+
+void OfflineContext::post_packet(Packet * packet) {
+  push(packet);
+  }
+
+
+Packet * OfflineContext::get_input_packet() {
+  // Like the decoder thread, only hand out a packet if it's next in line
+  while(head==nullptr && reading && !stop) {
+    if (!step()) break;
+    }
+  if (head && head->type==Buffer)
+    return static_cast<Packet*>(pop());
+  return nullptr;
+  }
+
+
+Packet * OfflineContext::get_output_packet() {
+  return outputpool.wait(abortsignal);
+  }
+
+
+void OfflineContext::post_output_packet(Packet *& packet,FXbool end) {
+  if (packet) {
+    const FXint nframes = packet->numFrames();
+    if (nframes) {
+      const FXuint nsamples = nframes * packet->af.channels;
+      samples.reserve(nsamples*sizeof(FXfloat));
+      if (to_float(packet->af,packet->data(),nsamples,samples.flt()))
+        samples.wroteBytes(nsamples*sizeof(FXfloat));
+      else
+        error=true;
+      if (packet->stream_length>0)
+        length = packet->stream_length;
+      }
+    packet->unref();
+    packet=nullptr;
+    }
+  if (end) eos=true;
+  }
+
+
+
+OfflineDecoder::OfflineDecoder() : context(nullptr) {
+  context = new OfflineContext;
+  }
+
+OfflineDecoder::~OfflineDecoder() {
+  delete context;
+  }
+
+FXbool OfflineDecoder::open(const FXString & url) {
+  close();
+
+  if (context->abortsignal.handle()==BadHandle && !context->init())
+    return false;
+
+  if (!context->open(url))
+    return false;
+
+  // Run until the output format is known
+  while(!context->af.set() && context->step()) ;
+
+  if (!context->af.set()) {
+    close();
+    return false;
+    }
+  return true;
+  }
+
+void OfflineDecoder::close() {
+  context->close();
+  }
+
+FXival OfflineDecoder::read(FXfloat * buffer,FXival nframes) {
+  const FXival nchannels = context->af.channels;
+  FXival n=0;
+
+  if (nchannels==0)
+    return -1;
+
+  while(n<nframes) {
+    const FXival navail = context->samples.size() / (nchannels*sizeof(FXfloat));
+    if (navail) {
+      const FXival ncopy = FXMIN(navail,nframes-n);
+      context->samples.read(buffer+(n*nchannels),ncopy*nchannels*sizeof(FXfloat));
+      n+=ncopy;
+      continue;
+      }
+    if (!context->step()) break;
+    }
+
+  if (n==0 && context->error)
+    return -1;
+
+  context->position+=n;
+  return n;
+  }
+
+FXbool OfflineDecoder::seek(FXdouble pos) {
+  return context->seek(pos);
+  }
+
+void OfflineDecoder::abort() {
+  context->stop=true;
+  context->abortsignal.set();
+  }
+
+FXuint OfflineDecoder::rate() const {
+  return context->af.rate;
+  }
+
+FXuint OfflineDecoder::channels() const {
+  return context->af.channels;
+  }
+
+FXlong OfflineDecoder::length() const {
+  return context->length;
+  }
+
+FXlong OfflineDecoder::position() const {
+  return context->position;
+  }
+
+FXlong OfflineDecoder::packets() const {
+  return context->npackets;
+  }
+
+const FXchar * OfflineDecoder::codec() const {
+  return Codec::name(context->decoder ? context->decoder->codec() : (FXuchar)Codec::Invalid);
+  }
+
+void OfflineDecoder::getReplayGain(FXdouble & track,FXdouble & track_peak,FXdouble & album,FXdouble & album_peak) const {
+  track      = context->replaygain.track;
+  track_peak = context->replaygain.track_peak;
+  album      = context->replaygain.album;
+  album_peak = context->replaygain.album_peak;
+  }
+
+}
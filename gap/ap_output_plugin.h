@@ -45,6 +45,8 @@ public:
 
   virtual void notify_volume(FXfloat value)=0;
 
+  virtual void notify_error(const FXString & message)=0;
+
   virtual void wait_plugin_events()=0;
 
   virtual Reactor & getReactor()=0;
@@ -75,9 +77,20 @@ public:
   /// Write frames to playback buffer
   virtual FXbool write(const void*, FXuint)=0;
 
+  /// Return a buffer in the playback buffer to render up to nframes into, waiting
+  /// for room if needed. nframes is updated with the frames that fit. Returns nullptr
+  /// if the plugin doesn't support this, in which case write is used.
+  virtual void * begin_write(FXuint & /*nframes*/) { return nullptr; }
+
+  /// Commit nframes rendered into the buffer returned by begin_write
+  virtual FXbool commit_write(FXuint /*nframes*/) { return false; }
+
   /// Return delay in no. of frames
   virtual FXint delay() { return 0; }
 
+  /// Return negotiated buffer and period size in frames. Returns false if unknown.
+  virtual FXbool latency(FXuint & /*buffer*/,FXuint & /*period*/) { return false; }
+
   /// Empty Playback Buffer Immediately
   virtual void drop()=0;
 
@@ -179,6 +179,18 @@ void OutputThread::notify_position() {
   }
 
 
+// Report what the plugin negotiated for the output profile
+void OutputThread::notify_latency() {
+  FXuint buffer,period;
+  if (plugin->latency(buffer,period) && plugin->af.rate && period) {
+    const FXuint latency = (FXuint)(((FXulong)buffer*1000)/plugin->af.rate);
+    const FXuint wakeups = (plugin->af.rate+period-1)/period;
+    GM_DEBUG_PRINT("[output] profile %u: latency %ums, %u wakeups/s\n",output_config.profile,latency,wakeups);
+    engine->post(new OutputInfo(output_config.profile,latency,wakeups));
+    }
+  }
+
+
 void OutputThread::notify_disable_volume(){
   engine->post(new VolumeNotify());
   }
@@ -187,6 +199,10 @@ void OutputThread::notify_volume(FXfloat value) {
   engine->post(new VolumeNotify(value));
   }
 
+void OutputThread::notify_error(const FXString & message) {
+  engine->post(new ErrorMessage(message));
+  }
+
 void OutputThread::clear_timers() {
   for (FXint i=0;i<timers.no();i++){
     delete timers[i];
@@ -540,6 +556,8 @@ void OutputThread::configure(const AudioFormat & fmt) {
     return;
     }
 
+  notify_latency();
+
 #ifdef DEBUG
   fxmessage("[output] stream ");
   af.debug();
@@ -551,17 +569,6 @@ void OutputThread::configure(const AudioFormat & fmt) {
   draining=false;
   }
 
-static FXbool mono_to_stereo(FXuchar * in,FXuint nsamples,FXuchar bps,MemoryBuffer & out){
-  out.clear();
-  out.reserve(nsamples*bps*2);
-  for (FXuint i=0;i<nsamples*bps;i+=bps) {
-    out.append(&in[i],bps);
-    out.append(&in[i],bps);
-    }
-  return true;
-  }
-
-
 #ifdef HAVE_SAMPLERATE
 void OutputThread::resample(Packet * packet,FXint & nframes) {
   static SRC_STATE * src_state = nullptr;
@@ -792,48 +799,20 @@ void OutputThread::crossfade_samples() {
   }
 
 
+// Check if we can convert the stream to what the plugin plays. The conversion is done by render_samples.
 bool OutputThread::convert_samples() {
   if (af.format != plugin->af.format) {
     switch(plugin->af.format) {
       case AP_FORMAT_S16:
-        {
-          switch(af.format) {
-            case AP_FORMAT_FLOAT:
-              float_to_s16(samples.data(), samples.nframes * af.channels);
-              break;
-            case AP_FORMAT_S24_3:
-              s24le3_to_s16(samples.data(), samples.nframes * af.channels);
-              break;
-            default:
-              goto mismatch;
-              break;
-            }
-        } break;
       case AP_FORMAT_S32:
-        {
-          switch(af.format) {
-            case AP_FORMAT_FLOAT:
-              float_to_s32(samples.data(), samples.nframes * af.channels);
-              break;
-            case AP_FORMAT_S24_3:
-              s24le3_to_s32(samples.data(), samples.nframes * af.channels, samples.formatted);
-              samples.buffer = &samples.formatted;
-              break;
-            default:
-              goto mismatch;
-              break;
-            }
-        } break;
+        if (af.format!=AP_FORMAT_FLOAT && af.format!=AP_FORMAT_S24_3)
+          goto mismatch;
+        break;
       }
     }
   if (af.channels != plugin->af.channels) {
-    if (af.channels == 1 && plugin->af.channels == 2) {
-      mono_to_stereo(samples.data(), samples.nframes, af.packing(), samples.remapped);
-      samples.buffer = &samples.remapped;
-      }
-    else {
+    if (af.channels != 1 || plugin->af.channels != 2)
       goto mismatch;
-      }
     }
   return true;
 mismatch:
@@ -845,19 +824,65 @@ mismatch:
   }
 
 
+// Convert nframes from samples into output, in the format of the plugin
+void OutputThread::render_samples(FXuchar * output,FXuint nframes) {
+  const FXuchar * input = samples.data();
+  const FXuint nsamples = nframes * af.channels;
+  switch(plugin->af.format) {
+    case AP_FORMAT_S16:
+      if (af.format==AP_FORMAT_FLOAT) { float_to_s16(input, nsamples, output); break; }
+      if (af.format==AP_FORMAT_S24_3) { s24le3_to_s16(input, nsamples, output); break; }
+      memcpy(output, input, nsamples * af.packing());
+      break;
+    case AP_FORMAT_S32:
+      if (af.format==AP_FORMAT_FLOAT) { float_to_s32(input, nsamples, output); break; }
+      if (af.format==AP_FORMAT_S24_3) { s24le3_to_s32(input, nsamples, output); break; }
+      memcpy(output, input, nsamples * af.packing());
+      break;
+    default:
+      memcpy(output, input, nsamples * af.packing());
+      break;
+    }
+  if (af.channels != plugin->af.channels) {
+    mono_to_stereo(output, nframes, plugin->af.packing());
+    }
+  }
+
+
+/*
+  Plugins that hand out their own buffer through begin_write get the samples
+  rendered straight into it. Others get the samples as is, or converted into
+  samples.formatted if the formats differ.
+*/
 FXbool OutputThread::write_samples() {
+  const FXbool convert = (af.format != plugin->af.format) || (af.channels != plugin->af.channels);
   FXuint nframes;
+  FXbool result;
   while (samples.nframes) {
     nframes = FXMIN(FXint(plugin->af.rate >> 1), samples.nframes);
+    FXuchar * output = static_cast<FXuchar*>(plugin->begin_write(nframes));
     update_position(samples.stream, samples.position, nframes, samples.length);
-    if (!plugin->write(samples.data(), nframes)) {
+    if (output) {
+      render_samples(output, nframes);
+      result = plugin->commit_write(nframes);
+      }
+    else if (convert) {
+      samples.formatted.clear();
+      samples.formatted.reserve(plugin->af.framesize() * nframes);
+      render_samples(samples.formatted.ptr(), nframes);
+      result = plugin->write(samples.formatted.ptr(), nframes);
+      }
+    else {
+      result = plugin->write(samples.data(), nframes);
+      }
+    if (!result) {
       GM_DEBUG_PRINT("[output] write failed\n");
       engine->input->post(new ControlEvent(Ctrl_Close));
       engine->post(new ErrorMessage(FXString::value("Output Error")));
       close_plugin();
       return false;
       }
-    samples.buffer->readBytes(plugin->af.framesize() * nframes);
+    samples.buffer->readBytes(af.framesize() * nframes);
     samples.nframes -= nframes;
     }
   return true;
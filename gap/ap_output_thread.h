@@ -45,7 +45,6 @@ struct ReplayGainConfig {
 
 struct Samples {
   MemoryBuffer * buffer = nullptr;
-  MemoryBuffer   remapped;
   MemoryBuffer   formatted;
   FXint          nframes;
   FXlong         position;
@@ -106,6 +105,7 @@ protected:
   void process_samples();
   void crossfade_samples();
   FXbool convert_samples();
+  void render_samples(FXuchar * output,FXuint nframes);
   FXbool write_samples();
   void replay_gain();
 protected:
@@ -122,6 +122,8 @@ protected:
   void drain(FXbool flush=true);
   void update_position(FXint stream,FXlong position,FXint nframes,FXlong length);
   void notify_position();
+
+  void notify_latency();
   void reset_position();
   void reconfigure();
 public:
@@ -135,6 +137,8 @@ public:
 
   void notify_volume(FXfloat value) override;
 
+  void notify_error(const FXString & message) override;
+
   void wait_plugin_events() override;
 
   Reactor & getReactor() override { return reactor; }
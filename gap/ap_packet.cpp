@@ -25,19 +25,62 @@ namespace ap {
 PacketPool::PacketPool() {
   }
 
+static const FXint MAXPACKETS = 64;
+
 FXbool PacketPool::init(FXival sz,FXival n) {
-  if (n>64) fxerror("fixme");
-  packets.setSize(64); //
+  if (n>MAXPACKETS) fxerror("fixme");
+  packets.setSize(MAXPACKETS);
   for (FXint i=0;i<n;i++) {
     packets.push(new Packet(this,sz));
     }
+  packetsize = minsize = sz;
+  npackets   = mindepth = n;
+  nsurplus   = 0;
   return semaphore.create(n);
   }
 
+
+void PacketPool::configure(const AudioFormat & af,FXuint duration,FXuint total) {
+  if (af.undefined() || af.rate==0 || af.framesize()==0)
+    return;
+
+  const FXlong rate = (FXlong)af.rate*af.framesize();
+
+  // Packet size, rounded to whole pages
+  FXival size = (FXival)((rate*duration)/1000);
+  size = FXMAX(minsize,(size+4095)&~((FXival)4095));
+
+  // Pool depth
+  FXint depth = (FXint)FXCLAMP(mindepth,(rate*total)/(1000*(FXlong)size),MAXPACKETS);
+
+  if (size!=packetsize || depth!=npackets-nsurplus) {
+    GM_DEBUG_PRINT("[packetpool] %ld bytes (%lldms) x %d\n",size,(size*1000)/rate,depth);
+    }
+
+  packetsize = size;
+
+  // Grow, cancelling pending deletes first
+  while(depth>npackets-nsurplus) {
+    if (nsurplus) {
+      nsurplus--;
+      }
+    else {
+      packets.push(new Packet(this,packetsize));
+      npackets++;
+      semaphore.release();
+      }
+    }
+
+  // Shrink as packets come back
+  nsurplus = npackets-depth;
+  }
+
+
 void PacketPool::free() {
   Packet * packet = nullptr;
   while(packets.pop(packet)) delete packet;
   semaphore.close();
+  npackets=nsurplus=0;
   }
 
 PacketPool::~PacketPool() {
@@ -51,9 +94,18 @@ void PacketPool::push(Packet * packet) {
 
 
 Packet * PacketPool::wait(const Signal & signal) {
-  if (semaphore.wait(signal)){
+  while (semaphore.wait(signal)) {
     Packet * packet = nullptr;
     packets.pop(packet);
+    if (nsurplus) {
+      delete packet;
+      npackets--;
+      nsurplus--;
+      continue;
+      }
+    if (packet->capacity()!=packetsize && !packet->resize(packetsize)) {
+      fxwarning("gogglesmm: unable to allocate packet\n");
+      }
     return packet;
     }
   return nullptr;
@@ -61,7 +113,6 @@ Packet * PacketPool::wait(const Signal & signal) {
 
 
 
-
 Packet::Packet(PacketPool *p,FXival sz) : Event(Buffer), MemoryBuffer(sz), pool(p),flags(0),stream_position(-1),stream_length(-1) {
   }
 
@@ -36,17 +36,37 @@ class Stream {
   };
 */
 
+/*
+  Pool of packets. The pool can be sized for an audio format, so a packet
+  holds about the same duration regardless of format. Packets are resized
+  when they're taken from the pool, and surplus packets are deleted then,
+  so configure() and wait() must be called from the same thread.
+*/
 class PacketPool {
 protected:
   FXLFQueueOf<Packet> packets;
   Semaphore           semaphore;
+  FXival              packetsize = 0; // current packet size
+  FXival              minsize    = 0; // minimum packet size
+  FXint               npackets   = 0; // packets owned, including the ones in use
+  FXint               nsurplus   = 0; // packets to delete when they come back
+  FXint               mindepth   = 0; // minimum number of packets
 public:
   /// Constructor
   PacketPool();
 
-  /// Initialize pool
+  /// Initialize pool with n packets of sz bytes. Neither will be configured below that.
   FXbool init(FXival sz,FXival n);
 
+  /// Size packets to hold duration ms of af and the pool to hold total ms.
+  void configure(const AudioFormat & af,FXuint duration=40,FXuint total=2000);
+
+  /// Size of packets handed out
+  FXival size() const { return packetsize; }
+
+  /// Number of packets
+  FXint depth() const { return npackets-nsurplus; }
+
   /// free pool
   void free();
 
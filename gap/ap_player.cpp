@@ -62,9 +62,13 @@ Event* AudioPlayer::pop() {
   }
 
 void AudioPlayer::open(const FXString & url,FXbool flush) {
+  open(url,ReplayGain(),flush);
+  }
+
+void AudioPlayer::open(const FXString & url,const ReplayGain & gain,FXbool flush) {
   FXASSERT(engine->input->running());
   /// EventQueue::Flush => pending commands should not be executed
-  engine->input->post(new ControlEvent(flush ? Ctrl_Open_Flush : Ctrl_Open,url),EventQueue::Flush);
+  engine->input->post(new CtrlOpenEvent(flush ? Ctrl_Open_Flush : Ctrl_Open,url,gain),EventQueue::Flush);
   }
 
 void AudioPlayer::close() {
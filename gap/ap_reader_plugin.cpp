@@ -137,7 +137,7 @@ extern ReaderPlugin * ap_flac_reader(InputContext*);
 extern ReaderPlugin * ap_ogg_reader(InputContext*);
 #endif
 
-#ifdef HAVE_MAD
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
 extern ReaderPlugin * ap_mad_reader(InputContext*);
 #endif
 
@@ -158,7 +158,7 @@ ReaderPlugin* ReaderPlugin::open(InputContext * ctx,FXuint type) {
 #ifdef HAVE_FLAC
     case Format::FLAC     : return ap_flac_reader(ctx); break;
 #endif
-#ifdef HAVE_MAD
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
     case Format::MP3      : return ap_mad_reader(ctx); break;
 #endif
 #ifdef HAVE_FAAD
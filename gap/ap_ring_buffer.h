@@ -0,0 +1,144 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef AP_RING_BUFFER_H
+#define AP_RING_BUFFER_H
+
+#include <FXAtomic.h>
+
+namespace ap {
+
+/*
+  Single producer, single consumer ring of interleaved float frames, for
+  outputs where the sound server pulls samples from a callback. The output
+  thread writes, the callback reads. Neither side locks or allocates, so
+  the read side is safe to use from a realtime thread.
+
+  Positions count frames and run freely, the ring itself holds a power of
+  two number of frames so a frame never wraps around. The producer can drop
+  everything written so far at any time; the consumer skips ahead the next
+  time it reads.
+*/
+class RingBuffer {
+protected:
+  FXfloat *       buffer   = nullptr;
+  FXuint          nframes  = 0;     // capacity in frames
+  FXuint          channels = 0;
+  volatile FXuint wpos     = 0;     // written by producer
+  volatile FXuint rpos     = 0;     // written by consumer
+  volatile FXuint droppos  = 0;     // drop request, written by producer
+  volatile FXuint ndrop    = 0;     // drop requests made
+  FXuint          ndropped = 0;     // drop requests handled by consumer
+private:
+  RingBuffer(const RingBuffer&);
+  RingBuffer &operator=(const RingBuffer&);
+public:
+  RingBuffer() {}
+
+  /// Allocate room for at least n frames. Not safe while in use.
+  FXbool init(FXuint n,FXuint nchannels) {
+    free();
+    FXuint size=1;
+    while(size<n) size<<=1;
+    if (!allocElms(buffer,size*nchannels))
+      return false;
+    nframes  = size;
+    channels = nchannels;
+    return true;
+    }
+
+  /// Free the ring. Not safe while in use.
+  void free() {
+    freeElms(buffer);
+    nframes=channels=0;
+    wpos=rpos=droppos=ndrop=ndropped=0;
+    }
+
+  /// Capacity in frames
+  FXuint size() const { return nframes; }
+
+  /// Number of channels per frame
+  FXuint numChannels() const { return channels; }
+
+  /// Frames waiting to be read
+  FXuint readable() const { return wpos-rpos; }
+
+  /// Frames that can be written
+  FXuint writable() const { return nframes-(wpos-rpos); }
+
+  /// [producer] Return contiguous space for up to n frames, n is updated with the space available.
+  FXfloat * wptr(FXuint & n) {
+    const FXuint w = wpos;
+    const FXuint o = w&(nframes-1);
+    n = FXMIN(n,FXMIN(nframes-(w-rpos),nframes-o));
+    return buffer+o*channels;
+    }
+
+  /// [producer] Make n frames written through wptr available to the consumer
+  void commit(FXuint n) {
+    atomicThreadFence();
+    wpos=wpos+n;
+    }
+
+  /// [producer] Copy up to n frames into the ring, returns the number of frames written
+  FXuint write(const FXfloat * data,FXuint n) {
+    FXuint total=0;
+    while(total<n) {
+      FXuint count=n-total;
+      FXfloat * ptr = wptr(count);
+      if (count==0) break;
+      memcpy(ptr,data+total*channels,sizeof(FXfloat)*count*channels);
+      commit(count);
+      total+=count;
+      }
+    return total;
+    }
+
+  /// [producer] Drop all frames written so far
+  void drop() {
+    droppos=wpos;
+    atomicThreadFence();
+    ndrop=ndrop+1;
+    }
+
+  /// [consumer] Return contiguous frames, up to n. n is updated with the frames available.
+  const FXfloat * rptr(FXuint & n) {
+    if (ndrop!=ndropped) {
+      ndropped=ndrop;
+      atomicThreadFence();
+      const FXuint d = droppos;
+      if ((FXint)(d-rpos)>0) rpos=d;
+      }
+    const FXuint r = rpos;
+    const FXuint o = r&(nframes-1);
+    n = FXMIN(n,FXMIN(wpos-r,nframes-o));
+    atomicThreadFence();
+    return buffer+o*channels;
+    }
+
+  /// [consumer] Release n frames returned by rptr
+  void release(FXuint n) {
+    atomicThreadFence();
+    rpos=rpos+n;
+    }
+
+  ~RingBuffer() { free(); }
+  };
+
+}
+#endif
@@ -357,6 +357,40 @@ FXint Socket::connect(const struct sockaddr * address,FXint address_length) {
   }
 
 
+// Start connecting to address
+FXint Socket::beginConnect(const struct sockaddr * address,FXint address_length) {
+#ifdef _WIN32
+  if (::connect(sockethandle,address,address_length)==0)
+    return 0;
+  if (WSAGetLastError()==WSAEWOULDBLOCK)
+    return FXIO::Again;
+#else
+  if (::connect(device,address,address_length)==0)
+    return 0;
+  switch(errno) {
+    case EINTR      :
+    case EINPROGRESS:
+    case EWOULDBLOCK: return FXIO::Again; break;
+    default         : break;
+    }
+#endif
+  return FXIO::Error;
+  }
+
+
+// Complete connection
+FXint Socket::finishConnect() {
+  if (getError()==0) {
+#if FOXVERSION < FXVERSION(1, 7, 82)
+    access|=FXIO::ReadWrite;
+    pointer=0;
+#endif
+    return 0;
+    }
+  return FXIO::Error;
+  }
+
+
 FXival Socket::writeBlock(const void* ptr,FXival count){
 #ifdef _WIN32
 #else
@@ -648,8 +682,22 @@ FXint SecureSocket::connect(const struct sockaddr * address,FXint address_length
 
   // Establish Connection
   FXint status = Socket::connect(address,address_length);
-  if (status<0) return status;
+  if (status!=0) return status;
+  return negotiate();
+  }
 
+
+// Complete connection
+FXint SecureSocket::finishConnect() {
+  FXint status = Socket::finishConnect();
+  if (status!=0) return status;
+  return negotiate();
+  }
+
+
+// Negotiate secure connection
+FXint SecureSocket::negotiate() {
+  FXint status;
 #if defined(HAVE_OPENSSL)
   // Negotiate SSL
 x:status = SSL_connect(ssl);
@@ -84,6 +84,11 @@ public:
   // Connect to address
   virtual FXint connect(const struct sockaddr *,FXint sockaddr_length);
 
+  // Start connecting to address without waiting. Returns 0 or FXIO::Again on success.
+  FXint beginConnect(const struct sockaddr *,FXint sockaddr_length);
+
+  // Complete connection started by beginConnect once the socket is writable
+  virtual FXint finishConnect();
   };
 
 #if defined(HAVE_OPENSSL) || defined(HAVE_GNUTLS)
@@ -97,6 +102,9 @@ protected:
 protected:
   FXint handshake();
 #endif
+protected:
+  // Negotiate secure connection on a connected socket
+  FXint negotiate();
 public:
   SecureSocket();
 
@@ -116,6 +124,9 @@ public:
 
   // Connect to address
   FXint connect(const struct sockaddr *,FXint sockaddr_length) override;
+
+  // Complete connection started by beginConnect once the socket is writable
+  FXint finishConnect() override;
   };
 
 #endif
@@ -19,6 +19,9 @@
 #include "ap_defs.h"
 #include "ap_utils.h"
 #include "ap_xml_parser.h"
+#include "ap_buffer_base.h"
+#include "ap_buffer_io.h"
+#include "ap_http_response.h"
 
 #include <expat.h>
 
@@ -26,12 +29,13 @@ namespace ap {
 
 #define NUM_NODES 32
 
-XmlParser::XmlParser() : nnodes(NUM_NODES),level(0) {
+XmlParser::XmlParser() : parser(nullptr),nnodes(NUM_NODES),level(0),stopped(false) {
   allocElms(nodes,nnodes);
   nodes[0]=Elem_None;
   }
 
 XmlParser::~XmlParser() {
+  if (parser) XML_ParserFree((XML_Parser)parser);
   freeElms(nodes);
   }
 
@@ -93,29 +97,110 @@ static int unknown_encoding(void*,const XML_Char * name,XML_Encoding * info){
   }
 
 
-FXbool XmlParser::parse(const FXString & buffer,const FXString & encoding) {
+FXbool XmlParser::start(const FXString & encoding) {
   if (!encoding.empty())
     GM_DEBUG_PRINT("[xml] parse with encoding %s\n",encoding.text());
 
-  XML_Parser parser;
+  if (parser)
+    XML_ParserFree((XML_Parser)parser);
 
   if (encoding.empty())
     parser = XML_ParserCreate(nullptr);
   else
     parser = XML_ParserCreate(encoding.text());
 
+  if (parser==nullptr)
+    return false;
+
   XML_SetUserData((XML_Parser)parser,this);
   XML_SetElementHandler((XML_Parser)parser,ap::element_start,ap::element_end);
   XML_SetCharacterDataHandler((XML_Parser)parser,ap::element_data);
   XML_SetUnknownEncodingHandler((XML_Parser)parser,unknown_encoding,this);
 
-  XML_Status code = XML_Parse((XML_Parser)parser,buffer.text(),buffer.length(),1);
-  if (code==XML_STATUS_ERROR) {
-    XML_ParserFree(parser);
+  level=0;
+  nodes[0]=Elem_None;
+  stopped=false;
+  return true;
+  }
+
+
+void XmlParser::stop() {
+  if (parser && !stopped) {
+    XML_StopParser((XML_Parser)parser,XML_FALSE);
+    stopped=true;
+    }
+  }
+
+
+FXbool XmlParser::feed(const FXchar * buffer,FXival len) {
+  if (parser==nullptr && !start())
     return false;
+
+  if (stopped)
+    return false;
+
+  while(len>0) {
+    FXint n = (FXint)FXMIN(len,(FXival)(1<<30));
+    if (XML_Parse((XML_Parser)parser,buffer,n,0)==XML_STATUS_ERROR || stopped)
+      return false;
+    buffer+=n;
+    len-=n;
     }
-  XML_ParserFree(parser);
   return true;
   }
 
+
+FXbool XmlParser::finish() {
+  FXbool result = stopped;
+  if (parser) {
+    if (!stopped && XML_Parse((XML_Parser)parser,nullptr,0,1)!=XML_STATUS_ERROR)
+      result = true;
+    XML_ParserFree((XML_Parser)parser);
+    parser=nullptr;
+    }
+  return result;
+  }
+
+
+FXbool XmlParser::parse(const FXString & buffer,const FXString & encoding) {
+  if (!start(encoding))
+    return false;
+  feed(buffer.text(),buffer.length());
+  return finish();
+  }
+
+
+FXbool XmlParser::parse(HttpResponse & response,const FXString & encoding) {
+  FXchar buffer[4096];
+  FXival n;
+  if (!start(encoding))
+    return false;
+  while((n=response.readBody(buffer,sizeof(buffer)))>0) {
+    if (!feed(buffer,n)) break;
+    }
+  if (stopped)
+    response.abort();
+  else if (n<0) {
+    finish();
+    return false;
+    }
+  return finish();
+  }
+
+
+FXbool XmlParser::parse(FXIO & io,const FXString & encoding) {
+  FXchar buffer[4096];
+  FXival n;
+  if (!start(encoding))
+    return false;
+  while((n=io.readBlock(buffer,sizeof(buffer)))>0) {
+    if (!feed(buffer,n)) break;
+    }
+  if (n<0 && !stopped) {
+    finish();
+    return false;
+    }
+  return finish();
+  }
+
 }
@@ -38,6 +38,7 @@
 #include <ap_app_queue.h>
 #include <ap_device.h>
 #include <ap_player.h>
+#include <ap_offline_decoder.h>
 #include <ap_common.h>
 #include <ap_http.h>
 #include <ap_xml_parser.h>
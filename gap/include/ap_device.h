@@ -29,9 +29,18 @@ enum {
   DeviceJack    = 4,
   DeviceWav     = 5,
   DeviceSndio   = 6,
+  DeviceStream  = 7,
   DeviceLast,
   };
 
+/// Output profiles, trading latency for wakeups
+enum {
+  ProfileDefault     = 0,   // Device or server defaults
+  ProfileLowLatency  = 1,   // Small buffers, responsive seeking and volume changes
+  ProfilePowerSaving = 2,   // Multi-second buffers, few wakeups
+  ProfileLast
+  };
+
 class GMAPI DeviceConfig {
 public:
   DeviceConfig();
@@ -99,17 +108,58 @@ public:
 
 
 
+class GMAPI StreamConfig : public DeviceConfig {
+public:
+  enum {
+    FormatWav  = 0,
+    FormatFlac = 1,
+    };
+public:
+  FXushort port;
+  FXuchar  format;
+public:
+  StreamConfig();
+
+  void load(FXSettings &);
+
+  void save(FXSettings &) const;
+
+  virtual ~StreamConfig();
+  };
+
+
+
 class GMAPI OutputConfig {
 public:
-  AlsaConfig  alsa;
-  OSSConfig   oss;
-  SndioConfig sndio;
+  AlsaConfig   alsa;
+  OSSConfig    oss;
+  SndioConfig  sndio;
+  StreamConfig stream;
   FXuchar     device;
+  FXuchar     profile;
 public:
   OutputConfig();
 
   FXString plugin() const;
 
+  /// Requested buffer time in ms, 0 for the default
+  FXuint bufferTime() const {
+    switch(profile) {
+      case ProfileLowLatency : return 50;
+      case ProfilePowerSaving: return 2000;
+      default                : return 0;
+      }
+    }
+
+  /// Requested period time in ms, 0 for the default
+  FXuint periodTime() const {
+    switch(profile) {
+      case ProfileLowLatency : return 10;
+      case ProfilePowerSaving: return 500;
+      default                : return 0;
+      }
+    }
+
   void load(FXSettings &);
 
   void save(FXSettings &) const;
@@ -32,6 +32,7 @@ enum EventType {
   AP_ERROR,         // ErrorMessage
   AP_META_INFO,
   AP_VOLUME_NOTIFY,
+  AP_OUTPUT_INFO,   // OutputInfo
   AP_LAST           // Reserved
   };
 
@@ -41,6 +42,17 @@ enum ReplayGainMode {
   ReplayGainAlbum   = 2,
   };
 
+struct GMAPI ReplayGain {
+  FXdouble album      = NAN;
+  FXdouble album_peak = NAN;
+  FXdouble track      = NAN;
+  FXdouble track_peak = NAN;
+
+  FXbool empty() const { return isnan(album) && isnan(track); }
+
+  void reset() { album=NAN; album_peak=NAN; track=NAN; track_peak=NAN; }
+  };
+
 class GMAPI Volume {
 public:
   FXfloat value;
@@ -109,5 +121,16 @@ public:
   VolumeNotify(FXfloat v);
   };
 
+class GMAPI OutputInfo : public Event {
+public:
+  FXuchar profile;  /// requested profile
+  FXuint  latency;  /// negotiated buffer in ms
+  FXuint  wakeups;  /// periods per second
+protected:
+  virtual ~OutputInfo();
+public:
+  OutputInfo(FXuchar p,FXuint l,FXuint w);
+  };
+
 }
 #endif
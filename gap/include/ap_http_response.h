@@ -100,6 +100,7 @@ enum {
 
 /* ZLIB */
 struct ZIO;
+struct ZBody;
 
 /* HttpIO */
 class GMAPI HttpIO : public BufferIO {
@@ -178,6 +179,7 @@ protected:
   FXint        content_length;    // Content Length from header
   FXint        content_remaining; // Content left to read
   FXint        chunk_remaining;   // Remaining bytes left to read in chunk
+  ZBody*       zbody;             // Inflater used by readBody
   FXuchar      flags;             // Options flags used by parser
 public:
   HttpStatus          status;     // Response Status. Valid after response() returns true
@@ -229,6 +231,12 @@ private:
   // Read body using normal transfer
   FXival   read_body(void * ptr,FXival len);
 
+  // Read body as send by the server
+  FXival   read_body_raw(void * ptr,FXival len);
+
+  // Read gzip'ed body
+  FXival   read_body_gzip(void * ptr,FXival len);
+
 protected:
   HttpResponse();
 
@@ -240,6 +248,9 @@ public:
   // Completes reading response
   virtual void discard();
 
+  // Don't read the rest of the response. The connection won't be reused.
+  void abort();
+
   // Read response status and headers.
   FXint parse();
 
@@ -249,7 +260,7 @@ public:
   // Return the complete message body as string.
   FXString textBody();
 
-  /// Read partial body
+  /// Read partial body. Gzip'ed content is decompressed.
   FXival readBody(void*ptr,FXival len);
 
   // Return header for given key
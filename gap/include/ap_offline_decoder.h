@@ -0,0 +1,81 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef AP_OFFLINE_DECODER_H
+#define AP_OFFLINE_DECODER_H
+
+namespace ap {
+
+class OfflineContext;
+
+/*
+  Decodes a stream without an output device, as fast as possible. Input,
+  reader and decoder run on the calling thread, so no engine threads or
+  timers are involved. Separate instances may be used from different threads
+  at the same time. Decoded audio is returned as interleaved floats.
+*/
+class GMAPI OfflineDecoder {
+private:
+  OfflineContext * context;
+private:
+  OfflineDecoder(const OfflineDecoder&);
+  OfflineDecoder& operator=(const OfflineDecoder&);
+public:
+  OfflineDecoder();
+
+  /// Open url. Returns once the output format is known.
+  FXbool open(const FXString & url);
+
+  /// Close stream
+  void close();
+
+  /// Read up to nframes. Returns number of frames read, 0 at end of stream or -1 on error.
+  FXival read(FXfloat * buffer,FXival nframes);
+
+  /// Seek to pos (0-1). Returns false if the stream isn't seekable.
+  FXbool seek(FXdouble pos);
+
+  /// Abort decoding. May be called from any thread.
+  void abort();
+
+  /// Sample rate of the decoded audio
+  FXuint rate() const;
+
+  /// Number of channels of the decoded audio
+  FXuint channels() const;
+
+  /// Stream length in frames, -1 if unknown
+  FXlong length() const;
+
+  /// Number of frames read so far, or the frame seeked to
+  FXlong position() const;
+
+  /// Number of packets handed to the decoder
+  FXlong packets() const;
+
+  /// Name of the codec being decoded
+  const FXchar * codec() const;
+
+  /// Replay gain of the stream if available
+  void getReplayGain(FXdouble & track,FXdouble & track_peak,FXdouble & album,FXdouble & album_peak) const;
+
+  ~OfflineDecoder();
+  };
+
+}
+#endif
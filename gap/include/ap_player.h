@@ -50,6 +50,9 @@ public:
   /// Open url and flush existing stream if true
   void open(const FXString & url,FXbool flush=true);
 
+  /// Open url with the replay gain to use if the stream doesn't have any
+  void open(const FXString & url,const ReplayGain & gain,FXbool flush=true);
+
   /// Pause Stream
   void pause();
 
@@ -21,11 +21,15 @@
 
 namespace ap {
 
+class HttpResponse;
+
 class GMAPI XmlParser {
 private:
+  void*  parser;
   FXint* nodes;
   FXint  nnodes;
   FXint  level;
+  FXbool stopped;
 public:
   void element_start(const FXchar*,const FXchar**);
   void element_end(const FXchar * element);
@@ -35,6 +39,12 @@ protected:
   virtual void data(const FXchar *,FXint) {}
   virtual void end(const FXchar *){}
   FXint node() const { return nodes[level]; }
+
+  // Stop parsing. May be called from begin, data and end.
+  void stop();
+private:
+  XmlParser(const XmlParser&);
+  XmlParser &operator=(const XmlParser&);
 public:
   enum {
     Elem_Skip = 0, // Skipped Element
@@ -44,11 +54,28 @@ public:
 public:
   XmlParser();
 
+  // Start incremental parsing with optional encoding. Implied by the first feed.
+  FXbool start(const FXString & encoding=FXString::null);
+
+  // Parse next part of the document. Returns false on error or if parsing was stopped.
+  FXbool feed(const FXchar * buffer,FXival len);
+
+  // Finish incremental parsing. Returns true if the document was well-formed or parsing was stopped.
+  FXbool finish();
+
+  // Return true if parsing was stopped before the end of the document
+  FXbool isStopped() const { return stopped; }
+
   // Parse buffer with optional encoding
   FXbool parse(const FXString & text,const FXString & encoding=FXString::null);
 
+  // Parse message body while it is being received. If stopped, the rest of the body is not read.
+  FXbool parse(HttpResponse & response,const FXString & encoding=FXString::null);
+
+  // Parse stream with optional encoding
+  FXbool parse(FXIO & io,const FXString & encoding=FXString::null);
+
   virtual ~XmlParser();
   };
 }
 #endif
-
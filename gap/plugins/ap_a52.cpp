@@ -20,6 +20,7 @@
 #include "ap_event_private.h"
 #include "ap_packet.h"
 #include "ap_decoder_plugin.h"
+#include "ap_interleave.h"
 
 extern "C" {
 #include <stdint.h>
@@ -90,11 +91,8 @@ FXbool A52Decoder::process(Packet*in) {
         out->af=af;
         }
 
-      FXfloat * data = out->flt();
-      for (FXint i=0,d=0;i<256;i++) {
-        data[d++] = samples[i];
-        data[d++] = samples[256+i];
-        }
+      const FXfloat * const planes[2] = {samples,samples+256};
+      interleave_float(planes,2,0,256,out->flt());
       out->wroteFrames(256);
       if (out->availableFrames()<256) {
         context->post_output_packet(out);
@@ -323,7 +323,6 @@ protected:
   NeAACDecHandle handle;
   MemoryBuffer   buffer;
   FXlong         stream_position = -1;
-  FXushort       stream_offset_start;
   FXbool         rawmode=false;
   FXbool         use_internal_buffer=false;
 protected:
@@ -404,7 +403,6 @@ FXbool AacDecoder::init(ConfigureEvent*event) {
     rawmode=true;
     }
   stream_position=-1;
-  stream_offset_start=event->stream_offset_start;
   return true;
   }
 
@@ -493,31 +491,20 @@ FXbool AacDecoder::getNextFrame(Packet *& packet,FXuchar *& ptr,FXuint & framesi
 
 
 FXint AacDecoder::process_output(FXuint stream_id,FXlong stream_length,void * outsamples,FXint nsamples) {
-  const FXlong stream_begin = FXMAX(stream_offset_start,stream_decode_offset);
-
   FXint nframes = nsamples / af.channels;
   //GM_DEBUG_PRINT("process_output %d\n",nframes);
 
-  // trim all samples
-  if ((stream_position+nframes)<stream_begin) {
-    stream_position+=nframes;
-    return 0;
-    }
-
   // trim end of stream
-  if (stream_length>0 && stream_position+nframes > stream_length) {
-    nframes = FXMIN(nframes,stream_length-stream_position);
-    }
+  if (stream_length>0)
+    nframes = trim_end(stream_position,nframes,stream_length);
+
+  // trim encoder delay or up to the seek position
+  const FXint skip = trim_begin(stream_position,nframes);
 
   if (use_internal_buffer) {
-    FXuchar * in = reinterpret_cast<FXuchar*>(outsamples);
-    if (stream_position<stream_begin) {
-      FXint skip_frames = FXMIN(nframes,(stream_begin-stream_position));
-      FXint nbytes = (skip_frames*af.framesize());
-      in+=nbytes;
-      nframes-=skip_frames;
-      stream_position += skip_frames;
-      }
+    FXuchar * in = reinterpret_cast<FXuchar*>(outsamples) + (skip*af.framesize());
+    nframes-=skip;
+    stream_position+=skip;
     while(nframes) {
       if (out==nullptr){
         out = context->get_output_packet();
@@ -533,12 +520,11 @@ FXint AacDecoder::process_output(FXuint stream_id,FXlong stream_length,void * ou
       }
     }
   else {
+    // frames were decoded straight into the packet
+    if (skip) memmove(out->ptr(),out->ptr()+(skip*af.framesize()),(nframes-skip)*af.framesize());
+    if (out->numFrames()==0) out->stream_position = stream_position + skip - stream_offset_start;
+    out->wroteFrames(nframes-skip);
     stream_position+=nframes;
-    out->wroteFrames(nframes);
-    if (stream_position<stream_begin) {
-      FXint skip_frames = FXMIN(nframes,(stream_begin-stream_position));
-      out->trimBegin(af.framesize()*skip_frames);
-      }
     if (out->availableFrames() < (nsamples / af.channels))
       context->post_output_packet(out);
     }
@@ -190,6 +190,15 @@ FXbool AlacDecoder::process(Packet*packet){
     decode_frame(handle,inputdata,outbuf.ptr(),&nframes);
     outbuf.wroteBytes(nframes);
     nframes /= af.framesize();
+
+    // Trim encoder delay or up to the seek position, and any padding
+    const FXint skip = trim_begin(stream_position,nframes);
+    outbuf.readBytes(skip*af.framesize());
+    stream_position+=skip;
+    nframes-=skip;
+    if (stream_length>0)
+      nframes = trim_end(stream_position,nframes,stream_length);
+
     while(nframes) {
 
       // Get output packet
@@ -198,8 +207,8 @@ FXbool AlacDecoder::process(Packet*packet){
         if (out==nullptr) return true;
         out->af              = af;
         out->stream          = stream_id;
-        out->stream_position = stream_position;
-        out->stream_length   = stream_length;
+        out->stream_position = stream_position - stream_offset_start;
+        out->stream_length   = stream_length - stream_offset_start;
         }
 
       // copy max frames
@@ -38,12 +38,15 @@ protected:
   snd_pcm_t*        handle;
   snd_pcm_uframes_t period_size;
   snd_pcm_uframes_t period_written;
+  snd_pcm_uframes_t buffer_size;
   FXuchar*          silence;
 
 
   AlsaMixer * mixer;
 protected:
   AlsaConfig config;
+  FXuint   buffer_time;
+  FXuint   period_time;
   FXbool   can_pause;
   FXbool   can_resume;
 protected:
@@ -60,6 +63,9 @@ public:
   /// Return delay in no. of frames
   FXint delay();
 
+  /// Return negotiated buffer and period size
+  FXbool latency(FXuint & buffer,FXuint & period);
+
   /// Empty Playback Buffer Immediately
   void drop();
 
@@ -186,6 +192,8 @@ protected:
   snd_pcm_uframes_t     period_size = 0;
   unsigned int          channels = 0;
   unsigned int          rate = 0;
+  unsigned int          buffer_time = 0;  // requested by profile, in us
+  unsigned int          period_time = 0;
 protected:
 
   void debug_hw_caps(){
@@ -470,7 +478,7 @@ protected:
     }
 
 
-  FXbool finish(AudioFormat & af,FXbool & can_pause,FXbool & can_resume,snd_pcm_uframes_t & period_frames) {
+  FXbool finish(AudioFormat & af,FXbool & can_pause,FXbool & can_resume,snd_pcm_uframes_t & period_frames,snd_pcm_uframes_t & buffer_frames) {
     int result;
 
     af.rate       = rate;
@@ -478,6 +486,7 @@ protected:
     can_pause     = snd_pcm_hw_params_can_pause(hw);
     can_resume    = snd_pcm_hw_params_can_resume(hw);
     period_frames = period_size;
+    buffer_frames = buffer_size;
 
     debug_hw_parameters();
     debug_sw_parameters();
@@ -522,18 +531,19 @@ static int query_chmaps(snd_pcm_t *pcm)
 
   FXbool setupHardware() {
     int result;
-/*
-    int result;
-    unsigned int buffer_time = 1000000; // 1 sec
-    unsigned int periods     = 5;       // periods every 200ms
     int dir=0;
 
-    if (snd_pcm_hw_params_set_buffer_time_near(pcm,hw,&buffer_time,&dir)<0)
-      return false;
+    // Buffer and period time from the output profile. The device decides what we get.
+    if (buffer_time) {
+      if ((result=snd_pcm_hw_params_set_buffer_time_near(pcm,hw,&buffer_time,&dir))<0)
+        GM_DEBUG_PRINT("[alsa] failed to set buffer time. Reason: %s\n",snd_strerror(result));
+      }
+
+    if (period_time) {
+      if ((result=snd_pcm_hw_params_set_period_time_near(pcm,hw,&period_time,&dir))<0)
+        GM_DEBUG_PRINT("[alsa] failed to set period time. Reason: %s\n",snd_strerror(result));
+      }
 
-    if (snd_pcm_hw_params_set_periods_near(pcm,hw,&periods,&dir)<0)
-      return false;
-*/
     if ((result=snd_pcm_hw_params(pcm,hw))<0) {
       GM_DEBUG_PRINT("[alsa] failed to set hardware paramaters. Reason: %s\n",snd_strerror(result));
       return false;
@@ -643,8 +653,10 @@ static int query_chmaps(snd_pcm_t *pcm)
 
 public:
 
-  static FXbool configure(snd_pcm_t * pcm,AlsaConfig & config,const AudioFormat & in,AudioFormat & out,FXbool & can_pause,FXbool & can_resume,snd_pcm_uframes_t & period_frames) {
+  static FXbool configure(snd_pcm_t * pcm,AlsaConfig & config,FXuint buffer_time,FXuint period_time,const AudioFormat & in,AudioFormat & out,FXbool & can_pause,FXbool & can_resume,snd_pcm_uframes_t & period_frames,snd_pcm_uframes_t & buffer_frames) {
     AlsaSetup alsa(pcm);
+    alsa.buffer_time = buffer_time*1000;
+    alsa.period_time = period_time*1000;
 
     // Init structures
     if (!alsa.init())
@@ -666,7 +678,7 @@ public:
       return false;
 
     /// Finish up and get the Configured Format
-    if (!alsa.finish(out,can_pause,can_resume,period_frames))
+    if (!alsa.finish(out,can_pause,can_resume,period_frames,buffer_frames))
       return false;
 
     return true;
@@ -837,7 +849,7 @@ fail:
 
 
 
-AlsaOutput::AlsaOutput(OutputContext * ctx) : OutputPlugin(ctx), handle(nullptr),period_size(0),period_written(0),silence(nullptr),mixer(nullptr),can_pause(false),can_resume(false) {
+AlsaOutput::AlsaOutput(OutputContext * ctx) : OutputPlugin(ctx), handle(nullptr),period_size(0),period_written(0),buffer_size(0),silence(nullptr),mixer(nullptr),buffer_time(0),period_time(0),can_pause(false),can_resume(false) {
   }
 
 AlsaOutput::~AlsaOutput() {
@@ -880,6 +892,8 @@ void AlsaOutput::close() {
 
 FXbool AlsaOutput::setOutputConfig(const OutputConfig & c) {
   config=c.alsa;
+  buffer_time=c.bufferTime();
+  period_time=c.periodTime();
   return true;
   }
 
@@ -904,6 +918,16 @@ FXint AlsaOutput::delay() {
   }
 
 
+FXbool AlsaOutput::latency(FXuint & buffer,FXuint & period) {
+  if (handle && af.set()) {
+    buffer = buffer_size;
+    period = period_size;
+    return true;
+    }
+  return false;
+  }
+
+
 void AlsaOutput::drop() {
   int result;
   if (__likely(handle)) {
@@ -989,7 +1013,7 @@ FXbool AlsaOutput::configure(const AudioFormat & fmt){
     return true;
     }
 
-  if (!AlsaSetup::configure(handle,config,fmt,af,can_pause,can_resume,period_size)) {
+  if (!AlsaSetup::configure(handle,config,buffer_time,period_time,fmt,af,can_pause,can_resume,period_size,buffer_size)) {
     GM_DEBUG_PRINT("[alsa] error configuring device\n");
     af.reset();
     return false;
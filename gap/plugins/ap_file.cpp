@@ -17,17 +17,120 @@
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
 #include "ap_defs.h"
+#include "ap_utils.h"
 #include "ap_input_plugin.h"
 
+#include <FXAtomic.h>
+#include <sys/mman.h>
+#include <signal.h>
+
 using namespace ap;
 
 namespace ap {
 
+/*
+  Regular files are memory mapped, so reads are a copy from the page cache
+  and header parsing can seek around without system calls. Anything that
+  can't be mapped (pipes, empty files) is read through FXFile instead, as is
+  everything with GOGGLESMM_FILE_MMAP=0.
+
+  The map has the size of the file when it was opened. Touching a mapped
+  page after someone else truncated the file (a tag editor rewriting it, a
+  network share going away) raises SIGBUS. Every map is registered in a
+  fixed table the SIGBUS handler can walk without locking. On a fault inside
+  a registered map, the handler replaces the rest of the map with zero pages
+  and flags it, and the access that faulted simply continues. The input then
+  clamps itself to the new size of the file, so readers see a short file
+  instead of the player going down. Faults anywhere else go to the previous
+  handler.
+*/
+
+struct MappedRegion {
+  volatile FXptr   base;
+  volatile FXlong  length;
+  volatile FXbool  truncated;
+  };
+
+static const FXint       MAXREGIONS = 64;
+static MappedRegion      regions[MAXREGIONS];
+static struct sigaction  previous_handler;
+static FXlong            pagesize = 0;
+
+
+static void sigbus_handler(int sig,siginfo_t * info,void * context) {
+  const FXuchar * address = static_cast<const FXuchar*>(info->si_addr);
+  for (FXint i=0;i<MAXREGIONS;i++) {
+    FXuchar * base = static_cast<FXuchar*>(regions[i].base);
+    const FXlong length = regions[i].length;
+    if (base && address>=base && address<base+length) {
+      FXuchar * page = base + ((address-base) & ~(pagesize-1));
+      if (mmap(page,base+length-page,PROT_READ,MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED,-1,0)!=MAP_FAILED) {
+        regions[i].truncated=true;
+        return;
+        }
+      break;
+      }
+    }
+
+  // Not ours
+  if (previous_handler.sa_flags&SA_SIGINFO) {
+    previous_handler.sa_sigaction(sig,info,context);
+    }
+  else if (previous_handler.sa_handler!=SIG_DFL && previous_handler.sa_handler!=SIG_IGN) {
+    previous_handler.sa_handler(sig);
+    }
+  else {
+    // Fault again with the default action
+    sigaction(SIGBUS,&previous_handler,nullptr);
+    }
+  }
+
+
+static FXbool install_sigbus_handler() {
+  struct sigaction action;
+  memset(&action,0,sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_sigaction=sigbus_handler;
+  action.sa_flags=SA_SIGINFO;
+  pagesize=FXMappedFile::granularity();
+  return sigaction(SIGBUS,&action,&previous_handler)==0;
+  }
+
+
+// Register a map with the SIGBUS handler, returns its slot or -1 if the table is full
+static FXint register_region(const FXuchar * data,FXlong length) {
+  static const FXbool installed = install_sigbus_handler();
+  if (installed) {
+    for (FXint i=0;i<MAXREGIONS;i++) {
+      if (regions[i].base==nullptr && regions[i].length==0 && atomicCas(&regions[i].length,(FXlong)0,length)==0) {
+        regions[i].truncated=false;
+        atomicSet(&regions[i].base,const_cast<FXuchar*>(data));
+        return i;
+        }
+      }
+    }
+  return -1;
+  }
+
+
+static void unregister_region(FXint slot) {
+  atomicSet(&regions[slot].base,(FXptr)nullptr);
+  atomicSet(&regions[slot].length,(FXlong)0);
+  }
+
 
 class FileInput : public InputPlugin {
 protected:
-  FXFile   file;
-  FXString filename;
+  FXFile          file;
+  FXMappedFile    map;
+  const FXuchar * data   = nullptr; // mapped file
+  FXlong          length = 0;       // length of mapped file
+  FXlong          offset = 0;       // position in mapped file
+  FXint           region = -1;      // slot with the SIGBUS handler
+  FXString        filename;
+protected:
+  void advise(FXlong from,FXlong n,FXint advice);
+  FXival available(FXival count);
 private:
   FileInput(const FileInput&);
   FileInput &operator=(const FileInput&);
@@ -43,6 +146,9 @@ public:
 	/// Preview
 	FXival preview(void*,FXival) override;
 
+  /// Span
+  const FXuchar * span(FXival&) override;
+
   /// Set Position
   FXlong position(FXlong offset,FXuint from) override;
 
@@ -70,6 +176,7 @@ FileInput::FileInput(IOContext * ctx) : InputPlugin(ctx) {
   }
 
 FileInput::~FileInput() {
+  if (region>=0) unregister_region(region);
   }
 
 FXbool FileInput::open(const FXString & url) {
@@ -78,6 +185,22 @@ FXbool FileInput::open(const FXString & url) {
   filename=FXURL::fileFromURL(url);
   if (filename.empty()) filename=url;
 
+  // Map regular files
+  if (FXStat::isFile(filename) && ap_get_environment("GOGGLESMM_FILE_MMAP","1")!="0") {
+    data = static_cast<const FXuchar*>(map.open(filename,FXIO::Reading));
+    if (data) {
+      length = map.length();
+      region = register_region(data,length);
+      if (region>=0) {
+        advise(0,length,POSIX_MADV_SEQUENTIAL);
+        return true;
+        }
+      map.close();
+      data=nullptr;
+      length=0;
+      }
+    }
+
   // Open file
   if (!file.open(filename,FXIO::Reading)){
     filename.clear();
@@ -87,34 +210,89 @@ FXbool FileInput::open(const FXString & url) {
   return true;
   }
 
-FXival FileInput::preview(void*data,FXival count) {
+// Hint the kernel how we're going to access [from,from+n)
+void FileInput::advise(FXlong from,FXlong n,FXint advice) {
+  const FXlong start = from - (from % FXMappedFile::granularity());
+  const FXlong end   = FXMIN(from+n,length);
+  if (end>start) posix_madvise(const_cast<FXuchar*>(data+start),end-start,advice);
+  }
+
+// Bytes that can be copied from the map at offset. Call again after the copy;
+// if the file got truncated meanwhile only the bytes before the new end count.
+FXival FileInput::available(FXival count) {
+  if (regions[region].truncated) {
+    const FXlong size = FXStat::size(filename);
+    if (size<length) {
+      GM_DEBUG_PRINT("[file] %s truncated from %lld to %lld bytes\n",filename.text(),length,size);
+      length = size;
+      }
+    }
+  return (FXival) FXCLAMP(0,length-offset,(FXlong)count);
+  }
+
+FXival FileInput::preview(void*ptr,FXival count) {
+  if (data) {
+    FXival n = available(count);
+    memcpy(ptr,data+offset,n);
+    return available(n);
+    }
 	FXlong pos = file.position();
-	FXival n = file.readBlock(data,count);
+	FXival n = file.readBlock(ptr,count);
 	file.position(pos,FXIO::Begin);
 	return n;
   }
 
-FXival FileInput::read(void*data,FXival ncount) {
-  return file.readBlock(data,ncount);
+const FXuchar * FileInput::span(FXival & count) {
+  if (data) {
+    count = available(count);
+    return data+offset;
+    }
+  count=0;
+  return nullptr;
   }
 
-FXlong FileInput::position(FXlong offset,FXuint from) {
-  return file.position(offset,from);
+FXival FileInput::read(void*ptr,FXival ncount) {
+  if (data) {
+    FXival n = available(ncount);
+    memcpy(ptr,data+offset,n);
+    n = available(n);
+    offset+=n;
+    return n;
+    }
+  return file.readBlock(ptr,ncount);
+  }
+
+FXlong FileInput::position(FXlong pos,FXuint from) {
+  if (data) {
+    if (from==FXIO::Current) pos+=offset;
+    else if (from==FXIO::End) pos+=length;
+    if (pos<0) return FXIO::Error;
+
+    // Start reading ahead when we jump beyond what the kernel is reading ahead already
+    if (FXABS(pos-offset)>(1<<18)) advise(pos,1<<18,POSIX_MADV_WILLNEED);
+    offset=pos;
+    return offset;
+    }
+  return file.position(pos,from);
   }
 
 FXlong FileInput::position() const {
+  if (data) return offset;
   return file.position();
   }
 
 FXlong FileInput::size() {
+  if (data) return length;
   return file.size();
   }
 
 FXbool FileInput::eof()  {
+  if (data) return offset>=length;
   return file.eof();
   }
 
 FXbool FileInput::serial() const {
+  if (data) return false;
   return file.isSerial();
   }
 
@@ -23,6 +23,7 @@
 #include "ap_input_plugin.h"
 #include "ap_reader_plugin.h"
 #include "ap_decoder_plugin.h"
+#include "ap_interleave.h"
 
 #include <FLAC/stream_decoder.h>
 
@@ -710,7 +711,6 @@ FLAC__StreamDecoderWriteStatus FlacDecoder::flac_decoder_write(const FLAC__Strea
   FlacDecoder * plugin = static_cast<FlacDecoder*>(client_data);
   FXASSERT(frame);
   FXASSERT(buffer);
-  FXint s,c,p=0;
   FXint sample  = 0;
   FXint nchannels = frame->header.channels;
   FXint ncopy;
@@ -732,9 +732,9 @@ FLAC__StreamDecoderWriteStatus FlacDecoder::flac_decoder_write(const FLAC__Strea
       packet->stream_position = stream_position;
     }
 
-  if (stream_position<plugin->stream_decode_offset) {
-    FXlong offset = FXMIN(nframes,plugin->stream_decode_offset-stream_position);
-    GM_DEBUG_PRINT("[flac] stream decode offset %ld. Skipping %ld of %ld \n",plugin->stream_decode_offset,offset,plugin->stream_decode_offset-stream_position);
+  const FXint offset = plugin->trim_begin(stream_position,nframes);
+  if (offset) {
+    GM_DEBUG_PRINT("[flac] stream decode offset %ld. Skipping %d\n",plugin->stream_decode_offset,offset);
     nframes-=offset;
     stream_position+=offset;
     sample+=offset;
@@ -758,36 +758,15 @@ FLAC__StreamDecoderWriteStatus FlacDecoder::flac_decoder_write(const FLAC__Strea
 
     ncopy = FXMIN(nframes,packet->availableFrames());
     switch(frame->header.bits_per_sample) {
-      case 8:
-        {
-          FXchar * buf8 = packet->s8();
-          for (p=0,s=sample;s<(ncopy+sample);s++)
-            for (c=0;c<nchannels;c++,p++)
-              buf8[p]=buffer[c][s];
-        }
-        break;
-      case 16:
-        {
-          FXshort * buf16 = packet->s16();
-          for (p=0,s=sample;s<(ncopy+sample);s++)
-            for (c=0;c<nchannels;c++,p++)
-              buf16[p]=buffer[c][s];
-        }
-        break;
-      case 24:
-        {
-          FXchar * buf8 = packet->s8();
-          for (p=0,s=sample;s<(ncopy+sample);s++) {
-            for (c=0;c<nchannels;c++,p+=3) {
-              buf8[p+0]=(buffer[c][s]&0xFF);
-              buf8[p+1]=(buffer[c][s]&0xFF00)>>8;
-              buf8[p+2]=(buffer[c][s]&0xFF0000)>>16;
-              }
-            }
-        }
-        break;
+      case 8 : interleave_s8(buffer,nchannels,sample,ncopy,0,packet->s8()); break;
+      case 16: interleave_s16(buffer,nchannels,sample,ncopy,0,packet->s16()); break;
+      case 24: interleave_s24le3(buffer,nchannels,sample,ncopy,0,packet->ptr()); break;
       case 32:
+#if FOX_BIGENDIAN == 0
+        interleave_s32(buffer,nchannels,sample,ncopy,packet->s32());
+#else
         {
+          FXint s,c,p;
           FXchar * buf8 = packet->s8();
           for (p=0,s=sample;s<(ncopy+sample);s++) {
             for (c=0;c<nchannels;c++,p+=4) {
@@ -798,6 +777,7 @@ FLAC__StreamDecoderWriteStatus FlacDecoder::flac_decoder_write(const FLAC__Strea
               }
             }
         }
+#endif
         break;
       default: return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT; break;
       }
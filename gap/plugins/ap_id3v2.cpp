@@ -17,6 +17,7 @@
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
 #include "ap_defs.h"
+#include "ap_event.h"
 #include "ap_input_plugin.h"
 #include "ap_id3v2.h"
 
@@ -26,6 +27,8 @@
 
 namespace ap {
 
+extern void ap_replaygain_from_vorbis_comment(ReplayGain & gain,const FXchar * comment,FXint len);
+
 
 ID3V2 * ID3V2::parse(InputPlugin * input,const FXuchar * id) {
   FXuchar info[6];
@@ -270,6 +273,37 @@ void ID3V2::parse_comment_frame(FXint framesize) {
   }
 
 
+// User defined text. Used by most taggers to store replay gain.
+void ID3V2::parse_txxx_frame(FXint framesize) {
+  FXString key,field;
+
+  const FXuchar & encoding = buffer[p];
+  const FXchar* textstart  = (const FXchar*)(buffer+p+1);
+  const FXint   textlength = framesize - 1;
+
+  if (textlength<=0)
+    return;
+
+  if (encoding==UTF16_BOM || encoding==UTF16) {
+    FXint ksize = strwlen(textstart,textlength);
+    FXint vsize = strwlen(textstart+ksize+2,textlength-ksize-2);
+    parse_text(encoding,textstart,ksize,key);
+    parse_text(encoding,textstart+ksize+2,vsize,field);
+    }
+  else {
+    FXint ksize = strnlen(textstart,textlength);
+    FXint vsize = strnlen(textstart+ksize+1,textlength-ksize-1);
+    parse_text(encoding,textstart,ksize,key);
+    parse_text(encoding,textstart+ksize+1,vsize,field);
+    }
+
+  if (FXString::comparecase(key,"REPLAYGAIN_",11)==0) {
+    FXString comment = key + "=" + field;
+    ap_replaygain_from_vorbis_comment(replaygain,comment.text(),comment.length());
+    }
+  }
+
+
 void ID3V2::parse_text_frame(FXuint frameid,FXint framesize) {
   FXString text;
   const FXuchar & encoding = buffer[p];
@@ -344,6 +378,7 @@ void ID3V2::parse_frame() {
       case RVA2 : parse_rva2_frame(framesize); break;
       case PRIV : parse_priv_frame(framesize); break;
       case COMM : parse_comment_frame(framesize); break;
+      case TXXX : parse_txxx_frame(framesize); break;
       case 0    : p=size; return; break;
       default   : break;
       };
@@ -42,6 +42,7 @@ protected:
   void parse_text_frame(FXuint frameid,FXint framesize);
   void parse_rva2_frame(FXint framesize);
   void parse_priv_frame(FXint framesize);
+  void parse_txxx_frame(FXint framesize);
   FXbool parse_text(FXint encoding,const FXchar * buffer,FXint length,FXString & text);
 public:
   enum Encoding {
@@ -65,7 +66,8 @@ public:
     TALB = DEFINE_FRAME('T','A','L','B'),
     TIT2 = DEFINE_FRAME('T','I','T','2'),
     RVA2 = DEFINE_FRAME('R','V','A','2'),
-    PRIV = DEFINE_FRAME('P','R','I','V')
+    PRIV = DEFINE_FRAME('P','R','I','V'),
+    TXXX = DEFINE_FRAME('T','X','X','X')
     };
 
   enum {
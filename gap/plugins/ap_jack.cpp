@@ -18,18 +18,67 @@
 ********************************************************************************/
 #include "ap_defs.h"
 #include "ap_output_plugin.h"
+#include "ap_convert.h"
+#include "ap_ring_buffer.h"
 
 #include <jack/jack.h>
 
+#ifdef HAVE_SAMPLERATE
+#include <samplerate.h>
+#endif
+
 using namespace ap;
 
 namespace ap {
 
+/*
+  Jack pulls samples from its process callback. The output thread converts
+  to float and writes into a ring buffer, the process callback deinterleaves
+  from the ring into the ports. The callback doesn't lock or allocate; pause,
+  volume and drop are passed as flags.
+
+  Jack runs all clients at the server rate. Streams at another rate are
+  resampled with libsamplerate on their way into the ring, so af.rate stays
+  the stream rate and the ring counts frames at the server rate.
+*/
 class JackOutput : public OutputPlugin {
 protected:
-  jack_client_t * jack;
+  static const FXint MAXCHANNELS = 8;
+  static const FXint MAXSAMPLES  = 4096;
+protected:
+  jack_client_t *   jack = nullptr;
+  jack_port_t *     ports[MAXCHANNELS];
+  FXint             nports    = 0;
+  RingBuffer        ring;
+  volatile FXfloat  gain      = 1.0f;
+  volatile FXbool   paused    = false;
+  volatile FXbool   playing   = false;
+  volatile FXbool   shutdown  = false;
+  volatile FXint    xruns     = 0;    // reported by jack
+  volatile FXint    underruns = 0;    // ring ran empty while playing
+  FXint             nxruns    = 0;
+  FXint             nunderruns= 0;
+  FXbool            active    = false;
+  FXuint            rate      = 0;    // server rate
+#ifdef HAVE_SAMPLERATE
+  SRC_STATE *       src       = nullptr;
+  FXfloat           samples[MAXSAMPLES];
+#endif
+protected:
+  static int process(jack_nframes_t,void*);
+  static int xrun(void*);
+  static void on_shutdown(void*);
 protected:
   FXbool open();
+  FXbool setup(FXint channels);
+  void connect();
+  void deactivate();
+  void report();
+  FXTime period() const;
+  FXuint stream_frames(FXuint n) const;
+#ifdef HAVE_SAMPLERATE
+  FXbool resample(const FXuchar*,FXuint);
+#endif
 public:
   JackOutput(OutputContext* ctx);
 
@@ -42,6 +91,9 @@ public:
   /// Return delay in no. of frames
   FXint delay();
 
+  /// Return ring and jack period size
+  FXbool latency(FXuint & buffer,FXuint & period);
+
   /// Empty Playback Buffer Immediately
   void drop();
 
@@ -54,6 +106,9 @@ public:
   /// Change Volume
   void volume(FXfloat);
 
+  /// Get Volume
+  FXfloat volume() { return gain; }
+
   /// Close Output
   void close();
 
@@ -72,49 +127,345 @@ JackOutput::~JackOutput() {
   close();
   }
 
+
+// Realtime thread. Deinterleave from the ring into the ports.
+int JackOutput::process(jack_nframes_t nframes,void * ptr) {
+  JackOutput * out = static_cast<JackOutput*>(ptr);
+  const FXint nchannels = out->nports;
+  FXfloat * buffers[MAXCHANNELS];
+
+  for (FXint c=0;c<nchannels;c++) {
+    buffers[c] = static_cast<FXfloat*>(jack_port_get_buffer(out->ports[c],nframes));
+    }
+
+  FXuint done=0;
+  if (!out->paused) {
+    const FXfloat gain = out->gain;
+    while(done<nframes) {
+      FXuint n=nframes-done;
+      const FXfloat * src = out->ring.rptr(n);
+      if (n==0) break;
+      for (FXint c=0;c<nchannels;c++) {
+        FXfloat * dst = buffers[c]+done;
+        for (FXuint i=0;i<n;i++) dst[i]=src[i*nchannels+c]*gain;
+        }
+      out->ring.release(n);
+      done+=n;
+      }
+    if (done<nframes && out->playing) {
+      atomicAdd(&out->underruns,1);
+      }
+    }
+
+  // Silence the remainder
+  for (FXint c=0;c<nchannels;c++) {
+    memset(buffers[c]+done,0,sizeof(FXfloat)*(nframes-done));
+    }
+  return 0;
+  }
+
+
+int JackOutput::xrun(void * ptr) {
+  JackOutput * out = static_cast<JackOutput*>(ptr);
+  atomicAdd(&out->xruns,1);
+  return 0;
+  }
+
+
+void JackOutput::on_shutdown(void * ptr) {
+  JackOutput * out = static_cast<JackOutput*>(ptr);
+  out->shutdown = true;
+  }
+
+
 FXbool JackOutput::open() {
-  jack = jack_client_open("gap",JackNoStartServer,nullptr);
   if (jack==nullptr) {
-    return false;
+    jack_status_t status;
+    jack = jack_client_open("Goggles Music Manager",JackNoStartServer,&status);
+    if (jack==nullptr) {
+      GM_DEBUG_PRINT("[jack] unable to connect to server (0x%x)\n",status);
+      return false;
+      }
+    shutdown=false;
+    jack_set_process_callback(jack,process,this);
+    jack_set_xrun_callback(jack,xrun,this);
+    jack_on_shutdown(jack,on_shutdown,this);
     }
-  return false;
+  return !shutdown;
+  }
+
+
+void JackOutput::deactivate() {
+  if (active) {
+    jack_deactivate(jack);
+    active=false;
+    }
+  }
+
+
+// Register one port per channel. Only while deactivated.
+FXbool JackOutput::setup(FXint channels) {
+  FXASSERT(!active);
+  while(nports>channels) {
+    jack_port_unregister(jack,ports[--nports]);
+    }
+  while(nports<channels) {
+    jack_port_t * port = jack_port_register(jack,FXString::value("out_%d",nports+1).text(),JACK_DEFAULT_AUDIO_TYPE,JackPortIsOutput,0);
+    if (port==nullptr) return false;
+    ports[nports++]=port;
+    }
+  return true;
   }
 
+
+// Connect our ports to the physical outputs. Mono goes to the first two.
+void JackOutput::connect() {
+  const char ** physical = jack_get_ports(jack,nullptr,JACK_DEFAULT_AUDIO_TYPE,JackPortIsPhysical|JackPortIsInput);
+  if (physical) {
+    for (FXint i=0;physical[i] && i<FXMAX(nports,2);i++) {
+      jack_connect(jack,jack_port_name(ports[FXMIN(i,nports-1)]),physical[i]);
+      }
+    jack_free(physical);
+    }
+  }
+
+
 void JackOutput::close() {
   if (jack) {
+    report();
+    deactivate();
     jack_client_close(jack);
     jack=nullptr;
     }
+#ifdef HAVE_SAMPLERATE
+  if (src) {
+    src_delete(src);
+    src=nullptr;
+    }
+#endif
+  nports=0;
+  rate=0;
+  ring.free();
+  playing=false;
+  paused=false;
   af.reset();
   }
 
 
-void JackOutput::volume(FXfloat) {
+void JackOutput::report() {
+  const FXint x = xruns;
+  const FXint u = underruns;
+  if (x!=nxruns || u!=nunderruns) {
+    GM_DEBUG_PRINT("[jack] xruns %d underruns %d\n",x,u);
+    nxruns=x;
+    nunderruns=u;
+    }
+  }
+
+
+// Duration of a jack period
+FXTime JackOutput::period() const {
+  return ((FXTime)jack_get_buffer_size(jack)*NANOSECONDS_PER_SECOND) / FXMAX(rate,1u);
+  }
+
+
+// Convert frames at the server rate to frames at the stream rate
+FXuint JackOutput::stream_frames(FXuint n) const {
+  return (FXuint)(((FXulong)n*af.rate) / FXMAX(rate,1u));
+  }
+
+
+void JackOutput::volume(FXfloat v) {
+  gain=v;
   }
 
+
+// Frames in the ring plus the playback latency of the ports
 FXint JackOutput::delay() {
-  return 0;
+  FXint value=0;
+  if (jack && active) {
+    jack_latency_range_t range;
+    jack_port_get_latency_range(ports[0],JackPlaybackLatency,&range);
+    value = stream_frames(ring.readable() + range.max);
+    }
+  return value;
   }
 
+
+FXbool JackOutput::latency(FXuint & buffer,FXuint & period) {
+  if (jack && active) {
+    buffer = stream_frames(ring.size());
+    period = stream_frames(jack_get_buffer_size(jack));
+    return true;
+    }
+  return false;
+  }
+
+
 void JackOutput::drop() {
+  if (active) {
+    playing=false;
+    ring.drop();
+#ifdef HAVE_SAMPLERATE
+    if (src) src_reset(src);
+#endif
+    }
   }
 
+
 void JackOutput::drain() {
+  if (active) {
+    playing=false;
+    while(ring.readable() && !paused && !shutdown) {
+      FXThread::sleep(period());
+      }
+    jack_latency_range_t range;
+    jack_port_get_latency_range(ports[0],JackPlaybackLatency,&range);
+    FXThread::sleep(((FXTime)range.max*NANOSECONDS_PER_SECOND) / FXMAX(rate,1u));
+    report();
+    }
   }
 
-void JackOutput::pause(FXbool) {
+
+void JackOutput::pause(FXbool p) {
+  paused=p;
   }
 
-FXbool JackOutput::configure(const AudioFormat &){
-//  af.format = AP_FORMAT_FLOAT;
-//  af.rate   = jack_get_sample_rate(jack);
+
+// Jack only does float at the server rate. We convert any linear pcm
+// to float ourselves and resample streams at a different rate.
+FXbool JackOutput::configure(const AudioFormat & fmt){
+  FXuchar  silence[8]={0};
+  FXfloat  sample;
+
+  if (!open())
+    return false;
+
+  if (!to_float(fmt,silence,1,&sample) || fmt.channels<1 || fmt.channels>MAXCHANNELS) {
+    GM_DEBUG_PRINT("[jack] Unsupported configuration:\n");
+    fmt.debug();
+    return false;
+    }
+
+  if (active && fmt==af)
+    return true;
+
+  deactivate();
+
+  rate = jack_get_sample_rate(jack);
+
+#ifdef HAVE_SAMPLERATE
+  if (src) {
+    src_delete(src);
+    src=nullptr;
+    }
+  if (fmt.rate!=rate) {
+    FXint error;
+    src = src_new(SRC_SINC_FASTEST,fmt.channels,&error);
+    if (src==nullptr) {
+      GM_DEBUG_PRINT("[jack] resampler: %s\n",src_strerror(error));
+      goto failed;
+      }
+    GM_DEBUG_PRINT("[jack] resampling %u to %u\n",fmt.rate,rate);
+    }
+#else
+  if (fmt.rate!=rate) {
+    context->notify_error(FXString::value("The Jack server runs at %u Hz and cannot play this %u Hz stream.\nGoggles Music Manager was built without resampling support (libsamplerate).",rate,fmt.rate));
+    goto failed;
+    }
+#endif
+
+  if (!setup(fmt.channels))
+    goto failed;
+
+  // At least 250ms or four periods
+  if (!ring.init(FXMAX(rate>>2,jack_get_buffer_size(jack)<<2),fmt.channels))
+    goto failed;
+
+  af=fmt;
+
+  if (jack_activate(jack))
+    goto failed;
+
+  active=true;
+  connect();
+  return true;
+failed:
+  GM_DEBUG_PRINT("[jack] configure failed\n");
+  af.reset();
   return false;
   }
 
 
-FXbool JackOutput::write(const void *,FXuint){
-  return false;
+#ifdef HAVE_SAMPLERATE
+
+// Convert a chunk at a time to float and resample it into the ring
+FXbool JackOutput::resample(const FXuchar * input,FXuint nframes) {
+  const FXuint framesize = af.framesize();
+  const FXuint maxframes = MAXSAMPLES/af.channels;
+  SRC_DATA data;
+  data.src_ratio    = (FXdouble)rate / (FXdouble)af.rate;
+  data.end_of_input = 0;
+  while(nframes) {
+    const FXuint n = FXMIN(nframes,maxframes);
+    to_float(af,input,n*af.channels,samples);
+    data.data_in      = samples;
+    data.input_frames = n;
+    while(data.input_frames) {
+      if (shutdown)
+        return false;
+      FXuint space = ring.size();
+      data.data_out      = ring.wptr(space);
+      data.output_frames = space;
+      if (space==0) {
+        FXThread::sleep(period());
+        continue;
+        }
+      FXint error = src_process(src,&data);
+      if (error) {
+        GM_DEBUG_PRINT("[jack] resampler: %s\n",src_strerror(error));
+        return false;
+        }
+      ring.commit(data.output_frames_gen);
+      data.data_in      += data.input_frames_used*af.channels;
+      data.input_frames -= data.input_frames_used;
+      playing=true;
+      }
+    input+=n*framesize;
+    nframes-=n;
+    }
+  report();
+  return true;
   }
+
+#endif
+
+
+FXbool JackOutput::write(const void * b,FXuint nframes){
+  const FXuchar * input = static_cast<const FXuchar*>(b);
+  const FXuint framesize = af.framesize();
+#ifdef HAVE_SAMPLERATE
+  if (src) return resample(input,nframes);
+#endif
+  while(nframes) {
+    if (shutdown)
+      return false;
+    FXuint n = nframes;
+    FXfloat * output = ring.wptr(n);
+    if (n==0) {
+      FXThread::sleep(period());
+      continue;
+      }
+    to_float(af,input,n*af.channels,output);
+    ring.commit(n);
+    input+=n*framesize;
+    nframes-=n;
+    playing=true;
+    }
+  report();
+  return true;
+  }
+
 }
 
 
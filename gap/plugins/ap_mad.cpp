@@ -24,12 +24,21 @@
 #include "ap_reader_plugin.h"
 #include "ap_input_plugin.h"
 #include "ap_decoder_plugin.h"
+#include "ap_interleave.h"
+#include "ap_utils.h"
 
+#ifdef HAVE_MAD
 #include <mad.h>
+#endif
+
+#ifdef HAVE_MPG123
+#include <mpg123.h>
+#endif
 
 #include <FX88591Codec.h>
 
 
+// Delay of the layer 3 synthesis filter, the same for libmad and mpg123
 #define MAD_DECODER_DELAY 529
 
 namespace ap {
@@ -92,6 +101,7 @@ public:
   };
 
 
+#ifdef HAVE_MAD
 class MadDecoder : public DecoderPlugin {
 protected:
   MemoryBuffer buffer;
@@ -103,8 +113,6 @@ protected:
 protected:
   FXuchar flags = 0;
   FXlong  stream_position = 0;
-  FXshort stream_offset_start = 0;
-  FXshort stream_offset_end = 0;
   FXint   frame_counter = 0;
 
 protected:
@@ -119,6 +127,33 @@ public:
   FXbool flush(FXlong) override;
   virtual ~MadDecoder();
   };
+#endif
+
+
+#ifdef HAVE_MPG123
+class Mpg123Decoder : public DecoderPlugin {
+protected:
+  MemoryBuffer   buffer;
+  Packet       * out = nullptr;
+  mpg123_handle* handle = nullptr;
+protected:
+  FXlong  stream_position = 0;
+  FXlong  stream_end = -1;
+  FXlong  input_position = -1;
+  FXbool  floatoutput = false;
+protected:
+  FXbool open();
+  void feed(FXbool eos);
+  FXbool write(const FXuchar * data,FXint nframes,FXlong stream_length);
+public:
+  Mpg123Decoder(DecoderContext*);
+  FXuchar codec() const override { return Codec::MPEG; }
+  FXbool init(ConfigureEvent*) override;
+  FXbool process(Packet*) override;
+  FXbool flush(FXlong) override;
+  virtual ~Mpg123Decoder();
+  };
+#endif
 
 
 
@@ -1215,7 +1250,15 @@ ReadStatus MadReader::process(Packet*packet) {
             }
           }
         }
-      if (buffer[0]==0 && buffer[1]==0 && buffer[2]==0 && buffer[3]==0) {
+      const FXuchar * span;
+      FXival nspan = 65536;
+      if (buffer[1]!=0xff && buffer[2]!=0xff && buffer[3]!=0xff && (span=input->span(nspan))!=nullptr) {
+        // Skip straight to the next sync candidate when the input is mapped
+        const FXuchar * next = static_cast<const FXuchar*>(memchr(span,0xff,nspan));
+        input->position(next ? next-span : nspan,FXIO::Current);
+        if (input->read(buffer,4)!=4) goto error_or_eos;
+        }
+      else if (buffer[0]==0 && buffer[1]==0 && buffer[2]==0 && buffer[3]==0) {
         if (input->read(buffer,4)!=4) goto error_or_eos;
         }
       else {
@@ -1248,6 +1291,8 @@ done:
   }
 
 
+#ifdef HAVE_MAD
+
 MadDecoder::MadDecoder(DecoderContext *e) : DecoderPlugin(e), buffer(MAD_BUFFER_MDLEN),flags(0) {
   out=nullptr;
   }
@@ -1303,102 +1348,12 @@ FXbool MadDecoder::init(ConfigureEvent* event){
   return true;
   }
 
-#include <limits.h>
-
-#ifdef MAD_FLOAT_OUTPUT
-static FXfloat madfixed_to_float(mad_fixed_t fixed) {
-//mad_f_todouble
-static FXfloat m = exp2f(-MAD_F_FRACBITS);
-/*
-  FXfloat r1,r2,r3,r4;
-  FXlong s1,s2,s3,s4,e1,e2,e3,e4;
-
-
-  s1 = fxgetticks();
-  r1=  (float) ((fixed) / (float) (1L << MAD_F_FRACBITS));
-  e1 = fxgetticks();
-
-
-  s2 = fxgetticks();
-  r2=  (float) ((fixed) * exp2f(-MAD_F_FRACBITS));
-  e2 = fxgetticks();
-
-  s3 = fxgetticks();
-  r3=  (float) ((fixed) * powf(2,-MAD_F_FRACBITS));
-  e3 = fxgetticks();
-
-  s4 = fxgetticks();
-  r4=  (float) ((fixed) * m);
-  e4 = fxgetticks();
-
-
-  fxmessage("%ld %ld %ld %ld\n",e1-s1,e2-s2,e3-s3,e4-s4);
-*/
-  return  (float) ((fixed) * m);
-
-//((x) * (double) (1L << MAD_F_FRACBITS) + 0.5))
-//  return ((FXfloat)fixed) * (exp2(-MAD_F_FRACBITS));
-  }
-
-#else
-static FXshort madfixed_to_s16(mad_fixed_t Fixed)
-{
-  /* A fixed point number is formed of the following bit pattern:
-   *
-   * SWWWFFFFFFFFFFFFFFFFFFFFFFFFFFFF
-   * MSB                          LSB
-   * S ==> Sign (0 is positive, 1 is negative)
-   * W ==> Whole part bits
-   * F ==> Fractional part bits
-   *
-   * This pattern contains MAD_F_FRACBITS fractional bits, one
-   * should alway use this macro when working on the bits of a fixed
-   * point number. It is not guaranteed to be constant over the
-   * different platforms supported by libmad.
-   *
-   * The signed short value is formed, after clipping, by the least
-   * significant whole part bit, followed by the 15 most significant
-   * fractional part bits. Warning: this is a quick and dirty way to
-   * compute the 16-bit number, madplay includes much better
-   * algorithms.
-   */
-
-
-
-
-  /* round */
-  Fixed += (1L << (MAD_F_FRACBITS - 16));
-
-  /* clip */
-  if (Fixed >= MAD_F_ONE)
-    Fixed = MAD_F_ONE - 1;
-  else if (Fixed < -MAD_F_ONE)
-    Fixed = -MAD_F_ONE;
-
-  /* quantize */
-  return Fixed >> (MAD_F_FRACBITS + 1 - 16);
-
-#if 0
-  /* Clipping */
-  if(Fixed>=MAD_F_ONE)
-    return(SHRT_MAX);
-  if(Fixed<=-MAD_F_ONE)
-    return(-SHRT_MAX);
-
-  /* Conversion. */
-  Fixed=Fixed>>(MAD_F_FRACBITS-15);
-  return((FXshort)Fixed);
-#endif
-}
-#endif
-
-
 
 
 FXbool MadDecoder::process(Packet*in){
   FXASSERT(in);
 
-  FXint p,s,n;
+  FXint n;
   FXint max_samples=0;  // maximum number of samples to writr
   FXint max_frames=0;   // maximum frames to decode
   FXint total_frames=0; // frames in buffer
@@ -1446,7 +1401,7 @@ FXbool MadDecoder::process(Packet*in){
 
   // Adjust for end of stream
   if (eos) {
-    GM_DEBUG_PRINT("[mad_decoder] stream offset end %hd. max_samples from %d to %d\n",stream_offset_end,max_samples,max_samples-stream_offset_end);
+    GM_DEBUG_PRINT("[mad_decoder] stream offset end %d. max_samples from %d to %d\n",stream_offset_end,max_samples,max_samples-stream_offset_end);
     max_frames=total_frames;
     max_samples-=stream_offset_end;
     }
@@ -1486,12 +1441,10 @@ FXbool MadDecoder::process(Packet*in){
     // Prevent from writing to many samples..
     nframes=FXMIN(synth.pcm.length,max_samples);
 
-    FXlong stream_begin = FXMAX(stream_offset_start,stream_decode_offset);
-
     // Adjust for beginning of stream
-    if (stream_position<stream_begin) {
-      FXlong offset = FXMIN(nframes,(stream_begin - stream_position));
-      GM_DEBUG_PRINT("[mad_decoder] stream offset start %ld. Skip %ld at %ld\n",stream_begin,offset,stream_position);
+    const FXint offset = trim_begin(stream_position,nframes);
+    if (offset) {
+      GM_DEBUG_PRINT("[mad_decoder] Skip %d at %ld\n",offset,stream_position);
       nframes-=offset;
       left+=offset;
       right+=offset;
@@ -1512,33 +1465,14 @@ FXbool MadDecoder::process(Packet*in){
 
       n = FXMIN(out->availableFrames(),nframes);
 
+      const FXint * const planes[2] = {left,right};
 #ifdef MAD_FLOAT_OUTPUT
-      FXfloat * flt = out->flt();
-      if (synth.pcm.channels==2) {
-        for (p=0,s=0;s<n;s++) {
-          flt[p++] = madfixed_to_float(*left++);
-          flt[p++] = madfixed_to_float(*right++);
-          }
-        }
-      else {
-        for (p=0,s=0;s<n;s++) {
-          flt[p++] = madfixed_to_float(*left++);
-          }
-        }
+      interleave_fixed_to_float(planes,synth.pcm.channels,0,n,MAD_F_FRACBITS,out->flt());
 #else
-      FXshort * buf16 = out->s16();
-      if (synth.pcm.channels==2) {
-        for (p=0,s=0;s<n;s++) {
-          buf16[p++] = madfixed_to_s16(*left++);
-          buf16[p++] = madfixed_to_s16(*right++);
-          }
-        }
-      else {
-        for (p=0,s=0;s<n;s++) {
-          buf16[p++] = madfixed_to_s16(*left++);
-          }
-        }
+      interleave_s16(planes,synth.pcm.channels,0,n,MAD_F_FRACBITS-15,out->s16());
 #endif
+      left+=n;
+      right+=n;
       nframes-=n;
       out->wroteFrames(n);
       stream_position+=n;
@@ -1578,13 +1512,244 @@ FXbool MadDecoder::flush(FXlong offset){
   }
 
 
+#endif
+
+
+#ifdef HAVE_MPG123
+
+/*
+  mpg123 decodes straight to float. Like libmad it gets the raw frames from
+  MadReader, so the Xing/Lame frame is never seen and mpg123's own gapless
+  handling is turned off. Frames are only fed once we know they're not part
+  of the end padding, everything else is trimmed on the output side.
+*/
+
+Mpg123Decoder::Mpg123Decoder(DecoderContext * e) : DecoderPlugin(e) {
+  }
+
+Mpg123Decoder::~Mpg123Decoder() {
+  if (out) {
+    out->unref();
+    out=nullptr;
+    }
+  if (handle) {
+    mpg123_delete(handle);
+    handle=nullptr;
+    }
+  }
+
+
+FXbool Mpg123Decoder::open() {
+  const long * rates;
+  const int  * encodings;
+  size_t       nrates,nencodings;
+  int          error;
+
+#if MPG123_API_VERSION < 46
+  static FXbool initialized = false;
+  if (!initialized) {
+    mpg123_init();
+    initialized=true;
+    }
+#endif
+
+  handle = mpg123_new(nullptr,&error);
+  if (handle==nullptr) {
+    GM_DEBUG_PRINT("[mpg123] %s\n",mpg123_plain_strerror(error));
+    return false;
+    }
+
+  mpg123_param(handle,MPG123_REMOVE_FLAGS,MPG123_GAPLESS,0.0);
+  mpg123_param(handle,MPG123_ADD_FLAGS,MPG123_QUIET,0.0);
+
+  // Float unless mpg123 was build for fixed point only
+  floatoutput=false;
+  mpg123_encodings(&encodings,&nencodings);
+  for (size_t i=0;i<nencodings;i++) {
+    if (encodings[i]==MPG123_ENC_FLOAT_32) floatoutput=true;
+    }
+
+  mpg123_format_none(handle);
+  mpg123_rates(&rates,&nrates);
+  for (size_t i=0;i<nrates;i++) {
+    mpg123_format(handle,rates[i],MPG123_MONO|MPG123_STEREO,floatoutput ? MPG123_ENC_FLOAT_32 : MPG123_ENC_SIGNED_16);
+    }
+
+  if (mpg123_open_feed(handle)!=MPG123_OK) {
+    GM_DEBUG_PRINT("[mpg123] %s\n",mpg123_strerror(handle));
+    mpg123_delete(handle);
+    handle=nullptr;
+    return false;
+    }
+  return true;
+  }
+
+
+FXbool Mpg123Decoder::init(ConfigureEvent * event) {
+  DecoderPlugin::init(event);
+
+  if (handle==nullptr && !open())
+    return false;
+
+  // Pass decoder output format back to OutputThread.
+  af.set(floatoutput ? AP_FORMAT_FLOAT : AP_FORMAT_S16,event->af.rate,event->af.channels);
+  event->af=af;
+
+  // offset should include decoder delay
+  stream_offset_start = MAD_DECODER_DELAY + event->stream_offset_start;
+  stream_offset_end   = FXMAX(0,event->stream_offset_end - MAD_DECODER_DELAY);
+  return flush(0);
+  }
+
+
+FXbool Mpg123Decoder::flush(FXlong offset) {
+  DecoderPlugin::flush(offset);
+  if (out) {
+    out->unref();
+    out=nullptr;
+    }
+  buffer.clear();
+  input_position=-1;
+  stream_end=-1;
+  return handle && mpg123_open_feed(handle)==MPG123_OK;
+  }
+
+
+// Feed whole frames, but hold back the ones that may hold end padding until the end of stream
+void Mpg123Decoder::feed(FXbool eos) {
+  const FXuchar * beg = buffer.data();
+  const FXuchar * end = beg + buffer.size();
+  const FXuchar * ptr = beg;
+  FXint nbuffered = 0;
+  mpeg_frame frame;
+
+  for (const FXuchar * p=beg;p+4<=end && frame.validate(p) && p+frame.size()<=end;p+=frame.size())
+    nbuffered+=frame.nsamples();
+
+  if (eos) {
+    input_position+=nbuffered;
+    stream_end=input_position-stream_offset_end;
+    ptr=end;
+    }
+  else {
+    while(ptr+4<=end && frame.validate(ptr) && ptr+frame.size()<=end && nbuffered-frame.nsamples()>=stream_offset_end) {
+      nbuffered-=frame.nsamples();
+      input_position+=frame.nsamples();
+      ptr+=frame.size();
+      }
+    // Lost sync, let mpg123 deal with it
+    if (ptr+4<=end && !frame.validate(ptr))
+      ptr=end;
+    }
+
+  if (ptr>beg) {
+    mpg123_feed(handle,beg,ptr-beg);
+    buffer.readBytes(ptr-beg);
+    }
+  }
+
+
+FXbool Mpg123Decoder::write(const FXuchar * data,FXint nframes,FXlong stream_length) {
+  FXint n;
+
+  // Skip decoder delay and start padding, or up to the seek position
+  n = trim_begin(stream_position,nframes);
+  data+=n*af.framesize();
+  nframes-=n;
+  stream_position+=n;
+
+  // Drop end padding
+  nframes = trim_end(stream_position,nframes,stream_end);
+
+  while(nframes>0) {
+
+    // Get new buffer
+    if (out==nullptr) {
+      out = context->get_output_packet();
+      if (out==nullptr) return false;
+      out->af=af;
+      out->stream_position=stream_position-stream_offset_start;
+      out->stream_length=stream_length-stream_offset_start-stream_offset_end;
+      }
+
+    n = FXMIN(out->availableFrames(),nframes);
+    out->appendFrames(data,n);
+    data+=n*af.framesize();
+    nframes-=n;
+    stream_position+=n;
+
+    if (out->availableFrames()==0) {
+      context->post_output_packet(out);
+      }
+    }
+  return true;
+  }
+
+
+FXbool Mpg123Decoder::process(Packet * in) {
+  const FXbool eos           = (in->flags&FLAG_EOS);
+  const FXlong stream_length = in->stream_length;
+  unsigned char * data;
+  size_t          nbytes;
+  off_t           num;
+  long            rate;
+  int             channels,encoding;
+  int             result;
+
+  if (handle==nullptr) {
+    in->unref();
+    return false;
+    }
+
+  if (input_position<0) {
+    input_position=stream_position=in->stream_position;
+    }
+
+  buffer.append(in->data(),in->size());
+  in->unref();
+
+  feed(eos);
+
+  while((result=mpg123_decode_frame(handle,&num,&data,&nbytes))!=MPG123_NEED_MORE) {
+    if (result==MPG123_NEW_FORMAT) {
+      mpg123_getformat(handle,&rate,&channels,&encoding);
+      if (rate!=(long)af.rate || channels!=af.channels) {
+        GM_DEBUG_PRINT("[mpg123] format changed: %ld/%d -> %u/%u ???\n",rate,channels,af.rate,af.channels);
+        }
+      continue;
+      }
+    if (result!=MPG123_OK) {
+      GM_DEBUG_PRINT("[mpg123] %s\n",mpg123_strerror(handle));
+      return false;
+      }
+    if (!write(data,nbytes/af.framesize(),stream_length))
+      return true;
+    }
+
+  if (eos) {
+    context->post_output_packet(out,true);
+    }
+  return true;
+  }
+
+#endif
+
 
 ReaderPlugin * ap_mad_reader(InputContext * ctx) {
   return new MadReader(ctx);
   }
 
-DecoderPlugin * ap_mad_decoder(DecoderContext * ctx) {
+// Prefer libmad, unless GOGGLESMM_MPEG_DECODER=mpg123
+DecoderPlugin * ap_mpeg_decoder(DecoderContext * ctx) {
+#if defined(HAVE_MAD) && defined(HAVE_MPG123)
+  if (ap_get_environment("GOGGLESMM_MPEG_DECODER")=="mpg123")
+    return new Mpg123Decoder(ctx);
+#endif
+#ifdef HAVE_MAD
   return new MadDecoder(ctx);
+#else
+  return new Mpg123Decoder(ctx);
+#endif
   }
 
 }
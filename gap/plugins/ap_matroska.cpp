@@ -953,7 +953,7 @@ FXbool MatroskaReader::parse_track_entry(Element & container) {
               break;
               }
 
-#ifdef HAVE_MAD
+#if defined(HAVE_MAD) || defined(HAVE_MPG123)
             if (FXString::comparecase(codec,"A_MPEG/L3")==0) {
               track->codec      = Codec::MPEG;
               track->af.format |= (Format::Signed|Format::Little);
@@ -53,6 +53,9 @@ public:
   FXuint                  fixed_sample_size = 0;        // used if all samples have the same size
   FXushort                samples_per_frame = 0;        // number of pcm samples in a frame (used by AAC)
   FXbool                  upsampled = false;
+  FXuint                  timescale = 0;                // media timescale
+  FXlong                  edit_start = -1;              // media time of the first edit (encoder delay)
+  FXlong                  edit_duration = 0;            // duration of the first edit in movie timescale
   DecoderSpecificConfig * dc = nullptr;
   FXArray<FXuint>         stsz;                         // samples size lookup table (in bytes)
   FXArray<FXuint>         stco;                         // chunk offset table
@@ -196,6 +199,7 @@ protected:
   MetaInfo*          meta = nullptr;
   FXushort           padstart = 0;
   FXushort           padend = 0;
+  FXuint             timescale = 0;
   FXlong             framesize = 0;
 protected:
   FXuint read_descriptor_length(FXuint&);
@@ -209,6 +213,9 @@ protected:
   FXbool atom_parse_stts(FXlong size);
   FXbool atom_parse_stsz(FXlong size);
   FXbool atom_parse_ctts(FXlong size);
+  FXbool atom_parse_mvhd(FXlong size);
+  FXbool atom_parse_mdhd(FXlong size);
+  FXbool atom_parse_elst(FXlong size);
   FXbool atom_parse_trak(FXlong size);
   //FXbool atom_parse_freeform(FXlong size);
   //FXbool atom_parse_text(FXlong size,FXString & value);
@@ -273,6 +280,7 @@ FXbool MP4Reader::init(InputPlugin*plugin) {
     }
   padstart=0;
   padend=0;
+  timescale=0;
   return true;
   }
 
@@ -428,6 +436,18 @@ ReadStatus MP4Reader::parse() {
     GM_DEBUG_PRINT("[mp4] padding %hu %hu\n",padstart,padend);
     GM_DEBUG_PRINT("[mp4] composition offset %d\n",track->getCompositionOffset(0));
 
+    // Without iTunSMPB, get encoder delay and padding from the edit list
+    if (padstart==0 && padend==0 && track->edit_start>0 && track->edit_duration>0 && track->timescale && timescale) {
+      const FXlong length   = track->upsampled ? (stream_length>>1) : stream_length;
+      const FXlong duration = (track->edit_duration*track->timescale)/timescale;
+      const FXlong padding  = length - track->edit_start - duration;
+      if (track->edit_start<=0xffff && padding>=0 && padding<=0xffff) {
+        padstart = track->edit_start;
+        padend   = padding;
+        GM_DEBUG_PRINT("[mp4] padding from edit list %hu %hu\n",padstart,padend);
+        }
+      }
+
     if (track->codec == Codec::AAC) {
 
       if (track->upsampled) {
@@ -444,7 +464,11 @@ ReadStatus MP4Reader::parse() {
         stream_length -= track->samples_per_frame;
         }
       cfg->stream_offset_start = FXMAX(0, padstart - track->samples_per_frame);
-      GM_DEBUG_PRINT("[mp4] stream_offset_start %hu\n",cfg->stream_offset_start);
+      GM_DEBUG_PRINT("[mp4] stream_offset_start %d\n",cfg->stream_offset_start);
+      }
+    else if (track->codec == Codec::ALAC) {
+      stream_length -= padend;
+      cfg->stream_offset_start = padstart;
       }
 
     GM_DEBUG_STREAM_LENGTH("mp4",stream_length-cfg->stream_offset_start,track->af.rate);
@@ -501,6 +525,9 @@ enum Atom {
   STTS = DEFINE_ATOM('s','t','t','s'),
   CTTS = DEFINE_ATOM('c','t','t','s'),
 
+  EDTS = DEFINE_ATOM('e','d','t','s'),
+  ELST = DEFINE_ATOM('e','l','s','t'),
+
   TRAK = DEFINE_ATOM('t','r','a','k'),
   UDTA = DEFINE_ATOM('u','d','t','a'),
   MP4A = DEFINE_ATOM('m','p','4','a'),
@@ -1061,6 +1088,103 @@ FXbool MP4Reader::atom_parse_ctts(FXlong /*size*/) {
 
 
 
+// Movie timescale, used by edit lists
+FXbool MP4Reader::atom_parse_mvhd(FXlong size) {
+  FXlong start = input->position();
+  FXuint version;
+
+  if (!input->read_uint32_be(version))
+    return false;
+
+  input->position((version>>24)==1 ? 16 : 8,FXIO::Current);
+
+  if (!input->read_uint32_be(timescale))
+    return false;
+
+  input->position(start+size,FXIO::Begin);
+  return true;
+  }
+
+
+// Media timescale of the track
+FXbool MP4Reader::atom_parse_mdhd(FXlong size) {
+  FXlong start = input->position();
+  FXuint version;
+
+  if (track==nullptr)
+    return false;
+
+  if (!input->read_uint32_be(version))
+    return false;
+
+  input->position((version>>24)==1 ? 16 : 8,FXIO::Current);
+
+  if (!input->read_uint32_be(track->timescale))
+    return false;
+
+  input->position(start+size,FXIO::Begin);
+  return true;
+  }
+
+
+// Edit list. Gapless encoders write a single edit skipping the encoder delay.
+FXbool MP4Reader::atom_parse_elst(FXlong size) {
+  FXlong start = input->position();
+  FXuint version;
+  FXuint nentries;
+  FXlong duration;
+  FXlong media_time;
+  FXuint rate;
+  FXint  nedits = 0;
+
+  if (track==nullptr)
+    return false;
+
+  if (!input->read_uint32_be(version))
+    return false;
+
+  if (!input->read_uint32_be(nentries))
+    return false;
+
+  for (FXuint i=0;i<nentries;i++) {
+    if ((version>>24)==1) {
+      if (!input->read_int64_be(duration) || !input->read_int64_be(media_time))
+        return false;
+      }
+    else {
+      FXuint d;
+      FXint  t;
+      if (!input->read_uint32_be(d) || !input->read_int32_be(t))
+        return false;
+      duration   = d;
+      media_time = t;
+      }
+    if (!input->read_uint32_be(rate))
+      return false;
+
+    // Skip empty edits
+    if (media_time==-1)
+      continue;
+
+    if (nedits++==0) {
+      track->edit_start    = media_time;
+      track->edit_duration = duration;
+      }
+    }
+
+  // Not a gapless edit
+  if (nedits>1) {
+    track->edit_start    = -1;
+    track->edit_duration = 0;
+    }
+
+  GM_DEBUG_PRINT("[mp4] edit list start %ld duration %ld\n",track->edit_start,track->edit_duration);
+  input->position(start+size,FXIO::Begin);
+  return true;
+  }
+
+
+
 FXbool MP4Reader::atom_parse_stsz(FXlong /*size*/) {
   FXuint version;
   FXuint samplecount;
@@ -1131,6 +1255,7 @@ FXbool MP4Reader::atom_parse(FXlong size) {
       case TRAK: ok=atom_parse_trak(atom_size);
                  if(!ok) return false;
                  // fallthrough - intentionally no break
+      case EDTS:
       case MDIA:
       case MINF:
       case STBL:
@@ -1145,6 +1270,9 @@ FXbool MP4Reader::atom_parse(FXlong size) {
       case STSC: ok=atom_parse_stsc(atom_size); break;
       case STTS: ok=atom_parse_stts(atom_size); break;
       case CTTS: ok=atom_parse_ctts(atom_size); break;
+      case MVHD: ok=atom_parse_mvhd(atom_size); break;
+      case MDHD: ok=atom_parse_mdhd(atom_size); break;
+      case ELST: ok=atom_parse_elst(atom_size); break;
       case MP4A: ok=atom_parse_mp4a(atom_size); break;
       case ALAC: ok=atom_parse_alac(atom_size); break;
       case ESDS: ok=atom_parse_esds(atom_size); break;
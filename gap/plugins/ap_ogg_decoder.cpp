@@ -40,7 +40,6 @@ FXbool OggDecoder::init(ConfigureEvent*event){
   DecoderPlugin::init(event);
   buffer.clear();
   stream_position=-1;
-  stream_offset_start=event->stream_offset_start;
   return true;
   }
 
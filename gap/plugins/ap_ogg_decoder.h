@@ -34,7 +34,6 @@ protected:
   ogg_packet op = {};
   Packet*    out;
   FXlong     stream_position;
-  FXushort   stream_offset_start;
 protected:
   FXbool get_next_packet(Packet*&);
 public:
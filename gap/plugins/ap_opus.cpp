@@ -32,7 +32,6 @@ protected:
   OpusMSDecoder* opus;
   FXfloat      * pcm;
   FXfloat        gain;
-  FXushort       stream_offset_start;
 protected:
   FXbool init_decoder(const FXuchar *,FXuint);
 //  FXbool find_stream_position();
@@ -51,7 +50,7 @@ public:
   };
 
 
-OpusDecoderPlugin::OpusDecoderPlugin(DecoderContext * e) : OggDecoder(e),opus(nullptr),pcm(nullptr),gain(0.0f),stream_offset_start(0) {
+OpusDecoderPlugin::OpusDecoderPlugin(DecoderContext * e) : OggDecoder(e),opus(nullptr),pcm(nullptr),gain(0.0f) {
   }
 
 OpusDecoderPlugin::~OpusDecoderPlugin(){
@@ -153,10 +152,9 @@ FXbool OpusDecoderPlugin::init_decoder(const FXuchar * packet,const FXuint size)
 FXbool OpusDecoderPlugin::process(Packet * packet) {
   OggDecoder::process(packet);
 
-  const FXlong stream_begin  = FXMAX(stream_offset_start,stream_decode_offset);
   const FXlong stream_length = packet->stream_length;
   const FXbool eos           = packet->flags&FLAG_EOS;
-  FXlong stream_end          = stream_length;
+  const FXlong stream_end    = (stream_length>0) ? stream_length + stream_offset_start : -1;
 
   while(get_next_packet(packet)) {
     FXint nsamples = opus_multistream_decode_float(opus,(unsigned char*)op.packet,op.bytes,pcm,MAX_FRAME_SIZE,0);
@@ -169,10 +167,10 @@ FXbool OpusDecoderPlugin::process(Packet * packet) {
         pcm[i]*=gain;
         }
       }
-    // Adjust for beginning of stream
-    if (stream_position<stream_begin) {
-      FXlong offset = FXMIN(nsamples,stream_begin - stream_position);
-      GM_DEBUG_PRINT("[opus] stream offset start %ld. Skip %ld at %ld\n",stream_begin,offset,stream_position);
+    // Adjust for pre-skip or seek position
+    const FXint offset = trim_begin(stream_position,nsamples);
+    if (offset) {
+      GM_DEBUG_PRINT("[opus] Skip %d at %ld\n",offset,stream_position);
       nsamples-=offset;
       pcmi+=(offset*af.framesize());
       stream_position+=offset;
@@ -180,11 +178,7 @@ FXbool OpusDecoderPlugin::process(Packet * packet) {
 
     //GM_DEBUG_PRINT("[opus] decoded %d frames\n",nsamples);
     if (eos) {
-      FXlong total = stream_position-stream_offset_start+nsamples;
-      if (total>stream_end) {
-        GM_DEBUG_PRINT("adjusting end trimming by %ld\n",(total-stream_end));
-        nsamples -= (total-stream_end);
-        }
+      nsamples = trim_end(stream_position,nsamples,stream_end);
       }
 
     while(nsamples>0) {
@@ -45,7 +45,12 @@ protected:
   pa_context     * pulse_context = nullptr;
   pa_stream      * stream        = nullptr;
   pa_volume_t      pulsevolume   = PA_VOLUME_MUTED;
+  FXuint           buffer_time   = 0;
+  FXuint           period_time   = 0;
+  size_t           nwritable     = 0;       // bytes pulse asked for
+  void *           wrptr         = nullptr; // buffer from pa_stream_begin_write
 protected:
+  static void stream_write_callback(pa_stream*,size_t,void*);
   static void sink_info_callback(pa_context*, const pa_sink_input_info *,int eol,void*);
   static void context_subscribe_callback(pa_context *c,pa_subscription_event_type_t, uint32_t,void*);
 protected:
@@ -59,9 +64,21 @@ public:
   /// Write frames to playback buffer
   FXbool write(const void*, FXuint);
 
+  /// Get buffer from pulse to render into
+  void * begin_write(FXuint & nframes);
+
+  /// Hand rendered buffer to pulse
+  FXbool commit_write(FXuint nframes);
+
   /// Return delay in no. of frames
   FXint delay();
 
+  /// Return negotiated buffer and period size
+  FXbool latency(FXuint & buffer,FXuint & period);
+
+  /// Set Device Configuration
+  FXbool setOutputConfig(const OutputConfig &);
+
   /// Empty Playback Buffer Immediately
   void drop();
 
@@ -407,9 +424,11 @@ static void stream_state_callback(pa_stream *s,void*){
 #endif
 
 
-//static void stream_write_callback(pa_stream*s,size_t,void *){
-//  GM_DEBUG_PRINT("stream_write_callback %d\n",pa_stream_get_state(s));
-//  }
+// Pulse wants more data
+void PulseOutput::stream_write_callback(pa_stream*,size_t nbytes,void * userdata){
+  PulseOutput * out = static_cast<PulseOutput*>(userdata);
+  out->nwritable = nbytes;
+  }
 
 void PulseOutput::sink_info_callback(pa_context*, const pa_sink_input_info * info,int /*eol*/,void*userdata){
   PulseOutput * out = static_cast<PulseOutput*>(userdata);
@@ -494,6 +513,8 @@ void PulseOutput::close() {
 
   if (stream) {
     GM_DEBUG_PRINT("[pulse] disconnecting stream\n");
+    if (wrptr) pa_stream_cancel_write(stream);
+    wrptr=nullptr;
     pa_stream_disconnect(stream);
     pa_stream_unref(stream);
     stream=nullptr;
@@ -544,6 +565,24 @@ FXint PulseOutput::delay() {
   return value;
   }
 
+FXbool PulseOutput::latency(FXuint & buffer,FXuint & period) {
+  if (stream && af.set()) {
+    const pa_buffer_attr * attr = pa_stream_get_buffer_attr(stream);
+    if (attr) {
+      buffer = attr->tlength / af.framesize();
+      period = attr->minreq / af.framesize();
+      return true;
+      }
+    }
+  return false;
+  }
+
+FXbool PulseOutput::setOutputConfig(const OutputConfig & c) {
+  buffer_time = c.bufferTime();
+  period_time = c.periodTime();
+  return true;
+  }
+
 void PulseOutput::drop() {
   if (stream) {
     pa_operation* operation = pa_stream_flush(stream,nullptr,0);
@@ -560,12 +599,18 @@ void PulseOutput::drain() {
     }
   }
 
-void PulseOutput::pause(FXbool) {
+// Cork the stream, so the server can stop waking us up
+void PulseOutput::pause(FXbool p) {
+  if (stream) {
+    pa_operation* operation = pa_stream_cork(stream,p ? 1 : 0,nullptr,nullptr);
+    if (operation) pa_operation_unref(operation);
+    }
   }
 
 FXbool PulseOutput::configure(const AudioFormat & fmt){
   const pa_sample_spec * config=nullptr;
   pa_operation *operation=nullptr;
+  pa_stream_flags flags=pa_stream_flags(PA_STREAM_AUTO_TIMING_UPDATE|PA_STREAM_INTERPOLATE_TIMING);
 
   if (!open())
     return false;
@@ -579,6 +624,9 @@ FXbool PulseOutput::configure(const AudioFormat & fmt){
     stream=nullptr;
     }
 
+  nwritable=0;
+  wrptr=nullptr;
+
   pa_sample_spec spec;
   pa_channel_map cmap;
 
@@ -616,6 +664,7 @@ FXbool PulseOutput::configure(const AudioFormat & fmt){
 #ifdef DEBUG
   pa_stream_set_state_callback(stream,stream_state_callback,this);
 #endif
+  pa_stream_set_write_callback(stream,stream_write_callback,this);
 
   // Set to recommended values according to PulseAudio docs
   pa_buffer_attr buffer_attributes;
@@ -625,7 +674,14 @@ FXbool PulseOutput::configure(const AudioFormat & fmt){
   buffer_attributes.minreq = -1;     // server should initialize this to reasonable default
   buffer_attributes.fragsize = -1;   // server should initialize this to reasonable default
 
-  if (pa_stream_connect_playback(stream,nullptr,&buffer_attributes,pa_stream_flags(PA_STREAM_AUTO_TIMING_UPDATE|PA_STREAM_INTERPOLATE_TIMING),nullptr,nullptr)<0)
+  // Unless the profile asks for something else. With adjust latency, tlength is the end to end latency.
+  if (buffer_time) {
+    buffer_attributes.tlength = pa_usec_to_bytes((pa_usec_t)buffer_time*PA_USEC_PER_MSEC,&spec);
+    buffer_attributes.minreq  = pa_usec_to_bytes((pa_usec_t)period_time*PA_USEC_PER_MSEC,&spec);
+    flags = pa_stream_flags(flags|PA_STREAM_ADJUST_LATENCY);
+    }
+
+  if (pa_stream_connect_playback(stream,nullptr,&buffer_attributes,flags,nullptr,nullptr)<0)
     goto failed;
 
   /// Wait until stream is ready
@@ -656,31 +712,61 @@ failed:
   return false;
   }
 
-FXbool PulseOutput::write(const void * b,FXuint nframes){
+/*
+  Wait until pulse asks for data and let the caller render straight
+  into a pulse memblock. The write callback runs from the reactor and
+  tells us how much pulse wants, so we only ask once we've used that up.
+*/
+void * PulseOutput::begin_write(FXuint & nframes){
   FXASSERT(stream);
-  const FXchar * buffer = reinterpret_cast<const FXchar*>(b);
-  FXuint total = nframes*af.framesize();
-  while(total) {
-
+  FXASSERT(wrptr==nullptr);
+  const size_t framesize = af.framesize();
+  if (nwritable<framesize) {
+    const size_t n = pa_stream_writable_size(stream);
+    if (n!=(size_t)-1) nwritable=n;
+    }
+  while(nwritable<framesize) {
     if (pa_stream_get_state(stream)!=PA_STREAM_READY)
-      return false;
-
-    size_t nbytes = pa_stream_writable_size(stream);
-    size_t n = FXMIN(total,nbytes);
-    if (n==0) {
-      //fxmessage("size %ld\n",nbytes);
-      context->wait_plugin_events();
-      continue;
-      }
-    pa_stream_write(stream,buffer,n,nullptr,0,PA_SEEK_RELATIVE);
-    total-=n;
-    buffer+=n;
+      return nullptr;
+    context->wait_plugin_events();
     }
-  return true;
+  size_t nbytes = FXMIN((size_t)nframes*framesize,nwritable);
+  if (pa_stream_begin_write(stream,&wrptr,&nbytes)<0 || nbytes<framesize) {
+    if (wrptr) pa_stream_cancel_write(stream);
+    wrptr=nullptr;
+    return nullptr;
+    }
+  nframes = nbytes / framesize;
+  return wrptr;
   }
 
 
+FXbool PulseOutput::commit_write(FXuint nframes){
+  FXASSERT(wrptr);
+  const size_t nbytes = (size_t)nframes*af.framesize();
+  const int result = pa_stream_write(stream,wrptr,nbytes,nullptr,0,PA_SEEK_RELATIVE);
+  wrptr=nullptr;
+  nwritable-=FXMIN(nbytes,nwritable);
+  return result==0;
+  }
+
 
+FXbool PulseOutput::write(const void * b,FXuint nframes){
+  const FXuchar * buffer = reinterpret_cast<const FXuchar*>(b);
+  const FXuint framesize = af.framesize();
+  while(nframes) {
+    FXuint n = nframes;
+    void * data = begin_write(n);
+    if (data==nullptr)
+      return false;
+    memcpy(data,buffer,n*framesize);
+    if (!commit_write(n))
+      return false;
+    buffer+=n*framesize;
+    nframes-=n;
+    }
+  return true;
+  }
 
 }
 
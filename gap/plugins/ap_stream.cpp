@@ -0,0 +1,841 @@
+/*******************************************************************************
+*                         Goggles Audio Player Library                         *
+********************************************************************************
+*           Copyright (C) 2010-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+
+// Building a plugin
+#define GAP_PLUGIN 1
+
+#include "ap_defs.h"
+#include "ap_output_plugin.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#ifdef HAVE_FLAC
+#include <FLAC/stream_encoder.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace ap;
+
+/*
+  Serves the playback as a http stream to any number of clients.
+
+  - Audio is encoded once into blocks, which are kept in a ring shared by
+    all clients. Each block is stored as a complete http chunk, so clients
+    send straight from the block, at their own pace. Clients speaking
+    http/1.0 skip the chunk framing.
+
+  - Blocks are reference counted. The ring holds one reference and each
+    client sending a block holds another, so a block outlives the ring as
+    long as someone is still sending it.
+
+  - A client that falls more than the whole ring behind is disconnected.
+
+  - There's no sound card to pace us, so writes run on the clock, at most
+    the profile buffer time ahead. New clients start at the block being
+    played right now, and get the part that's ahead as a burst.
+
+  - Everything runs on the reactor of the output thread, so nothing locks.
+*/
+
+namespace ap {
+
+class StreamOutput;
+
+
+struct StreamBlock {
+  FXuchar * data    = nullptr;
+  FXuint    size    = 0;      // bytes of payload
+  FXuint    nframes = 0;      // frames in payload
+  FXlong    frame   = 0;      // first frame in payload
+  FXint     refs    = 1;
+
+  enum {
+    Header  = 10,             // "%08x\r\n"
+    Trailer = 2               // "\r\n"
+    };
+
+  StreamBlock(FXuint n) {
+    allocElms(data,Header+n+Trailer);
+    }
+
+  FXuchar * payload() { return data+Header; }
+
+  // Write the chunk framing around the payload
+  void frame_chunk() {
+    static const FXchar hex[]="0123456789abcdef";
+    for (FXint i=0;i<8;i++) data[i]=hex[(size>>(28-4*i))&0xf];
+    data[8]='\r';
+    data[9]='\n';
+    data[Header+size]='\r';
+    data[Header+size+1]='\n';
+    }
+
+  StreamBlock * ref() { refs++; return this; }
+
+  void unref() { if (--refs==0) delete this; }
+
+  ~StreamBlock() { freeElms(data); }
+  };
+
+
+class StreamClient : public Reactor::Input {
+public:
+  enum {
+    Request,                            // Reading request
+    Streaming,                          // Sending stream
+    Closing                             // Close once header is send
+    };
+public:
+  StreamOutput * output;
+  FXString       request;               // request received so far
+  FXString       header;                // response and stream header
+  FXint          hpos    = 0;           // bytes of header send
+  StreamBlock *  block   = nullptr;     // block being send
+  FXuint         bpos    = 0;           // bytes of block send
+  FXuint         bend    = 0;           // end of block
+  FXlong         next    = 0;           // sequence number of next block
+  FXbool         chunked = true;        // use chunked transfer
+  FXuchar        state   = Request;
+public:
+  StreamClient(StreamOutput * o,FXInputHandle h) : Reactor::Input(h,Readable|Exception), output(o) {}
+  void onSignal() override;
+  ~StreamClient() {
+    if (block) block->unref();
+    ::close(handle);
+    }
+  };
+
+
+class StreamListener : public Reactor::Input {
+public:
+  StreamOutput * output;
+public:
+  StreamListener(StreamOutput * o,FXInputHandle h) : Reactor::Input(h,Readable), output(o) {}
+  void onSignal() override;
+  ~StreamListener() {
+    ::close(handle);
+    }
+  };
+
+
+class StreamOutput : public OutputPlugin {
+  friend class StreamClient;
+  friend class StreamListener;
+protected:
+  enum {
+    NBLOCKS = 128,                          // blocks in ring
+    };
+protected:
+  StreamConfig               config;
+  FXuint                     buffertime  = 500;       // ms to run ahead of the clock
+  StreamListener *           listener    = nullptr;
+  FXPtrListOf<StreamClient>  clients;
+  StreamBlock *              ring[NBLOCKS];
+  FXlong                     head        = 0;         // sequence number of next block
+  StreamBlock *              pending     = nullptr;   // block handed out by begin_write
+  FXString                   header;                  // stream header
+  const FXchar *             mimetype    = nullptr;
+  Reactor::Timer             timer;
+  FXTime                     starttime   = 0;         // clock start
+  FXTime                     pausetime   = 0;         // clock stopped
+  FXlong                     startframe  = 0;         // frame at clock start
+  FXlong                     written     = 0;         // frames written
+#ifdef HAVE_FLAC
+  FLAC__StreamEncoder *      encoder     = nullptr;
+  FXint *                    samples     = nullptr;   // encoder input
+  FXuint                     nsamples    = 0;
+  FXlong                     encoded     = 0;         // frames encoded
+protected:
+  static FLAC__StreamEncoderWriteStatus flac_encoder_write(const FLAC__StreamEncoder*,const FLAC__byte*,size_t,unsigned,unsigned,void*);
+  FXbool flac_configure(const AudioFormat &);
+  FXbool flac_encode(const FXuchar*,FXuint);
+  void flac_close();
+#endif
+protected:
+  FXbool listen();
+  void accept();
+  FXbool respond(StreamClient*);
+  FXbool send(StreamClient*);
+  FXbool read(StreamClient*);
+  void remove(StreamClient*);
+  void push(StreamBlock*);
+  void reset();
+  FXlong position() const;
+  FXuint blockframes() const;
+  void wait(FXlong ahead);
+  void sync();
+  FXbool wav_configure(const AudioFormat &);
+public:
+  StreamOutput(OutputContext * ctx);
+
+  FXchar type() const override { return DeviceStream; }
+
+  FXbool setOutputConfig(const OutputConfig &) override;
+
+  FXbool configure(const AudioFormat &) override;
+
+  FXbool write(const void*, FXuint) override;
+
+  void * begin_write(FXuint & nframes) override;
+
+  FXbool commit_write(FXuint nframes) override;
+
+  FXint delay() override;
+
+  FXbool latency(FXuint & buffer,FXuint & period) override;
+
+  void drop() override;
+
+  void drain() override;
+
+  void pause(FXbool) override;
+
+  void close() override;
+
+  virtual ~StreamOutput();
+  };
+
+
+
+void StreamListener::onSignal() {
+  if (mode&IsReadable)
+    output->accept();
+  }
+
+
+void StreamClient::onSignal() {
+  if (mode&IsException) {
+    output->remove(this);
+    return;
+    }
+  if ((mode&IsReadable) && !output->read(this)) {
+    return;
+    }
+  if (mode&IsWritable) {
+    if (!output->send(this))
+      output->remove(this);
+    }
+  }
+
+
+
+StreamOutput::StreamOutput(OutputContext * ctx) : OutputPlugin(ctx) {
+  for (FXint i=0;i<NBLOCKS;i++) ring[i]=nullptr;
+  }
+
+StreamOutput::~StreamOutput() {
+  close();
+  }
+
+
+FXbool StreamOutput::setOutputConfig(const OutputConfig & c) {
+  config=c.stream;
+  buffertime=c.bufferTime() ? c.bufferTime() : 500;
+  return true;
+  }
+
+
+// Listen on all interfaces, ipv4 and ipv6 where possible
+FXbool StreamOutput::listen() {
+  const int on = 1;
+  FXInputHandle fd = ::socket(AF_INET6,SOCK_STREAM,0);
+  if (fd!=BadHandle) {
+    struct sockaddr_in6 addr;
+    const int off = 0;
+    memset(&addr,0,sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr   = in6addr_any;
+    addr.sin6_port   = htons(config.port);
+    setsockopt(fd,IPPROTO_IPV6,IPV6_V6ONLY,&off,sizeof(off));
+    setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+    if (::bind(fd,(struct sockaddr*)&addr,sizeof(addr))<0) {
+      ::close(fd);
+      fd=BadHandle;
+      }
+    }
+  if (fd==BadHandle) {
+    struct sockaddr_in addr;
+    fd = ::socket(AF_INET,SOCK_STREAM,0);
+    if (fd==BadHandle) {
+      GM_DEBUG_PRINT("[stream] unable to create socket: %s\n",strerror(errno));
+      return false;
+      }
+    memset(&addr,0,sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(config.port);
+    setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+    if (::bind(fd,(struct sockaddr*)&addr,sizeof(addr))<0) {
+      GM_DEBUG_PRINT("[stream] unable to bind port %u: %s\n",config.port,strerror(errno));
+      ::close(fd);
+      return false;
+      }
+    }
+  fcntl(fd,F_SETFD,FD_CLOEXEC);
+  fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+  if (::listen(fd,16)<0) {
+    GM_DEBUG_PRINT("[stream] unable to listen: %s\n",strerror(errno));
+    ::close(fd);
+    return false;
+    }
+  GM_DEBUG_PRINT("[stream] listening on port %u\n",config.port);
+  listener = new StreamListener(this,fd);
+  context->getReactor().addInput(listener);
+  return true;
+  }
+
+
+// Keep the kernel from buffering megabytes for slow clients, so the ring notices them
+void StreamOutput::accept() {
+  const int sndbuf = 131072;
+  FXInputHandle fd;
+  while((fd=::accept(listener->handle,nullptr,nullptr))!=BadHandle) {
+    fcntl(fd,F_SETFD,FD_CLOEXEC);
+    fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+    setsockopt(fd,SOL_SOCKET,SO_SNDBUF,&sndbuf,sizeof(sndbuf));
+    StreamClient * client = new StreamClient(this,fd);
+    clients.append(client);
+    context->getReactor().addInput(client);
+    GM_DEBUG_PRINT("[stream] client connected (%ld)\n",clients.no());
+    }
+  }
+
+
+void StreamOutput::remove(StreamClient * client) {
+  GM_DEBUG_PRINT("[stream] client disconnected\n");
+  context->getReactor().removeInput(client);
+  clients.remove(client);
+  delete client;
+  }
+
+
+// Read from client. Returns false if the client was removed.
+FXbool StreamOutput::read(StreamClient * client) {
+  FXchar buffer[1024];
+  FXival n = ::recv(client->handle,buffer,sizeof(buffer),0);
+  if (n<0 && (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR))
+    return true;
+
+  if (n<=0 || (client->state==StreamClient::Request && client->request.length()>8192)) {
+    remove(client);
+    return false;
+    }
+
+  // Anything send after the request is ignored
+  if (client->state==StreamClient::Request) {
+    client->request.append(buffer,n);
+    if (client->request.find("\r\n\r\n")>=0)
+      return respond(client);
+    }
+  return true;
+  }
+
+
+// Send response. Returns false if the client was removed.
+FXbool StreamOutput::respond(StreamClient * client) {
+  const FXString line    = client->request.before('\r');
+  const FXString method  = line.section(' ',0);
+  const FXString version = line.section(' ',2);
+
+  client->chunked = (version!="HTTP/1.0");
+  client->request.clear();
+
+  if (method!="GET" && method!="HEAD") {
+    client->header = "HTTP/1.1 405 Method Not Allowed\r\n"
+                     "Allow: GET, HEAD\r\n"
+                     "Content-Length: 0\r\n"
+                     "Connection: close\r\n\r\n";
+    client->state = StreamClient::Closing;
+    }
+  else {
+    client->header.format("%s 200 OK\r\n"
+                          "Content-Type: %s\r\n"
+                          "%s"
+                          "Cache-Control: no-cache, no-store\r\n"
+                          "Connection: close\r\n\r\n",client->chunked ? "HTTP/1.1" : "HTTP/1.0",mimetype,client->chunked ? "Transfer-Encoding: chunked\r\n" : "");
+    if (method=="HEAD") {
+      client->state = StreamClient::Closing;
+      }
+    else {
+      if (client->chunked)
+        client->header += FXString::value("%x\r\n",header.length()) + header + "\r\n";
+      else
+        client->header += header;
+
+      // Start at the block being played right now
+      const FXlong now = position();
+      client->next = FXMAX(0,head-NBLOCKS);
+      while(client->next<head && ring[client->next%NBLOCKS]->frame+ring[client->next%NBLOCKS]->nframes<=now)
+        client->next++;
+      client->state = StreamClient::Streaming;
+      }
+    }
+  client->mode|=Reactor::Input::Writable;
+  if (!send(client)) {
+    remove(client);
+    return false;
+    }
+  return true;
+  }
+
+
+// Send as much as the client takes. Returns false if the client should be disconnected.
+FXbool StreamOutput::send(StreamClient * client) {
+  FXival n;
+
+  while(client->hpos<client->header.length()) {
+    n = ::send(client->handle,client->header.text()+client->hpos,client->header.length()-client->hpos,MSG_NOSIGNAL);
+    if (n<0) goto error;
+    client->hpos+=n;
+    }
+
+  if (client->state==StreamClient::Closing)
+    return false;
+
+  // Fell behind more than the ring
+  if (client->next+NBLOCKS<head) {
+    GM_DEBUG_PRINT("[stream] client too slow\n");
+    return false;
+    }
+
+  do {
+    if (client->block==nullptr) {
+      if (client->next==head) {
+        client->mode&=~Reactor::Input::Writable;
+        return true;
+        }
+      client->block = ring[(client->next++)%NBLOCKS]->ref();
+      if (client->chunked) {
+        client->bpos = 0;
+        client->bend = StreamBlock::Header+client->block->size+StreamBlock::Trailer;
+        }
+      else {
+        client->bpos = StreamBlock::Header;
+        client->bend = StreamBlock::Header+client->block->size;
+        }
+      }
+    n = ::send(client->handle,client->block->data+client->bpos,client->bend-client->bpos,MSG_NOSIGNAL);
+    if (n<0) goto error;
+    client->bpos+=n;
+    if (client->bpos==client->bend) {
+      client->block->unref();
+      client->block=nullptr;
+      }
+    }
+  while(1);
+  return true;
+error:
+  if (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR) {
+    client->mode|=Reactor::Input::Writable;
+    return true;
+    }
+  return false;
+  }
+
+
+// Add block to the ring and hand it to the clients
+void StreamOutput::push(StreamBlock * block) {
+  block->frame_chunk();
+  StreamBlock *& slot = ring[head%NBLOCKS];
+  if (slot) slot->unref();
+  slot=block;
+  head++;
+  for (FXint i=clients.no()-1;i>=0;i--) {
+    if (clients[i]->state==StreamClient::Streaming && clients[i]->block==nullptr) {
+      if (!send(clients[i]))
+        remove(clients[i]);
+      }
+    else if (clients[i]->state==StreamClient::Streaming && clients[i]->next+NBLOCKS<head) {
+      GM_DEBUG_PRINT("[stream] client too slow\n");
+      remove(clients[i]);
+      }
+    }
+  }
+
+
+// Disconnect all clients and empty the ring
+void StreamOutput::reset() {
+  for (FXint i=clients.no()-1;i>=0;i--) {
+    remove(clients[i]);
+    }
+  for (FXint i=0;i<NBLOCKS;i++) {
+    if (ring[i]) ring[i]->unref();
+    ring[i]=nullptr;
+    }
+  if (pending) {
+    pending->unref();
+    pending=nullptr;
+    }
+  header.clear();
+  head=0;
+  written=0;
+  starttime=0;
+  pausetime=0;
+  startframe=0;
+  }
+
+
+// Frame being played right now
+FXlong StreamOutput::position() const {
+  if (starttime==0)
+    return written;
+  const FXTime now = pausetime ? pausetime : FXThread::time();
+  return startframe + (((now-starttime)/NANOSECONDS_PER_MICROSECOND)*af.rate) / 1000000;
+  }
+
+
+// Frames per block, about 50ms
+FXuint StreamOutput::blockframes() const {
+  return FXMAX(1u,af.rate/20);
+  }
+
+
+// (Re)start the clock if we haven't started yet or ran out of data
+void StreamOutput::sync() {
+  if (starttime==0 || (pausetime==0 && position()>written)) {
+    starttime  = FXThread::time();
+    startframe = written;
+    pausetime  = 0;
+    }
+  }
+
+
+// Serve the clients until we're no more than ahead frames ahead of the clock
+void StreamOutput::wait(FXlong ahead) {
+  FXlong n;
+  while(pausetime==0 && (n=written-ahead-position())>0) {
+    context->getReactor().addTimer(&timer,FXThread::time()+(n*NANOSECONDS_PER_SECOND)/af.rate);
+    context->wait_plugin_events();
+    context->getReactor().removeTimer(&timer);
+    }
+  }
+
+
+static void wav_header(const AudioFormat & af,FXushort format,FXString & header) {
+  FXuint   chunksize     = 0xFFFFFFFF;
+  FXushort channels      = af.channels;
+  FXuint   rate          = af.rate;
+  FXuint   byterate      = af.rate*af.framesize();
+  FXushort blockalign    = af.framesize();
+  FXushort bitspersample = af.packing()*8;
+
+  header.length(44);
+  FXchar * h = header.text();
+  memcpy(h+0,"RIFF",4);
+  memcpy(h+4,&chunksize,4);
+  memcpy(h+8,"WAVE",4);
+  memcpy(h+12,"fmt ",4);
+  chunksize=16;
+  memcpy(h+16,&chunksize,4);
+  memcpy(h+20,&format,2);
+  memcpy(h+22,&channels,2);
+  memcpy(h+24,&rate,4);
+  memcpy(h+28,&byterate,4);
+  memcpy(h+32,&blockalign,2);
+  memcpy(h+34,&bitspersample,2);
+  memcpy(h+36,"data",4);
+  chunksize=0xFFFFFFFF;
+  memcpy(h+40,&chunksize,4);
+  }
+
+
+FXbool StreamOutput::wav_configure(const AudioFormat & fmt) {
+  FXushort format;
+
+  if (fmt.byteorder()!=Format::Little || fmt.channels>2)
+    return false;
+
+  switch(fmt.format) {
+    case AP_FORMAT_U8   :
+    case AP_FORMAT_S16  :
+    case AP_FORMAT_S24_3:
+    case AP_FORMAT_S32  : format = 0x0001; break;
+    case AP_FORMAT_FLOAT: format = 0x0003; break;
+    default             : return false;    break;
+    }
+
+  af=fmt;
+  wav_header(af,format,header);
+  mimetype="audio/wav";
+  return true;
+  }
+
+
+#ifdef HAVE_FLAC
+
+FLAC__StreamEncoderWriteStatus StreamOutput::flac_encoder_write(const FLAC__StreamEncoder*,const FLAC__byte buffer[],size_t bytes,unsigned samples,unsigned,void*client_data) {
+  StreamOutput * output = static_cast<StreamOutput*>(client_data);
+  if (samples==0) {
+    output->header.append((const FXchar*)buffer,bytes);
+    }
+  else {
+    StreamBlock * block = new StreamBlock(bytes);
+    memcpy(block->payload(),buffer,bytes);
+    block->size    = bytes;
+    block->nframes = samples;
+    block->frame   = output->encoded;
+    output->encoded += samples;
+    output->push(block);
+    }
+  return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+  }
+
+
+FXbool StreamOutput::flac_configure(const AudioFormat & fmt) {
+  FXuint bits;
+
+  if (fmt.byteorder()!=Format::Little || fmt.channels>8 || fmt.rate>655350)
+    return false;
+
+  // Float and 32 bit samples are encoded as 24 bit
+  af=fmt;
+  switch(fmt.format) {
+    case AP_FORMAT_S16  : bits=16; break;
+    case AP_FORMAT_S24_3: bits=24; break;
+    case AP_FORMAT_S32  : bits=24; break;
+    case AP_FORMAT_FLOAT: bits=24; af.format=AP_FORMAT_S32; break;
+    default             : return false; break;
+    }
+
+  encoder = FLAC__stream_encoder_new();
+  if (encoder==nullptr)
+    return false;
+
+  FLAC__stream_encoder_set_channels(encoder,af.channels);
+  FLAC__stream_encoder_set_bits_per_sample(encoder,bits);
+  FLAC__stream_encoder_set_sample_rate(encoder,af.rate);
+  FLAC__stream_encoder_set_compression_level(encoder,5);
+  FLAC__stream_encoder_set_streamable_subset(encoder,true);
+  if (buffertime<100)
+    FLAC__stream_encoder_set_blocksize(encoder,1152);
+
+  // Metadata is written right away and ends up in the stream header
+  header.clear();
+  encoded=0;
+  if (FLAC__stream_encoder_init_stream(encoder,flac_encoder_write,nullptr,nullptr,nullptr,this)!=FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+    GM_DEBUG_PRINT("[stream] failed to initialize flac encoder\n");
+    FLAC__stream_encoder_delete(encoder);
+    encoder=nullptr;
+    return false;
+    }
+  mimetype="audio/flac";
+  return true;
+  }
+
+
+FXbool StreamOutput::flac_encode(const FXuchar * buffer,FXuint nframes) {
+  const FXuint n = nframes*af.channels;
+  if (n>nsamples) {
+    if (!resizeElms(samples,n))
+      return false;
+    nsamples=n;
+    }
+  switch(af.format) {
+    case AP_FORMAT_S16:
+      {
+        const FXshort * input = reinterpret_cast<const FXshort*>(buffer);
+        for (FXuint i=0;i<n;i++) samples[i]=input[i];
+      } break;
+    case AP_FORMAT_S24_3:
+      {
+        for (FXuint i=0;i<n;i++,buffer+=3) samples[i]=((FXint)(buffer[0]<<8|buffer[1]<<16|buffer[2]<<24))>>8;
+      } break;
+    case AP_FORMAT_S32:
+      {
+        const FXint * input = reinterpret_cast<const FXint*>(buffer);
+        for (FXuint i=0;i<n;i++) samples[i]=input[i]>>8;
+      } break;
+    }
+  return FLAC__stream_encoder_process_interleaved(encoder,samples,nframes);
+  }
+
+
+// Flush the last frame out to the clients
+void StreamOutput::flac_close() {
+  if (encoder) {
+    FLAC__stream_encoder_finish(encoder);
+    FLAC__stream_encoder_delete(encoder);
+    encoder=nullptr;
+    }
+  freeElms(samples);
+  nsamples=0;
+  }
+
+#endif
+
+
+FXbool StreamOutput::configure(const AudioFormat & fmt) {
+  const AudioFormat current = af;
+
+#ifdef HAVE_FLAC
+  if (config.format==StreamConfig::FormatFlac) {
+
+    // Keep encoding into the same stream if the format didn't change
+    if (encoder) {
+      AudioFormat next=fmt;
+      if (next.format==AP_FORMAT_FLOAT) next.format=AP_FORMAT_S32;
+      if (next==current)
+        return true;
+      flac_close();
+      }
+    reset();
+    if (!flac_configure(fmt)) {
+      af.reset();
+      return false;
+      }
+    }
+  else
+#endif
+    {
+    if (fmt==current)
+      return true;
+    reset();
+    if (!wav_configure(fmt)) {
+      af.reset();
+      return false;
+      }
+    }
+
+  if (listener==nullptr && !listen()) {
+    close();
+    return false;
+    }
+  return true;
+  }
+
+
+void * StreamOutput::begin_write(FXuint & nframes) {
+#ifdef HAVE_FLAC
+  if (encoder) return nullptr;
+#endif
+  FXASSERT(pending==nullptr);
+  sync();
+  wait(((FXlong)buffertime*af.rate)/1000);
+  nframes = FXMIN(nframes,blockframes());
+  pending = new StreamBlock(nframes*af.framesize());
+  return pending->payload();
+  }
+
+
+FXbool StreamOutput::commit_write(FXuint nframes) {
+  FXASSERT(pending);
+  StreamBlock * block = pending;
+  pending = nullptr;
+  block->size    = nframes*af.framesize();
+  block->nframes = nframes;
+  block->frame   = written;
+  written += nframes;
+  push(block);
+  return true;
+  }
+
+
+FXbool StreamOutput::write(const void * data,FXuint nframes) {
+  const FXuchar * buffer = static_cast<const FXuchar*>(data);
+  const FXuint framesize = af.framesize();
+  while(nframes) {
+    FXuint n = nframes;
+#ifdef HAVE_FLAC
+    if (encoder) {
+      sync();
+      wait(((FXlong)buffertime*af.rate)/1000);
+      n = FXMIN(n,blockframes());
+      if (!flac_encode(buffer,n))
+        return false;
+      written += n;
+      }
+    else
+#endif
+      {
+      void * ptr = begin_write(n);
+      memcpy(ptr,buffer,n*framesize);
+      commit_write(n);
+      }
+    buffer+=n*framesize;
+    nframes-=n;
+    }
+  return true;
+  }
+
+
+FXint StreamOutput::delay() {
+  return (FXint)FXMAX(0,written-position());
+  }
+
+
+FXbool StreamOutput::latency(FXuint & buffer,FXuint & period) {
+  if (!af.set())
+    return false;
+  buffer = (buffertime*af.rate)/1000;
+  period = blockframes();
+  return true;
+  }
+
+
+void StreamOutput::drop() {
+  if (starttime) {
+    starttime  = FXThread::time();
+    startframe = written;
+    pausetime  = 0;
+    }
+  }
+
+
+void StreamOutput::drain() {
+  wait(0);
+  }
+
+
+void StreamOutput::pause(FXbool p) {
+  if (starttime==0) return;
+  if (p) {
+    if (pausetime==0) pausetime=FXThread::time();
+    }
+  else if (pausetime) {
+    starttime+=FXThread::time()-pausetime;
+    pausetime=0;
+    }
+  }
+
+
+void StreamOutput::close() {
+#ifdef HAVE_FLAC
+  flac_close();
+#endif
+  reset();
+  if (listener) {
+    GM_DEBUG_PRINT("[stream] closed\n");
+    context->getReactor().removeInput(listener);
+    delete listener;
+    listener=nullptr;
+    }
+  af.reset();
+  }
+
+}
+
+AP_IMPLEMENT_PLUGIN(StreamOutput);
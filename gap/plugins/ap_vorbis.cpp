@@ -20,6 +20,7 @@
 #include "ap_packet.h"
 #include "ap_vorbis.h"
 #include "ap_ogg_decoder.h"
+#include "ap_interleave.h"
 
 #if defined(HAVE_VORBIS)
 #include <vorbis/codec.h>
@@ -87,8 +88,6 @@ FXbool VorbisDecoder::init(ConfigureEvent*event) {
 #endif
   event->af.channelmap = vorbis_channel_map[event->af.channels-1];
 
-  stream_offset_start = event->stream_offset_start;
-
   af=event->af;
 
   reset_decoder();
@@ -151,15 +150,6 @@ FXbool VorbisDecoder::is_vorbis_header() {
   return (op.bytes>6 && ((op.packet[0]==1) || (op.packet[0]==3) || (op.packet[0]==5)) && (FXString::compare((const FXchar*)&op.packet[1],"vorbis",6)==0));
   }
 
-#ifdef HAVE_TREMOR
-static ogg_int32_t CLIP_TO_15(ogg_int32_t x) {
-  int ret=x;
-  ret-= ((x<=32767)-1)&(x-32767);
-  ret-= ((x>=-32768)-1)&(x+32768);
-  return(ret);
-  }
-#endif
-
 void VorbisDecoder::init_info() {
   if (has_info) {
     vorbis_info_clear(&info);
@@ -184,17 +174,15 @@ FXbool VorbisDecoder::process(Packet * packet) {
 
 #if defined(HAVE_VORBIS)
   FXfloat ** pcm=nullptr;
-  FXfloat * buf32=nullptr;
 #elif defined(HAVE_TREMOR)
   FXint ** pcm=nullptr;
-  FXshort * buf32=nullptr;
 #else
 #error "No vorbis decoder library specified"
 #endif
 
-  FXint p,navail=0;
+  FXint navail=0;
 
-  FXint ngiven,ntotalsamples,nsamples,sample,c,s;
+  FXint ngiven,ntotalsamples,nsamples,sample;
 
   FXbool  eos=packet->flags&FLAG_EOS;
   const FXlong stream_length=packet->stream_length;
@@ -215,18 +203,16 @@ FXbool VorbisDecoder::process(Packet * packet) {
 
     while((ngiven=vorbis_synthesis_pcmout(&dsp,&pcm))>0) {
 
-      const FXlong stream_begin = FXMAX(stream_offset_start,stream_decode_offset);
-
       // don't go past the stream_length
       if (stream_length>0 && stream_position+ngiven>stream_length) {
         GM_DEBUG_PRINT("[vorbis] unexpected stream position > stream length: %ld > %ld (%ld)\n",stream_position+ngiven,stream_length,stream_position+ngiven-stream_length);
         vorbis_synthesis_read(&dsp,stream_position+ngiven-stream_length);
-        ngiven = stream_length - stream_position;
+        ngiven = trim_end(stream_position,ngiven,stream_length);
         }
 
-      if (__unlikely(stream_position<stream_begin)) {
-        FXlong offset = FXMIN(ngiven,stream_begin - stream_position);
-        GM_DEBUG_PRINT("[vorbis] stream decode offset %ld. Skipping %ld of %ld \n",stream_begin,offset,stream_begin-stream_position);
+      const FXint offset = trim_begin(stream_position,ngiven);
+      if (__unlikely(offset)) {
+        GM_DEBUG_PRINT("[vorbis] Skipping %d at %ld\n",offset,stream_position);
         ngiven-=offset;
         stream_position+=offset;
         sample=offset;
@@ -246,32 +232,21 @@ FXbool VorbisDecoder::process(Packet * packet) {
             if (packet) packet->unref();
             return true;
             }
-          out->stream_position=stream_position;
+          out->stream_position=stream_position - stream_offset_start;
           out->stream_length=stream_length - stream_offset_start;
           out->af=af;
           navail = out->availableFrames();
           }
 
-#if defined(HAVE_VORBIS)
-        buf32 = out->flt();
-#elif defined(HAVE_TREMOR)
-        buf32 = out->s16();
-#else
-#error "No vorbis decoder library specified"
-#endif
         /// Copy Samples
         nsamples = FXMIN(ntotalsamples,navail);
-        for (p=0,s=sample;s<(nsamples+sample);s++){
-          for (c=0;c<info.channels;c++,p++) {
 #if defined(HAVE_VORBIS)
-            buf32[p]=pcm[c][s];
+        interleave_float(pcm,info.channels,sample,nsamples,out->flt());
 #elif defined(HAVE_TREMOR)
-            buf32[p]=CLIP_TO_15(pcm[c][s]>>9);
+        interleave_s16(pcm,info.channels,sample,nsamples,9,out->s16());
 #else
 #error "No vorbis decoder library specified"
 #endif
-            }
-          }
 
         /// Update sample counts
         out->wroteFrames(nsamples);
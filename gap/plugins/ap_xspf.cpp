@@ -18,8 +18,10 @@
 ********************************************************************************/
 #include "ap_defs.h"
 #include "ap_common.h"
+#include "ap_packet.h"
 #include "ap_xml_parser.h"
 #include "ap_reader_plugin.h"
+#include "ap_input_plugin.h"
 
 namespace ap {
 
@@ -31,6 +33,7 @@ public:
   FXString     title;
 protected:
   FXint        elem;
+  FXString     location;
 protected:
   FXint begin(const FXchar *,const FXchar**) override;
   void data(const FXchar *,FXint len) override;
@@ -88,17 +91,16 @@ FXint XSPFParser::begin(const FXchar * element,const FXchar **/* attributes*/){
 
 void XSPFParser::data(const FXchar* str,FXint len){
   switch(node()) {
-    case Elem_Playlist_Title:  title.assign(str,len); break;
-    case Elem_Playlist_TrackList_Track_Location:
-      {
-        FXString url(str,len);
-        files.append(url);
-
-      } break;
+    case Elem_Playlist_Title: title.append(str,len); break;
+    case Elem_Playlist_TrackList_Track_Location: location.append(str,len); break;
     }
   }
 
 void XSPFParser::end(const FXchar*) {
+  if (node()==Elem_Playlist_TrackList_Track_Location) {
+    files.append(location);
+    location.clear();
+    }
   }
 
 
@@ -129,15 +131,29 @@ FXbool XSPFReader::init(InputPlugin*plugin) {
   }
 
 ReadStatus XSPFReader::process(Packet*packet) {
-  if (TextReader::process(packet)==ReadDone) {
-    FXString title;
-    ap_parse_xspf(textbuffer,uri,title);
-    if (uri.no())
-      return ReadRedirect;
-    else
-      return ReadDone;
+  XSPFParser xspf;
+  FXchar buffer[4096];
+  FXival n;
+
+  packet->unref();
+
+  if (!xspf.start())
+    return ReadError;
+
+  while((n=input->read(buffer,sizeof(buffer)))>0) {
+    if (!xspf.feed(buffer,n)) break;
     }
-  return ReadError;
+
+  if (n<0)
+    return ReadError;
+
+  if (xspf.finish())
+    uri=xspf.files;
+
+  if (uri.no())
+    return ReadRedirect;
+  else
+    return ReadDone;
   }
 
 ReaderPlugin * ap_xspf_reader(InputContext * ctx) {
@@ -0,0 +1,241 @@
+#include <fx.h>
+
+typedef FXArray<FXString> FXStringList;
+#include <FXTextCodec.h>
+#include <ap.h>
+
+#include <new>
+#include <sys/resource.h>
+
+/*
+  Decoder benchmark. Every file is run through its reader and decoder with
+  the offline decoder as a null sink, followed by a number of seeks to random
+  positions. Results are printed as a table and optionally written as JSON.
+  Run with GOGGLESMM_SIMD=none to compare against the generic interleave code,
+  or with GOGGLESMM_MPEG_DECODER=mpg123 to compare mp3 decoding with mpg123.
+
+  usage: gap_bench [-n iterations] [-s seeks] [-o result.json] file [file...]
+*/
+
+static volatile FXlong allocations = 0;
+
+#if defined(__GLIBC__)
+
+// Count every allocation, including the ones made by the codec libraries
+extern "C" void * __libc_malloc(size_t);
+extern "C" void * __libc_calloc(size_t,size_t);
+extern "C" void * __libc_realloc(void*,size_t);
+
+extern "C" void * malloc(size_t size) {
+  atomicAdd(&allocations,1);
+  return __libc_malloc(size);
+  }
+
+extern "C" void * calloc(size_t n,size_t size) {
+  atomicAdd(&allocations,1);
+  return __libc_calloc(n,size);
+  }
+
+extern "C" void * realloc(void * ptr,size_t size) {
+  atomicAdd(&allocations,1);
+  return __libc_realloc(ptr,size);
+  }
+
+#else
+
+void * operator new(size_t size) {
+  atomicAdd(&allocations,1);
+  void * ptr = ::malloc(size);
+  if (ptr==nullptr) throw std::bad_alloc();
+  return ptr;
+  }
+
+void operator delete(void * ptr) noexcept {
+  ::free(ptr);
+  }
+
+#endif
+
+
+// Cpu time used by all threads
+static FXTime cputime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF,&usage);
+  return (usage.ru_utime.tv_sec+usage.ru_stime.tv_sec)*1000000000LL + (usage.ru_utime.tv_usec+usage.ru_stime.tv_usec)*1000LL;
+  }
+
+
+struct Result {
+  FXString filename;
+  FXString codec;
+  FXuint   rate        = 0;
+  FXuint   channels    = 0;
+  FXlong   frames      = 0;
+  FXlong   packets     = 0;
+  FXlong   allocs      = 0;
+  FXTime   elapsed     = 0;
+  FXTime   cpu         = 0;
+  FXint    nseeks      = 0;
+  FXTime   seek_total  = 0;
+  FXTime   seek_max    = 0;
+  FXbool   ok          = false;
+
+  FXdouble duration() const { return rate ? frames / (FXdouble)rate : 0.0; }
+  FXdouble seconds() const { return elapsed / 1000000000.0; }
+  FXdouble xrealtime() const { return elapsed ? duration() / seconds() : 0.0; }
+  FXdouble cpuPerHour() const { return duration()>0.0 ? (cpu / 1000000000.0) * 3600.0 / duration() : 0.0; }
+  FXdouble usPerPacket() const { return packets ? (elapsed / 1000.0) / packets : 0.0; }
+  FXdouble allocsPerSecond() const { return elapsed ? allocs / seconds() : 0.0; }
+  FXdouble seekMean() const { return nseeks ? (seek_total / 1000000.0) / nseeks : 0.0; }
+  FXdouble seekMax() const { return seek_max / 1000000.0; }
+  };
+
+
+static FXbool decode(Result & result) {
+  OfflineDecoder decoder;
+  FXfloat buffer[4096*8];
+  FXival n;
+
+  FXlong allocs = allocations;
+  FXTime start  = FXThread::steadytime();
+  FXTime cpu    = cputime();
+
+  if (!decoder.open(result.filename))
+    return false;
+
+  const FXival nframes = 4096*8 / decoder.channels();
+  FXlong frames = 0;
+  while((n=decoder.read(buffer,nframes))>0) {
+    frames+=n;
+    }
+
+  FXTime elapsed = FXThread::steadytime()-start;
+  cpu = cputime()-cpu;
+  if (n<0) return false;
+
+  // Keep the fastest run
+  if (!result.ok || elapsed<result.elapsed) {
+    result.elapsed  = elapsed;
+    result.cpu      = cpu;
+    result.allocs   = allocations-allocs;
+    result.frames   = frames;
+    result.packets  = decoder.packets();
+    result.rate     = decoder.rate();
+    result.channels = decoder.channels();
+    result.codec    = decoder.codec();
+    result.ok       = true;
+    }
+  return true;
+  }
+
+
+// Time from seek request until the first samples at the new position are available
+static void seek(Result & result,FXint nseeks,FXRandom & random) {
+  OfflineDecoder decoder;
+  FXfloat buffer[4096*8];
+  if (!decoder.open(result.filename))
+    return;
+
+  const FXival nframes = 1024;
+  for (FXint i=0;i<nseeks;i++) {
+    FXdouble pos = random.randDouble();
+    FXTime start = FXThread::steadytime();
+    if (!decoder.seek(pos))
+      return;
+    if (decoder.read(buffer,nframes)<0)
+      return;
+    FXTime elapsed = FXThread::steadytime()-start;
+    result.seek_total+=elapsed;
+    result.seek_max=FXMAX(result.seek_max,elapsed);
+    result.nseeks++;
+    }
+  }
+
+
+static FXString json_string(const FXString & str) {
+  return FXString::escape(str,'"','"',2);
+  }
+
+
+static FXbool write_json(const FXString & filename,const FXArray<Result> & results) {
+  FXFile file;
+  if (!file.open(filename,FXIO::Writing))
+    return false;
+
+  FXString out;
+  out+="{\n";
+  out+=FXString::value("  \"timestamp\": %lld,\n",FXThread::time()/1000000000);
+  out+="  \"results\": [\n";
+  for (FXint i=0;i<results.no();i++) {
+    const Result & r = results[i];
+    out+="    {";
+    out+=FXString::value("\"file\": %s, ",json_string(r.filename).text());
+    out+=FXString::value("\"ok\": %s",r.ok ? "true" : "false");
+    if (r.ok) {
+      out+=FXString::value(", \"codec\": %s, ",json_string(r.codec).text());
+      out+=FXString::value("\"rate\": %u, \"channels\": %u, \"duration\": %.3f, ",r.rate,r.channels,r.duration());
+      out+=FXString::value("\"decode_seconds\": %.6f, \"xrealtime\": %.2f, ",r.seconds(),r.xrealtime());
+      out+=FXString::value("\"cpu_seconds_per_hour\": %.3f, ",r.cpuPerHour());
+      out+=FXString::value("\"packets\": %lld, \"us_per_packet\": %.3f, ",r.packets,r.usPerPacket());
+      out+=FXString::value("\"allocations\": %lld, \"allocations_per_second\": %.1f, ",r.allocs,r.allocsPerSecond());
+      out+=FXString::value("\"seeks\": %d, \"seek_ms_mean\": %.3f, \"seek_ms_max\": %.3f",r.nseeks,r.seekMean(),r.seekMax());
+      }
+    out+=(i+1<results.no()) ? "},\n" : "}\n";
+    }
+  out+="  ]\n";
+  out+="}\n";
+  return file.writeBlock(out.text(),out.length())==out.length();
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXint    iterations = 3;
+  FXint    nseeks     = 20;
+  FXString output;
+  FXArray<Result> results;
+
+  for (FXint i=1;i<argc;i++) {
+    if (FXString::compare(argv[i],"-n")==0 && i+1<argc) {
+      const FXint value = FXString(argv[++i]).toInt();
+      iterations = FXMAX(1,value);
+      }
+    else if (FXString::compare(argv[i],"-s")==0 && i+1<argc) {
+      const FXint value = FXString(argv[++i]).toInt();
+      nseeks = FXMAX(0,value);
+      }
+    else if (FXString::compare(argv[i],"-o")==0 && i+1<argc)
+      output = argv[++i];
+    else {
+      Result result;
+      result.filename = FXPath::absolute(argv[i]);
+      results.append(result);
+      }
+    }
+
+  if (results.no()==0) {
+    fxmessage("usage: gap_bench [-n iterations] [-s seeks] [-o result.json] file [file...]\n");
+    return 1;
+    }
+
+  FXRandom random(1);
+  fxmessage("%-32s %-8s %10s %10s %10s %12s %10s %10s\n","file","codec","xrealtime","cpu s/h","us/packet","allocs/s","seek (ms)","max (ms)");
+  for (FXint i=0;i<results.no();i++) {
+    Result & r = results[i];
+    for (FXint n=0;n<iterations;n++) {
+      if (!decode(r)) break;
+      }
+    if (r.ok) {
+      seek(r,nseeks,random);
+      fxmessage("%-32s %-8s %10.1f %10.2f %10.2f %12.1f %10.3f %10.3f\n",FXPath::name(r.filename).text(),r.codec.text(),r.xrealtime(),r.cpuPerHour(),r.usPerPacket(),r.allocsPerSecond(),r.seekMean(),r.seekMax());
+      }
+    else {
+      fxmessage("%-32s failed\n",FXPath::name(r.filename).text());
+      }
+    }
+
+  if (!output.empty() && !write_json(output,results)) {
+    fxmessage("unable to write %s\n",output.text());
+    return 1;
+    }
+  return 0;
+  }
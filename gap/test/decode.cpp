@@ -0,0 +1,73 @@
+#include <fx.h>
+
+typedef FXArray<FXString> FXStringList;
+#include <FXTextCodec.h>
+#include <ap.h>
+
+/*
+  Decode files with the offline decoder, each file on its own thread,
+  and report the speed relative to realtime.
+
+  usage: gap_decode file [file...]
+*/
+
+class DecodeThread : public FXThread {
+public:
+  FXString filename;
+  FXlong   frames = 0;
+  FXuint   rate   = 0;
+  FXfloat  peak   = 0.0f;
+  FXTime   elapsed= 0;
+  FXbool   ok     = false;
+public:
+  FXint run() override {
+    OfflineDecoder decoder;
+    FXTime start = FXThread::steadytime();
+    if (decoder.open(filename)) {
+      FXfloat buffer[4096*8];
+      const FXival nframes = 4096*8 / decoder.channels();
+      FXival n;
+      rate = decoder.rate();
+      while((n=decoder.read(buffer,nframes))>0) {
+        for (FXival i=0;i<n*decoder.channels();i++) peak=FXMAX(peak,fabsf(buffer[i]));
+        frames+=n;
+        }
+      ok = (n==0);
+      }
+    elapsed = FXThread::steadytime()-start;
+    return 0;
+    }
+  };
+
+
+int main(int argc,char * argv[]) {
+  if (argc<2) {
+    fxmessage("usage: gap_decode file [file...]\n");
+    return 1;
+    }
+
+  FXArray<DecodeThread*> threads(argc-1);
+  FXTime start = FXThread::steadytime();
+  for (FXint i=0;i<threads.no();i++) {
+    threads[i] = new DecodeThread;
+    threads[i]->filename = FXPath::absolute(argv[i+1]);
+    threads[i]->start();
+    }
+
+  FXdouble total=0.0;
+  for (FXint i=0;i<threads.no();i++) {
+    DecodeThread * thread = threads[i];
+    thread->join();
+    if (thread->ok && thread->rate) {
+      FXdouble duration = thread->frames / (FXdouble)thread->rate;
+      total+=duration;
+      fxmessage("%-40s %10lld frames %8.2fs peak %.4f %8.1fx realtime\n",FXPath::name(thread->filename).text(),thread->frames,duration,thread->peak,duration / (thread->elapsed/1000000000.0));
+      }
+    else {
+      fxmessage("%-40s failed\n",FXPath::name(thread->filename).text());
+      }
+    delete thread;
+    }
+  fxmessage("total %.2fs of audio in %.2fs\n",total,(FXThread::steadytime()-start)/1000000000.0);
+  return 0;
+  }
@@ -0,0 +1,229 @@
+#include <fx.h>
+
+typedef FXArray<FXString> FXStringList;
+#include <FXTextCodec.h>
+#include <ap.h>
+#include "ap_input_plugin.h"
+
+using namespace ap;
+
+/*
+  FileInput test. Opens the same file memory mapped and through FXFile, runs
+  the same random mix of reads, previews and seeks on both and checks that
+  they return the same bytes and positions. Then truncates a mapped copy
+  while it is open and checks that reads stop at the new end instead of
+  raising SIGBUS. Also times reading a file in small chunks with a skip now
+  and then, the way container readers do.
+
+  usage: gap_fileinput [-n operations] [file]
+*/
+
+class Context : public IOContext {
+public:
+  Signal signal_;
+public:
+  const Signal & signal() override { return signal_; }
+  FXbool aborted() override { return false; }
+  void post_meta(MetaInfo*) override {}
+  };
+
+
+static InputPlugin * open(Context & context,const FXString & filename,FXbool mapped) {
+  FXSystem::setEnvironment("GOGGLESMM_FILE_MMAP",mapped ? "1" : "0");
+  return InputPlugin::open(&context,filename);
+  }
+
+
+// Truncate a mapped copy halfway through reading it
+static FXuint truncate(Context & context,const FXString & filename) {
+  const FXString copy = FXPath::unique(FXPath::absolute(FXSystem::getTempDirectory(),"gap_fileinput_copy.bin"));
+  FXuint errors = 0;
+  if (!FXFile::copy(filename,copy,true)) {
+    fxmessage("unable to copy %s\n",filename.text());
+    return 1;
+    }
+  InputPlugin * input = open(context,copy,true);
+  InputPlugin * check = open(context,filename,false);
+  if (input && check) {
+    FXuchar a[8192];
+    FXuchar b[8192];
+    FXival  nspan;
+    const FXlong size = input->size();
+    const FXlong half = size/2;
+    const FXlong cut  = (size*3/4) & ~4095;   // on a page, so the next page faults
+    input->position(half,FXIO::Begin);
+    check->position(half,FXIO::Begin);
+
+    FXFile file;
+    if (file.open(copy,FXIO::ReadWrite) && file.truncate(cut)==cut) {
+      file.close();
+      FXlong total=0;
+      FXival na,nb;
+      while((na=input->read(a,sizeof(a)))>0) {
+        nb = check->read(b,na);
+        if (nb!=na || memcmp(a,b,na)) {
+          fxmessage("truncated read differs at %lld\n",half+total);
+          errors++;
+          break;
+          }
+        total+=na;
+        }
+      if (half+total!=cut || !input->eof()) {
+        fxmessage("truncated at %lld, read up to %lld\n",cut,half+total);
+        errors++;
+        }
+      if (input->preview(a,sizeof(a))!=0) {
+        fxmessage("preview past the truncated end\n");
+        errors++;
+        }
+      nspan=sizeof(a);
+      input->position(cut-16,FXIO::Begin);
+      if (input->span(nspan)==nullptr || nspan!=16) {
+        fxmessage("span of %ld bytes before the truncated end\n",nspan);
+        errors++;
+        }
+      }
+    else {
+      fxmessage("unable to truncate %s\n",copy.text());
+      errors++;
+      }
+    }
+  else {
+    errors++;
+    }
+  delete input;
+  delete check;
+  FXFile::remove(copy);
+  return errors;
+  }
+
+
+static FXTime scan(InputPlugin * input,FXlong & nbytes) {
+  FXuchar buffer[4096];
+  FXRandom random(1);
+  FXTime start = FXThread::steadytime();
+  input->position(0,FXIO::Begin);
+  nbytes = 0;
+  while(1) {
+    FXival n = input->read(buffer,1+random.randLong()%16);
+    if (n<=0) break;
+    nbytes+=n;
+    if (random.randLong()%8==0) input->position(random.randLong()%64,FXIO::Current);
+    }
+  return FXThread::steadytime()-start;
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXuint   noperations = 100000;
+  FXString filename;
+
+  for (FXint i=1;i<argc;i++) {
+    if (FXString::compare(argv[i],"-n")==0 && i+1<argc) {
+      const FXuint value = FXString(argv[++i]).toUInt();
+      noperations = FXMAX(1u,value);
+      }
+    else {
+      filename = argv[i];
+      }
+    }
+
+  // Default to a generated file
+  FXbool generated = filename.empty();
+  if (generated) {
+    FXRandom random(7);
+    FXuchar  block[4096];
+    FXFile   out;
+    filename = FXPath::unique(FXPath::absolute(FXSystem::getTempDirectory(),"gap_fileinput.bin"));
+    if (!out.open(filename,FXIO::Writing)) {
+      fxmessage("unable to create %s\n",filename.text());
+      return 1;
+      }
+    for (FXint i=0;i<256;i++) {
+      for (FXuint j=0;j<sizeof(block);j++) block[j]=random.randLong()&0xff;
+      out.writeBlock(block,sizeof(block));
+      }
+    out.close();
+    }
+
+  Context context;
+  InputPlugin * mapped = open(context,filename,true);
+  InputPlugin * file   = open(context,filename,false);
+  if (mapped==nullptr || file==nullptr) {
+    fxmessage("unable to open %s\n",filename.text());
+    return 1;
+    }
+
+  FXuint errors = 0;
+  FXival nspan  = 16;
+  if (mapped->span(nspan)==nullptr) {
+    fxmessage("%s is not mapped\n",filename.text());
+    errors++;
+    }
+  if (file->span(nspan)!=nullptr || nspan!=0) {
+    fxmessage("%s is mapped with GOGGLESMM_FILE_MMAP=0\n",filename.text());
+    errors++;
+    }
+
+  // Mapping is the default
+  FXSystem::setEnvironment("GOGGLESMM_FILE_MMAP",FXString::null);
+  InputPlugin * plain = InputPlugin::open(&context,filename);
+  if (plain==nullptr || plain->span(nspan)==nullptr) {
+    fxmessage("%s is not mapped without GOGGLESMM_FILE_MMAP\n",filename.text());
+    errors++;
+    }
+  delete plain;
+
+  if (mapped->size()!=file->size()) {
+    fxmessage("size %lld and %lld\n",mapped->size(),file->size());
+    errors++;
+    }
+
+  FXRandom random(1);
+  FXuchar  a[8192];
+  FXuchar  b[8192];
+  const FXlong size = file->size();
+  for (FXuint i=0;i<noperations && errors<10;i++) {
+    const FXival count = random.randLong()%sizeof(a);
+    const FXuint operation = random.randLong()%4;
+    FXival na=0,nb=0;
+    switch(operation) {
+      case 0: na = mapped->read(a,count);
+              nb = file->read(b,count);
+              break;
+      case 1: na = mapped->preview(a,count);
+              nb = file->preview(b,count);
+              break;
+      case 2: {
+                const FXlong offset = random.randLong()%(size+64);
+                na = mapped->position(offset,FXIO::Begin);
+                nb = file->position(offset,FXIO::Begin);
+              } break;
+      case 3: {
+                const FXlong offset = (FXlong)(random.randLong()%1024)-512;
+                na = mapped->position(offset,FXIO::Current);
+                nb = file->position(offset,FXIO::Current);
+              } break;
+      }
+    if (na!=nb || (operation<2 && na>0 && memcmp(a,b,na)) || mapped->position()!=file->position() || mapped->eof()!=file->eof()) {
+      fxmessage("operation %u: %ld and %ld at %lld and %lld\n",i,na,nb,mapped->position(),file->position());
+      errors++;
+      }
+    }
+
+  errors+=truncate(context,filename);
+
+  FXlong mapped_bytes,file_bytes;
+  FXTime mapped_time = scan(mapped,mapped_bytes);
+  FXTime file_time   = scan(file,file_bytes);
+  if (mapped_bytes!=file_bytes) errors++;
+
+  fxmessage("mapped   %.2f ms\n",mapped_time/1000000.0);
+  fxmessage("file     %.2f ms\n",file_time/1000000.0);
+  fxmessage("errors   %u\n",errors);
+
+  delete mapped;
+  delete file;
+  if (generated) FXFile::remove(filename);
+  return errors ? 1 : 0;
+  }
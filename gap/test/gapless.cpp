@@ -0,0 +1,287 @@
+#include <fx.h>
+
+typedef FXArray<FXString> FXStringList;
+#include <FXTextCodec.h>
+#include <ap.h>
+#include "ap_event_private.h"
+#include "ap_decoder_plugin.h"
+#include "ap_input_plugin.h"
+#include "ap_reader_plugin.h"
+#include "ap_packet.h"
+
+using namespace ap;
+
+/*
+  Gapless trimming test. Runs random streams through the DecoderPlugin trim
+  helpers, with random encoder delay, padding, decoded chunk sizes and seek
+  offsets, and checks that exactly the frames between the delay (or seek
+  offset) and the padding come out, without gaps or overlap.
+
+  Also writes small ALAC mp4 files with an edit list and checks the delay
+  and stream length the mp4 reader configures from mvhd, mdhd and elst.
+
+  usage: gap_gapless [-n streams]
+*/
+
+class Trimmer : public DecoderPlugin {
+public:
+  FXlong position = 0;    // decoded frames
+  FXlong next     = -1;   // next frame expected in output
+  FXlong noutput  = 0;
+  FXuint errors   = 0;
+public:
+  Trimmer() : DecoderPlugin(nullptr) {}
+
+  FXbool process(Packet*) override { return false; }
+
+  FXbool init(FXint start,FXint end) {
+    ConfigureEvent * event = new ConfigureEvent(AudioFormat());
+    event->stream_offset_start = start;
+    event->stream_offset_end   = end;
+    DecoderPlugin::init(event);
+    event->unref();
+    position = 0;
+    next     = -1;
+    noutput  = 0;
+    return true;
+    }
+
+  void seek(FXlong offset) {
+    flush(offset);
+    position = offset - (offset % 1152);
+    next     = -1;
+    }
+
+  void decode(FXint nframes,FXlong length) {
+    const FXint skip = trim_begin(position,nframes);
+    const FXint keep = trim_end(position+skip,nframes-skip,length-stream_offset_end);
+    if (keep>0) {
+      if (next>=0 && position+skip!=next) errors++;
+      next = position+skip+keep;
+      noutput+=keep;
+      }
+    position+=nframes;
+    }
+  };
+
+
+// Big endian atom writer
+class Atom {
+protected:
+  FXString data;
+public:
+  Atom(const FXchar * type) { u32(0); data.append(type,4); }
+  Atom & u8(FXuint x) { data.append((FXchar)x); return *this; }
+  Atom & u16(FXuint x) { return u8(x>>8).u8(x); }
+  Atom & u32(FXuint x) { return u16(x>>16).u16(x); }
+  Atom & u64(FXulong x) { return u32(x>>32).u32(x); }
+  Atom & zero(FXint n) { while(n--) u8(0); return *this; }
+  Atom & add(const Atom & atom) { data.append(atom.bytes()); return *this; }
+  FXString bytes() const {
+    FXString b(data);
+    const FXuint n = b.length();
+    b[0]=n>>24; b[1]=n>>16; b[2]=n>>8; b[3]=n;
+    return b;
+    }
+  };
+
+
+struct Edit {
+  FXlong duration;    // in movie timescale
+  FXlong media_time;  // in media timescale, -1 for an empty edit
+  };
+
+
+class Context : public IOContext, public InputContext {
+public:
+  Signal signal_;
+  FXint  offset = -1;
+public:
+  const Signal & signal() override { return signal_; }
+  FXbool aborted() override { return false; }
+  void post_meta(MetaInfo*) override {}
+  void post_configuration(ConfigureEvent * event) override {
+    offset = event->stream_offset_start;
+    event->unref();
+    }
+  void post_packet(Packet * packet) override { packet->unref(); }
+  };
+
+
+/*
+  ALAC track of nsamples frames of 4096 with the given timescales and edit list.
+  Version 1 uses 64 bit times in mvhd, mdhd and elst.
+*/
+static FXString mp4(FXuint version,FXuint movie_timescale,FXuint media_timescale,FXuint nsamples,const Edit * edits,FXuint nedits) {
+  const FXuint frames = 4096;
+
+  Atom mvhd("mvhd");
+  Atom mdhd("mdhd");
+  mvhd.u32(version<<24);
+  mdhd.u32(version<<24);
+  if (version==1) {
+    mvhd.u64(0).u64(0).u32(movie_timescale).u64(((FXulong)nsamples*frames*movie_timescale)/media_timescale);
+    mdhd.u64(0).u64(0).u32(media_timescale).u64((FXulong)nsamples*frames);
+    }
+  else {
+    mvhd.u32(0).u32(0).u32(movie_timescale).u32(((FXulong)nsamples*frames*movie_timescale)/media_timescale);
+    mdhd.u32(0).u32(0).u32(media_timescale).u32(nsamples*frames);
+    }
+  mvhd.zero(80);
+  mdhd.zero(4);
+
+  Atom elst("elst");
+  elst.u32(version<<24).u32(nedits);
+  for (FXuint i=0;i<nedits;i++) {
+    if (version==1)
+      elst.u64(edits[i].duration).u64(edits[i].media_time);
+    else
+      elst.u32(edits[i].duration).u32(edits[i].media_time);
+    elst.u32(1<<16);
+    }
+
+  Atom alac("alac");
+  alac.zero(6).u16(1).u16(0).zero(6).u16(2).u16(16).zero(4).u32(media_timescale<<16);
+  alac.u32(36).u8('a').u8('l').u8('a').u8('c').u32(0);
+  alac.u32(frames).u8(0).u8(16).u8(40).u8(10).u8(14).u8(2).u16(255).u32(0).u32(0).u32(media_timescale);
+
+  Atom stts("stts");
+  Atom stsc("stsc");
+  Atom stsz("stsz");
+  stts.u32(0).u32(1).u32(nsamples).u32(frames);
+  stsc.u32(0).u32(1).u32(1).u32(nsamples).u32(1);
+  stsz.u32(0).u32(4).u32(nsamples);
+
+  // Chunk offset depends on the size of everything before mdat
+  FXString moov;
+  FXString ftyp = Atom("ftyp").u8('M').u8('4').u8('A').u8(' ').u32(0).bytes();
+  for (FXuint pass=0,offset=0;pass<2;pass++) {
+    Atom stco("stco");
+    stco.u32(0).u32(1).u32(offset);
+    moov = Atom("moov").add(mvhd)
+                       .add(Atom("trak").add(Atom("edts").add(elst))
+                                        .add(Atom("mdia").add(mdhd)
+                                                         .add(Atom("minf").add(Atom("stbl").add(Atom("stsd").u32(0).u32(1).add(alac))
+                                                                                           .add(stts)
+                                                                                           .add(stsc)
+                                                                                           .add(stsz)
+                                                                                           .add(stco))))).bytes();
+    offset = ftyp.length()+moov.length()+8;
+    }
+  return ftyp + moov + Atom("mdat").zero(nsamples*4).bytes();
+  }
+
+
+// Returns false if the reader doesn't come up with the expected delay and length
+static FXbool check_mp4(const FXString & filename,const FXString & data,FXint start,FXlong length) {
+  Context    context;
+  PacketPool pool;
+  FXFile     file;
+  FXbool     ok = false;
+
+  if (!file.open(filename,FXIO::Writing) || file.writeBlock(data.text(),data.length())!=data.length())
+    return false;
+  file.close();
+
+  InputPlugin  * input  = InputPlugin::open(&context,filename);
+  ReaderPlugin * reader = ReaderPlugin::open(&context,Format::MP4);
+  if (input && reader && reader->init(input) && pool.init(8192,4)) {
+    Packet * packet = pool.wait(context.signal_);
+    packet->af = AudioFormat();
+    packet->af.set(AP_FORMAT_S16,44100,2);
+    reader->process(packet);
+    ok = (context.offset==start && reader->seek_offset(1.0)==length);
+    if (!ok) fxmessage("mp4: delay %d length %ld, expected %d %ld\n",context.offset,reader->seek_offset(1.0),start,length);
+    }
+  delete reader;
+  delete input;
+  pool.free();
+  FXFile::remove(filename);
+  return ok;
+  }
+
+
+static FXuint test_mp4() {
+  const FXString filename = FXPath::unique(FXPath::absolute(FXSystem::getTempDirectory(),"gap_gapless.m4a"));
+  const FXuint   nsamples = 100;
+  const FXlong   length   = nsamples*4096;
+  const FXlong   delay    = 2112;
+  const FXlong   padding  = 1728;
+  FXuint errors = 0;
+
+  // Edit durations in a movie timescale of 1000, except precise at 44100
+  const Edit gapless    = {((length-delay-padding)*1000)/44100,delay};
+  const Edit empty      = {1000,-1};
+  const Edit split[]    = {{1000,delay},{1000,delay+44100}};
+  const Edit precise    = {length-delay-padding,delay};
+  const Edit padded[]   = {empty,gapless};
+  const Edit toolong    = {(length*1000)/44100+1000,delay};
+
+  // Reader scales the duration back to the media timescale, which rounds down
+  const FXlong trimmed  = delay + (gapless.duration*44100)/1000;
+
+  // Version 0 and 1 headers, with a movie timescale of 1000 and one equal to the media timescale
+  if (!check_mp4(filename,mp4(0,1000,44100,nsamples,&gapless,1),delay,trimmed)) errors++;
+  if (!check_mp4(filename,mp4(1,1000,44100,nsamples,&gapless,1),delay,trimmed)) errors++;
+  if (!check_mp4(filename,mp4(0,44100,44100,nsamples,&precise,1),delay,length-padding)) errors++;
+  if (!check_mp4(filename,mp4(1,44100,44100,nsamples,&precise,1),delay,length-padding)) errors++;
+
+  // Empty edits are skipped
+  if (!check_mp4(filename,mp4(0,1000,44100,nsamples,padded,2),delay,trimmed)) errors++;
+
+  // More than one edit isn't a gapless edit, and neither is one that doesn't fit the track
+  if (!check_mp4(filename,mp4(0,1000,44100,nsamples,split,2),0,length)) errors++;
+  if (!check_mp4(filename,mp4(0,1000,44100,nsamples,&toolong,1),0,length)) errors++;
+
+  return errors;
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXuint nstreams = 10000;
+
+  for (FXint i=1;i+1<argc;i+=2) {
+    const FXuint value = FXString(argv[i+1]).toUInt();
+    if (FXString::compare(argv[i],"-n")==0)
+      nstreams = FXMAX(1u,value);
+    }
+
+  FXRandom random(1);
+  Trimmer  trimmer;
+  FXuint   errors = 0;
+
+  for (FXuint s=0;s<nstreams;s++) {
+    const FXint  start  = random.randLong()%4096;
+    const FXint  end    = random.randLong()%4096;
+    const FXlong length = start + end + random.randLong()%200000;
+    const FXbool seek   = random.randLong()%2;
+    const FXlong offset = start + random.randLong()%(length-start-end+1);
+    FXlong begin = start;
+
+    trimmer.init(start,end);
+    if (seek) {
+      trimmer.seek(offset);
+      begin = offset;
+      }
+
+    while(trimmer.position<length) {
+      const FXint n = 1+random.randLong()%4608;
+      trimmer.decode((FXint)FXMIN((FXlong)n,length-trimmer.position),length);
+      }
+
+    if (trimmer.noutput!=length-end-begin || (trimmer.noutput && trimmer.next!=length-end)) {
+      fxmessage("stream %u: start %d end %d length %ld seek %ld: %ld frames, expected %ld\n",s,start,end,length,seek ? offset : -1L,trimmer.noutput,length-end-begin);
+      errors++;
+      }
+    errors+=trimmer.errors;
+    trimmer.errors=0;
+    }
+
+  const FXuint mp4errors = test_mp4();
+  errors+=mp4errors;
+
+  fxmessage("streams  %u\n",nstreams);
+  fxmessage("mp4      %u errors\n",mp4errors);
+  fxmessage("errors   %u\n",errors);
+  return errors ? 1 : 0;
+  }
@@ -0,0 +1,237 @@
+#include <fx.h>
+
+typedef FXArray<FXString> FXStringList;
+#include <FXTextCodec.h>
+#include <ap.h>
+#include "ap_output_plugin.h"
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace ap;
+
+/*
+  Network stream output test. Loads the stream output plugin and plays a
+  generated stream into it, while a number of clients read it back through
+  HttpClient. Each client checks that it gets a wav header followed by
+  frames that count up without gaps. One more client connects but doesn't
+  read until the end, and should be disconnected once it falls behind.
+
+  usage: gap_httpstream [-p port] [-c clients] [-t seconds] [plugin]
+*/
+
+static const FXuint RATE = 44100;
+
+
+class Player : public FXThread, public OutputContext {
+public:
+  Reactor        reactor;
+  OutputPlugin * plugin = nullptr;
+  FXuint         seconds;
+public:
+  Player(FXuint s) : seconds(s) {}
+
+  void notify_disable_volume() override {}
+  void notify_volume(FXfloat) override {}
+  void notify_error(const FXString&) override {}
+  void wait_plugin_events() override { reactor.runOnce(); }
+  Reactor & getReactor() override { return reactor; }
+
+  FXint run() override {
+    FXshort buffer[2*RATE/20];
+    FXuint  frame = 0;
+    while(frame<RATE*seconds) {
+      for (FXuint i=0;i<RATE/20;i++,frame++) {
+        buffer[2*i+0] = frame&0x7fff;
+        buffer[2*i+1] = (frame>>15)&0x7fff;
+        }
+      if (!plugin->write(buffer,RATE/20))
+        return 1;
+      }
+    plugin->drain();
+
+    // Let the clients catch up
+    FXTime end = FXThread::time()+500000000;
+    for (FXTime now=FXThread::time();now<end;now=FXThread::time())
+      reactor.runOnce(end-now);
+
+    plugin->close();
+    return 0;
+    }
+  };
+
+
+class Listener : public FXThread {
+public:
+  FXString url;
+  FXlong   nframes = 0;
+  FXuint   errors  = 0;
+public:
+  Listener(const FXString & u) : url(u) {}
+
+  // Read exactly n bytes
+  static FXbool read(HttpClient & client,FXuchar * buffer,FXival n) {
+    while(n>0) {
+      FXival r = client.readBody(buffer,n);
+      if (r<=0) return false;
+      buffer+=r;
+      n-=r;
+      }
+    return true;
+    }
+
+  FXint run() override {
+    HttpClient client;
+    FXuchar    header[44];
+    FXuchar    frame[4];
+    FXuint     last = 0;
+
+    if (!client.request("GET",url) || client.parse()!=HTTP_RESPONSE_SUCCESS) {
+      fxmessage("request failed\n");
+      errors++;
+      return 1;
+      }
+    if (client.getHeader("content-type")!="audio/wav") {
+      fxmessage("unexpected content type %s\n",client.getHeader("content-type").text());
+      errors++;
+      }
+    if (!read(client,header,44) || memcmp(header,"RIFF",4) || memcmp(header+8,"WAVE",4) || memcmp(header+36,"data",4)) {
+      fxmessage("no wav header\n");
+      errors++;
+      return 1;
+      }
+    while(read(client,frame,4)) {
+      const FXuint value = (frame[0]|frame[1]<<8) | (frame[2]|frame[3]<<8)<<15;
+      if (nframes && value!=last+1) errors++;
+      last = value;
+      nframes++;
+      }
+    return 0;
+    }
+  };
+
+
+class SlowListener : public FXThread {
+public:
+  FXuint port;
+  FXlong nbytes = 0;
+  FXint  fd     = -1;
+public:
+  SlowListener(FXuint p) : port(p) {}
+
+  FXbool open() {
+    struct sockaddr_in addr;
+    const int size = 4096;
+    fd = ::socket(AF_INET,SOCK_STREAM,0);
+    setsockopt(fd,SOL_SOCKET,SO_RCVBUF,&size,sizeof(size));
+    memset(&addr,0,sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons(port);
+    if (::connect(fd,(struct sockaddr*)&addr,sizeof(addr))<0)
+      return false;
+    const FXchar request[] = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    return ::send(fd,request,sizeof(request)-1,0)==sizeof(request)-1;
+    }
+
+  // Read whatever made it before the disconnect
+  FXint run() override {
+    FXchar buffer[4096];
+    FXival n;
+    while((n=::recv(fd,buffer,sizeof(buffer),0))>0) nbytes+=n;
+    ::close(fd);
+    return 0;
+    }
+  };
+
+
+int main(int argc,char * argv[]) {
+  FXuint   port     = 18000;
+  FXuint   nclients = 4;
+  FXuint   seconds  = 10;
+#ifdef GAP_STREAM_PLUGIN
+  FXString path     = GAP_STREAM_PLUGIN;
+#else
+  FXString path     = FXSystem::dllName("gap_stream");
+#endif
+
+  for (FXint i=1;i<argc;i++) {
+    FXuint value = (i+1<argc) ? FXString(argv[i+1]).toUInt() : 0;
+    if (i+1<argc && FXString::compare(argv[i],"-p")==0)
+      port = value, i++;
+    else if (i+1<argc && FXString::compare(argv[i],"-c")==0)
+      nclients = FXCLAMP(1u,value,64u), i++;
+    else if (i+1<argc && FXString::compare(argv[i],"-t")==0)
+      seconds = FXMAX(1u,value), i++;
+    else
+      path = argv[i];
+    }
+
+  FXDLL dll;
+  if (!dll.load(path)) {
+    fxmessage("unable to load %s: %s\n",path.text(),dll.error().text());
+    return 1;
+    }
+  ap_load_plugin_t ap_load_plugin = (ap_load_plugin_t) dll.address("ap_load_plugin");
+  ap_free_plugin_t ap_free_plugin = (ap_free_plugin_t) dll.address("ap_free_plugin");
+  if (ap_load_plugin==nullptr || ap_free_plugin==nullptr) {
+    fxmessage("%s is not an output plugin\n",path.text());
+    return 1;
+    }
+
+  Player player(seconds);
+  player.plugin = ap_load_plugin(&player);
+
+  OutputConfig config;
+  config.stream.port   = port;
+  config.stream.format = StreamConfig::FormatWav;
+  player.plugin->setOutputConfig(config);
+
+  AudioFormat af;
+  af.set(AP_FORMAT_S16,RATE,2);
+  if (!player.plugin->configure(af)) {
+    fxmessage("unable to configure plugin on port %u\n",port);
+    return 1;
+    }
+
+  FXArray<Listener*> listeners;
+  for (FXuint i=0;i<nclients;i++)
+    listeners.append(new Listener(FXString::value("http://localhost:%u/",port)));
+
+  SlowListener slow(port);
+  if (!slow.open()) {
+    fxmessage("unable to connect to port %u\n",port);
+    return 1;
+    }
+
+  FXTime start = FXThread::steadytime();
+  player.start();
+  for (FXint i=0;i<listeners.no();i++)
+    listeners[i]->start();
+  player.join();
+  FXTime elapsed = FXThread::steadytime()-start;
+
+  FXuint errors = 0;
+  for (FXint i=0;i<listeners.no();i++) {
+    listeners[i]->join();
+    fxmessage("client %d %lld frames, %u errors\n",i,listeners[i]->nframes,listeners[i]->errors);
+    if (listeners[i]->nframes==0) errors++;
+    errors+=listeners[i]->errors;
+    delete listeners[i];
+    }
+
+  slow.start();
+  slow.join();
+  fxmessage("slow     %lld bytes\n",slow.nbytes);
+  if (slow.nbytes>=(FXlong)RATE*4*seconds/2) {
+    fxmessage("slow client was not disconnected\n");
+    errors++;
+    }
+
+  fxmessage("time     %.2f s for %u s\n",elapsed/1000000000.0,seconds);
+  fxmessage("errors   %u\n",errors);
+  ap_free_plugin(player.plugin);
+  return errors ? 1 : 0;
+  }
@@ -0,0 +1,196 @@
+#include <fx.h>
+#include "ap_interleave.h"
+
+using namespace ap;
+
+/*
+  Interleave kernel test. Checks every conversion against a plain loop for
+  1 to 8 channels with random offsets and lengths, then times both on a
+  long stereo and mono stream. Set GOGGLESMM_SIMD to none, sse2, ssse3 or
+  avx2 to test the other kernels.
+
+  usage: gap_interleave [-n frames] [-r rounds]
+*/
+
+static const FXuint MAXCHANNELS = 8;
+
+static FXint reference(FXint x,FXint shift,FXint bits) {
+  const FXlong lo = -(1LL<<(bits-1));
+  const FXlong hi = (1LL<<(bits-1))-1;
+  FXlong v = shift ? (((FXlong)x+(1LL<<(shift-1)))>>shift) : x;
+  return (FXint)FXCLAMP(lo,v,hi);
+  }
+
+
+class Test {
+public:
+  FXint   * ints[MAXCHANNELS];
+  FXfloat * floats[MAXCHANNELS];
+  FXuchar * output;
+  FXuchar * expect;
+  FXuint    nframes;
+  FXuint    errors = 0;
+public:
+  Test(FXuint n) : nframes(n) {
+    FXRandom random(1);
+    for (FXuint c=0;c<MAXCHANNELS;c++) {
+      allocElms(ints[c],nframes);
+      allocElms(floats[c],nframes);
+      for (FXuint s=0;s<nframes;s++) {
+        ints[c][s]   = (FXint)random.randLong();
+        floats[c][s] = random.randFloat();
+        }
+      // full range, zero and the limits around the rounding point
+      ints[c][0] = 0x7fffffff;
+      ints[c][1] = -0x7fffffff-1;
+      ints[c][2] = -1;
+      ints[c][3] = 0;
+      }
+    allocElms(output,nframes*MAXCHANNELS*4);
+    allocElms(expect,nframes*MAXCHANNELS*4);
+    }
+
+  ~Test() {
+    for (FXuint c=0;c<MAXCHANNELS;c++) {
+      freeElms(ints[c]);
+      freeElms(floats[c]);
+      }
+    freeElms(output);
+    freeElms(expect);
+    }
+
+  void ref_float(FXuint nc,FXuint offset,FXuint n,FXfloat * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++) *out++ = floats[c][s];
+    }
+
+  void ref_fixed(FXuint nc,FXuint offset,FXuint n,FXint fracbits,FXfloat * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++) *out++ = (FXfloat)ints[c][s]*ldexpf(1.0f,-fracbits);
+    }
+
+  void ref_s8(FXuint nc,FXuint offset,FXuint n,FXint shift,FXchar * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++) *out++ = reference(ints[c][s],shift,8);
+    }
+
+  void ref_s16(FXuint nc,FXuint offset,FXuint n,FXint shift,FXshort * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++) *out++ = reference(ints[c][s],shift,16);
+    }
+
+  void ref_s24(FXuint nc,FXuint offset,FXuint n,FXint shift,FXuchar * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++,out+=3) {
+        const FXint v = reference(ints[c][s],shift,24);
+        out[0] = v&0xFF;
+        out[1] = (v>>8)&0xFF;
+        out[2] = (v>>16)&0xFF;
+        }
+    }
+
+  void ref_s32(FXuint nc,FXuint offset,FXuint n,FXint * out) const {
+    for (FXuint s=offset;s<offset+n;s++)
+      for (FXuint c=0;c<nc;c++) *out++ = ints[c][s];
+    }
+
+  void compare(const FXchar * name,FXuint nc,FXuint offset,FXuint n,FXuint size) {
+    if (memcmp(output,expect,n*nc*size)) {
+      if (errors<10) fxmessage("%s mismatch for %u channels at %u+%u\n",name,nc,offset,n);
+      errors++;
+      }
+    }
+
+  // Random shapes, with the shifts the decoders use
+  void check(FXuint rounds) {
+    FXRandom random(2);
+    const FXint shifts[] = {0,1,9,13,16,31};
+    for (FXuint r=0;r<rounds;r++) {
+      const FXuint nc     = 1+random.randLong()%MAXCHANNELS;
+      const FXuint n      = random.randLong()%FXMIN(nframes,2048u);
+      const FXuint offset = random.randLong()%(nframes-n+1);
+      const FXint  shift  = shifts[random.randLong()%ARRAYNUMBER(shifts)];
+      const FXint  * const * in  = ints;
+      const FXfloat* const * inf = floats;
+
+      interleave_float(inf,nc,offset,n,(FXfloat*)output);
+      ref_float(nc,offset,n,(FXfloat*)expect);
+      compare("float",nc,offset,n,4);
+
+      interleave_fixed_to_float(in,nc,offset,n,28,(FXfloat*)output);
+      ref_fixed(nc,offset,n,28,(FXfloat*)expect);
+      compare("fixed",nc,offset,n,4);
+
+      interleave_s8(in,nc,offset,n,shift+24>31 ? 31 : shift+24,(FXchar*)output);
+      ref_s8(nc,offset,n,shift+24>31 ? 31 : shift+24,(FXchar*)expect);
+      compare("s8",nc,offset,n,1);
+
+      interleave_s16(in,nc,offset,n,shift,(FXshort*)output);
+      ref_s16(nc,offset,n,shift,(FXshort*)expect);
+      compare("s16",nc,offset,n,2);
+
+      interleave_s24le3(in,nc,offset,n,shift,output);
+      ref_s24(nc,offset,n,shift,expect);
+      compare("s24",nc,offset,n,3);
+
+      interleave_s32(in,nc,offset,n,(FXint*)output);
+      ref_s32(nc,offset,n,(FXint*)expect);
+      compare("s32",nc,offset,n,4);
+      }
+    }
+
+  template<typename F>
+  static FXdouble measure(F f) {
+    FXTime start = FXThread::steadytime();
+    for (FXuint i=0;i<16;i++) f();
+    return (FXThread::steadytime()-start)/16000000.0;
+    }
+
+  // Time a plain loop against the kernels in blocks of 1152 frames, as a decoder would
+  void bench(FXuint nc) {
+    const FXuint B = 1152;
+    const FXint  * const * in  = ints;
+    const FXfloat* const * inf = floats;
+    struct { const FXchar * name; FXdouble ref,ker; } r[5];
+    r[0].name = "float";
+    r[0].ref  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) ref_float(nc,s,B,(FXfloat*)expect+s*nc); });
+    r[0].ker  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) interleave_float(inf,nc,s,B,(FXfloat*)output+s*nc); });
+    r[1].name = "fixed";
+    r[1].ref  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) ref_fixed(nc,s,B,28,(FXfloat*)expect+s*nc); });
+    r[1].ker  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) interleave_fixed_to_float(in,nc,s,B,28,(FXfloat*)output+s*nc); });
+    r[2].name = "s16";
+    r[2].ref  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) ref_s16(nc,s,B,13,(FXshort*)expect+s*nc); });
+    r[2].ker  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) interleave_s16(in,nc,s,B,13,(FXshort*)output+s*nc); });
+    r[3].name = "s24";
+    r[3].ref  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) ref_s24(nc,s,B,0,expect+s*nc*3); });
+    r[3].ker  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) interleave_s24le3(in,nc,s,B,0,output+s*nc*3); });
+    r[4].name = "s32";
+    r[4].ref  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) ref_s32(nc,s,B,(FXint*)expect+s*nc); });
+    r[4].ker  = measure([&]{ for (FXuint s=0;s+B<=nframes;s+=B) interleave_s32(in,nc,s,B,(FXint*)output+s*nc); });
+    for (FXuint i=0;i<ARRAYNUMBER(r);i++)
+      fxmessage("%u ch %-6s %8.3f ms loop %8.3f ms kernel %5.2fx\n",nc,r[i].name,r[i].ref,r[i].ker,r[i].ref/r[i].ker);
+    }
+  };
+
+
+int main(int argc,char * argv[]) {
+  FXuint nframes = 1<<20;
+  FXuint rounds  = 20000;
+
+  for (FXint i=1;i+1<argc;i+=2) {
+    FXuint value = FXString(argv[i+1]).toUInt();
+    if (FXString::compare(argv[i],"-n")==0)
+      nframes = FXMAX(4096u,value);
+    else if (FXString::compare(argv[i],"-r")==0)
+      rounds = value;
+    }
+
+  fxmessage("kernels  %s\n",interleave_kernels());
+  Test test(nframes);
+  test.check(rounds);
+  test.bench(2);
+  test.bench(1);
+  test.bench(6);
+  fxmessage("errors   %u\n",test.errors);
+  return test.errors ? 1 : 0;
+  }
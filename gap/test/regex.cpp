@@ -0,0 +1,152 @@
+#include <fx.h>
+
+/*
+  Benchmark the regular expressions used by gogglesmm on generated
+  input, with both the backtracking and the lock-step matcher.
+
+  usage: gap_regex [iterations]
+*/
+
+struct Pattern {
+  const FXchar * name;
+  const FXchar * pattern;
+  FXint          mode;
+  FXint          input;
+  };
+
+enum {
+  INPUT_LRC,
+  INPUT_HTML,
+  INPUT_PAGE,
+  INPUT_TITLES
+  };
+
+static const Pattern patterns[]={
+  {"lrc word tags",   "<\\d\\d:\\d\\d.\\d\\d>",                FXRex::Normal,                     INPUT_LRC},
+  {"html linebreaks", "(</?div[^>*]>|<\\s*br\\s*/?>)",         FXRex::IgnoreCase|FXRex::Normal,   INPUT_HTML},
+  {"html sup",        "<sup\\s*>.*</sup\\s*>",                 FXRex::IgnoreCase|FXRex::Normal,   INPUT_HTML},
+  {"html tags",       "</?[^>]*/?>",                           FXRex::Normal,                     INPUT_HTML},
+  {"feed link",       "<link[^>]*>",                           FXRex::IgnoreCase|FXRex::Normal,   INPUT_PAGE},
+  {"filter word",     "remaster",                              FXRex::Normal,                     INPUT_TITLES},
+  {"filter prefix",   "The .*",                                FXRex::Normal,                     INPUT_TITLES},
+  {"filter alt",      ".*(live|demo|remix)",                   FXRex::IgnoreCase|FXRex::Normal,   INPUT_TITLES},
+  };
+
+static const FXchar * words[]={
+  "love","night","the","heart","never","dance","road","home","fire","rain",
+  "light","dream","you","forever","tonight","baby","world","time","shadow","river"
+  };
+
+
+static FXString make_lrc(FXint lines) {
+  FXString out;
+  for (FXint i=0;i<lines;i++) {
+    out+=FXString::value("[%02d:%02d.%02d]",i/60,i%60,(i*7)%100);
+    for (FXint w=0;w<6;w++) {
+      out+=FXString::value("<%02d:%02d.%02d>%s ",i/60,i%60,(w*13)%100,words[(i+w)%20]);
+      }
+    out+="\n";
+    }
+  return out;
+  }
+
+
+static FXString make_html(FXint lines) {
+  FXString out("<html><head><title>Lyrics</title></head><body><div class=\"lyrics\">\n");
+  for (FXint i=0;i<lines;i++) {
+    for (FXint w=0;w<8;w++) {
+      out+=words[(i*3+w)%20];
+      out+=' ';
+      }
+    if (i%10==0) out+="<sup>1</sup>";
+    if (i%4==0) out+="<i>oh</i>";
+    out+=(i%2) ? "<br/>\n" : "<BR>\n";
+    }
+  out+="</div></body></html>\n";
+  return out;
+  }
+
+
+static FXString make_page(FXint lines) {
+  FXString out("<!DOCTYPE html><html><head><meta charset=\"utf-8\">\n");
+  out+="<link rel=\"stylesheet\" href=\"/style.css\">\n";
+  out+="<link rel=\"alternate\" type=\"application/rss+xml\" title=\"Podcast\" href=\"https://example.com/feed.xml\">\n";
+  out+="</head><body>\n";
+  for (FXint i=0;i<lines;i++) {
+    out+=FXString::value("<p class=\"episode\"><a href=\"/episode/%d\">Episode %d</a> %s %s %s</p>\n",i,i,words[i%20],words[(i+5)%20],words[(i+11)%20]);
+    }
+  out+="</body></html>\n";
+  return out;
+  }
+
+
+static void make_titles(FXArray<FXString> & titles,FXint n) {
+  static const FXchar * suffix[]={""," (Live)"," - 2011 Remaster"," (Demo)"," [Remix]",""};
+  titles.no(n);
+  for (FXint i=0;i<n;i++) {
+    titles[i] = (i%7==0) ? "The " : "";
+    titles[i]+=FXString::value("%s %s %s%s",words[i%20],words[(i*3)%20],words[(i*7)%20],suffix[i%6]);
+    }
+  }
+
+
+// Search the whole text, the way the lyrics and podcast code does
+static FXint search_all(const FXRex & rex,const FXString & text,FXint mode) {
+  FXint b[1],e[1],f=0,n=0;
+  while(f<text.length() && rex.search(text,f,text.length()-1,mode,b,e,1)>=0) {
+    f=FXMAX(e[0],b[0]+1);
+    n++;
+    }
+  return n;
+  }
+
+
+// Anchored match per title, the way the REGEXP callback does
+static FXint match_all(const FXRex & rex,const FXArray<FXString> & titles,FXint mode) {
+  FXint n=0;
+  for (FXint i=0;i<titles.no();i++) {
+    if (rex.amatch(titles[i],0,mode)) n++;
+    }
+  return n;
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXint iterations = (argc==2) ? FXString(argv[1]).toInt() : 200;
+  FXArray<FXString> titles;
+  FXString input[3];
+
+  input[INPUT_LRC]  = make_lrc(120);
+  input[INPUT_HTML] = make_html(200);
+  input[INPUT_PAGE] = make_page(500);
+  make_titles(titles,20000);
+
+  fxmessage("%-16s %10s %12s %12s %8s\n","pattern","matches","normal (us)","linear (us)","speedup");
+  for (FXuint p=0;p<ARRAYNUMBER(patterns);p++) {
+    FXRex::Error error;
+    FXRex rex(patterns[p].pattern,patterns[p].mode,&error);
+    if (error!=FXRex::ErrOK) {
+      fxmessage("%s: %s\n",patterns[p].name,FXRex::getError(error));
+      continue;
+      }
+    FXTime elapsed[2];
+    FXint matches[2];
+    for (FXint m=0;m<2;m++) {
+      FXint mode = (m==0) ? FXRex::Normal : FXRex::Linear;
+      FXTime start = FXThread::steadytime();
+      for (FXint i=0;i<iterations;i++) {
+        if (patterns[p].input==INPUT_TITLES)
+          matches[m]=match_all(rex,titles,mode);
+        else
+          matches[m]=search_all(rex,input[patterns[p].input],mode);
+        }
+      elapsed[m] = (FXThread::steadytime()-start) / iterations;
+      }
+    if (matches[0]!=matches[1]) {
+      fxmessage("%s: matchers disagree (%d vs %d)\n",patterns[p].name,matches[0],matches[1]);
+      return 1;
+      }
+    fxmessage("%-16s %10d %12.1f %12.1f %7.2fx\n",patterns[p].name,matches[0],elapsed[0]/1000.0,elapsed[1]/1000.0,(FXdouble)elapsed[0]/(FXdouble)FXMAX(elapsed[1],1));
+    }
+  return 0;
+  }
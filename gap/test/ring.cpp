@@ -0,0 +1,141 @@
+#include <fx.h>
+#include "ap_ring_buffer.h"
+
+using namespace ap;
+
+/*
+  RingBuffer stress test. A producer thread writes numbered frames in random
+  chunks and now and then drops what it wrote, the consumer reads in fixed
+  periods, as a sound server callback would. The consumer checks that every
+  frame is whole and that frames only go forward, skipping ahead only when
+  frames were dropped.
+
+  usage: gap_ring [-n frames] [-c channels] [-p period]
+*/
+
+static const FXuint NOFRAME = 0xffffffff;
+static const FXuint MASK    = 0xfffff;  // frame numbers stay exact as float
+
+class Producer : public FXThread {
+public:
+  RingBuffer & ring;
+  FXuint       total;
+  FXuint       ndrops = 0;
+  FXuint       nfull  = 0;
+public:
+  Producer(RingBuffer & r,FXuint n) : ring(r),total(n) {}
+
+  FXint run() {
+    FXRandom random(1);
+    FXfloat  frame[8];
+    FXuint   next = 0;
+    while(next<total) {
+      FXuint n = FXMIN(1+random.randLong()%4096,total-next);
+      while(n) {
+        FXuint count = n;
+        FXfloat * ptr = ring.wptr(count);
+        if (count==0) {
+          nfull++;
+          FXThread::yield();
+          continue;
+          }
+        for (FXuint i=0;i<count;i++,next++) {
+          for (FXuint c=0;c<ring.numChannels();c++) frame[c]=(FXfloat)(next&MASK)+c;
+          memcpy(ptr+i*ring.numChannels(),frame,sizeof(FXfloat)*ring.numChannels());
+          }
+        ring.commit(count);
+        n-=count;
+        }
+      if (next<total && random.randLong()%64==0) {
+        ring.drop();
+        ndrops++;
+        }
+      }
+    return 0;
+    }
+  };
+
+
+class Consumer : public FXThread {
+public:
+  RingBuffer & ring;
+  FXuint       period;
+  FXuint       total;
+  FXuint       nread    = 0;
+  FXuint       nskipped = 0;
+  FXuint       nempty   = 0;
+  FXuint       errors   = 0;
+public:
+  Consumer(RingBuffer & r,FXuint p,FXuint n) : ring(r),period(p),total(n) {}
+
+  FXint run() {
+    FXuint last = NOFRAME;
+    while(last==NOFRAME || last+1<total) {
+      FXuint done=0;
+      while(done<period) {
+        FXuint n = period-done;
+        const FXfloat * src = ring.rptr(n);
+        if (n==0) break;
+        for (FXuint i=0;i<n;i++) {
+          const FXuint value = (FXuint)src[i*ring.numChannels()];
+          for (FXuint c=1;c<ring.numChannels();c++) {
+            if (src[i*ring.numChannels()+c]!=(FXfloat)value+c) errors++;
+            }
+          const FXuint expect = (last==NOFRAME) ? 0 : ((last+1)&MASK);
+          if (value!=expect) {
+            if (last!=NOFRAME && ((value-expect)&MASK)>(MASK>>1)) errors++;
+            nskipped++;
+            }
+          last = (last==NOFRAME) ? value : last+1+((value-expect)&MASK);
+          }
+        ring.release(n);
+        nread+=n;
+        done+=n;
+        }
+      if (done<period) {
+        nempty++;
+        FXThread::yield();
+        }
+      }
+    return 0;
+    }
+  };
+
+
+int main(int argc,char * argv[]) {
+  FXuint nframes  = 10000000;
+  FXuint channels = 2;
+  FXuint period   = 256;
+
+  for (FXint i=1;i+1<argc;i+=2) {
+    FXuint value = FXString(argv[i+1]).toUInt();
+    if (FXString::compare(argv[i],"-n")==0)
+      nframes = FXMAX(1u,value);
+    else if (FXString::compare(argv[i],"-c")==0)
+      channels = FXCLAMP(1u,value,8u);
+    else if (FXString::compare(argv[i],"-p")==0)
+      period = FXMAX(1u,value);
+    }
+
+  RingBuffer ring;
+  if (!ring.init(16384,channels)) {
+    fxmessage("unable to allocate ring\n");
+    return 1;
+    }
+
+  Producer producer(ring,nframes);
+  Consumer consumer(ring,period,nframes);
+
+  FXTime start = FXThread::steadytime();
+  consumer.start();
+  producer.start();
+  producer.join();
+  consumer.join();
+  FXTime elapsed = FXThread::steadytime()-start;
+
+  fxmessage("frames   %u written, %u read, %u drops, %u skips\n",nframes,consumer.nread,producer.ndrops,consumer.nskipped);
+  fxmessage("waits    %u full, %u empty periods\n",producer.nfull,consumer.nempty);
+  fxmessage("time     %.2f ms, %.1f Mframes/s\n",elapsed/1000000.0,(consumer.nread/1000000.0)/(elapsed/1000000000.0));
+  fxmessage("errors   %u\n",consumer.errors);
+  return consumer.errors ? 1 : 0;
+  }
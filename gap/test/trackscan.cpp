@@ -0,0 +1,198 @@
+#include <fx.h>
+#include <sqlite3.h>
+
+/*
+  Benchmark scanning the tracks table with lyrics stored inline
+  (schema 2018) versus lyrics stored in the track_text side table (schema 2019).
+
+  usage: gap_trackscan [tracks] [iterations]
+*/
+
+static const FXchar create_albums[]="CREATE TABLE albums (id INTEGER NOT NULL, name TEXT NOT NULL, artist INTEGER NOT NULL, year INTEGER, audio_channels INTEGER, audio_rate INTEGER, audio_format INTEGER, PRIMARY KEY (id));";
+
+static const FXchar create_tracks_inline[]="CREATE TABLE tracks (id INTEGER NOT NULL, collection INTEGER NOT NULL, path INTEGER NOT NULL, mrl TEXT, title TEXT NOT NULL, time INTEGER, no INTEGER, year INTEGER, bitrate INTEGER, album INTEGER NOT NULL, artist INTEGER NOT NULL, composer INTEGER, conductor INTEGER, playcount INTEGER, playdate INTEGER, importdate INTEGER, rating INTEGER, samplerate INTEGER, channels INTEGER, filetype INTEGER, lyrics TEXT, PRIMARY KEY (id));";
+
+static const FXchar create_tracks[]="CREATE TABLE tracks (id INTEGER NOT NULL, collection INTEGER NOT NULL, path INTEGER NOT NULL, mrl TEXT, title TEXT NOT NULL, time INTEGER, no INTEGER, year INTEGER, bitrate INTEGER, album INTEGER NOT NULL, artist INTEGER NOT NULL, composer INTEGER, conductor INTEGER, playcount INTEGER, playdate INTEGER, importdate INTEGER, rating INTEGER, samplerate INTEGER, channels INTEGER, filetype INTEGER, PRIMARY KEY (id));";
+
+static const FXchar create_track_text[]="CREATE TABLE track_text (track INTEGER NOT NULL REFERENCES tracks(id), lyrics TEXT, PRIMARY KEY (track));";
+
+// Same columns as GMDatabaseSource::listTracks
+static const FXchar list_tracks[]="SELECT tracks.id, tracks.path, tracks.mrl, tracks.title, tracks.time, tracks.no, tracks.year, tracks.artist, tracks.composer, tracks.conductor, "
+                                  "albums.artist, albums.name, albums.year, albums.id, tracks.playcount, tracks.bitrate, tracks.samplerate, tracks.channels, tracks.filetype, tracks.playdate, tracks.rating "
+                                  "FROM tracks JOIN albums ON tracks.album == albums.id;";
+
+// Same shape as a GMFilter title match
+static const FXchar filter_tracks[]="SELECT id FROM tracks WHERE title LIKE '%night%';";
+
+static const FXchar count_tracks[]="SELECT COUNT(*), SUM(time) FROM tracks;";
+
+static const FXchar * words[]={
+  "love","night","the","heart","never","dance","road","home","fire","rain",
+  "light","dream","you","forever","tonight","baby","world","time","shadow","river"
+  };
+
+
+static FXbool execute(sqlite3 * db,const FXchar * sql) {
+  FXchar * msg = nullptr;
+  if (sqlite3_exec(db,sql,nullptr,nullptr,&msg)!=SQLITE_OK) {
+    fxwarning("%s\n",msg);
+    sqlite3_free(msg);
+    return false;
+    }
+  return true;
+  }
+
+
+// Synced lyrics of about 4kb
+static FXString make_lyrics(FXint t) {
+  FXString out;
+  for (FXint i=0;i<60;i++) {
+    out+=FXString::value("[%02d:%02d.%02d]",i/20,(i*3)%60,(t+i)%100);
+    for (FXint w=0;w<6;w++) {
+      out+=words[(t+i*7+w)%20];
+      out+=' ';
+      }
+    out+='\n';
+    }
+  return out;
+  }
+
+
+static FXbool populate(const FXString & filename,FXbool sidetable,FXint ntracks) {
+  sqlite3 * db = nullptr;
+  sqlite3_stmt * insert_track = nullptr;
+  sqlite3_stmt * insert_text = nullptr;
+  FXbool ok = false;
+
+  FXFile::remove(filename);
+  if (sqlite3_open(filename.text(),&db)!=SQLITE_OK)
+    goto done;
+
+  execute(db,"BEGIN");
+  execute(db,create_albums);
+  execute(db,sidetable ? create_tracks : create_tracks_inline);
+  if (sidetable) execute(db,create_track_text);
+
+  for (FXint a=0;a<ntracks/10+1;a++) {
+    execute(db,FXString::value("INSERT INTO albums VALUES (%d,'%s %s',%d,%d,2,44100,16);",a+1,words[a%20],words[(a*3)%20],a%500+1,1970+a%50).text());
+    }
+
+  if (sqlite3_prepare_v2(db,sidetable ? "INSERT INTO tracks VALUES (?,1,?,?,?,?,?,?,320,?,?,NULL,NULL,0,0,0,0,44100,2,1);"
+                                      : "INSERT INTO tracks VALUES (?,1,?,?,?,?,?,?,320,?,?,NULL,NULL,0,0,0,0,44100,2,1,?);",-1,&insert_track,nullptr)!=SQLITE_OK)
+    goto done;
+
+  if (sidetable && sqlite3_prepare_v2(db,"INSERT INTO track_text VALUES (?,?);",-1,&insert_text,nullptr)!=SQLITE_OK)
+    goto done;
+
+  for (FXint t=0;t<ntracks;t++) {
+    FXString mrl = FXString::value("%02d - %s %s.flac",t%12+1,words[t%20],words[(t*7)%20]);
+    FXString title = FXString::value("%s %s %s",words[t%20],words[(t*7)%20],words[(t*3)%20]);
+    FXString lyrics;
+    if (t%5!=0) lyrics = make_lyrics(t);
+
+    sqlite3_bind_int(insert_track,1,t+1);
+    sqlite3_bind_int(insert_track,2,t/12+1);
+    sqlite3_bind_text(insert_track,3,mrl.text(),mrl.length(),SQLITE_TRANSIENT);
+    sqlite3_bind_text(insert_track,4,title.text(),title.length(),SQLITE_TRANSIENT);
+    sqlite3_bind_int(insert_track,5,180+t%240);
+    sqlite3_bind_int(insert_track,6,t%12+1);
+    sqlite3_bind_int(insert_track,7,1970+t%50);
+    sqlite3_bind_int(insert_track,8,t/10+1);
+    sqlite3_bind_int(insert_track,9,t%500+1);
+    if (!sidetable) {
+      if (lyrics.empty())
+        sqlite3_bind_null(insert_track,10);
+      else
+        sqlite3_bind_text(insert_track,10,lyrics.text(),lyrics.length(),SQLITE_TRANSIENT);
+      }
+    sqlite3_step(insert_track);
+    sqlite3_reset(insert_track);
+
+    if (sidetable && !lyrics.empty()) {
+      sqlite3_bind_int(insert_text,1,t+1);
+      sqlite3_bind_text(insert_text,2,lyrics.text(),lyrics.length(),SQLITE_TRANSIENT);
+      sqlite3_step(insert_text);
+      sqlite3_reset(insert_text);
+      }
+    }
+  ok = execute(db,"COMMIT");
+done:
+  sqlite3_finalize(insert_track);
+  sqlite3_finalize(insert_text);
+  sqlite3_close(db);
+  return ok;
+  }
+
+
+// Run query on a fresh connection, so nothing is in the sqlite page cache
+static FXTime run(const FXString & filename,const FXchar * sql,FXint iterations,FXint & rows) {
+  FXTime start = FXThread::steadytime();
+  for (FXint i=0;i<iterations;i++) {
+    sqlite3 * db = nullptr;
+    sqlite3_stmt * stmt = nullptr;
+    sqlite3_open_v2(filename.text(),&db,SQLITE_OPEN_READONLY,nullptr);
+    sqlite3_prepare_v2(db,sql,-1,&stmt,nullptr);
+    rows=0;
+    while(sqlite3_step(stmt)==SQLITE_ROW) {
+      sqlite3_column_text(stmt,0);
+      rows++;
+      }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    }
+  return (FXThread::steadytime()-start) / iterations;
+  }
+
+
+static FXint pages(const FXString & filename) {
+  sqlite3 * db = nullptr;
+  sqlite3_stmt * stmt = nullptr;
+  FXint n=0;
+  sqlite3_open_v2(filename.text(),&db,SQLITE_OPEN_READONLY,nullptr);
+  if (sqlite3_prepare_v2(db,"PRAGMA page_count;",-1,&stmt,nullptr)==SQLITE_OK && sqlite3_step(stmt)==SQLITE_ROW)
+    n = sqlite3_column_int(stmt,0);
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return n;
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXint ntracks    = (argc>1) ? FXString(argv[1]).toInt() : 20000;
+  FXint iterations = (argc>2) ? FXString(argv[2]).toInt() : 20;
+
+  const FXchar * names[2]={"inline","side table"};
+  const FXchar * queries[3]={list_tracks,filter_tracks,count_tracks};
+  const FXchar * labels[3]={"listTracks","filter","count"};
+  FXString filename[2];
+
+  filename[0] = FXPath::unique(FXPath::absolute(FXSystem::getTempDirectory(),"gap_trackscan_inline.db"));
+  filename[1] = FXPath::unique(FXPath::absolute(FXSystem::getTempDirectory(),"gap_trackscan_side.db"));
+
+  for (FXint s=0;s<2;s++) {
+    if (!populate(filename[s],s==1,ntracks)) {
+      fxmessage("failed to create %s\n",filename[s].text());
+      return 1;
+      }
+    }
+
+  fxmessage("%d tracks, %d iterations\n",ntracks,iterations);
+  fxmessage("%-12s %12s %12s\n","","inline","side table");
+  fxmessage("%-12s %12d %12d\n","pages",pages(filename[0]),pages(filename[1]));
+  for (FXint q=0;q<3;q++) {
+    FXTime elapsed[2];
+    FXint rows[2];
+    for (FXint s=0;s<2;s++) {
+      elapsed[s] = run(filename[s],queries[q],iterations,rows[s]);
+      }
+    if (rows[0]!=rows[1]) {
+      fxmessage("%s: %s returned %d rows, %s %d\n",labels[q],names[0],rows[0],names[1],rows[1]);
+      return 1;
+      }
+    fxmessage("%-12s %10.2fms %10.2fms\n",labels[q],elapsed[0]/1000000.0,elapsed[1]/1000000.0);
+    }
+
+  FXFile::remove(filename[0]);
+  FXFile::remove(filename[1]);
+  return 0;
+  }
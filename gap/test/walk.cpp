@@ -0,0 +1,240 @@
+#include <fx.h>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/*
+  Directory scan benchmark. Walks a directory tree the way the scanner used
+  to, with FXDir, FXStat and FXPath::match on full paths, and with
+  FXDirWalker. Counts the opens and stats made per 10000 matching files.
+  Without a directory, a tree of generated files is created first.
+
+  usage: gap_walk [-n files] [directory]
+*/
+
+static const FXchar pattern[]="*.(ogg,flac,opus,oga,mp3,m4a,mp4,m4p,m4b,aac)";
+static const FXuint matchflags=FXPath::PathName|FXPath::NoEscape|FXPath::CaseFold;
+
+static volatile FXlong nopen = 0;
+static volatile FXlong nstat = 0;
+
+#if defined(__GLIBC__)
+
+// Count the calls made through libc, including the large file variants
+#define NEXT(name) static decltype(&::name) next_##name = (decltype(&::name))dlsym(RTLD_NEXT,#name)
+
+#define COUNT_OPEN(name)                                      \
+extern "C" int name(const char * path,int flags,...) {        \
+  NEXT(name);                                                 \
+  va_list args;                                               \
+  va_start(args,flags);                                       \
+  mode_t mode = (flags&O_CREAT) ? va_arg(args,int) : 0;       \
+  va_end(args);                                               \
+  atomicAdd(&nopen,1);                                        \
+  return next_##name(path,flags,mode);                        \
+  }
+
+#define COUNT_OPENAT(name)                                    \
+extern "C" int name(int fd,const char * path,int flags,...) { \
+  NEXT(name);                                                 \
+  va_list args;                                               \
+  va_start(args,flags);                                       \
+  mode_t mode = (flags&O_CREAT) ? va_arg(args,int) : 0;       \
+  va_end(args);                                               \
+  atomicAdd(&nopen,1);                                        \
+  return next_##name(fd,path,flags,mode);                     \
+  }
+
+#define COUNT_STAT(name,type)                                 \
+extern "C" int name(const char * path,type * data) {          \
+  NEXT(name);                                                 \
+  atomicAdd(&nstat,1);                                        \
+  return next_##name(path,data);                              \
+  }
+
+#define COUNT_FSTAT(name,type)                                \
+extern "C" int name(int fd,type * data) {                     \
+  NEXT(name);                                                 \
+  atomicAdd(&nstat,1);                                        \
+  return next_##name(fd,data);                                \
+  }
+
+#define COUNT_FSTATAT(name,type)                                          \
+extern "C" int name(int fd,const char * path,type * data,int flags) {     \
+  NEXT(name);                                                             \
+  atomicAdd(&nstat,1);                                                    \
+  return next_##name(fd,path,data,flags);                                 \
+  }
+
+COUNT_OPEN(open)
+COUNT_OPEN(open64)
+COUNT_OPENAT(openat)
+COUNT_OPENAT(openat64)
+COUNT_STAT(stat,struct stat)
+COUNT_STAT(stat64,struct stat64)
+COUNT_STAT(lstat,struct stat)
+COUNT_STAT(lstat64,struct stat64)
+COUNT_FSTAT(fstat,struct stat)
+COUNT_FSTAT(fstat64,struct stat64)
+COUNT_FSTATAT(fstatat,struct stat)
+COUNT_FSTATAT(fstatat64,struct stat64)
+
+extern "C" DIR * opendir(const char * path) {
+  NEXT(opendir);
+  atomicAdd(&nopen,1);
+  return next_opendir(path);
+  }
+
+#endif
+
+
+struct Result {
+  FXlong files  = 0;
+  FXlong opens  = 0;
+  FXlong stats  = 0;
+  FXTime elapsed = 0;
+
+  FXdouble per10k(FXlong n) const { return files ? (n*10000.0)/files : 0.0; }
+  };
+
+
+struct Seen {
+  Seen * next;
+  FXlong node;
+  };
+
+
+// As GMImportTask::scan used to do it
+static void scan(const FXString & path,Seen * seen,FXlong index,Result & result) {
+  FXDir    directory;
+  FXStat   data;
+  FXString name;
+
+  Seen here={seen,index};
+
+  if (directory.open(path)) {
+    while(directory.next(name)) {
+      if (FXStat::statLink(path+PATHSEPSTRING+name,data)) {
+        if (data.isDirectory()) {
+          if(!(name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))){
+            for(Seen *s=seen; s; s=s->next){
+              if(data.index()==s->node) goto next_dir;
+              }
+            scan(path+PATHSEPSTRING+name,&here,data.index(),result);
+            }
+          }
+        }
+next_dir:;
+      }
+    directory.close();
+    }
+
+  if(directory.open(path)) {
+    while(directory.next(name)) {
+      if (FXStat::statFile(path+PATHSEPSTRING+name,data)) {
+        if (!data.isDirectory() && data.isReadable()) {
+          if (FXPath::match(name,pattern,matchflags)) {
+            result.files++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+
+class Walker : public FXDirWalker {
+public:
+  Result & result;
+public:
+  Walker(Result & r) : result(r) {}
+  FXuint visit(const FXString&,const FXString&) {
+    result.files++;
+    return 1;
+    }
+  };
+
+
+static void run_scan(const FXString & path,Result & result) {
+  FXStat data;
+  FXlong o=nopen,s=nstat;
+  FXTime start=FXThread::steadytime();
+  if (FXStat::statLink(path,data))
+    scan(path,nullptr,data.index(),result);
+  result.elapsed=FXThread::steadytime()-start;
+  result.opens=nopen-o;
+  result.stats=nstat-s;
+  }
+
+
+static void run_walk(const FXString & path,Result & result) {
+  Walker walker(result);
+  FXlong o=nopen,s=nstat;
+  FXTime start=FXThread::steadytime();
+  walker.walk(path,pattern,FXDir::HiddenFiles|FXDir::HiddenDirs|FXDir::CaseFold);
+  result.elapsed=FXThread::steadytime()-start;
+  result.opens=nopen-o;
+  result.stats=nstat-s;
+  }
+
+
+// Albums of 10 tracks with a cover and a playlist, 10 albums per artist
+static FXbool generate(const FXString & root,FXint nfiles) {
+  const FXchar * extensions[]={"mp3","flac","ogg","m4a"};
+  FXint n=0;
+  for (FXint artist=0;n<nfiles;artist++) {
+    for (FXint album=0;album<10 && n<nfiles;album++) {
+      FXString path=FXString::value("%s/artist%d/album%d",root.text(),artist,album);
+      if (!FXDir::createDirectories(path))
+        return false;
+      for (FXint track=0;track<10 && n<nfiles;track++,n++) {
+        FXFile file(FXString::value("%s/%02d track.%s",path.text(),track+1,extensions[artist%4]),FXIO::Writing);
+        }
+      FXFile cover(path+"/cover.jpg",FXIO::Writing);
+      FXFile playlist(path+"/album.m3u",FXIO::Writing);
+      }
+    }
+  return true;
+  }
+
+
+int main(int argc,char * argv[]) {
+  FXint    nfiles = 10000;
+  FXString path;
+  FXbool   generated = false;
+
+  for (FXint i=1;i<argc;i++) {
+    if (FXString::compare(argv[i],"-n")==0 && i+1<argc) {
+      nfiles = FXString(argv[++i]).toInt();
+      nfiles = FXMAX(1,nfiles);
+      }
+    else
+      path = FXPath::absolute(argv[i]);
+    }
+
+  if (path.empty()) {
+    path = FXPath::unique(FXSystem::getTempDirectory()+PATHSEPSTRING+"gap_walk");
+    if (!generate(path,nfiles)) {
+      fxmessage("unable to create %s\n",path.text());
+      return 1;
+      }
+    generated = true;
+    }
+
+  Result old_scan,new_walk;
+  run_scan(path,old_scan);
+  run_walk(path,new_walk);
+
+  fxmessage("%-12s %10s %10s %12s %12s %10s\n","method","files","ms","opens/10k","stats/10k","total/10k");
+  fxmessage("%-12s %10lld %10.2f %12.1f %12.1f %10.1f\n","scan",old_scan.files,old_scan.elapsed/1000000.0,old_scan.per10k(old_scan.opens),old_scan.per10k(old_scan.stats),old_scan.per10k(old_scan.opens+old_scan.stats));
+  fxmessage("%-12s %10lld %10.2f %12.1f %12.1f %10.1f\n","walker",new_walk.files,new_walk.elapsed/1000000.0,new_walk.per10k(new_walk.opens),new_walk.per10k(new_walk.stats),new_walk.per10k(new_walk.opens+new_walk.stats));
+
+  if (generated)
+    FXFile::removeFiles(path,true);
+
+  return (old_scan.files==new_walk.files) ? 0 : 1;
+  }
@@ -28,108 +28,70 @@
 
 
 
-#define GET_ARTIST_STRING(x)  GMPlayerManager::instance()->getTrackDatabase()->getArtist(x)
+#define GET_ARTIST_KEY(x)  GMPlayerManager::instance()->getTrackDatabase()->getArtistKey(x)
 
 
-// return true if string starts with configured keyword
-static inline FXbool begins_with_keyword(const FXString & t){
-  for (FXint i=0;i<GMPlayerManager::instance()->getPreferences().gui_sort_keywords.no();i++){
-    if (FXString::comparecase(t,GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i],GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i].length())==0) return true;
-    }
-  return false;
-  }
-
-// return true if string starts with configured keyword
-static inline FXbool begins_with_keyword_ptr(const FXString * t){
-  for (FXint i=0;i<GMPlayerManager::instance()->getPreferences().gui_sort_keywords.no();i++){
-    if (FXString::comparecase(*t,GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i],GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i].length())==0) return true;
-    }
-  return false;
-  }
-
-// compare two string taking into account the configured keywords it needs to ignore
-static inline FXint keywordcompare(const FXString *a,const FXString *b) {
-  FXint pa,pb;
-
+// compare two collation keys
+static inline FXint keycompare(const FXString * a,const FXString * b) {
   if (a==b) return 0;
-
-  if (begins_with_keyword_ptr(a))
-    pa=FXMIN(a->length()-1,a->find(' ')+1);
-  else
-    pa=0;
-
-  if (begins_with_keyword_ptr(b))
-    pb=FXMIN(b->length()-1,b->find(' ')+1);
-  else
-    pb=0;
-  return FXString::comparecase(&((*a)[pa]),&((*b)[pb]));
-  }
-
-// compare two string taking into account the configured keywords it needs to ignore
-static inline FXint keywordcompare(const FXString & a,const FXString & b) {
-  FXint pa,pb;
-  if (begins_with_keyword(a))
-    pa=FXMIN(a.length()-1,a.find(' ')+1);
-  else
-    pa=0;
-
-  if (begins_with_keyword(b))
-    pb=FXMIN(b.length()-1,b.find(' ')+1);
-  else
-    pb=0;
-  return FXString::comparecase(&((a)[pa]),&((b)[pb]));
+  return FXCollate::compareKeys(*a,*b);
   }
 
 
 
 FXint GMAlbumListItem::album_list_sort(const GMAlbumListItem* pa,const GMAlbumListItem* pb){
-  FXint a=0,b=0;
   if (GMTrackView::album_by_year) {
     if (pa->year>pb->year) return 1;
     else if (pa->year<pb->year) return -1;
     }
-  if (begins_with_keyword(pa->title)) a=FXMIN(pa->title.length()-1,pa->title.find(' ')+1);
-  if (begins_with_keyword(pb->title)) b=FXMIN(pb->title.length()-1,pb->title.find(' ')+1);
-  return FXString::comparecase(&pa->title[a],&pb->title[b]);
+  return FXCollate::compareKeys(pa->key,pb->key);
   }
 
 FXint GMAlbumListItem::album_list_sort_reverse(const GMAlbumListItem* pa,const GMAlbumListItem* pb){
-  FXint a=0,b=0;
   if (GMTrackView::album_by_year) {
     if (pa->year>pb->year) return -1;
     else if (pa->year<pb->year) return 1;
     }
-  if (begins_with_keyword(pa->title)) a=FXMIN(pa->title.length()-1,pa->title.find(' ')+1);
-  if (begins_with_keyword(pb->title)) b=FXMIN(pb->title.length()-1,pb->title.find(' ')+1);
-  return -FXString::comparecase(&pa->title[a],&pb->title[b]);
+  return -FXCollate::compareKeys(pa->key,pb->key);
   }
 
 
 
 FXint GMAlbumListItem::album_browser_sort(const GMAlbumListItem* pa,const GMAlbumListItem* pb){
-  FXint x = keywordcompare(GET_ARTIST_STRING(pa->artist),GET_ARTIST_STRING(pb->artist));
+  FXint x = keycompare(GET_ARTIST_KEY(pa->artist),GET_ARTIST_KEY(pb->artist));
   if (x!=0) return GMTrackView::reverse_artist ? -x : x;
   if (GMTrackView::album_by_year) {
     if (pa->year>pb->year) return 1;
     else if (pa->year<pb->year) return -1;
     }
-  return keywordcompare(pa->title,pb->title);
+  return FXCollate::compareKeys(pa->key,pb->key);
   }
 
 FXint GMAlbumListItem::album_browser_sort_reverse(const GMAlbumListItem* pa,const GMAlbumListItem* pb){
-  FXint x = keywordcompare(GET_ARTIST_STRING(pb->artist),GET_ARTIST_STRING(pa->artist));
+  FXint x = keycompare(GET_ARTIST_KEY(pb->artist),GET_ARTIST_KEY(pa->artist));
   if (x!=0) return GMTrackView::reverse_artist ? -x : x;
   if (GMTrackView::album_by_year) {
     if (pa->year>pb->year) return -1;
     else if (pa->year<pb->year) return 1;
     }
-  return keywordcompare(pa->title,pb->title);
+  return FXCollate::compareKeys(pa->key,pb->key);
   }
 
 
 // Object implementation
 FXIMPLEMENT(GMAlbumListItem,FXObject,nullptr,0)
 
+
+GMAlbumListItem::GMAlbumListItem(const FXint a,const FXString & t,FXint y,FXint i) : title(t),artist(a),year(y),id(i),state(DRAGGABLE) {
+  key = gm_sort_key(title,GMPlayerManager::instance()->getPreferences().gui_sort_keywords);
+  }
+
+
+GMAlbumListItem::GMAlbumListItem(const FXint a,const FXString & t,FXString & p,FXint y,FXint i) : title(t),audioproperty(p),artist(a),year(y),id(i),state(DRAGGABLE) {
+  key = gm_sort_key(title,GMPlayerManager::instance()->getPreferences().gui_sort_keywords);
+  }
+
+
 static void drawTextLimited(FXDC & dc,FXFont * font,FXint x,FXint y,FXint space,const FXString & text) {
   FXint dw,len=text.length();
   FXint tw = font->getTextWidth(text.text(),text.length());
@@ -342,6 +304,29 @@ void GMAlbumListItem::setShowArtist(FXbool showartist){
   }
 
 
+// Selection and focus are not saved
+void GMAlbumListItem::save(FXStream & store) const {
+  store << title;
+  store << key;
+  store << audioproperty;
+  store << artist;
+  store << year;
+  store << id;
+  store << (state&(DRAGGABLE|SHOW_ARTIST));
+  }
+
+
+void GMAlbumListItem::load(FXStream & store) {
+  store >> title;
+  store >> key;
+  store >> audioproperty;
+  store >> artist;
+  store >> year;
+  store >> id;
+  store >> state;
+  }
+
+
 FXint GMAlbumListItem::getWidth(const GMAlbumList * list){
   FXint w=0;
 
@@ -2221,6 +2206,36 @@ void GMAlbumList::clearItems(FXbool notify){
   recalc();
   }
 
+
+void GMAlbumList::saveItems(FXStream & store) const {
+  store << (FXint)items.no();
+  for (FXint i=0;i<items.no();i++) {
+    items[i]->save(store);
+    }
+  }
+
+
+FXbool GMAlbumList::loadItems(FXStream & store) {
+  FXint n;
+  clearItems();
+  store >> n;
+  if (store.status()!=FXStreamOK || n<0)
+    return false;
+  for (FXint i=0;i<n;i++) {
+    GMAlbumListItem * item = new GMAlbumListItem;
+    item->load(store);
+    if (store.status()!=FXStreamOK) {
+      delete item;
+      clearItems();
+      return false;
+      }
+    items.append(item);
+    }
+  recalc();
+  return true;
+  }
+
+
 // Get item by data
 FXint GMAlbumList::findItemById(const FXint needle,FXint start,FXuint flgs) const {
   FXint index;
@@ -48,6 +48,7 @@ class GMAlbumListItem : public FXObject {
   friend class GMAlbumList;
 protected:
   FXString  title;
+  FXString  key;         // collation key of title
   FXString  audioproperty;
   FXint     artist = 0;
   FXint     year   = 0;
@@ -76,10 +77,10 @@ public:
     SHOW_ARTIST   = 8
     };
 public:
-  GMAlbumListItem(const FXint a,const FXString & t,FXint y,FXint i): title(t),artist(a),year(y),id(i),state(DRAGGABLE){}
+  GMAlbumListItem(const FXint a,const FXString & t,FXint y,FXint i);
 
   /// Construct new item with given text, icons, and user-data
-  GMAlbumListItem(const FXint a,const FXString & t,FXString & p,FXint y,FXint i):title(t),audioproperty(p),artist(a),year(y),id(i),state(DRAGGABLE){}
+  GMAlbumListItem(const FXint a,const FXString & t,FXString & p,FXint y,FXint i);
 
   /// Return item's id
   FXint getId() const { return id; }
@@ -114,6 +115,12 @@ public:
   /// Get Title
   const FXString & getTitle() const { return title; }
 
+  /// Save to stream
+  virtual void save(FXStream& store) const;
+
+  /// Load from stream
+  virtual void load(FXStream& store);
+
   /// Destroy item and free icons if owned
   virtual ~GMAlbumListItem();
   };
@@ -310,6 +317,12 @@ public:
   /// Remove all items from list
   void clearItems(FXbool notify=false);
 
+  /// Save all items to stream
+  void saveItems(FXStream & store) const;
+
+  /// Replace all items with the ones loaded from stream
+  FXbool loadItems(FXStream & store);
+
   /// Return item width
   FXint getItemWidth() const { return itemWidth; }
 
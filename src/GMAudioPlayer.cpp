@@ -89,6 +89,14 @@ long GMAudioPlayer::onEngineEvents(FXObject*,FXSelector,void*){
             if (target) target->handle(this,FXSEL(SEL_PLAYER_VOLUME,message),(void*)(FXival)vvolume);
             break;
         }
+      case AP_OUTPUT_INFO            :
+        {
+            OutputInfo * info = static_cast<OutputInfo*>(event);
+            output.profile = info->profile;
+            output.latency = info->latency;
+            output.wakeups = info->wakeups;
+            break;
+        }
       default: break;
       }
     Event::unref(event);
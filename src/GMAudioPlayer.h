@@ -31,6 +31,13 @@ struct PlaybackTime {
   FXuint length = 0;
   };
 
+
+struct OutputLatency {
+  FXuchar profile = ProfileDefault;
+  FXuint  latency = 0;  // ms
+  FXuint  wakeups = 0;  // per second
+  };
+
 class GMAudioPlayer : public AudioPlayer {
   FXDECLARE(GMAudioPlayer);
 private:
@@ -40,6 +47,7 @@ private:
 protected:
   PlayerState    state = PLAYER_STOPPED;
   PlaybackTime   time;
+  OutputLatency  output;
   FXint          vvolume = -1;
 protected:
   GMAudioPlayer(){}
@@ -61,6 +69,9 @@ public:
 
   FXint getVolume() const { return vvolume; }
 
+  /// Latency and wakeups negotiated by the output, zero if unknown
+  const OutputLatency & getOutputLatency() const { return output; }
+
   void stop() { close(); }
 
   /// Status
@@ -172,9 +172,19 @@ FXlong GMCoverCacheWriter::fit(FXImage * image){
 
 
 FXbool GMCoverCacheWriter::insert(FXint id,GMCover * cover) {
-  FXint length;
   FXImage * image = GMCover::toImage(cover,info.size,1);
-  if (image && store.eof()==false) {
+  if (image) {
+    FXbool result = insert(id,image);
+    delete image;
+    return result;
+    }
+  return false;
+  }
+
+
+FXbool GMCoverCacheWriter::insert(FXint id,FXImage * image) {
+  FXint length;
+  if (store.eof()==false) {
 
     if (image->getWidth()!=info.size || image->getHeight()!=info.size)
       length=fit(image);
@@ -182,7 +192,6 @@ FXbool GMCoverCacheWriter::insert(FXint id,GMCover * cover) {
       length=save(image->getData());
 
     info.insert(id,store.position()-length,length);
-    delete image;
     return true;
     }
   return false;
@@ -349,23 +358,63 @@ GMCoverLoader::GMCoverLoader(const FXString & file,GMCoverPathList & pathlist,FX
   list.adopt(pathlist);
   }
 
+// Loads and scales a single cover on the thread pool
+class GMCoverDecodeJob : public FXRunnable {
+public:
+  FXString  path;
+  FXImage * image      = nullptr;
+  FXint     size       = 0;
+  FXbool    folderonly = false;
+public:
+  FXint run() {
+    GMCover * cover;
+    if (__likely(folderonly==false)) {
+      cover = GMCover::fromTag(path);
+      if (cover==nullptr) cover = GMCover::fromPath(FXPath::directory(path));
+      }
+    else {
+      cover = GMCover::fromPath(path);
+      }
+    image = GMCover::toImage(cover,size,1);
+    return 0;
+    }
+  };
+
+
 FXint GMCoverLoader::run() {
-  GMCover * cover;
   FXint percentage=0,p=-1;
   if (writer.open(filename)) {
-    for (FXint i=0;i<list.no() && processing;i++){
-      percentage = (FXint)(100.0f*((float)(i+1)/(float)list.no()));
-      if (p!=percentage)
-        taskmanager->setStatus(FXString::value("Loading Covers %d%%",percentage));
-      if (__likely(folderonly==false)) {
-        cover = GMCover::fromTag(list[i].path);
-        if (cover==nullptr) cover = GMCover::fromPath(FXPath::directory(list[i].path));
+
+    // Decode covers in batches across the pool and write them out in order
+    const FXint nbatch = 4*(GMThreadPool::instance() ? GMThreadPool::instance()->getMaximumThreads() : 1);
+    FXArray<GMCoverDecodeJob> jobs(nbatch);
+
+    for (FXint i=0,n;i<list.no() && processing;i+=n){
+      n = FXMIN(nbatch,list.no()-i);
+
+      GMTaskGroup group(this);
+      for (FXint j=0;j<n;j++) {
+        jobs[j].path       = list[i+j].path;
+        jobs[j].size       = writer.getSize();
+        jobs[j].folderonly = folderonly;
+        group.execute(&jobs[j]);
         }
-      else {
-        cover = GMCover::fromPath(list[i].path);
+      group.wait();
+
+      for (FXint j=0;j<n;j++) {
+        if (jobs[j].image) {
+          if (processing) writer.insert(list[i+j].id,jobs[j].image);
+          delete jobs[j].image;
+          jobs[j].image=nullptr;
+          }
         }
-       if (cover) writer.insert(list[i].id,cover);
+
+      percentage = (FXint)(100.0f*((float)(i+n)/(float)list.no()));
+      if (p!=percentage)
+        taskmanager->setStatus(FXString::value("Loading Covers %d%%",percentage));
+      p=percentage;
       }
+
     if (processing) {
       writer.finish();
       writer.close();
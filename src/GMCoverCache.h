@@ -70,6 +70,10 @@ public:
 
   FXbool insert(FXint id,GMCover*);
 
+  FXbool insert(FXint id,FXImage*);
+
+  FXint getSize() const { return info.size; }
+
   FXbool finish();
 
   FXbool close();
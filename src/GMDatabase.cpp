@@ -332,16 +332,29 @@ FXbool GMDatabase::open(const FXString & filename){
     return false;
     }
   init_regex();
+  init_collation();
   return true;
   }
 
 
+static void delete_regex(void * ptr) {
+  delete static_cast<FXRex*>(ptr);
+  }
+
+
 void GMDatabase::perform_regex_match(sqlite3_context *context, int argc, sqlite3_value **argv){
   if (argc==2) {
-    FXRex reg;
-    const FXchar * pattern = (const FXchar*)sqlite3_value_text(argv[0]);
-    const FXchar * value   = (const FXchar*)sqlite3_value_text(argv[1]);
-    if (value && reg.parse(pattern)==0  && reg.amatch(value,strlen(value))) {
+
+    // The pattern is the same for every row, so only parse it once per statement
+    FXRex * reg = static_cast<FXRex*>(sqlite3_get_auxdata(context,0));
+    if (reg==nullptr) {
+      const FXchar * pattern = (const FXchar*)sqlite3_value_text(argv[0]);
+      sqlite3_set_auxdata(context,0,new FXRex(pattern),delete_regex);
+      reg = static_cast<FXRex*>(sqlite3_get_auxdata(context,0));
+      }
+
+    const FXchar * value = (const FXchar*)sqlite3_value_text(argv[1]);
+    if (reg && value && reg->amatch(value,sqlite3_value_bytes(argv[1]),0,FXRex::Linear)) {
       sqlite3_result_int(context,1);
       return;
       }
@@ -364,6 +377,18 @@ void GMDatabase::init_regex() {
 
 
 
+int GMDatabase::perform_unicode_collation(void*,int n1,const void * s1,int n2,const void * s2) {
+  return FXCollate::compare((const FXchar*)s1,n1,(const FXchar*)s2,n2);
+  }
+
+
+void GMDatabase::init_collation() {
+  if (sqlite3_create_collation_v2(db,"UNICODE",SQLITE_UTF8,nullptr,perform_unicode_collation,nullptr)!=SQLITE_OK){
+    fxwarning("failed to register unicode collation\n");
+    }
+  }
+
+
 void GMDatabase::reset() {
   FXStringList tables;
   FXString table;
@@ -471,6 +496,17 @@ FXint GMDatabase::getVersion(){
   return v;
   }
 
+// Stored in the database header at offset 24 as big endian integer. Read through the file
+// handle of sqlite itself, closing another descriptor of the file would release its locks.
+FXuint GMDatabase::getChangeCounter() const {
+  sqlite3_file * file = nullptr;
+  FXuchar header[4];
+  if (sqlite3_file_control(db,"main",SQLITE_FCNTL_FILE_POINTER,&file)==SQLITE_OK && file && file->pMethods && file->pMethods->xRead(file,header,4,24)==SQLITE_OK)
+    return (header[0]<<24)|(header[1]<<16)|(header[2]<<8)|header[3];
+  return 0;
+  }
+
+
 FXbool GMDatabase::threadsafe() {
   if (sqlite3_threadsafe())
     return true;
@@ -111,6 +111,7 @@ private:
   static FXCondition condition;
 public:
   static void perform_regex_match(sqlite3_context *,int,sqlite3_value**);
+  static int perform_unicode_collation(void*,int,const void*,int,const void*);
 public:
   static volatile FXbool interrupt;
 private:
@@ -133,6 +134,9 @@ public:
   /// Initialize Regular Expressions
   void init_regex();
 
+  /// Register UNICODE collation
+  void init_collation();
+
   /// Compile Query
   sqlite3_stmt * compile(const FXchar * statement);
   sqlite3_stmt * compile(const FXString & statement) { return compile(statement.text()); }
@@ -165,6 +169,9 @@ public:
   /// Get Version
   FXint getVersion();
 
+  /// Get file change counter. Changes whenever a transaction modified the database.
+  FXuint getChangeCounter() const;
+
   // Check if table has column
   FXbool hasColumn(const FXchar * table,const FXchar * column);
 
@@ -48,6 +48,8 @@
 #include "GMTrackEditor.h"
 #include "GMScanner.h"
 #include "GMCoverLoader.h"
+#include "GMLoudness.h"
+#include "GMWaveform.h"
 
 #include "GMFilter.h"
 #include "GMFilterSource.h"
@@ -119,6 +121,9 @@ FXDEFMAP(GMDatabaseSource) GMDatabaseSourceMap[]={
   FXMAPFUNC(SEL_TIMEOUT,GMDatabaseSource::ID_TRACK_PLAYED,GMDatabaseSource::onCmdTrackPlayed),
   FXMAPFUNC(SEL_COMMAND,GMDatabaseSource::ID_OPEN_FOLDER,GMDatabaseSource::onCmdOpenFolder),
   FXMAPFUNC(SEL_COMMAND,GMDatabaseSource::ID_ADD_COVER,GMDatabaseSource::onCmdAddCover),
+  FXMAPFUNC(SEL_COMMAND,GMDatabaseSource::ID_ANALYZE_TRACK,GMDatabaseSource::onCmdAnalyzeLoudness),
+  FXMAPFUNC(SEL_COMMAND,GMDatabaseSource::ID_ANALYZE_ALBUM,GMDatabaseSource::onCmdAnalyzeLoudness),
+  FXMAPFUNC(SEL_COMMAND,GMDatabaseSource::ID_GENERATE_WAVEFORMS,GMDatabaseSource::onCmdGenerateWaveforms),
   FXMAPFUNC(SEL_TASK_COMPLETED,GMDatabaseSource::ID_LOAD_COVERS,GMDatabaseSource::onCmdLoadCovers),
   FXMAPFUNC(SEL_TASK_CANCELLED,GMDatabaseSource::ID_LOAD_COVERS,GMDatabaseSource::onCmdLoadCovers),
   FXMAPFUNC(SEL_CHORE,GMDatabaseSource::ID_IMPORT_FILES,GMDatabaseSource::onDndImportFiles)
@@ -128,6 +133,8 @@ FXIMPLEMENT(GMDatabaseSource,GMSource,GMDatabaseSourceMap,ARRAYNUMBER(GMDatabase
 
 GMDatabaseSource* GMDatabaseSource::filterowner=nullptr;
 GMCoverCache* GMDatabaseSource::covercache=nullptr;
+FXbool GMDatabaseSource::coverloading=false;
+FXbool GMDatabaseSource::coverpending=false;
 
 GMDatabaseSource::GMDatabaseSource(GMTrackDatabase * database) : db(database) {
   FXASSERT(db);
@@ -163,11 +170,18 @@ void GMDatabaseSource::loadCovers() {
     }
   }
 
+// Covers are interactive and don't wait for other tasks, so only one loader may write the cache at a time
 void GMDatabaseSource::updateCovers() {
   if (covercache) {
+    if (coverloading) {
+      coverpending=true;
+      return;
+      }
     GMCoverPathList list;
     if (db->listAlbumPaths(list)) {
       GMCoverLoader * loader = new GMCoverLoader(covercache->getTempFilename(),list,GMPlayerManager::instance()->getPreferences().gui_coverdisplay_size,GMPlayerManager::instance()->getDatabaseSource(),ID_LOAD_COVERS);
+      loader->setPriority(TASK_PRIORITY_INTERACTIVE);
+      coverloading=true;
       GMPlayerManager::instance()->runTask(loader);
       }
     }
@@ -181,6 +195,11 @@ long GMDatabaseSource::onCmdLoadCovers(FXObject*,FXSelector sel,void*ptr) {
     GMPlayerManager::instance()->getTrackView()->redrawAlbumList();
     }
   delete loader;
+  coverloading=false;
+  if (coverpending) {
+    coverpending=false;
+    updateCovers();
+    }
   return 0;
   }
 
@@ -312,7 +331,7 @@ FXint GMDatabaseSource::getNumTracks() const{
 
 
 FXbool GMDatabaseSource::getTrack(GMTrack & info) const{
-  return db->getTrack(current_track,info);
+  return db->getTrack(current_track,info) && db->getTrackLyrics(current_track,info.lyrics);
   }
 
 FXbool GMDatabaseSource::genre_context_menu(FXMenuPane * /*pane*/) {
@@ -329,6 +348,7 @@ FXbool GMDatabaseSource::artist_context_menu(FXMenuPane * pane){
 FXbool GMDatabaseSource::album_context_menu(FXMenuPane * pane){
   new GMMenuCommand(pane,fxtr("Copy\tCtrl-C\tCopy associated tracks to the clipboard."),GMIconTheme::instance()->icon_copy,this,ID_COPY_ALBUM);
   new GMMenuCommand(pane,fxtr("Find Cover…\t\tFind Cover with Google Image Search"),nullptr,this,ID_SEARCH_COVER_ALBUM);
+  new GMMenuCommand(pane,fxtr("Analyze Loudness…\t\tCalculate replay gain of associated tracks."),nullptr,this,ID_ANALYZE_ALBUM);
   new FXMenuSeparator(pane);
   new GMMenuCommand(pane,fxtr("Remove…\tDel\tRemove associated tracks from library."),GMIconTheme::instance()->icon_delete,this,GMSource::ID_DELETE_ALBUM);
   return true;
@@ -337,6 +357,7 @@ FXbool GMDatabaseSource::album_context_menu(FXMenuPane * pane){
 FXbool GMDatabaseSource::track_context_menu(FXMenuPane * pane){
   new GMMenuCommand(pane,fxtr("Edit…\tF2\tEdit Track Information."),GMIconTheme::instance()->icon_edit,this,GMDatabaseSource::ID_EDIT_TRACK);
   new GMMenuCommand(pane,fxtr("Set Cover…\t\t"),nullptr,this,GMDatabaseSource::ID_ADD_COVER);
+  new GMMenuCommand(pane,fxtr("Analyze Loudness…\t\tCalculate replay gain of track(s)."),nullptr,this,GMDatabaseSource::ID_ANALYZE_TRACK);
 
   new GMMenuCommand(pane,fxtr("Copy\tCtrl-C\tCopy track(s) to clipboard."),GMIconTheme::instance()->icon_copy,this,ID_COPY_TRACK);
   new FXMenuSeparator(pane);
@@ -354,6 +375,7 @@ FXbool GMDatabaseSource::track_context_menu(FXMenuPane * pane){
 
 FXbool GMDatabaseSource::source_context_menu(FXMenuPane * pane){
   new GMMenuCommand(pane,fxtr("Export As…"),GMIconTheme::instance()->icon_export,this,GMDatabaseSource::ID_EXPORT);
+  new GMMenuCommand(pane,fxtr("Generate Waveforms\t\tGenerate seek bar waveforms for all tracks"),nullptr,this,GMDatabaseSource::ID_GENERATE_WAVEFORMS);
   new FXMenuSeparator(pane);
   new GMMenuCommand(pane,fxtr("Remove Folder…\t\tRemove tracks in folder from library"),nullptr,GMPlayerManager::instance()->getMainWindow(),GMWindow::ID_REMOVE_FOLDER);
   new GMMenuCommand(pane,fxtr("Remove All Tracks\t\tRemove all tracks from the library"),GMIconTheme::instance()->icon_delete,this,GMDatabaseSource::ID_CLEAR);
@@ -642,7 +664,7 @@ FXbool GMDatabaseSource::listAlbums(GMAlbumList * list,const FXIntList & artistl
       if (artistlist.no()) {
         query+=" AND artist " + artistselection;
         }
-      query+=" ORDER BY albums.name";
+      query+=" ORDER BY albums.name COLLATE UNICODE";
       }
     else {
       if (playlist) {
@@ -671,7 +693,7 @@ FXbool GMDatabaseSource::listAlbums(GMAlbumList * list,const FXIntList & artistl
             query+=" WHERE artists.id == albums.artist ";
           }
         }
-      query+=" ORDER BY albums.name;";
+      query+=" ORDER BY albums.name COLLATE UNICODE;";
       }
 
     q = db->compile(query);
@@ -753,7 +775,7 @@ FXbool GMDatabaseSource::listTracks(GMTrackList * tracklist,const FXIntList & al
   GMQuery::makeSelection(taglist,tagselection);
   GMQuery::makeSelection(albumlist,albumselection);
 
-  GMDBTrackItem * item;
+  GMTrackStore * store = new GMTrackStore(GMPlayerManager::instance()->getPreferences().gui_sort_keywords);
 
   GMDBTrackItem::max_queue=0;
   GMDBTrackItem::max_trackno=0;
@@ -874,37 +896,43 @@ FXbool GMDatabaseSource::listTracks(GMTrackList * tracklist,const FXIntList & al
       if (bitrate<0)
         bitrate *= -(samplerate*channels);
 
-      item = new GMDBTrackItem(id,
-                               path,
-                               c_mrl,
-                               c_title,
-                               artist,
-                               albumartist,
-                               composer,
-                               conductor,
-                               album,
-                               c_albumname,
-                               time,
-                               no,
-                               queue++,
-                               (FXushort)track_year,
-                               (FXushort)album_year,
-                               (FXushort)playcount,
-                               filetype,
-                               bitrate,
-                               samplerate,
-                               channels,
-                               playdate,
-                               (FXushort)rating);
-
-      tracklist->appendItem(item);
+      store->append(id,
+                    path,
+                    c_mrl,
+                    c_title,
+                    artist,
+                    albumartist,
+                    composer,
+                    conductor,
+                    album,
+                    c_albumname,
+                    time,
+                    no,
+                    queue++,
+                    (FXushort)track_year,
+                    (FXushort)album_year,
+                    (FXushort)playcount,
+                    filetype,
+                    bitrate,
+                    samplerate,
+                    channels,
+                    playdate,
+                    (FXushort)rating);
       }
+
+    GMDBTrackItem * items = store->createItems();
+    GMTrackItemList list(store->getNumRows());
+    for (FXint i=0;i<list.no();i++) list[i]=&items[i];
+    tracklist->appendItems(list);
+    store->unref();
+
     GMDBTrackItem::max_trackno = tracklist->getFont()->getTextWidth(FXString('8',GMDBTrackItem::max_trackno));
     GMDBTrackItem::max_queue   = tracklist->getFont()->getTextWidth(FXString('8',GMDBTrackItem::max_digits(queue)));
     GMDBTrackItem::max_time    = tracklist->getFont()->getTextWidth("88:88",5);
     }
   catch(GMDatabaseException & e){
     tracklist->clearItems();
+    store->unref();
     return false;
     }
   GM_TICKS_END();
@@ -912,90 +940,195 @@ FXbool GMDatabaseSource::listTracks(GMTrackList * tracklist,const FXIntList & al
   }
 
 
-FXbool GMDatabaseSource::updateSelectedTracks(GMTrackList*tracklist) {
-  FXString query;
-  GMQuery  q;
-  const FXchar * c_albumname;
-  const FXchar * c_title;
-  const FXchar * c_mrl;
-  FXint path;
-  FXint time;
+// Saves the store with the order of the list. Not possible while filtering.
+FXbool GMDatabaseSource::saveTracks(GMTrackList * tracklist,FXStream & store) {
+  GMTrackStore * tracks = nullptr;
+  FXArray<FXint> rows(tracklist->getNumItems());
+
+  if (hasFilter())
+    return false;
+
+  for (FXint i=0;i<tracklist->getNumItems();i++) {
+    GMDBTrackItem * item = static_cast<GMDBTrackItem*>(tracklist->getItem(i));
+    if (tracks==nullptr)
+      tracks = item->store;
+    else if (item->store!=tracks)
+      return false;
+    rows[i] = item->row;
+    }
+
+  store << (FXuchar)(tracks!=nullptr);
+  if (tracks) {
+    tracks->save(store);
+    store << (FXint)rows.no();
+    store.save(rows.data(),rows.no());
+    }
+  return store.status()==FXStreamOK;
+  }
+
+
+FXbool GMDatabaseSource::loadTracks(GMTrackList * tracklist,FXStream & store) {
+  FXuchar hastracks=0;
+  FXint n;
+
+  store >> hastracks;
+  if (store.status()!=FXStreamOK)
+    return false;
+
+  if (!hastracks)
+    return true;
+
+  GMTrackStore * tracks = new GMTrackStore(GMPlayerManager::instance()->getPreferences().gui_sort_keywords);
+  if (!tracks->load(store)) {
+    tracks->unref();
+    return false;
+    }
+
+  store >> n;
+  if (store.status()!=FXStreamOK || n<0 || n>tracks->getNumRows()) {
+    tracks->unref();
+    return false;
+    }
+
+  FXArray<FXint>  rows(n);
+  FXArray<FXuchar> listed(tracks->getNumRows());
+  memset(listed.data(),0,listed.no());
+  store.load(rows.data(),n);
+  for (FXint i=0;i<n;i++) {
+    if (store.status()!=FXStreamOK || rows[i]<0 || rows[i]>=tracks->getNumRows() || listed[rows[i]]) {
+      tracks->unref();
+      return false;
+      }
+    listed[rows[i]]=1;
+    }
+
+  GMDBTrackItem * items = tracks->createItems();
+  GMTrackItemList list(n);
+  for (FXint i=0;i<n;i++) list[i]=&items[rows[i]];
+  tracklist->appendItems(list);
+
+  FXint max_trackno=0;
+  for (FXint i=0;i<tracks->getNumRows();i++) {
+    max_trackno=FXMAX(GMDBTrackItem::max_digits(GMTRACKNO(tracks->no[i])),max_trackno);
+    }
+  GMDBTrackItem::max_trackno = tracklist->getFont()->getTextWidth(FXString('8',max_trackno));
+  GMDBTrackItem::max_queue   = tracklist->getFont()->getTextWidth(FXString('8',GMDBTrackItem::max_digits(tracks->getNumRows()+1)));
+  GMDBTrackItem::max_time    = tracklist->getFont()->getTextWidth("88:88",5);
+
+  // Rows removed from the list before the snapshot was taken
+  for (FXint i=0;i<tracks->getNumRows();i++) {
+    if (!listed[i]) items[i].destroy();
+    }
+  tracks->unref();
+
+  return true;
+  }
+
+
+// Copy a row of the updateSelectedTracks query into a listed item
+void GMDatabaseSource::updateTrackItem(GMQuery & q,GMDBTrackItem * item) {
+  FXint path,time,track_year,artist,composer,conductor,albumartist,album_year,playcount,rating;
   FXuint no;
-  //FXint id;
-  //FXint queue=1;
-  FXint album_year;
-  FXint track_year;
-  FXint playcount;
   FXlong playdate;
-  FXint bitrate;
-  FXint rating;
+  q.get(1,path);
+  q.get(4,time);
+  q.get(5,no);
+  q.get(6,track_year);
+  q.get(7,artist);
+  q.get(8,composer);
+  q.get(9,conductor);
+  q.get(10,albumartist);
+  q.get(12,album_year);
+  q.get(13,playcount);
+  q.get(15,playdate);
+  q.get(16,rating);
+
+  GMTrackStore * store = item->store;
+  const FXint row = item->row;
+  store->setMrl(row,q.get(2));
+  store->setTitle(row,q.get(3));
+  store->setAlbum(row,q.get(11));
+  store->playdate[row]    = playdate;
+  store->artist[row]      = artist;
+  store->albumartist[row] = albumartist;
+  store->composer[row]    = composer;
+  store->conductor[row]   = conductor;
+  store->time[row]        = time;
+  store->no[row]          = no;
+  store->path[row]        = path;
+  store->year[row]        = track_year;
+  store->album_year[row]  = album_year;
+  store->playcount[row]   = playcount;
+  store->rating[row]      = rating / 51;
+  }
 
-  FXint artist,composer,conductor,albumartist;
 
+// Refresh the selected items after an edit. The tracks are fetched in batches and each
+// row is applied to its item through the id lookup. Selected items that aren't the first
+// listing of their track (play lists may list a track twice) are kept aside and updated too.
+FXbool GMDatabaseSource::updateSelectedTracks(GMTrackList*tracklist) {
+  const FXint nbatch = 256;
+  FXIntList tracks;
+  FXIntList duplicates;
+  FXString  selection;
+  FXString  query;
+  GMQuery   q;
 
   GM_TICKS_START();
 
-  try {
-    query = "SELECT "
-                 "tracks.path,"
-                 "tracks.mrl,"
-                 "tracks.title,"
-                 "tracks.time,"
-                 "tracks.no,"
-                 "tracks.year,"
-                 "tracks.artist,"
-                 "tracks.composer,"
-                 "tracks.conductor,"
-                 "albums.artist,albums.name,albums.year,"
-                 "tracks.playcount,"
-                 "tracks.bitrate,"
-                 "tracks.playdate,"
-                 "tracks.rating "
-           "FROM tracks JOIN albums ON tracks.album == albums.id WHERE tracks.id == ?;";
-
-    q = db->compile(query);
+  for (FXint i=0;i<tracklist->getNumItems();i++) {
+    if (tracklist->isItemSelected(i)) {
+      const FXint id    = tracklist->getItemId(i);
+      const FXint first = tracklist->findItemById(id);
+      if (first!=i) {
+        duplicates.append(i);
+        if (first>=0 && tracklist->isItemSelected(first)) continue;
+        }
+      tracks.append(id);
+      }
+    }
 
-    for (FXint i=0;i<tracklist->getNumItems();i++) {
-      if (tracklist->isItemSelected(i)) {
-        GMDBTrackItem * item = static_cast<GMDBTrackItem*>(tracklist->getItem(i));
-        q.set(0,item->id);
-        if (__likely(q.row())) {
-          q.get(0,path);
-          c_mrl   = q.get(1);
-          c_title = q.get(2);
-          q.get(3,time);
-          q.get(4,no);
-          q.get(5,track_year);
-          q.get(6,artist);
-          q.get(7,composer);
-          q.get(8,conductor);
-          q.get(9,albumartist);
-          c_albumname = q.get(10);
-          q.get(11,album_year);
-          q.get(12,playcount);
-          q.get(13,bitrate);
-          q.get(14,playdate);
-          q.get(15,rating);
-
-          item->mrl         = c_mrl;
-          item->title       = c_title;
-          item->album       = c_albumname;
-          item->playdate    = playdate;
-          item->artist      = artist;
-          item->albumartist = albumartist;
-          item->composer    = composer;
-          item->conductor   = conductor;
-          item->time        = time;
-          item->no          = no;
-          item->path        = path;
-          item->year        = track_year;
-          item->album_year  = album_year;
-          item->playcount   = playcount;
-          item->rating      = rating / 51;
-          tracklist->updateItem(i);
+  try {
+    for (FXint b=0;b<tracks.no();b+=nbatch) {
+      const FXint n = FXMIN(nbatch,tracks.no()-b);
+
+      query = "SELECT "
+                   "tracks.id,"
+                   "tracks.path,"
+                   "tracks.mrl,"
+                   "tracks.title,"
+                   "tracks.time,"
+                   "tracks.no,"
+                   "tracks.year,"
+                   "tracks.artist,"
+                   "tracks.composer,"
+                   "tracks.conductor,"
+                   "albums.artist,albums.name,albums.year,"
+                   "tracks.playcount,"
+                   "tracks.bitrate,"
+                   "tracks.playdate,"
+                   "tracks.rating "
+             "FROM tracks JOIN albums ON tracks.album == albums.id WHERE tracks.id";
+      GMQuery::makeSelection(FXIntList(tracks.data()+b,n),selection);
+      query+=selection;
+
+      q = db->compile(query);
+      while(q.row()) {
+        FXint id;
+        q.get(0,id);
+        const FXint index = tracklist->findItemById(id);
+        if (index>=0) {
+          updateTrackItem(q,static_cast<GMDBTrackItem*>(tracklist->getItem(index)));
+          tracklist->updateItem(index);
+          }
+        for (FXint i=0;i<duplicates.no();i++) {
+          if (tracklist->getItemId(duplicates[i])==id) {
+            updateTrackItem(q,static_cast<GMDBTrackItem*>(tracklist->getItem(duplicates[i])));
+            tracklist->updateItem(duplicates[i]);
+            }
           }
-        q.reset();
         }
+      q.reset();
       }
     }
   catch(GMDatabaseException & e){
@@ -1079,15 +1212,11 @@ long GMDatabaseSource::onCmdExport(FXObject*,FXSelector,void*){
     FXApp::instance()->reg().writeStringEntry("Settings","last-export-directory",dialog.getDirectory().text());
     FXApp::instance()->reg().writeBoolEntry("Settings","export-relative-paths",dialog.getRelativePath());
 
-    FXApp::instance()->beginWaitCursor();
-    switch(dialog.getCurrentPattern()){
-      case 0: db->exportList(dialog.getFilename(),playlist,PLAYLIST_XSPF,opts); break;
-      case 1: db->exportList(dialog.getFilename(),playlist,PLAYLIST_PLS,opts); break;
-      case 2: db->exportList(dialog.getFilename(),playlist,PLAYLIST_M3U_EXTENDED,opts); break;
-      case 3: db->exportList(dialog.getFilename(),playlist,PLAYLIST_M3U,opts); break;
-      case 4: db->exportList(dialog.getFilename(),playlist,PLAYLIST_CSV,opts); break;
+    const FXuint filetypes[]={PLAYLIST_XSPF,PLAYLIST_PLS,PLAYLIST_M3U_EXTENDED,PLAYLIST_M3U,PLAYLIST_CSV};
+    const FXint pattern = dialog.getCurrentPattern();
+    if (pattern>=0 && pattern<(FXint)ARRAYNUMBER(filetypes)) {
+      GMPlayerManager::instance()->runTask(new GMExportTask(dialog.getFilename(),playlist,filetypes[pattern],opts));
       }
-    FXApp::instance()->endWaitCursor();
     }
   return 1;
   }
@@ -1258,6 +1387,50 @@ long GMDatabaseSource::onCmdAddCover(FXObject*,FXSelector,void*){
   return 1;
   }
 
+long GMDatabaseSource::onCmdAnalyzeLoudness(FXObject*,FXSelector sel,void*){
+  FXIntList tracks;
+  if (FXSELID(sel)==ID_ANALYZE_TRACK)
+    GMPlayerManager::instance()->getTrackView()->getSelectedTracks(tracks);
+  else
+    GMPlayerManager::instance()->getTrackView()->getTracks(tracks);
+
+  if (tracks.no()==0) return 1;
+
+  FXDialogBox dialog(GMPlayerManager::instance()->getMainWindow(),fxtr("Analyze Loudness"),DECOR_TITLE|DECOR_BORDER|DECOR_RESIZE|DECOR_CLOSE,0,0,0,0,0,0,0,0,0,0);
+  GMPlayerManager::instance()->getMainWindow()->create_dialog_header(&dialog,fxtr("Analyze Loudness"),fxtr("Calculate the replay gain of the selected tracks and their albums."),nullptr);
+  FXHorizontalFrame *closebox=new FXHorizontalFrame(&dialog,LAYOUT_SIDE_BOTTOM|LAYOUT_FILL_X|PACK_UNIFORM_WIDTH,0,0,0,0);
+  new GMButton(closebox,fxtr("&Analyze"),nullptr,&dialog,FXDialogBox::ID_ACCEPT,BUTTON_INITIAL|BUTTON_DEFAULT|LAYOUT_RIGHT|FRAME_RAISED|FRAME_THICK,0,0,0,0, 15,15);
+  new GMButton(closebox,fxtr("&Cancel"),nullptr,&dialog,FXDialogBox::ID_CANCEL,BUTTON_DEFAULT|LAYOUT_RIGHT|FRAME_RAISED|FRAME_THICK,0,0,0,0, 15,15);
+  new FXSeparator(&dialog,SEPARATOR_GROOVE|LAYOUT_FILL_X|LAYOUT_SIDE_BOTTOM);
+  FXVerticalFrame * main = new FXVerticalFrame(&dialog,LAYOUT_FILL_X|LAYOUT_FILL_Y,0,0,0,0,30,20,10,10);
+  GMCheckButton * write_tags = new GMCheckButton(main,fxtr("Write replay gain tags"));
+  write_tags->setCheck(FXApp::instance()->reg().readBoolEntry("loudness dialog","write-tags",false));
+
+  if (dialog.execute()) {
+    FXApp::instance()->reg().writeBoolEntry("loudness dialog","write-tags",write_tags->getCheck());
+    GMLoudnessTask * task = new GMLoudnessTask(db,tracks,write_tags->getCheck());
+    task->setTarget(GMPlayerManager::instance());
+    task->setSelector(GMPlayerManager::ID_LOUDNESS_TASK);
+    GMPlayerManager::instance()->runTask(task);
+    }
+  return 1;
+  }
+
+
+// Tracks that already have a waveform are skipped, so this can be resumed any time.
+long GMDatabaseSource::onCmdGenerateWaveforms(FXObject*,FXSelector,void*){
+  FXIntList tracks;
+  FXStringList files;
+  GMPlayerManager::instance()->getTrackView()->getTracks(tracks);
+  if (tracks.no()) {
+    db->getTrackFilenames(tracks,files);
+    GMWaveformTask * task = new GMWaveformTask(files,GMPlayerManager::instance(),GMPlayerManager::ID_WAVEFORM_TASK);
+    GMPlayerManager::instance()->runTask(task);
+    }
+  return 1;
+  }
+
+
 long GMDatabaseSource::onCmdDelete(FXObject*,FXSelector sel,void*){
   FXIntList tracks;
   FXIntList selected;
@@ -1662,6 +1835,21 @@ long GMDatabaseSource::onCmdTrackPlayed(FXObject*,FXSelector,void*) {
   FXASSERT(current_track>=0);
   FXlong timestamp = (FXlong)FXThread::time();
   db->setTrackPlayed(current_track,timestamp);
+
+  // Update the listed track in place
+  GMTrackView * view = GMPlayerManager::instance()->getTrackView();
+  if (dynamic_cast<GMDatabaseSource*>(view->getSource())) {
+    FXint index = view->findTrackIndexById(current_track);
+    if (index>=0) {
+      GMDBTrackItem * item = static_cast<GMDBTrackItem*>(view->getTrackItem(index));
+      item->store->playcount[item->row]++;
+      item->store->playdate[item->row] = timestamp;
+      view->updateTrackItem(index);
+      if (view->getSortMethod()==HEADER_PLAYCOUNT || view->getSortMethod()==HEADER_PLAYDATE)
+        view->sortTracks();
+      }
+    }
+
   GMTrack info;
   if (getTrack(info) && GMPlayerManager::instance()->getAudioScrobbler())
     GMPlayerManager::instance()->getAudioScrobbler()->submit(timestamp,info);
@@ -25,6 +25,8 @@
 
 class GMSource;
 class GMTrackDatabase;
+class GMDBTrackItem;
+class GMQuery;
 
 class GMDatabaseClipboardData : public GMClipboardData {
 public:
@@ -46,6 +48,8 @@ FXDECLARE(GMDatabaseSource)
 protected:
   static GMDatabaseSource * filterowner;
   static GMCoverCache     * covercache;
+  static FXbool             coverloading;
+  static FXbool             coverpending;
 protected:
   GMTrackDatabase   * db         = nullptr;
   FXint               playlist   = 0;
@@ -61,6 +65,7 @@ private:
   GMDatabaseSource& operator=(const GMDatabaseSource&);
 protected:
   void removeFiles(const FXStringList & files);
+  static void updateTrackItem(GMQuery & q,GMDBTrackItem * item);
   FXbool hasFilter() const { return hasfilter; }
 public:
   enum {
@@ -82,6 +87,9 @@ public:
     ID_SEARCH_COVER_ALBUM,
     ID_LOAD_COVERS,
     ID_NEW_FILTER,
+    ID_ANALYZE_TRACK,
+    ID_ANALYZE_ALBUM,
+    ID_GENERATE_WAVEFORMS,
     ID_LAST
     };
 public:
@@ -111,6 +119,8 @@ public:
   long onCmdMainWindow(FXObject*,FXSelector,void*);
   long onCmdLoadCovers(FXObject*,FXSelector,void*);
   long onCmdNewFilter(FXObject*,FXSelector,void*);
+  long onCmdAnalyzeLoudness(FXObject*,FXSelector,void*);
+  long onCmdGenerateWaveforms(FXObject*,FXSelector,void*);
 public:
   GMDatabaseSource(GMTrackDatabase * db);
 
@@ -164,6 +174,10 @@ public:
 
   FXbool listTracks(GMTrackList * tracklist,const FXIntList & albumlist,const FXIntList & taglist) override;
 
+  FXbool saveTracks(GMTrackList * tracklist,FXStream & store) override;
+
+  FXbool loadTracks(GMTrackList * tracklist,FXStream & store) override;
+
   FXbool updateSelectedTracks(GMTrackList*) override;
 
   FXbool genre_context_menu(FXMenuPane * pane) override;
@@ -45,7 +45,7 @@ static const FXchar * const column_lookup[]={
   "tracks.bitrate",
   "tracks.samplerate",
   "-tracks.bitrate",
-  "tracks.lyrics"
+  "(SELECT lyrics FROM track_text WHERE track_text.track == tracks.id)"
   };
 
 // Operator Lookup Table
@@ -165,6 +165,15 @@ void Rule::save(FXStream & store) const {
 
 // Get sql match string
 FXString SortLimit::getMatch() const {
+  switch(column) {
+    case Rule::ColumnTitle      :
+    case Rule::ColumnArtist     :
+    case Rule::ColumnAlbumArtist:
+    case Rule::ColumnComposer   :
+    case Rule::ColumnConductor  :
+    case Rule::ColumnAlbum      : return FXString::value("%s COLLATE UNICODE %s",column_lookup[column],ascending ? "ASC" : "DESC"); break;
+    default                     : break;
+    }
   return FXString::value("%s %s",column_lookup[column],ascending ? "ASC" : "DESC");
   }
 
@@ -209,8 +218,8 @@ GMFilter::GMFilter(const FXString & n,FXint column,FXint opcode,FXint value) :
   }
 
 
-// Get sql match string
-FXString GMFilter::getMatch() const {
+// Get sql condition of all rules
+FXString GMFilter::getCondition() const {
   FXString query;
   FXString rule = (match == MatchAll) ? " AND " : " OR ";
 
@@ -218,6 +227,17 @@ FXString GMFilter::getMatch() const {
     if (!query.empty()) query+=rule;
     query += rules[i].getMatch();
     }
+  if (!query.empty()) {
+    query.prepend('(');
+    query.append(')');
+    }
+  return query;
+  }
+
+
+// Get sql match string
+FXString GMFilter::getMatch() const {
+  FXString query = getCondition();
   if (!query.empty())
     query.prepend("WHERE ");
 
@@ -235,6 +255,31 @@ FXString GMFilter::getMatch() const {
   }
 
 
+// Columns used by rules and, for limited filters, by the sort order
+FXuint GMFilter::getColumns() const {
+  FXuint columns=0;
+  for (FXint i=0;i<rules.no();i++) {
+    columns|=(1<<rules[i].column);
+    }
+  if (limit>0) {
+    for (FXint i=0;i<order.no();i++) {
+      columns|=(1<<order[i].column);
+      }
+    }
+  return columns;
+  }
+
+
+// Rules that compare against the current time
+FXbool GMFilter::isTimeRelative() const {
+  for (FXint i=0;i<rules.no();i++) {
+    if (rules[i].column==Rule::ColumnPlayDate || rules[i].column==Rule::ColumnImportDate)
+      return true;
+    }
+  return false;
+  }
+
+
 // Load from stream
 void GMFilter::load(FXStream & store) {
   FXint nitems=0;
@@ -123,9 +123,18 @@ public:
   // Construct integer input filter with name, column, opcode and value
   GMFilter(const FXString & name,FXint column,FXint opcode,FXint value);
 
+  // Get sql condition of all rules
+  FXString getCondition() const;
+
   // Get sql match string
   FXString getMatch() const;
 
+  // Return bitmask of columns (1<<Rule::Column*) the result depends on
+  FXuint getColumns() const;
+
+  // Return true if the result depends on the current time
+  FXbool isTimeRelative() const;
+
   // Load from stream
   void load(FXStream &);
 
@@ -49,6 +49,88 @@
 FXObjectListOf<GMFilterSource> GMFilterSource::sources;
 
 
+/*
+  Filter results are materialized into a temporary table per filter. Triggers
+  log every track whose filterable columns change, together with a bitmask
+  of the affected columns (1<<Rule::Column*). A filter only refreshes the
+  tracks in the log that touch its own columns. Filters with a limit are
+  recalculated in full and time relative filters at most once a minute.
+*/
+#define COLUMN(c) (1<<Rule::c)
+
+static const FXTime FILTER_TIME_REFRESH = 60000000000LL;
+
+static const struct {
+  const FXchar * name;
+  FXuint         columns;
+  } filter_track_columns[]={
+  {"title",      COLUMN(ColumnTitle)},
+  {"artist",     COLUMN(ColumnArtist)},
+  {"composer",   COLUMN(ColumnComposer)},
+  {"conductor",  COLUMN(ColumnConductor)},
+  {"album",      COLUMN(ColumnAlbum)|COLUMN(ColumnAlbumArtist)},
+  {"path",       COLUMN(ColumnPath)},
+  {"mrl",        COLUMN(ColumnPath)},
+  {"year",       COLUMN(ColumnYear)},
+  {"time",       COLUMN(ColumnTime)},
+  {"no",         COLUMN(ColumnTrackNumber)|COLUMN(ColumnDiscNumber)},
+  {"rating",     COLUMN(ColumnRating)},
+  {"playcount",  COLUMN(ColumnPlayCount)},
+  {"playdate",   COLUMN(ColumnPlayDate)},
+  {"importdate", COLUMN(ColumnImportDate)},
+  {"filetype",   COLUMN(ColumnFileType)},
+  {"channels",   COLUMN(ColumnChannels)},
+  {"bitrate",    COLUMN(ColumnBitRate)|COLUMN(ColumnSampleSize)},
+  {"samplerate", COLUMN(ColumnSampleRate)},
+  };
+
+static const FXchar filter_view_tables[]="FROM tracks JOIN albums ON tracks.album == albums.id "
+                                              "JOIN artists AS album_artist ON (albums.artist == album_artist.id) "
+                                              "JOIN artists AS track_artist ON (tracks.artist == track_artist.id) "
+                                              "JOIN pathlist ON (tracks.path == pathlist.id) "
+                                              "LEFT JOIN artists AS composers ON (tracks.composer == composers.id) "
+                                              "LEFT JOIN artists AS conductors ON (tracks.conductor == conductors.id) ";
+
+
+static void create_filter_log(GMTrackDatabase * db) {
+  FXString mask;
+  for (FXuint i=0;i<ARRAYNUMBER(filter_track_columns);i++) {
+    if (!mask.empty()) mask+="|";
+    mask+=FXString::value("((new.%s IS NOT old.%s)*%u)",filter_track_columns[i].name,filter_track_columns[i].name,filter_track_columns[i].columns);
+    }
+
+  db->execute("CREATE TEMP TABLE IF NOT EXISTS filter_log (id INTEGER PRIMARY KEY AUTOINCREMENT, track INTEGER, columns INTEGER);");
+
+  db->execute("CREATE TEMP TRIGGER IF NOT EXISTS filter_track_insert AFTER INSERT ON tracks BEGIN "
+                "INSERT INTO filter_log VALUES (NULL,new.id,-1); END;");
+  db->execute("CREATE TEMP TRIGGER IF NOT EXISTS filter_track_delete AFTER DELETE ON tracks BEGIN "
+                "INSERT INTO filter_log VALUES (NULL,old.id,-1); END;");
+  db->execute("CREATE TEMP TRIGGER IF NOT EXISTS filter_track_update AFTER UPDATE ON tracks WHEN (" + mask + ")!=0 BEGIN "
+                "INSERT INTO filter_log VALUES (NULL,new.id," + mask + "); END;");
+
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_tag_insert AFTER INSERT ON track_tags BEGIN "
+                      "INSERT INTO filter_log VALUES (NULL,new.track,%u); END;",COLUMN(ColumnTag));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_tag_delete AFTER DELETE ON track_tags BEGIN "
+                      "INSERT INTO filter_log VALUES (NULL,old.track,%u); END;",COLUMN(ColumnTag));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_tag_update AFTER UPDATE OF name ON tags BEGIN "
+                      "INSERT INTO filter_log SELECT NULL,track,%u FROM track_tags WHERE tag == new.id; END;",COLUMN(ColumnTag));
+
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_text_insert AFTER INSERT ON track_text BEGIN "
+                      "INSERT INTO filter_log VALUES (NULL,new.track,%u); END;",COLUMN(ColumnLyrics));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_text_update AFTER UPDATE ON track_text BEGIN "
+                      "INSERT INTO filter_log VALUES (NULL,new.track,%u); END;",COLUMN(ColumnLyrics));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_text_delete AFTER DELETE ON track_text BEGIN "
+                      "INSERT INTO filter_log VALUES (NULL,old.track,%u); END;",COLUMN(ColumnLyrics));
+
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_album_update AFTER UPDATE OF name,artist ON albums BEGIN "
+                      "INSERT INTO filter_log SELECT NULL,id,%u FROM tracks WHERE album == new.id; END;",COLUMN(ColumnAlbum)|COLUMN(ColumnAlbumArtist));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_artist_update AFTER UPDATE OF name ON artists BEGIN "
+                      "INSERT INTO filter_log SELECT NULL,id,%u FROM tracks WHERE artist == new.id OR composer == new.id OR conductor == new.id OR album IN (SELECT id FROM albums WHERE artist == new.id); END;",COLUMN(ColumnArtist)|COLUMN(ColumnAlbumArtist)|COLUMN(ColumnComposer)|COLUMN(ColumnConductor));
+  db->executeFormat("CREATE TEMP TRIGGER IF NOT EXISTS filter_path_update AFTER UPDATE OF name ON pathlist BEGIN "
+                      "INSERT INTO filter_log SELECT NULL,id,%u FROM tracks WHERE path == new.id; END;",COLUMN(ColumnPath));
+  }
+
+
 void GMFilterSource::init(GMTrackDatabase * database,GMSourceList & list){
   FXFileStream store;
 
@@ -155,17 +237,87 @@ FXString GMFilterSource::getName() const {
   }
 
 
+FXString GMFilterSource::viewTable() const {
+  return FXString::value("filter_view_%d",match.id);
+  }
+
+
+void GMFilterSource::createTable() {
+  const FXString table = viewTable();
+  create_filter_log(db);
+  db->execute("SELECT COALESCE(MAX(id),0) FROM filter_log;",serial);
+  db->execute("DROP TABLE IF EXISTS " + table + ";");
+  db->execute("CREATE TEMP TABLE " + table + " (track INTEGER NOT NULL, album INTEGER NOT NULL, PRIMARY KEY (track));");
+  db->execute("INSERT INTO " + table + " SELECT tracks.id,tracks.album " + filter_view_tables + match.getMatch());
+  db->execute("CREATE INDEX " + table + "_album ON " + table + " (album);");
+  refreshed = FXThread::time();
+  hastable  = true;
+  pruneLog();
+  }
+
+
+// Apply logged changes to the tracks this filter depends on
+void GMFilterSource::refreshTable() {
+  FXint last,changes;
+
+  if (!hastable) {
+    createTable();
+    return;
+    }
+
+  if (match.isTimeRelative() && FXThread::time()-refreshed>FILTER_TIME_REFRESH) {
+    createTable();
+    return;
+    }
+
+  // Album is included so the album column stays valid
+  const FXuint columns = match.getColumns()|COLUMN(ColumnAlbum);
+
+  db->execute("SELECT COALESCE(MAX(id),0) FROM filter_log;",last);
+  if (last==serial)
+    return;
+
+  db->execute(FXString::value("SELECT COUNT(*) FROM filter_log WHERE id > %d AND id <= %d AND (columns & %u) != 0;",serial,last,columns).text(),changes);
+  if (changes) {
+    GM_DEBUG_PRINT("[filter] %s: %d changes\n",match.name.text(),changes);
+    if (match.limit>0) {
+      createTable();
+      return;
+      }
+    const FXString table = viewTable();
+    const FXString tracks = FXString::value("SELECT track FROM filter_log WHERE id > %d AND id <= %d AND (columns & %u) != 0",serial,last,columns);
+    db->execute("DELETE FROM " + table + " WHERE track IN (" + tracks + ");");
+    db->execute("INSERT OR IGNORE INTO " + table + " SELECT tracks.id,tracks.album " + filter_view_tables + "WHERE tracks.id IN (" + tracks + ") AND " + match.getCondition() + ";");
+    }
+  serial = last;
+  pruneLog();
+  }
+
+
+// Drop log entries all filters have seen
+void GMFilterSource::pruneLog() {
+  FXint seen = serial;
+  for (FXint i=0;i<sources.no();i++) {
+    if (sources[i]->hastable) seen = FXMIN(seen,sources[i]->serial);
+    }
+  db->executeFormat("DELETE FROM filter_log WHERE id <= %d;",seen);
+  }
+
+
+void GMFilterSource::dropTable() {
+  if (hastable) {
+    db->execute("DROP TABLE IF EXISTS " + viewTable() + ";");
+    hastable=false;
+    }
+  }
+
+
 void GMFilterSource::updateView() {
   FXString query = match.getMatch();
   if (query.length()) {
+    refreshTable();
     db->execute("DROP VIEW IF EXISTS query_view;");
-    db->execute("CREATE TEMP VIEW query_view AS "
-                "SELECT tracks.id as track, tracks.album as album FROM tracks JOIN albums ON tracks.album == albums.id "
-                                                                             "JOIN artists AS album_artist ON (albums.artist == album_artist.id) "
-                                                                             "JOIN artists AS track_artist ON (tracks.artist == track_artist.id) "
-                                                                             "JOIN pathlist ON (tracks.path == pathlist.id) "
-                                                                             "LEFT JOIN artists AS composers ON (tracks.composer == composers.id) "
-                                                                             "LEFT JOIN artists AS conductors ON (tracks.conductor == conductors.id) " + query);
+    db->execute("CREATE TEMP VIEW query_view AS SELECT track,album FROM " + viewTable() + ";");
     hasview=true;
     }
   else {
@@ -174,6 +326,39 @@ void GMFilterSource::updateView() {
   }
 
 
+FXbool GMFilterSource::refreshView() {
+  if (hasview) {
+    try {
+      refreshTable();
+      }
+    catch(GMDatabaseException & e){
+      return false;
+      }
+    }
+  return true;
+  }
+
+
+FXbool GMFilterSource::listTags(GMList * taglist,FXIcon * icon) {
+  return refreshView() && GMDatabaseSource::listTags(taglist,icon);
+  }
+
+
+FXbool GMFilterSource::listArtists(GMList * artistlist,FXIcon * icon,const FXIntList & taglist) {
+  return refreshView() && GMDatabaseSource::listArtists(artistlist,icon,taglist);
+  }
+
+
+FXbool GMFilterSource::listAlbums(GMAlbumList * albumlist,const FXIntList & artistlist,const FXIntList & taglist) {
+  return refreshView() && GMDatabaseSource::listAlbums(albumlist,artistlist,taglist);
+  }
+
+
+FXbool GMFilterSource::listTracks(GMTrackList * tracklist,const FXIntList & albumlist,const FXIntList & taglist) {
+  return refreshView() && GMDatabaseSource::listTracks(tracklist,albumlist,taglist);
+  }
+
+
 void GMFilterSource::configure(GMColumnList& columns) {
   GMDatabaseSource::configure(columns);
   updateView();
@@ -184,6 +369,7 @@ long GMFilterSource::onCmdEdit(FXObject*,FXSelector,void*){
   GMFilterEditor editor(GMPlayerManager::instance()->getMainWindow(),match);
   if (editor.execute(PLACEMENT_SCREEN)) {
     editor.getFilter(match);
+    dropTable();
     updateView();
     GMFilterSource::save();
     GMPlayerManager::instance()->getTrackView()->refresh();
@@ -195,6 +381,7 @@ long GMFilterSource::onCmdEdit(FXObject*,FXSelector,void*){
 
 long GMFilterSource::onCmdRemove(FXObject*,FXSelector,void *){
   if (GMPlayerManager::instance()->getMainWindow()->question(fxtr("Remove Filter"),fxtr("Are you sure you want to remove the filter?"),fxtr("&Yes"),fxtr("&No"))){
+    dropTable();
     sources.remove(this);
     GMFilterSource::save();
     GMPlayerManager::instance()->removeSource(this);
@@ -36,9 +36,18 @@ public:
   // Create New Filter
   static void create(GMTrackDatabase * database);
 protected:
-  GMFilter match; // the actual filter
+  GMFilter match;              // the actual filter
+  FXint    serial    = 0;      // last change applied to the view table
+  FXTime   refreshed = 0;      // time of the last full refresh
+  FXbool   hastable  = false;  // view table has been created
 protected:
   GMFilterSource(){}
+  FXString viewTable() const;
+  void createTable();
+  void refreshTable();
+  void dropTable();
+  void pruneLog();
+  FXbool refreshView();
 private:
   GMFilterSource(const GMFilterSource&);
   GMFilterSource& operator=(const GMFilterSource&);
@@ -61,6 +70,12 @@ public:
   // Update View
   void updateView();
 
+  // Bring the view up to date before listing
+  FXbool listTags(GMList * taglist,FXIcon * icon) override;
+  FXbool listArtists(GMList * artistlist,FXIcon * icon,const FXIntList & taglist) override;
+  FXbool listAlbums(GMAlbumList *,const FXIntList &,const FXIntList &) override;
+  FXbool listTracks(GMTrackList * tracklist,const FXIntList & albumlist,const FXIntList & taglist) override;
+
   // Configure
   void configure(GMColumnList&) override;
 
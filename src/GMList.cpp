@@ -23,6 +23,7 @@
 #include "GMTrackList.h"
 #include "GMSource.h"
 #include "GMPlayerManager.h"
+#include "GMTrackDatabase.h"
 #include "GMTrackView.h"
 #include "GMCoverCache.h"
 
@@ -42,10 +43,10 @@ static inline FXbool begins_with_keyword(const FXString & t){
   }
 
 FXint genre_list_sort(const FXListItem* pa,const FXListItem* pb){
-  return FXString::comparecase(pa->getText(),pb->getText());
+  return FXCollate::compare(pa->getText(),pb->getText());
   }
 FXint genre_list_sort_reverse(const FXListItem* pa,const FXListItem* pb){
-  return -FXString::comparecase(pa->getText(),pb->getText());
+  return -FXCollate::compare(pa->getText(),pb->getText());
   }
 
 
@@ -53,14 +54,26 @@ FXint generic_name_sort(const FXListItem* pa,const FXListItem* pb){
   FXint a=0,b=0;
   if (begins_with_keyword(pa->getText())) a=FXMIN(pa->getText().length()-1,pa->getText().find(' ')+1);
   if (begins_with_keyword(pb->getText())) b=FXMIN(pb->getText().length()-1,pb->getText().find(' ')+1);
-  return FXString::comparecase(&pa->getText()[a],&pb->getText()[b]);
+  return FXCollate::compare(&pa->getText()[a],&pb->getText()[b]);
   }
 
 FXint generic_name_sort_reverse(const FXListItem* pa,const FXListItem* pb){
   FXint a=0,b=0;
   if (begins_with_keyword(pa->getText())) a=FXMIN(pa->getText().length()-1,pa->getText().find(' ')+1);
   if (begins_with_keyword(pb->getText())) b=FXMIN(pb->getText().length()-1,pb->getText().find(' ')+1);
-  return FXString::comparecase(&pb->getText()[b],&pa->getText()[a]);
+  return FXCollate::compare(&pb->getText()[b],&pa->getText()[a]);
+  }
+
+
+// Items hold the artist id, so we can use the precomputed collation keys
+FXint artist_list_sort(const FXListItem* pa,const FXListItem* pb){
+  GMTrackDatabase * db = GMPlayerManager::instance()->getTrackDatabase();
+  return FXCollate::compareKeys(*db->getArtistKey((FXint)(FXival)pa->getData()),*db->getArtistKey((FXint)(FXival)pb->getData()));
+  }
+
+FXint artist_list_sort_reverse(const FXListItem* pa,const FXListItem* pb){
+  GMTrackDatabase * db = GMPlayerManager::instance()->getTrackDatabase();
+  return FXCollate::compareKeys(*db->getArtistKey((FXint)(FXival)pb->getData()),*db->getArtistKey((FXint)(FXival)pa->getData()));
   }
 
 FXint source_list_sort(const FXTreeItem* pa,const FXTreeItem* pb){
@@ -25,6 +25,9 @@ extern FXint genre_list_sort_reverse(const FXListItem* pa,const FXListItem* pb);
 extern FXint generic_name_sort(const FXListItem* pa,const FXListItem* pb);
 extern FXint generic_name_sort_reverse(const FXListItem* pa,const FXListItem* pb);
 
+extern FXint artist_list_sort(const FXListItem* pa,const FXListItem* pb);
+extern FXint artist_list_sort_reverse(const FXListItem* pa,const FXListItem* pb);
+
 extern FXint source_list_sort(const FXTreeItem* pa,const FXTreeItem* pb);
 extern FXint source_list_sort_reverse(const FXTreeItem* pa,const FXTreeItem* pb);
 
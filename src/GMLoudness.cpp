@@ -0,0 +1,364 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include <math.h>
+#include "gmdefs.h"
+#include "gmutils.h"
+#include "GMTrack.h"
+#include "GMTag.h"
+#include "GMDatabase.h"
+#include "GMTrackDatabase.h"
+#include "GMTaskManager.h"
+#include "GMAudioPlayer.h"
+#include "GMLoudness.h"
+
+
+// Replay Gain 2.0 reference level
+#define REFERENCE_LOUDNESS -18.0
+
+// Interpolation filter from ITU-R BS.1770-4 Annex 2, 4 phases of 12 taps
+static const FXfloat truepeak_coefficients[4][12]={
+  { 0.0017089843750f, 0.0109863281250f,-0.0196533203125f, 0.0332031250000f,-0.0594482421875f, 0.1373291015625f,
+    0.9721679687500f,-0.1022949218750f, 0.0476074218750f,-0.0266113281250f, 0.0148925781250f,-0.0083007812500f},
+  {-0.0291748046875f, 0.0292968750000f,-0.0517578125000f, 0.0891113281250f,-0.1665039062500f, 0.4650878906250f,
+    0.7797851562500f,-0.2003173828125f, 0.1015625000000f,-0.0582275390625f, 0.0330810546875f,-0.0189208984375f},
+  {-0.0189208984375f, 0.0330810546875f,-0.0582275390625f, 0.1015625000000f,-0.2003173828125f, 0.7797851562500f,
+    0.4650878906250f,-0.1665039062500f, 0.0891113281250f,-0.0517578125000f, 0.0292968750000f,-0.0291748046875f},
+  {-0.0083007812500f, 0.0148925781250f,-0.0266113281250f, 0.0476074218750f,-0.1022949218750f, 0.9721679687500f,
+    0.1373291015625f,-0.0594482421875f, 0.0332031250000f,-0.0196533203125f, 0.0109863281250f, 0.0017089843750f}
+  };
+
+
+GMLoudnessMeter::GMLoudnessMeter() : energy(0.0),peak(0.0),nchannels(0),nsubframes(0),nframes(0),nsubblocks(0),oversample(false) {
+  }
+
+
+void GMLoudnessMeter::init(FXuint rate,FXuint channels) {
+  FXdouble f0,Q,K;
+
+  // High shelf (head response), coefficients valid for any sample rate
+  f0 = 1681.974450955533;
+  Q  = 0.7071752369554196;
+  K  = tan(PI*f0/rate);
+  FXdouble Vh = pow(10.0,3.999843853973347/20.0);
+  FXdouble Vb = pow(Vh,0.4996667741545416);
+  FXdouble a0 = 1.0 + K/Q + K*K;
+  b[0][0] = (Vh + Vb*K/Q + K*K) / a0;
+  b[0][1] = 2.0*(K*K - Vh) / a0;
+  b[0][2] = (Vh - Vb*K/Q + K*K) / a0;
+  a[0][0] = 2.0*(K*K - 1.0) / a0;
+  a[0][1] = (1.0 - K/Q + K*K) / a0;
+
+  // High pass (RLB weighting)
+  f0 = 38.13547087602444;
+  Q  = 0.5003270373238773;
+  K  = tan(PI*f0/rate);
+  a0 = 1.0 + K/Q + K*K;
+  b[1][0] = 1.0;
+  b[1][1] = -2.0;
+  b[1][2] = 1.0;
+  a[1][0] = 2.0*(K*K - 1.0) / a0;
+  a[1][1] = (1.0 - K/Q + K*K) / a0;
+
+  // Surround channels are weighted +1.5dB, LFE is ignored (5.1 layout)
+  weights.no(channels);
+  for (FXuint c=0;c<channels;c++) weights[c]=1.0;
+  if (channels==6) {
+    weights[3]=0.0;
+    weights[4]=1.41;
+    weights[5]=1.41;
+    }
+
+  state.no(channels*4);
+  for (FXint i=0;i<state.no();i++) state[i]=0.0;
+
+  history.no(channels*11);
+  for (FXint i=0;i<history.no();i++) history[i]=0.0f;
+
+  blocks.clear();
+  nchannels  = channels;
+  nsubframes = FXMAX(1,rate/10);
+  nframes    = 0;
+  nsubblocks = 0;
+  energy     = 0.0;
+  peak       = 0.0;
+
+  // At higher rates the sample peak is close enough
+  oversample = (rate<96000);
+  }
+
+
+void GMLoudnessMeter::clear() {
+  blocks.clear();
+  }
+
+
+// K-weight and collect the mean square per sub-block
+void GMLoudnessMeter::filter(const FXfloat * samples,FXival n) {
+  for (FXival i=0;i<n;i++) {
+    for (FXuint c=0;c<nchannels;c++) {
+      FXdouble * z = &state[c*4];
+      FXdouble x = samples[c];
+      FXdouble y = b[0][0]*x + z[0];
+      z[0] = b[0][1]*x - a[0][0]*y + z[1];
+      z[1] = b[0][2]*x - a[0][1]*y;
+      x = y;
+      y = b[1][0]*x + z[2];
+      z[2] = b[1][1]*x - a[1][0]*y + z[3];
+      z[3] = b[1][2]*x - a[1][1]*y;
+      energy += weights[c]*y*y;
+      }
+    samples+=nchannels;
+
+    if (++nframes==nsubframes) {
+      subblock[nsubblocks&3] = energy;
+      if (++nsubblocks>=4) {
+        blocks.append((subblock[0]+subblock[1]+subblock[2]+subblock[3]) / (4.0*nsubframes));
+        }
+      energy  = 0.0;
+      nframes = 0;
+      }
+    }
+  }
+
+
+// 4x oversampled peak
+void GMLoudnessMeter::truepeak(const FXfloat * samples,FXival n) {
+  FXArray<FXfloat> x(n+11);
+  for (FXuint c=0;c<nchannels;c++) {
+    FXfloat * h = &history[c*11];
+    for (FXint i=0;i<11;i++) x[i]=h[i];
+    for (FXival i=0;i<n;i++) x[i+11]=samples[i*nchannels+c];
+
+    for (FXival i=0;i<n;i++) {
+      const FXfloat * p = &x[i+11];
+      for (FXint f=0;f<4;f++) {
+        FXfloat y=0.0f;
+        for (FXint k=0;k<12;k++) y+=truepeak_coefficients[f][k]*p[-k];
+        peak = FXMAX(peak,(FXdouble)fabsf(y));
+        }
+      }
+
+    for (FXint i=0;i<11;i++) h[i]=x[n+i];
+    }
+  }
+
+
+void GMLoudnessMeter::process(const FXfloat * samples,FXival n) {
+  filter(samples,n);
+  if (oversample) {
+    truepeak(samples,n);
+    }
+  else {
+    for (FXival i=0;i<n*nchannels;i++) {
+      peak = FXMAX(peak,(FXdouble)fabsf(samples[i]));
+      }
+    }
+  }
+
+
+// Absolute gate at -70 LUFS, then relative gate 10 LU below the ungated level
+FXdouble GMLoudnessMeter::loudness(const FXArray<FXdouble> & blocks) {
+  const FXdouble absolute = pow(10.0,(-70.0+0.691)/10.0);
+  FXdouble sum=0.0,relative;
+  FXival n=0;
+
+  for (FXival i=0;i<blocks.no();i++) {
+    if (blocks[i]>absolute) {
+      sum+=blocks[i];
+      n++;
+      }
+    }
+  if (n==0) return NAN;
+
+  relative = (sum/n) * 0.1;
+  sum = 0.0;
+  n = 0;
+  for (FXival i=0;i<blocks.no();i++) {
+    if (blocks[i]>absolute && blocks[i]>relative) {
+      sum+=blocks[i];
+      n++;
+      }
+    }
+  if (n==0) return NAN;
+  return -0.691 + 10.0*log10(sum/n);
+  }
+
+
+
+// Decodes and measures a single track on the thread pool
+class GMLoudnessJob : public FXRunnable {
+public:
+  FXString                filename;
+  GMLoudnessMeter         meter;
+  const volatile FXbool * processing;
+  FXbool                  ok = false;
+public:
+  GMLoudnessJob(const FXString & file,const volatile FXbool * p) : filename(file), processing(p) {}
+
+  FXint run() {
+    ap::OfflineDecoder decoder;
+    if (decoder.open(filename)) {
+      const FXival nframes = 4096;
+      FXArray<FXfloat> buffer(nframes*decoder.channels());
+      FXival n;
+      meter.init(decoder.rate(),decoder.channels());
+      while((n=decoder.read(buffer.data(),nframes))>0 && *processing) {
+        meter.process(buffer.data(),n);
+        }
+      ok = (n==0);
+      decoder.close();
+      }
+    return 0;
+    }
+  };
+
+
+GMLoudnessTask::GMLoudnessTask(GMTrackDatabase * db,const FXIntList & t,FXbool w) : database(db), tracks(t), writetags(w) {
+  }
+
+
+FXint GMLoudnessTask::run() {
+  FXIntList    albums;
+  FXIntList    offsets;
+  FXIntList    list;
+  FXStringList files;
+  FXIntMap     seen;
+  FXint        album;
+  FXint        next=0;
+
+  FXArray<GMLoudnessJob*> jobs;
+
+  // The database is only locked to look up the tracks and to store results, never while decoding
+  try {
+    GMTaskTransaction transaction(database);
+
+    // Album gain needs every track of the album, not just the selected ones
+    GMQuery query_album(database,"SELECT album FROM tracks WHERE id == ?;");
+    GMQuery query_album_tracks(database,"SELECT id FROM tracks WHERE album == ? ORDER BY no;");
+    for (FXint i=0;i<tracks.no();i++) {
+      album=0;
+      query_album.execute(tracks[i],album);
+      if (album && seen.at(album)==0) {
+        seen.insert(album,1);
+        albums.append(album);
+        offsets.append(list.no());
+        query_album_tracks.set(0,album);
+        while(query_album_tracks.row()) {
+          FXint id;
+          query_album_tracks.get(0,id);
+          list.append(id);
+          }
+        query_album_tracks.reset();
+        }
+      }
+    offsets.append(list.no());
+    database->getTrackFilenames(list,files);
+    transaction.commit();
+    }
+  catch(GMDatabaseException&) {
+    return 1;
+    }
+
+  jobs.no(list.no());
+  for (FXint i=0;i<jobs.no();i++) jobs[i]=nullptr;
+
+  const FXint nbatch = 2*(GMThreadPool::instance() ? GMThreadPool::instance()->getMaximumThreads() : 1);
+  const FXTime start = FXThread::steadytime();
+
+  try {
+    for (FXint i=0,n;i<list.no() && processing;i+=n) {
+      n = FXMIN(nbatch,list.no()-i);
+
+      GMTaskGroup group(this);
+      for (FXint j=i;j<i+n;j++) {
+        jobs[j] = new GMLoudnessJob(files[j],&processing);
+        group.execute(jobs[j]);
+        }
+      group.wait();
+
+      if (!processing) break;
+
+      // Store albums that are complete
+      while(next<albums.no() && offsets[next+1]<=i+n) {
+        FXArray<FXdouble> blocks;
+        FXdouble album_peak=0.0;
+
+        for (FXint j=offsets[next];j<offsets[next+1];j++) {
+          if (jobs[j]->ok) {
+            blocks.append(jobs[j]->meter.getBlocks());
+            album_peak = FXMAX(album_peak,jobs[j]->meter.getPeak());
+            }
+          }
+
+        const FXdouble album_gain = REFERENCE_LOUDNESS - GMLoudnessMeter::loudness(blocks);
+
+        // Silent tracks have no loudness to store
+        for (FXint j=offsets[next];j<offsets[next+1];j++) {
+          if (!jobs[j]->ok) {
+            GM_DEBUG_PRINT("[loudness] failed to analyze %s\n",files[j].text());
+            }
+          else if (isnan(jobs[j]->meter.getLoudness())) {
+            GM_DEBUG_PRINT("[loudness] %s is silent\n",files[j].text());
+            jobs[j]->ok=false;
+            }
+          }
+
+        // Tags are written before taking the lock
+        FXArray<FXbool> tagged(offsets[next+1]-offsets[next]);
+        for (FXint j=offsets[next];j<offsets[next+1];j++) {
+          tagged[j-offsets[next]]=false;
+          if (writetags && jobs[j]->ok) {
+            GMFileTag tag;
+            if (tag.open(files[j],FILETAG_TAGS)) {
+              tag.setReplayGain(REFERENCE_LOUDNESS-jobs[j]->meter.getLoudness(),jobs[j]->meter.getPeak(),album_gain,album_peak);
+              tagged[j-offsets[next]]=tag.save();
+              }
+            }
+          }
+
+        GMTaskTransaction transaction(database);
+        for (FXint j=offsets[next];j<offsets[next+1];j++) {
+          if (database->interrupt)
+            transaction.pause();
+          if (jobs[j]->ok) {
+            const FXdouble loudness   = jobs[j]->meter.getLoudness();
+            const FXdouble track_gain = REFERENCE_LOUDNESS - loudness;
+            const FXdouble track_peak = jobs[j]->meter.getPeak();
+            database->setTrackLoudness(list[j],loudness,track_gain,track_peak,album_gain,album_peak);
+            if (tagged[j-offsets[next]])
+              database->setTrackImported(list[j],FXThread::time());
+            }
+          delete jobs[j];
+          jobs[j]=nullptr;
+          }
+        transaction.commit();
+        next++;
+        }
+
+      const FXdouble elapsed = (FXThread::steadytime()-start) / 1000000000.0;
+      taskmanager->setStatus(FXString::value("Analyzing %d/%d (%.1f tracks/s)",i+n,list.no(),(elapsed>0.0) ? (i+n)/elapsed : 0.0));
+      }
+    for (FXint i=0;i<jobs.no();i++) delete jobs[i];
+    }
+  catch(GMDatabaseException&) {
+    for (FXint i=0;i<jobs.no();i++) delete jobs[i];
+    return 1;
+    }
+  return processing ? 0 : 1;
+  }
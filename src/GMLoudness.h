@@ -0,0 +1,98 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef GMLOUDNESS_H
+#define GMLOUDNESS_H
+
+/*
+  EBU R128 / ITU-R BS.1770 loudness meter.
+
+  Samples are K-weighted and the mean square is collected in 100ms
+  sub-blocks, four of which make up one gating block (75% overlap).
+  The block energies are kept so the integrated loudness of an album
+  can be computed by gating the blocks of all its tracks together.
+*/
+class GMLoudnessMeter {
+protected:
+  FXArray<FXdouble> blocks;       // gating block energies
+  FXArray<FXdouble> state;        // filter state, 4 per channel
+  FXArray<FXdouble> weights;      // channel weights
+  FXArray<FXfloat>  history;      // true peak interpolation history, 11 per channel
+  FXdouble          b[2][3];      // K-weighting filter coefficients
+  FXdouble          a[2][2];
+  FXdouble          subblock[4];  // last four sub-block energies
+  FXdouble          energy;       // current sub-block energy
+  FXdouble          peak;         // true peak
+  FXuint            nchannels;
+  FXuint            nsubframes;   // frames per sub-block
+  FXuint            nframes;      // frames in current sub-block
+  FXuint            nsubblocks;   // number of sub-blocks seen
+  FXbool            oversample;
+protected:
+  void filter(const FXfloat * samples,FXival n);
+  void truepeak(const FXfloat * samples,FXival n);
+private:
+  GMLoudnessMeter(const GMLoudnessMeter&);
+  GMLoudnessMeter &operator=(const GMLoudnessMeter&);
+public:
+  GMLoudnessMeter();
+
+  /// Reset meter for given format
+  void init(FXuint rate,FXuint channels);
+
+  /// Process interleaved samples
+  void process(const FXfloat * samples,FXival nframes);
+
+  /// Integrated loudness in LUFS. NAN if there's nothing above the gate.
+  FXdouble getLoudness() const { return loudness(blocks); }
+
+  /// True peak, linear
+  FXdouble getPeak() const { return peak; }
+
+  /// Gating block energies
+  const FXArray<FXdouble> & getBlocks() const { return blocks; }
+
+  /// Release gating blocks
+  void clear();
+
+  /// Gated loudness of the given block energies
+  static FXdouble loudness(const FXArray<FXdouble> & blocks);
+  };
+
+
+class GMTrackDatabase;
+
+/*
+  Analyzes the loudness of a set of tracks on the thread pool and
+  stores the results in the database. Tracks are grouped per album,
+  and all tracks of an album are analyzed so the album gain covers
+  the whole album. Playback uses the stored gains for tracks without
+  replay gain tags. Optionally the tags are updated as well.
+*/
+class GMLoudnessTask : public GMTask {
+protected:
+  GMTrackDatabase * database;
+  FXIntList         tracks;
+  FXbool            writetags;
+protected:
+  FXint run();
+public:
+  GMLoudnessTask(GMTrackDatabase * db,const FXIntList & tracks,FXbool writetags);
+  };
+
+#endif
@@ -145,7 +145,14 @@ void GMPlayListSource::dragged(GMTrackList*tracklist){
 FXbool GMPlayListSource::findCurrent(GMTrackList * list,GMSource * src) {
   if (src->getCurrentTrack()==-1) return false;
   if (src==this) {
-    for (FXint i=0;i<list->getNumItems();i++){
+    // Usually the track is only listed once
+    FXint first = list->findItemById(current_track);
+    if (first>=0 && dynamic_cast<GMDBTrackItem*>(list->getItem(first))->getTrackQueue()==current_queue) {
+      list->setActiveItem(first);
+      list->setCurrentItem(first);
+      return true;
+      }
+    for (FXint i=first+1;first>=0 && i<list->getNumItems();i++){
       if (list->getItemId(i)==current_track && dynamic_cast<GMDBTrackItem*>(list->getItem(i))->getTrackQueue()==current_queue) {
         list->setActiveItem(i);
         list->setCurrentItem(i);
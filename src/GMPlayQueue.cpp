@@ -88,7 +88,14 @@ void GMPlayQueue::configure(GMColumnList& list) {
 FXbool GMPlayQueue::findCurrent(GMTrackList * list,GMSource * src) {
   if (src->getCurrentTrack()==-1) return false;
   if (src==this) {
-    for (FXint i=0;i<list->getNumItems();i++){
+    // Usually the track is only listed once
+    FXint first = list->findItemById(current_track);
+    if (first>=0 && dynamic_cast<GMDBTrackItem*>(list->getItem(first))->getTrackQueue()==1) {
+      list->setActiveItem(first);
+      list->setCurrentItem(first);
+      return true;
+      }
+    for (FXint i=first+1;first>=0 && i<list->getNumItems();i++){
       if (list->getItemId(i)==current_track && dynamic_cast<GMDBTrackItem*>(list->getItem(i))->getTrackQueue()==1) {
         list->setActiveItem(i);
         list->setCurrentItem(i);
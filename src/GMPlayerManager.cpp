@@ -78,6 +78,7 @@
 
 #include "GMCoverCache.h"
 #include "GMAudioPlayer.h"
+#include "GMWaveform.h"
 
 #include "GMAudioScrobbler.h"
 
@@ -124,10 +125,13 @@ FXDEFMAP(GMPlayerManager) GMPlayerManagerMap[]={
   FXMAPFUNC(SEL_TASK_IDLE,GMPlayerManager::ID_TASKMANAGER,GMPlayerManager::onTaskManagerIdle),
   FXMAPFUNC(SEL_TASK_RUNNING,GMPlayerManager::ID_TASKMANAGER,GMPlayerManager::onTaskManagerRunning),
 
-  FXMAPFUNC(SEL_TIMEOUT,GMPlayerManager::ID_TASKMANAGER_SHUTDOWN,GMPlayerManager::onTaskManagerShutdown),
 
   FXMAPFUNC(SEL_TASK_COMPLETED,GMPlayerManager::ID_IMPORT_TASK,GMPlayerManager::onImportTaskCompleted),
   FXMAPFUNC(SEL_TASK_CANCELLED,GMPlayerManager::ID_IMPORT_TASK,GMPlayerManager::onImportTaskCompleted),
+  FXMAPFUNC(SEL_TASK_COMPLETED,GMPlayerManager::ID_WAVEFORM_TASK,GMPlayerManager::onWaveformTaskCompleted),
+  FXMAPFUNC(SEL_TASK_CANCELLED,GMPlayerManager::ID_WAVEFORM_TASK,GMPlayerManager::onWaveformTaskCompleted),
+  FXMAPFUNC(SEL_TASK_COMPLETED,GMPlayerManager::ID_LOUDNESS_TASK,GMPlayerManager::onLoudnessTaskCompleted),
+  FXMAPFUNC(SEL_TASK_CANCELLED,GMPlayerManager::ID_LOUDNESS_TASK,GMPlayerManager::onLoudnessTaskCompleted),
 #ifdef HAVE_SESSION
   FXMAPFUNC(SEL_SESSION_CLOSED,GMPlayerManager::ID_SESSION_MANAGER,GMPlayerManager::onCmdQuit)
 #endif
@@ -293,6 +297,7 @@ GMPlayerManager::~GMPlayerManager() {
 
   delete player;
   delete taskmanager;
+  delete threadpool;
 
   myself=nullptr;
 
@@ -386,6 +391,7 @@ FXbool GMPlayerManager::init_sources() {
   if (!init_database(database)) {
     return false;
     }
+  database->setSortKeywords(preferences.gui_sort_keywords);
 
   /// Create the main database source
   sources.append(new GMDatabaseSource(database));
@@ -683,6 +689,7 @@ FXint GMPlayerManager::run(int& argc,char** argv) {
       "likely the libpng header files were not installed on your system."));
     }
 
+  threadpool  = new GMThreadPool();
   taskmanager = new GMTaskManager(this,ID_TASKMANAGER);
 
 #ifdef HAVE_DBUS
@@ -815,14 +822,13 @@ void GMPlayerManager::exit() {
 
   application->removeTimeout(this,GMPlayerManager::ID_PLAY_NOTIFY);
 
-  application->removeTimeout(this,GMPlayerManager::ID_TASKMANAGER_SHUTDOWN);
-
   application->removeTimeout(source,GMSource::ID_TRACK_PLAYED);
 
   preferences.save(application->reg());
 
   if (scrobbler) scrobbler->shutdown();
   if (taskmanager) taskmanager->shutdown();
+  if (threadpool) threadpool->shutdown();
 
 #ifdef HAVE_DBUS
   if (sessionbus) {
@@ -845,6 +851,9 @@ void GMPlayerManager::exit() {
     }
 #endif
 
+  // All database writes are done, so the snapshot matches the change counter
+  getTrackView()->saveSnapshot(database->getChangeCounter());
+
   // Destroy shared datastructures between playlists
   getDatabaseSource()->shutdown();
 
@@ -975,7 +984,18 @@ void GMPlayerManager::open(const FXString & url) {
     getTrackView()->setActive(-1);
     }
 
-  player->open(url,true);
+  open_player(url,true);
+  }
+
+
+// Open the current track. Analyzed loudness is used for tracks without replay gain tags.
+void GMPlayerManager::open_player(const FXString & url,FXbool flush) {
+  ReplayGain gain;
+  if (source && source->getCurrentTrack()!=-1 && dynamic_cast<GMDatabaseSource*>(source)) {
+    if (!database->getTrackLoudness(source->getCurrentTrack(),gain.track,gain.track_peak,gain.album,gain.album_peak))
+      gain.reset();
+    }
+  player->open(url,gain,flush);
   }
 
 
@@ -1024,7 +1044,7 @@ void GMPlayerManager::playItem(FXuint whence) {
 
   if (source) {
     trackinfoset = source->getTrack(trackinfo);
-    player->open(trackinfo.url,true);
+    open_player(trackinfo.url,true);
     }
   else {
     player->stop();
@@ -1180,7 +1200,7 @@ void GMPlayerManager::notify_playback_finished() {
     source = getTrackView()->getSource();
     trackinfoset = source->getTrack(trackinfo);
     }
-  player->open(trackinfo.url,false);
+  open_player(trackinfo.url,false);
   }
 
 FXbool GMPlayerManager::playing() const {
@@ -1285,6 +1305,8 @@ void GMPlayerManager::update_track_display(FXbool notify) {
 
   mainwindow->display(trackinfo);
 
+  update_waveform_display();
+
   if (notify) application->addTimeout(this,ID_PLAY_NOTIFY,500_ms);
 
   if (queue) {
@@ -1430,28 +1452,63 @@ long GMPlayerManager::onImportTaskCompleted(FXObject*,FXSelector sel,void*ptr){
 
 
 
+// Show the cached overview, or generate it for local files
+void GMPlayerManager::update_waveform_display() {
+  GMWaveform waveform;
+  if (gm_is_local_file(trackinfo.url) && waveform.load(trackinfo.url)) {
+    mainwindow->trackslider->setWaveform(waveform.peaks);
+    }
+  else {
+    mainwindow->trackslider->clearWaveform();
+    if (gm_is_local_file(trackinfo.url) && waveformfile!=trackinfo.url) {
+      FXStringList files;
+      files.append(trackinfo.url);
+      GMWaveformTask * task = new GMWaveformTask(files,this,ID_WAVEFORM_TASK);
+      waveformfile=trackinfo.url;
+      runTask(task);
+      }
+    }
+  }
+
+
+long GMPlayerManager::onWaveformTaskCompleted(FXObject*,FXSelector sel,void*ptr){
+  GMWaveformTask * task = static_cast<GMWaveformTask*>(*static_cast<GMTask**>(ptr));
+  if (task->getFiles().no()==1 && task->getFiles()[0]==waveformfile) waveformfile.clear();
+  if (FXSELTYPE(sel)==SEL_TASK_COMPLETED && playing() && !mainwindow->trackslider->hasWaveform()) {
+    const FXStringList & files = task->getFiles();
+    for (FXint i=0;i<files.no();i++) {
+      if (files[i]==trackinfo.url) {
+        GMWaveform waveform;
+        if (waveform.load(trackinfo.url))
+          mainwindow->trackslider->setWaveform(waveform.peaks);
+        break;
+        }
+      }
+    }
+  delete task;
+  return 0;
+  }
+
+
+// Analyzed loudness is picked up the next time a track is opened
+long GMPlayerManager::onLoudnessTaskCompleted(FXObject*,FXSelector,void*ptr){
+  GMTask * task = *static_cast<GMTask**>(ptr);
+  delete task;
+  return 0;
+  }
+
+
 void GMPlayerManager::runTask(GMTask * task) {
-  application->removeTimeout(this,GMPlayerManager::ID_TASKMANAGER_SHUTDOWN);
   taskmanager->run(task);
   }
 
 long GMPlayerManager::onTaskManagerIdle(FXObject*,FXSelector,void*){
   mainwindow->setStatus(FXString::null);
-  GM_DEBUG_PRINT("Schedule taskmanager shutdown in 30s\n");
-  application->addTimeout(this,GMPlayerManager::ID_TASKMANAGER_SHUTDOWN,30_s);
   return 0;
   }
 
 long GMPlayerManager::onTaskManagerRunning(FXObject*,FXSelector,void*){
   GM_DEBUG_PRINT("Taskmanager running\n");
-  application->removeTimeout(this,GMPlayerManager::ID_TASKMANAGER_SHUTDOWN);
-  return 0;
-  }
-
-
-long GMPlayerManager::onTaskManagerShutdown(FXObject*,FXSelector,void*){
-  GM_DEBUG_PRINT("Shutdown taskmanager now\n");
-  taskmanager->shutdown();
   return 0;
   }
 
@@ -51,6 +51,7 @@ class GMPodcastSource;
 class GMDatabaseSource;
 class GMCoverCache;
 class GMCoverManager;
+class GMThreadPool;
 class GMTaskManager;
 class GMTask;
 class GMSession;
@@ -99,6 +100,7 @@ protected:
   FXlong        count_track_remaining = 0;
   FXbool        scheduled_stop        = false;
   FXbool        has_seeked            = false;
+  GMThreadPool         * threadpool   = nullptr;
   GMTaskManager        * taskmanager  = nullptr;
 protected:
 
@@ -130,6 +132,7 @@ protected:
   GMCoverManager       * covermanager = nullptr;
   GMTrack                trackinfo;
   FXbool                 trackinfoset = false;
+  FXString               waveformfile;          // waveform being generated
 protected:
   FXbool hasSourceWithKey(const FXString & key) const;
   void cleanSourceSettings();
@@ -153,9 +156,10 @@ public:
 #endif
     ID_AUDIO_PLAYER,
     ID_IMPORT_TASK,
+    ID_WAVEFORM_TASK,
+    ID_LOUDNESS_TASK,
     ID_CANCEL_TASK,
     ID_TASKMANAGER,
-    ID_TASKMANAGER_SHUTDOWN,
     ID_SESSION_MANAGER,
     ID_CHILD
     };
@@ -173,10 +177,11 @@ public:
 
 
   long onImportTaskCompleted(FXObject*,FXSelector,void*);
+  long onWaveformTaskCompleted(FXObject*,FXSelector,void*);
+  long onLoudnessTaskCompleted(FXObject*,FXSelector,void*);
   long onTaskManagerRunning(FXObject*,FXSelector,void*);
   long onTaskManagerStatus(FXObject*,FXSelector,void*);
   long onTaskManagerIdle(FXObject*,FXSelector,void*);
-  long onTaskManagerShutdown(FXObject*,FXSelector,void*);
   long onCancelTask(FXObject*,FXSelector,void*);
   long onCmdQuit(FXObject*,FXSelector,void*);
 #ifdef HAVE_DBUS
@@ -196,6 +201,7 @@ protected:
   FXbool init_sources();
   void   init_window(FXbool wizard);
   void   init_configuration();
+  void   open_player(const FXString & url,FXbool flush);
 #ifdef HAVE_DBUS
   FXbool init_dbus(int & argc,char**argv);
 #endif
@@ -315,6 +321,8 @@ public:
 
   void update_track_display(FXbool notify=true);
 
+  void update_waveform_display();
+
   void update_time_display();
 
   void display_track_notification();
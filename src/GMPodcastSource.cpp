@@ -189,6 +189,7 @@ public:
   RssFeed  feed;
   RssItem  item;
   FXString value;
+  FXTime   stopdate = 0;  // Stop parsing when the feed date matches
 protected:
   FXint begin(const FXchar *element,const FXchar** attributes){
     switch(node()) {
@@ -264,7 +265,10 @@ protected:
         break;
       case Elem_Item_Date:
         gm_parse_datetime(value,item.date);
-        if (feed.date==0) feed.date=item.date;
+        if (feed.date==0) {
+          feed.date=item.date;
+          if (stopdate && feed.date==stopdate) stop();
+          }
         value.clear();
         break;
       case Elem_Item_Duration:
@@ -273,6 +277,7 @@ protected:
         break;
       case Elem_Channel_Date:
         gm_parse_datetime(value,feed.date);
+        if (stopdate && feed.date==stopdate) stop();
         value.clear();
         break;
       }
@@ -321,7 +326,7 @@ public:
     Elem_Item_Duration,
     };
 public:
-  RssParser(){}
+  RssParser(FXTime date=0) : stopdate(date) {}
   ~RssParser(){}
   };
 
@@ -946,16 +951,36 @@ FXint GMPodcastUpdater::run() {
         }
 
 
-      FXString feed = http.body();
-      RssParser rss;
+      FXString    feed_file = GMApp::getPodcastDirectory()+PATHSEPSTRING+feed_dir+PATHSEPSTRING"feed.rss";
+      RssParser   rss(date);
+      XmlParser & parser = rss;
+      FXFile      dump;
+      FXchar      buffer[4096];
+      FXival      n=0;
+
+      // Parse while receiving, stops as soon as we know the feed hasn't changed
+      dump.open(feed_file+".part",FXIO::Writing);
+      if (parser.start(media.parameters["charset"])) {
+        while((n=http.readBody(buffer,sizeof(buffer)))>0) {
+          dump.writeBlock(buffer,n);
+          if (!parser.feed(buffer,n)) break;
+          }
+        }
+      dump.close();
+
+      if (rss.isStopped()) {
+        GM_DEBUG_PRINT("[rss] feed is up to date\n");
+        FXFile::remove(feed_file+".part");
+        continue;
+        }
 
-      if (rss.parse(feed,media.parameters["charset"])) {
+      if (n>=0 && parser.finish()) {
         if (rss.feed.date!=date) {
           GM_DEBUG_PRINT("[rss] feed needs updating %s - %s\n",FXSystem::universalTime(rss.feed.date).text(),FXSystem::localTime(rss.feed.date).text());
 
           rss.feed.trim();
 
-          gm_dump_file(GMApp::getPodcastDirectory()+PATHSEPSTRING+feed_dir+PATHSEPSTRING"feed.rss",feed);
+          FXFile::move(feed_file+".part",feed_file,true);
 
           GM_DEBUG_PRINT("%s - %s\n",url.text(),FXSystem::universalTime(date).text());
           if (!rss.feed.image.empty()) {
@@ -1019,10 +1044,12 @@ FXint GMPodcastUpdater::run() {
           }
         else {
           GM_DEBUG_PRINT("[rss] feed is up to date\n");
+          FXFile::remove(feed_file+".part");
           }
         }
       else {
         GM_DEBUG_PRINT("[rss] failed to parse feed\n");
+        FXFile::remove(feed_file+".part");
         }
       }
     transaction.commit();
@@ -1167,6 +1194,10 @@ void GMPodcastSource::loadCovers() {
 
 void GMPodcastSource::updateCovers() {
   if (covercache) {
+    if (coverloading) {
+      coverpending=true;
+      return;
+      }
     GMCoverPathList list;
     FXString feed_dir;
     FXint feed,n=0;
@@ -1184,6 +1215,8 @@ void GMPodcastSource::updateCovers() {
         }
       GMCoverLoader * loader = new GMCoverLoader(covercache->getTempFilename(),list,GMPlayerManager::instance()->getPreferences().gui_coverdisplay_size,this,ID_LOAD_COVERS);
       loader->setFolderOnly(true);
+      loader->setPriority(TASK_PRIORITY_INTERACTIVE);
+      coverloading=true;
       GMPlayerManager::instance()->runTask(loader);
       }
     }
@@ -1198,6 +1231,11 @@ long GMPodcastSource::onCmdLoadCovers(FXObject*,FXSelector sel,void*ptr) {
     GMPlayerManager::instance()->getTrackView()->redrawAlbumList();
     }
   delete loader;
+  coverloading=false;
+  if (coverpending) {
+    coverpending=false;
+    updateCovers();
+    }
   return 0;
   }
 
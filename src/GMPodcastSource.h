@@ -43,6 +43,8 @@ protected:
   GMTrackDatabase     * db         = nullptr;
   GMCoverCache        * covercache = nullptr;
   GMPodcastDownloader * downloader = nullptr;
+  FXbool                coverloading = false;
+  FXbool                coverpending = false;
   FXint                 navailable = 0;
 protected:
   GMPodcastSource(){}
@@ -34,6 +34,7 @@
 #include "GMPlayerManager.h"
 #include "GMWindow.h"
 #include "GMRemote.h"
+#include "GMTrackDatabase.h"
 #include "GMDatabaseSource.h"
 #include "GMPodcastSource.h"
 #include "GMTrackView.h"
@@ -624,6 +625,9 @@ GMPreferencesDialog::GMPreferencesDialog(FXWindow * p) : FXDialogBox(p,FXString:
   if (AP_HAS_PLUGIN(devices,DeviceWav))
     driverlist->appendItem("Wave File Output",nullptr,(void*)DeviceWav);
 
+  if (AP_HAS_PLUGIN(devices,DeviceStream))
+    driverlist->appendItem("Network Stream",nullptr,(void*)DeviceStream);
+
   if (driverlist->getNumItems()) {
     driverlist->setCurrentItem(driverlist->findItemByData((void*)(FXival)config.device));
     driverlist->setNumVisible(FXMIN(9,driverlist->getNumItems()));
@@ -655,6 +659,32 @@ GMPreferencesDialog::GMPreferencesDialog(FXWindow * p) : FXDialogBox(p,FXString:
   sndio_device = new GMTextField(matrix,20,nullptr,0,TEXTFIELD_NORMAL|LAYOUT_FILL_X|LAYOUT_FILL_COLUMN);
   sndio_device->setText(config.sndio.device);
 
+  /// Network Stream
+  stream_port_label = new FXLabel(matrix,tr("Port:"),nullptr,labelstyle);
+  stream_port = new GMTextField(matrix,6,nullptr,0,TEXTFIELD_NORMAL|TEXTFIELD_INTEGER|LAYOUT_FILL_COLUMN);
+  stream_port->setText(FXString::value(config.stream.port));
+  stream_format_label = new FXLabel(matrix,tr("Format:"),nullptr,labelstyle);
+  stream_formatlist = new GMListBox(matrix,nullptr,0,LISTBOX_NORMAL|LAYOUT_FILL_COLUMN);
+  stream_formatlist->appendItem(tr("Wav"),nullptr,(void*)StreamConfig::FormatWav);
+  stream_formatlist->appendItem(tr("Flac"),nullptr,(void*)StreamConfig::FormatFlac);
+  stream_formatlist->setNumVisible(2);
+  stream_formatlist->setCurrentItem(FXMAX(0,stream_formatlist->findItemByData((void*)(FXival)config.stream.format)));
+
+  /// Alsa, Pulse and Network Stream
+  profile_label = new FXLabel(matrix,tr("Latency:"),nullptr,labelstyle);
+  profilelist = new GMListBox(matrix,nullptr,0,LISTBOX_NORMAL|LAYOUT_FILL_COLUMN);
+  profilelist->appendItem(tr("Default"),nullptr,(void*)ProfileDefault);
+  profilelist->appendItem(tr("Low Latency"),nullptr,(void*)ProfileLowLatency);
+  profilelist->appendItem(tr("Power Saving"),nullptr,(void*)ProfilePowerSaving);
+  profilelist->setNumVisible(3);
+  profilelist->setCurrentItem(FXMAX(0,profilelist->findItemByData((void*)(FXival)config.profile)));
+
+  profile_info_frame = new FXFrame(matrix,FRAME_NONE);
+  profile_info = new FXLabel(matrix,FXString::null,nullptr,labelstyle|LAYOUT_FILL_COLUMN);
+  const OutputLatency & latency = GMPlayerManager::instance()->getPlayer()->getOutputLatency();
+  if (latency.latency)
+    profile_info->setText(FXString::value(tr("%u ms, %u wakeups per second"),latency.latency,latency.wakeups));
+
   showDriverSettings(config.device);
 
   new FXFrame(matrix,FRAME_NONE);
@@ -749,6 +779,36 @@ long GMPreferencesDialog::onCmdDisplayDPI(FXObject*,FXSelector,void*ptr){
   return 1;
   }
 
+void GMPreferencesDialog::showProfileSettings(FXbool show) {
+  if (show) {
+    profile_label->show();
+    profilelist->show();
+    profile_info_frame->show();
+    profile_info->show();
+    }
+  else {
+    profile_label->hide();
+    profilelist->hide();
+    profile_info_frame->hide();
+    profile_info->hide();
+    }
+  }
+
+void GMPreferencesDialog::showStreamSettings(FXbool show) {
+  if (show) {
+    stream_port_label->show();
+    stream_port->show();
+    stream_format_label->show();
+    stream_formatlist->show();
+    }
+  else {
+    stream_port_label->hide();
+    stream_port->hide();
+    stream_format_label->hide();
+    stream_formatlist->hide();
+    }
+  }
+
 void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
   switch(driver) {
     case DeviceAlsa:
@@ -761,7 +821,8 @@ void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
         oss_device_label->hide();
         sndio_device->hide();
         sndio_device_label->hide();
-
+        showStreamSettings(false);
+        showProfileSettings(true);
       } break;
 
     case DeviceOSS:
@@ -774,6 +835,8 @@ void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
         sndio_device_label->hide();
         oss_device->show();
         oss_device_label->show();
+        showStreamSettings(false);
+        showProfileSettings(false);
       } break;
 
     case DevicePulse:
@@ -786,6 +849,22 @@ void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
         oss_device_label->hide();
         sndio_device->hide();
         sndio_device_label->hide();
+        showStreamSettings(false);
+        showProfileSettings(true);
+      } break;
+
+    case DeviceStream:
+      {
+        alsa_device_label->hide();
+        alsa_device->hide();
+        alsa_hardware_only->hide();
+        alsa_hardware_only_frame->hide();
+        oss_device->hide();
+        oss_device_label->hide();
+        sndio_device->hide();
+        sndio_device_label->hide();
+        showStreamSettings(true);
+        showProfileSettings(true);
       } break;
 
     case DeviceSndio:
@@ -798,6 +877,8 @@ void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
         oss_device_label->hide();
         sndio_device->show();
         sndio_device_label->show();
+        showStreamSettings(false);
+        showProfileSettings(false);
       } break;
 
     default:
@@ -810,6 +891,8 @@ void GMPreferencesDialog::showDriverSettings(FXuchar driver) {
         oss_device_label->hide();
         sndio_device->hide();
         sndio_device_label->hide();
+        showStreamSettings(false);
+        showProfileSettings(false);
       } break;
 
     }
@@ -836,6 +919,11 @@ long GMPreferencesDialog::onCmdApplyAudio(FXObject*,FXSelector,void*){
   config.oss.device = oss_device->getText();
   config.sndio.device = sndio_device->getText();
 
+  config.stream.port = (FXushort)FXCLAMP(1,stream_port->getText().toInt(),65535);
+  config.stream.format = (FXuchar)(FXival)stream_formatlist->getItemData(stream_formatlist->getCurrentItem());
+
+  config.profile = (FXuchar)(FXival)profilelist->getItemData(profilelist->getCurrentItem());
+
   GMPlayerManager::instance()->getPlayer()->setOutputConfig(config);
   return 1;
   }
@@ -891,6 +979,7 @@ long GMPreferencesDialog::onCmdAccept(FXObject*,FXSelector,void*) {
     }
 
   GMPlayerManager::instance()->getPreferences().setKeyWords(keywords);
+  GMPlayerManager::instance()->getTrackDatabase()->setSortKeywords(GMPlayerManager::instance()->getPreferences().gui_sort_keywords);
 
   if (!(selected==current)) {
     GMIconTheme::instance()->load();
@@ -55,8 +55,20 @@ protected:
   FXLabel     * sndio_device_label = nullptr;
   FXTextField * sndio_device = nullptr;
 
+  FXLabel     * stream_port_label = nullptr;
+  FXTextField * stream_port = nullptr;
+  FXLabel     * stream_format_label = nullptr;
+  GMListBox   * stream_formatlist = nullptr;
+
+  FXLabel     * profile_label = nullptr;
+  GMListBox   * profilelist = nullptr;
+  FXFrame     * profile_info_frame = nullptr;
+  FXLabel     * profile_info = nullptr;
+
 protected:
   void showDriverSettings(FXuchar driver);
+  void showProfileSettings(FXbool show);
+  void showStreamSettings(FXbool show);
 public:
   FXFontPtr     font_fixed;
 
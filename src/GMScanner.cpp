@@ -16,6 +16,7 @@
 * You should have received a copy of the GNU General Public License            *
 * along with this program.  If not, see http://www.gnu.org/licenses.           *
 ********************************************************************************/
+#include <limits.h>
 #include <tag.h>
 #include "gmdefs.h"
 #include "GMTaskManager.h"
@@ -79,8 +80,7 @@ void GMDBTracks::init(GMTrackDatabase*db,FXbool afg) {
                                                                            "0," // rating
                                                                            "?," // samplerate
                                                                            "?," // channels
-                                                                           "?,"  // filetype
-                                                                           "?);"); // lyrics
+                                                                           "?);"); // filetype
 
 
   insert_tag                          = database->compile("INSERT INTO tags VALUES ( NULL , ?  );");
@@ -94,6 +94,7 @@ void GMDBTracks::init(GMTrackDatabase*db,FXbool afg) {
                                                                                    "? ;");
   insert_playlist_track_by_id         = database->compile("INSERT INTO playlist_tracks VALUES (?,?,?);");
   insert_track_tag                    = database->compile("INSERT OR IGNORE INTO track_tags VALUES ( ? , ? );");
+  insert_track_text                   = database->compile("INSERT OR REPLACE INTO track_text VALUES ( ? , ? );");
 
   update_track                        = database->compile("UPDATE tracks SET title = ?,"
                                                                   "time = ?,"
@@ -107,7 +108,6 @@ void GMDBTracks::init(GMTrackDatabase*db,FXbool afg) {
                                                                   "artist = ?,"
                                                                   "composer = ?,"
                                                                   "conductor = ?,"
-                                                                  "lyrics = ?,"
                                                                   "importdate = ? WHERE id == ?;");
 
 
@@ -119,6 +119,8 @@ void GMDBTracks::init(GMTrackDatabase*db,FXbool afg) {
 
   delete_track_playlists              = database->compile("DELETE FROM playlist_tracks WHERE track == ?;");
   delete_track_tags                   = database->compile("DELETE FROM track_tags WHERE track == ?;");
+  delete_track_text                   = database->compile("DELETE FROM track_text WHERE track == ?;");
+  delete_track_loudness               = database->compile("DELETE FROM track_loudness WHERE track == ?;");
   delete_track                        = database->compile("DELETE FROM tracks WHERE id == ?;");
 
   initPathDict(database);
@@ -263,13 +265,16 @@ void GMDBTracks::insert(GMTrack & track,FXint & path_index) {
     insert_track.set(12,track.samplerate);
     insert_track.set(13,track.channels);
     insert_track.set(14,track.filetype);
-    insert_track.set(15,track.lyrics);
 
     track.index = insert_track.insert();
 
     /// Tags
     if (track.tags.no())
       insertTags(track.index,track.tags);
+
+    /// Lyrics
+    if (!track.lyrics.empty())
+      updateText(track.index,track.lyrics);
     }
 
   /// Add to playlist
@@ -307,25 +312,123 @@ void GMDBTracks::update(GMTrack & track) {
   update_track.set(9,artist_id);
   update_track.set_null(10,composer_id);
   update_track.set_null(11,conductor_id);
-  update_track.set(12,track.lyrics);
-  update_track.set(13,FXThread::time());
-  update_track.set(14,track.index);
+  update_track.set(12,FXThread::time());
+  update_track.set(13,track.index);
   update_track.execute();
 
   /// Update Tags
   updateTags(track.index,track.tags);
+
+  /// Update Lyrics
+  updateText(track.index,track.lyrics);
+  }
+
+
+void GMDBTracks::updateText(FXint track,const FXString & lyrics) {
+  if (lyrics.empty()) {
+    delete_track_text.update(track);
+    }
+  else {
+    insert_track_text.set(0,track);
+    insert_track_text.set(1,lyrics);
+    insert_track_text.execute();
+    }
   }
 
 
 void GMDBTracks::remove(FXint track) {
   delete_track_playlists.update(track);
   delete_track_tags.update(track);
+  delete_track_text.update(track);
+  delete_track_loudness.update(track);
   delete_track.update(track);
   }
 
 
 
 
+/*
+  Walks the folders to import. Files are parsed folder by folder and
+  imported when leaving the folder. Subfolders and files matching the
+  exclude patterns are skipped.
+*/
+class GMImportWalker : public FXDirWalker {
+protected:
+  GMImportTask * task;
+  FXString       root;
+  FXint          path_index = -1;
+public:
+  GMImportWalker(GMImportTask * t) : task(t) {}
+
+  FXuint scan(const FXString & path) {
+    root = path;
+    return walk(path,task->pattern,FXDir::HiddenFiles|FXDir::HiddenDirs|FXDir::CaseFold);
+    }
+
+  FXuint enter(const FXString & path) {
+    if (!task->processing)
+      return 2;
+    if (!task->options.exclude_folder.empty() && path!=root && FXPath::match(FXPath::name(path),task->options.exclude_folder,matchflags))
+      return 0;
+    return 1;
+    }
+
+  FXuint visit(const FXString & path,const FXString & name) {
+    if (!task->processing)
+      return 2;
+    if (task->options.exclude_file.empty() || !FXPath::match(name,task->options.exclude_file,matchflags)) {
+      if (path_index<0) path_index = task->dbtracks.hasPath(path);
+      parse(path,name);
+      }
+    return 1;
+    }
+
+  FXuint leave(const FXString &) {
+    if (!task->processing)
+      return 2;
+    update();
+    path_index = -1;
+    return 1;
+    }
+
+  virtual void parse(const FXString & path,const FXString & name) {
+    task->parse(path,name,path_index);
+    }
+
+  virtual void update() {
+    task->import_tracks(path_index);
+    }
+
+  virtual ~GMImportWalker() {}
+  };
+
+
+/*
+  Same as GMImportWalker, but existing tracks are updated when
+  their file changed.
+*/
+class GMSyncWalker : public GMImportWalker {
+protected:
+  GMSyncTask * sync;
+public:
+  GMSyncWalker(GMSyncTask * t) : GMImportWalker(t), sync(t) {}
+
+  void parse(const FXString & path,const FXString & name) {
+    FXStat data;
+    if (sync->options_sync.update_always)
+      sync->parse_update(path,name,forever,path_index);
+    else if (info(data))
+      sync->parse_update(path,name,data.modified(),path_index);
+    }
+
+  void update() {
+    sync->update_tracks(path_index);
+    }
+  };
+
+
+
+
 GMImportTask::GMImportTask(FXObject *tgt,FXSelector sel) : GMTask(tgt,sel) {
   database = GMPlayerManager::instance()->getTrackDatabase();
   pattern = FILE_PATTERNS;
@@ -404,12 +507,6 @@ void GMImportTask::load_track(const FXString & filename) {
   }
 
 
-struct Seen {
-  Seen * next;
-  FXlong node;
-  };
-
-
 void GMImportTask::import() {
   FXStat   data;
   FXString name;
@@ -428,9 +525,9 @@ void GMImportTask::import() {
       if (data.isDirectory()) {
         if(!(name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))) {
           if(files[i].tail()==PATHSEP)
-            scan(files[i].rafter(PATHSEP),nullptr,data.index());
+            scan(files[i].rafter(PATHSEP));
           else
-            scan(files[i],nullptr,data.index());
+            scan(files[i]);
           }
         dircount++;
         }
@@ -439,8 +536,22 @@ void GMImportTask::import() {
 
   // Scan remaining files
   if (dircount<files.no()) {
+    FXIntList ids;
+
+    // Playlists mostly refer to known tracks
+    if (dbtracks.playlist)
+      resolve(ids);
+
     for (FXint i=0;i<files.no() && processing;i++) {
-      if (FXStat::statFile(files[i],data)) {
+      if (ids.no() && ids[i]) {
+        if(ntracks>=tracks.no()) {
+          tracks.no(FXMAX(25,tracks.no()*2));
+          }
+        tracks[ntracks].index=ids[i];
+        tracks[ntracks].url.clear();
+        ntracks++;
+        }
+      else if (FXStat::statFile(files[i],data)) {
         if (!data.isDirectory() && data.isReadable()) {
           const FXString path = FXPath::directory(files[i]);
           const FXString name = FXPath::name(files[i]);
@@ -458,56 +569,16 @@ void GMImportTask::import() {
   }
 
 
-void GMImportTask::scan(const FXString & path,Seen * seen,FXlong index) {
-  FXDir    directory;
-  FXStat   data;
-  FXString name;
-
-  // Location
-  Seen here={seen,index};
-
-  // First scan subfolders
-  if (directory.open(path)) {
-    while(directory.next(name) && processing) {
-      if (FXStat::statLink(path+PATHSEPSTRING+name,data)) {
-        if (data.isDirectory()) {
-          if(!(name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))){
-            for(Seen *s=seen; s; s=s->next){
-              if(data.index()==s->node) goto next_dir;
-              }
-            if (options.exclude_folder.empty() || !FXPath::match(name,options.exclude_folder,matchflags))
-              scan(path+PATHSEPSTRING+name,&here,data.index());
-            }
-          }
-        }
-next_dir:;
-      }
-    directory.close();
-    }
-
-  // Scan files in current folder
-  if(directory.open(path) && processing) {
-    FXint path_index = dbtracks.hasPath(path);
-    while(directory.next(name) && processing) {
-      if (FXStat::statFile(path+PATHSEPSTRING+name,data)) {
-        if (!data.isDirectory() && data.isReadable()) {
-          if (options.exclude_file.empty() || !FXPath::match(name,options.exclude_file,matchflags)) {
-            if (FXPath::match(name,pattern,matchflags)) {
-              parse(path,name,path_index);
-              }
-            }
-          }
-        }
-      }
-    if (processing) import_tracks(path_index);
-    }
+void GMImportTask::scan(const FXString & path) {
+  GMImportWalker walker(this);
+  walker.scan(path);
   }
 
 
 void GMImportTask::parse(const FXString & path,const FXString & filename,FXint path_index) {
 
   if(ntracks>=tracks.no()) {
-    tracks.no(tracks.no()+25);
+    tracks.no(FXMAX(25,tracks.no()*2));
     }
 
   GMTrack & track = tracks[ntracks];
@@ -531,6 +602,33 @@ void GMImportTask::parse(const FXString & path,const FXString & filename,FXint p
   }
 
 
+void GMImportTask::resolve(FXIntList & ids) {
+  GM_TICKS_START();
+  ids.no(files.no());
+  database->execute("CREATE TEMP TABLE IF NOT EXISTS import_files (position INTEGER PRIMARY KEY, path INTEGER, mrl TEXT);");
+  database->execute("DELETE FROM import_files;");
+  GMQuery insert_file(database,"INSERT INTO import_files VALUES (?,?,?);");
+  for (FXint i=0;i<files.no();i++) {
+    const FXint path_index = dbtracks.hasPath(FXPath::directory(files[i]));
+    if (path_index) {
+      insert_file.set(0,i);
+      insert_file.set(1,path_index);
+      insert_file.set(2,FXPath::name(files[i]));
+      insert_file.execute();
+      }
+    ids[i]=0;
+    }
+  GMQuery query(database,"SELECT position,tracks.id FROM import_files,tracks WHERE tracks.path == import_files.path AND tracks.mrl == import_files.mrl;");
+  FXint position,id;
+  while(query.row()) {
+    query.get(0,position);
+    query.get(1,id);
+    ids[position]=id;
+    }
+  GM_TICKS_END();
+  }
+
+
 FXbool GMImportTask::has_same_composer() const {
   if (ntracks==0)
     return false;
@@ -744,9 +842,9 @@ void GMSyncTask::import_and_update(){
       if (data.isDirectory()) {
         if(!(name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))) {
           if(files[i].tail()==PATHSEP)
-            traverse(files[i].rafter(PATHSEP),nullptr,data.index());
+            traverse(files[i].rafter(PATHSEP));
           else
-            traverse(files[i],nullptr,data.index());
+            traverse(files[i]);
           }
         }
       }
@@ -885,7 +983,7 @@ void GMSyncTask::parse_update(const FXString & path,const FXString & filename,FX
 
   // Allocate tracks
   if (ntracks>=tracks.no()) {
-    tracks.no(tracks.no()+25);
+    tracks.no(FXMAX(25,tracks.no()*2));
     }
 
   // Current Track
@@ -911,49 +1009,9 @@ void GMSyncTask::parse_update(const FXString & path,const FXString & filename,FX
   }
 
 
-void GMSyncTask::traverse(const FXString & path,Seen * seen,FXlong index) {
-  FXDir    directory;
-  FXStat   data;
-  FXString name;
-
-  // Location
-  Seen here={seen,index};
-
-  // First scan subfolders
-  if (directory.open(path)) {
-    while(directory.next(name) && processing) {
-      if (FXStat::statLink(path+PATHSEPSTRING+name,data)) {
-        if (data.isDirectory()) {
-          if(!(name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))){
-            for(Seen *s=seen; s; s=s->next){
-              if(data.index()==s->node) goto next_dir;
-              }
-            if (options.exclude_folder.empty() || !FXPath::match(name,options.exclude_folder,matchflags))
-              traverse(path+PATHSEPSTRING+name,&here,data.index());
-            }
-          }
-        }
-next_dir:;
-      }
-    directory.close();
-    }
-
-  // Scan files in current folder
-  if(directory.open(path) && processing) {
-    FXint path_index = dbtracks.hasPath(path);
-    while(directory.next(name) && processing) {
-      if (FXStat::statFile(path+PATHSEPSTRING+name,data)) {
-        if (!data.isDirectory() && data.isReadable()) {
-          if (options.exclude_file.empty() || !FXPath::match(name,options.exclude_file,matchflags)) {
-            if (FXPath::match(name,pattern,matchflags)) {
-              parse_update(path,name,options_sync.update_always ? forever : data.modified(),path_index);
-              }
-            }
-          }
-        }
-      }
-    if (processing) update_tracks(path_index);
-    }
+void GMSyncTask::traverse(const FXString & path) {
+  GMSyncWalker walker(this);
+  walker.scan(path);
   }
 
 
@@ -970,6 +1028,7 @@ void GMSyncTask::update_tracks(FXint pathindex) {
     for (FXint i=0;i<ntracks;i++) {
       if (tracks[i].url.empty()) {
         database->getTrack(tracks[i].index,tracks[i]);
+        database->getTrackLyrics(tracks[i].index,tracks[i].lyrics);
         tracks[i].url.clear();
         }
       }
@@ -1066,3 +1125,236 @@ void GMRemoveTask::remove(GMTaskTransaction & transaction) {
     }
   if (changed) database->sync_tracks_removed();
   }
+
+
+
+
+GMExportTask::GMExportTask(const FXString & f,FXint p,FXuint t,FXuint o,FXObject *tgt,FXSelector sel) : GMTask(tgt,sel),
+  filename(f),
+  playlist(p),
+  filetype(t),
+  opts(o) {
+  database = GMPlayerManager::instance()->getTrackDatabase();
+  }
+
+
+GMExportTask::~GMExportTask() {
+  }
+
+
+FXbool GMExportTask::flush() {
+  if (nbuffer && file.writeBlock(buffer,nbuffer)!=nbuffer)
+    return false;
+  nbuffer=0;
+  return true;
+  }
+
+
+FXbool GMExportTask::write(const FXchar * fmt,...) {
+  va_list args;
+  va_start(args,fmt);
+  FXint n = vsnprintf(buffer+nbuffer,sizeof(buffer)-nbuffer,fmt,args);
+  va_end(args);
+  if (n<0) return false;
+  if (nbuffer+n>=(FXival)sizeof(buffer)) {
+    if (!flush()) return false;
+    if (n<(FXint)sizeof(buffer)) {
+      va_start(args,fmt);
+      vsnprintf(buffer,sizeof(buffer),fmt,args);
+      va_end(args);
+      }
+    else {
+      FXString line;
+      va_start(args,fmt);
+      line.vformat(fmt,args);
+      va_end(args);
+      return file.writeBlock(line.text(),line.length())==line.length();
+      }
+    }
+  nbuffer+=n;
+  return true;
+  }
+
+
+FXint GMExportTask::run() {
+  FXASSERT(database);
+  FXbool ok=false;
+
+  taskmanager->setStatus("Exporting...");
+
+  if (!file.open(filename,FXIO::Writing))
+    return 1;
+
+  try {
+    ok = write_list() && flush();
+    }
+  catch(GMDatabaseException&) {
+    ok = false;
+    }
+
+  file.close();
+
+  if (!ok || !processing) {
+    FXFile::remove(filename);
+    return 1;
+    }
+  return 0;
+  }
+
+
+namespace {
+
+struct GMExportRow {
+  FXString path;
+  FXString title;
+  FXString artist;
+  FXString album;
+  FXint    no   = 0;
+  FXint    time = 0;
+  FXint    year = 0;
+  };
+
+}
+
+/*
+  Rows are copied out a page at a time in a short transaction and written
+  to the file with the database unlocked. Pages continue after the last key
+  seen: the track id for the library, the queue position and rowid for a
+  playlist (queue positions need not be unique).
+*/
+FXbool GMExportTask::write_list() {
+  const FXint pagesize = 1000;
+  GMExportRow rows[pagesize];
+  FXint nrows;
+  FXint cnt=1;
+  FXlong key=LLONG_MIN;
+  FXlong rowkey=LLONG_MIN;
+  FXString query;
+  FXString title;
+  const FXString basepath=FXPath::directory(filename);
+
+  if (playlist) {
+    GMTaskTransaction transaction(database);
+    database->getPlaylistName(playlist,title);
+    transaction.commit();
+    }
+
+  query = "SELECT pathlist.name || '" PATHSEPSTRING "' || mrl,title,artists.name,albums.name,no,time,tracks.year";
+
+  if (playlist)
+    query+=",IFNULL(playlist_tracks.queue,0),playlist_tracks.rowid FROM tracks,pathlist, albums, artists, playlist_tracks";
+  else
+    query+=",tracks.id FROM tracks,pathlist, albums, artists";
+
+  query+=" WHERE "
+                "albums.artist == artists.id AND "
+                "tracks.album == albums.id AND "
+                "pathlist.id == tracks.path ";
+
+  if (playlist) {
+    query+=" AND playlist_tracks.track == tracks.id";
+    query+=" AND playlist_tracks.playlist == "+FXString::value(playlist);
+    query+=" AND (IFNULL(playlist_tracks.queue,0) > ?1 OR (IFNULL(playlist_tracks.queue,0) == ?1 AND playlist_tracks.rowid > ?2))";
+    query+=" ORDER BY IFNULL(playlist_tracks.queue,0),playlist_tracks.rowid";
+    }
+  else {
+    query+=" AND tracks.id > ?1 ORDER BY tracks.id";
+    }
+  query+=" LIMIT "+FXString::value(pagesize)+";";
+
+  if (filetype==PLAYLIST_XSPF) {
+    write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+    write("<playlist version=\"1\" xmlns=\"http://xspf.org/ns/0/\">\n");
+    if (!title.empty()) write("\t<title>%s</title>\n",title.text());
+    write("\t<trackList>\n");
+    }
+  else if (filetype==PLAYLIST_M3U_EXTENDED) {
+    write("#EXTM3U\n");
+    }
+  else if (filetype==PLAYLIST_PLS) {
+    write("[playlist]\n");
+    }
+  else if (filetype==PLAYLIST_CSV) {
+    write("No,Title,Album,Artist,Genre,Duration,Year,Filename\n");
+    }
+
+  do {
+
+    // Fetch the next page
+    nrows=0;
+    {
+      GMTaskTransaction transaction(database);
+      GMQuery list(database,query.text());
+      list.set(0,key);
+      if (playlist) list.set(1,rowkey);
+      while(list.row()){
+        GMExportRow & row = rows[nrows++];
+        list.get(0,row.path);
+        list.get(1,row.title);
+        list.get(2,row.artist);
+        list.get(3,row.album);
+        list.get(4,row.no);
+        list.get(5,row.time);
+        list.get(6,row.year);
+        list.get(7,key);
+        if (playlist) list.get(8,rowkey);
+        }
+      transaction.commit();
+    }
+
+    // Write it out without holding the database
+    for (FXint i=0;i<nrows && processing;i++) {
+      GMExportRow & row = rows[i];
+
+      if (opts&PLAYLIST_OPTIONS_RELATIVE)
+        row.path = FXPath::relative(basepath,row.path);
+
+      const FXchar * c_title  = row.title.text();
+      const FXchar * c_artist = row.artist.text();
+      const FXchar * c_album  = row.album.text();
+
+      FXbool ok=true;
+      if (filetype==PLAYLIST_XSPF) {
+        ok = write("\t\t<track>\n"
+                   "\t\t\t<location>%s</location>\n"
+                   "\t\t\t<creator>%s</creator>\n"
+                   "\t\t\t<album>%s</album>\n"
+                   "\t\t\t<title>%s</title>\n"
+                   "\t\t\t<duration>%d</duration>\n"
+                   "\t\t\t<trackNum>%u</trackNum>\n"
+                   "\t\t</track>\n",FXURL::fileToURL(row.path).text(),c_artist,c_album,c_title,row.time*1000,row.no);
+        }
+      else if (filetype==PLAYLIST_M3U_EXTENDED) {
+        ok = write("#EXTINF:%d,%s - %s\n%s\n",row.time,c_artist,c_title,row.path.text());
+        }
+      else if (filetype==PLAYLIST_M3U) {
+        ok = write("%s\n",row.path.text());
+        }
+      else if (filetype==PLAYLIST_PLS) {
+        ok = write("File%d=%s\nTitle%d=%s - %s\nLength%d=%d\n",cnt,row.path.text(),cnt,c_artist,c_title,cnt,row.time);
+        }
+      else if (filetype==PLAYLIST_CSV){
+        ok = write("%d,\"%s\",\"%s\",\"%s\",%d,%d,\"%s\"\n",row.no,c_title,c_album,c_artist,row.time,row.year,row.path.text());
+        }
+      if (!ok) return false;
+
+      // Update Progress
+      if (0==(cnt%1000)) {
+        taskmanager->setStatus(FXString::value("Exporting %d",cnt));
+        }
+      cnt++;
+      }
+    }
+  while(nrows==pagesize && processing);
+
+  if (!processing)
+    return false;
+
+  if (filetype==PLAYLIST_XSPF) {
+    return write("\t</trackList>\n</playlist>");
+    }
+  else if (filetype==PLAYLIST_PLS){
+    return write("Version=2\nNumberOfEntries=%d",cnt-1);
+    }
+  return true;
+  }
@@ -42,6 +42,7 @@ protected:
   GMQuery insert_playlist_track;
   GMQuery insert_playlist_track_by_id;
   GMQuery insert_track_tag;
+  GMQuery insert_track_text;
   GMQuery update_track;
   GMQuery query_album;
   GMQuery query_album_by_year;
@@ -49,6 +50,8 @@ protected:
   GMQuery query_tag;
   GMQuery delete_track;
   GMQuery delete_track_tags;
+  GMQuery delete_track_text;
+  GMQuery delete_track_loudness;
   GMQuery delete_track_playlists;
 protected:
   FXint insertPath(const FXString & path);
@@ -56,6 +59,7 @@ protected:
   FXint insertAlbum(const GMTrack & ,FXint album_artist_id);
   void insertTags(FXint,const FXStringList&);
   void updateTags(FXint,const FXStringList&);
+  void updateText(FXint,const FXString&);
   void initPathDict(GMTrackDatabase*);
 public:
   GMDBTracks();
@@ -82,10 +86,12 @@ public:
   };
 
 
-struct Seen;
+class GMImportWalker;
+class GMSyncWalker;
 class Lyrics;
 
 class GMImportTask : public GMTask {
+friend class GMImportWalker;
 protected:
   GMTrackDatabase   * database = nullptr;
   GMTaskTransaction * transaction = nullptr;
@@ -124,11 +130,14 @@ protected:
   // Parse track information
   void parse(const FXString & path,const FXString & file,FXint path_index);
 
+  // Look up the database ids of all input files at once
+  void resolve(FXIntList & ids);
+
   // Save scanned tracks. Pass path_index>=0 if from same folder.
   void import_tracks(FXint path_index=-1);
 
   // Scan path for files
-  void scan(const FXString & path,Seen*,FXlong index);
+  void scan(const FXString & path);
 
   // Detect compilation from tracks found
   void detect_compilation();
@@ -151,6 +160,7 @@ public:
   };
 
 class GMSyncTask : public GMImportTask {
+friend class GMSyncWalker;
 protected:
   GMSyncOptions  options_sync;
   FXbool         changed=false;
@@ -162,7 +172,7 @@ protected:
   void update_tracks(FXint pathindex);
 
   // Scan path for files
-  void traverse(const FXString & path,Seen*,FXlong index);
+  void traverse(const FXString & path);
 
   // Parse track information
   void parse_update(const FXString & path,const FXString & filename,FXTime modified,FXint pathindex);
@@ -203,4 +213,37 @@ public:
   };
 
 
+/*
+  Writes the library or a playlist to a playlist file. Rows are formatted
+  into a fixed size buffer that is flushed to the file whenever it fills up.
+  A cancelled export removes the partially written file.
+*/
+class GMExportTask : public GMTask {
+protected:
+  GMTrackDatabase * database = nullptr;
+  FXString          filename;
+  FXint             playlist = 0;
+  FXuint            filetype = 0;
+  FXuint            opts = 0;
+  FXFile            file;
+  FXchar            buffer[65536];
+  FXival            nbuffer = 0;
+protected:
+  virtual FXint run();
+protected:
+  // Format into the buffer, flushing it when full
+  FXbool write(const FXchar * fmt,...) FX_PRINTF(2,3);
+
+  // Write buffer to file
+  FXbool flush();
+
+  // Write all rows
+  FXbool write_list();
+public:
+  GMExportTask(const FXString & filename,FXint playlist,FXuint filetype,FXuint opts=0,FXObject*tgt=nullptr,FXSelector sel=0);
+
+  virtual ~GMExportTask();
+  };
+
+
 #endif
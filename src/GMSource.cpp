@@ -40,12 +40,11 @@ GMSource::~GMSource() {
 
 FXbool GMSource::findCurrent(GMTrackList * list,GMSource * src) {
   if (src==nullptr || src->current_track==-1) return false;
-  for (FXint i=0;i<list->getNumItems();i++){
-    if (list->getItemId(i)==src->current_track) {
-      list->setActiveItem(i);
-      list->setCurrentItem(i);
-      return true;
-      }
+  FXint i = list->findItemById(src->current_track);
+  if (i>=0) {
+    list->setActiveItem(i);
+    list->setCurrentItem(i);
+    return true;
     }
   return false;
   }
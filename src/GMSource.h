@@ -224,6 +224,10 @@ public:
 
   virtual FXbool listTracks(GMTrackList*,const FXIntList &,const FXIntList &) { return false; }
 
+  virtual FXbool saveTracks(GMTrackList*,FXStream &) { return false; }
+
+  virtual FXbool loadTracks(GMTrackList*,FXStream &) { return false; }
+
   virtual FXbool updateSelectedTracks(GMTrackList*) { return false; }
 
   virtual FXbool genre_context_menu(FXMenuPane*) { return false; }
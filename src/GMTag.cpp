@@ -618,6 +618,24 @@ void GMFileTag::id3v2_update_field(const FXchar * field,const FXStringList & lis
     }
   }
 
+void GMFileTag::id3v2_update_txxx(const FXchar * description,const FXString & value) {
+  FXASSERT(description);
+  FXASSERT(id3v2);
+  TagLib::ID3v2::UserTextIdentificationFrame * frame = TagLib::ID3v2::UserTextIdentificationFrame::find(id3v2,description);
+  if (value.empty()) {
+    if (frame) id3v2->removeFrame(frame);
+    }
+  else if (frame) {
+    frame->setText(TagLib::String(value.text(),TagLib::String::UTF8));
+    }
+  else {
+    frame = new TagLib::ID3v2::UserTextIdentificationFrame(TagLib::ID3v2::FrameFactory::instance()->defaultTextEncoding());
+    frame->setDescription(description);
+    frame->setText(TagLib::String(value.text(),TagLib::String::UTF8));
+    id3v2->addFrame(frame);
+    }
+  }
+
 FXbool  GMFileTag::id3v2_get_field(const FXchar * field,FXString & value) const{
   FXASSERT(field);
   FXASSERT(id3v2);
@@ -1109,6 +1127,30 @@ FXint GMFileTag::getYear()const {
   return tag->year();
   }
 
+
+// Replay Gain 2.0 fields as written by most taggers. NAN clears the field.
+void GMFileTag::setReplayGain(FXdouble track_gain,FXdouble track_peak,FXdouble album_gain,FXdouble album_peak) {
+  static const FXchar * const fields[4]={"REPLAYGAIN_TRACK_GAIN","REPLAYGAIN_TRACK_PEAK","REPLAYGAIN_ALBUM_GAIN","REPLAYGAIN_ALBUM_PEAK"};
+  static const FXchar * const mp4fields[4]={"----:com.apple.iTunes:replaygain_track_gain","----:com.apple.iTunes:replaygain_track_peak","----:com.apple.iTunes:replaygain_album_gain","----:com.apple.iTunes:replaygain_album_peak"};
+  FXString values[4];
+
+  if (!isnan(track_gain)) values[0]=FXString::value("%+.2f dB",track_gain);
+  if (!isnan(track_peak)) values[1]=FXString::value("%.6f",track_peak);
+  if (!isnan(album_gain)) values[2]=FXString::value("%+.2f dB",album_gain);
+  if (!isnan(album_peak)) values[3]=FXString::value("%.6f",album_peak);
+
+  for (FXint i=0;i<4;i++) {
+    if (xiph)
+      xiph_update_field(fields[i],values[i]);
+    if (id3v2)
+      id3v2_update_txxx(fields[i],values[i]);
+    if (mp4)
+      mp4_update_field(mp4fields[i],values[i]);
+    if (ape)
+      ape_update_field(fields[i],values[i]);
+    }
+  }
+
 GMCover * GMFileTag::getFrontCover() const {
   TagLib::FLAC::File * flacfile = dynamic_cast<TagLib::FLAC::File*>(file);
   if (flacfile) {
@@ -67,6 +67,7 @@ protected:
   FXbool id3v2_get_field(const FXchar * field,FXStringList &) const;
   void id3v2_update_field(const FXchar * field,const FXString & value);
   void id3v2_update_field(const FXchar * field,const FXStringList & value);
+  void id3v2_update_txxx(const FXchar * description,const FXString & value);
 
   FXbool xiph_get_field(const FXchar * field,FXString &) const;
   FXbool xiph_get_field(const FXchar * field,FXStringList &) const;
@@ -129,6 +130,8 @@ public:
   void setYear(FXint);
   FXint getYear() const;
 
+  void setReplayGain(FXdouble track_gain,FXdouble track_peak,FXdouble album_gain,FXdouble album_peak);
+
   FXint getTime() const;
   FXint getBitRate() const;
   FXint getChannels() const;
@@ -72,13 +72,24 @@ FXbool GMWorker::send(FXSelector msg,const void* data,FXint size){
 
 
 
-GMTask::GMTask(FXObject*tgt,FXSelector sel) : taskmanager(nullptr),mc(nullptr),processing(true),target(tgt),message(sel) {
+GMTask::GMTask(FXObject*tgt,FXSelector sel) : taskmanager(nullptr),mc(nullptr),processing(true),priority(TASK_PRIORITY_BACKGROUND),target(tgt),message(sel) {
   }
 
 GMTask::~GMTask() {
   }
 
-GMTaskManager::GMTaskManager(FXObject*tgt,FXSelector sel) : processing(false),started(false),active(nullptr),target(tgt),message(sel),mc(FXApp::instance())  {
+
+class GMTaskRunner : public FXRunnable {
+protected:
+  GMTaskManager * taskmanager;
+  GMTask        * task;
+public:
+  GMTaskRunner(GMTaskManager * m,GMTask * t) : taskmanager(m),task(t) {}
+  FXint run() { taskmanager->execute(task); return 0; }
+  };
+
+
+GMTaskManager::GMTaskManager(FXObject*tgt,FXSelector sel) : processing(true),background(false),target(tgt),message(sel),mc(FXApp::instance())  {
   }
 
 GMTaskManager::~GMTaskManager() {
@@ -89,85 +100,84 @@ void GMTaskManager::setStatus(const FXString & msg) {
   }
 
 void GMTaskManager::run(GMTask* task) {
-  mutex.lock();
-  tasks.append(task);
+  FXScopedMutex lock(mutex);
   task->mc = &mc;
   task->taskmanager = this;
   processing=true;
-  if (!started) {
-    started=true;
-    mutex.unlock();
-    start();
-    }
-  else {
-    condition_task.signal();
-    mutex.unlock();
+  if (task->priority==TASK_PRIORITY_INTERACTIVE)
+    dispatch(task);
+  else
+    tasks.append(task);
+  schedule();
+  }
+
+// Start the next background task if none is running. Called with mutex locked.
+void GMTaskManager::schedule() {
+  if (!background && tasks.no() && processing) {
+    background=true;
+    GMTask * task = tasks[0];
+    tasks.erase(0);
+    dispatch(task);
     }
   }
 
-FXbool GMTaskManager::next() {
-  mutex.lock();
-  if (tasks.no()) {
-    active = tasks[0];
-    tasks.erase(0);
+// Called with mutex locked.
+void GMTaskManager::dispatch(GMTask * task) {
+  if (active.no()==0 && target) mc.message(target,FXSEL(SEL_TASK_RUNNING,message),nullptr,0);
+  active.append(task);
+  GMThreadPool::instance()->execute(new GMTaskRunner(this,task),task->priority);
+  }
+
+void GMTaskManager::execute(GMTask * task) {
+  FXint code = task->run();
+  FXScopedMutex lock(mutex);
+  for (FXint i=0;i<active.no();i++) {
+    if (active[i]==task) {
+      active.erase(i);
+      break;
+      }
+    }
+  if (task->priority!=TASK_PRIORITY_INTERACTIVE)
+    background=false;
+
+  if (task->target) {
+    if (code)
+      mc.message(task->target,FXSEL(SEL_TASK_CANCELLED,task->message),&task,sizeof(GMTask*));
+    else
+      mc.message(task->target,FXSEL(SEL_TASK_COMPLETED,task->message),&task,sizeof(GMTask*));
     }
   else {
-    active=nullptr;
+    delete task;
     }
-  mutex.unlock();
-  return ((active!=nullptr) && processing);
-  }
 
-FXbool GMTaskManager::wait() {
-  if (processing) {
-    if (target) mc.message(target,FXSEL(SEL_TASK_IDLE,message),nullptr,0);
-    mutex.lock();
-    condition_task.wait(mutex);
-    mutex.unlock();
-    }
-  return processing;
-  }
-
-FXint GMTaskManager::run() {
-  ap_set_thread_name("gm_taskmanager");
-  do {
-    while(next()) {
-      if (target) mc.message(target,FXSEL(SEL_TASK_RUNNING,message),nullptr,0);
-      FXint code = active->run();
-      mutex.lock();
-      if (active->target) {
-        if (code)
-          mc.message(active->target,FXSEL(SEL_TASK_CANCELLED,active->message),&active,sizeof(GMTask*));
-        else
-          mc.message(active->target,FXSEL(SEL_TASK_COMPLETED,active->message),&active,sizeof(GMTask*));
-        active=nullptr;
-        }
-      else {
-        delete active;
-        active=nullptr;
-        }
-      mutex.unlock();
-      }
+  schedule();
+
+  if (active.no()==0) {
+    if (target && processing) mc.message(target,FXSEL(SEL_TASK_IDLE,message),nullptr,0);
+    condition_done.broadcast();
     }
-  while(wait());
-  return 0;
   }
 
+// Cancel the running background task. Interactive tasks are left alone.
 void GMTaskManager::cancelTask() {
   FXScopedMutex lock(mutex);
-  if (active) active->processing=false;
+  for (FXint i=0;i<active.no();i++) {
+    if (active[i]->priority!=TASK_PRIORITY_INTERACTIVE)
+      active[i]->processing=false;
+    }
   }
 
 void GMTaskManager::shutdown() {
-  mutex.lock();
-  if (active) active->processing=false;
+  FXScopedMutex lock(mutex);
   processing=false;
-  condition_task.signal();
-  mutex.unlock();
-  join();
+  for (FXint i=0;i<active.no();i++) {
+    active[i]->processing=false;
+    }
   for (FXint i=0;i<tasks.no();i++) {
     delete tasks[i];
     }
   tasks.clear();
-  started=false;
+  while(active.no()) {
+    condition_done.wait(mutex);
+    }
   }
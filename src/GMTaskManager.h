@@ -19,6 +19,8 @@
 #ifndef GMTHREAD_H
 #define GMTHREAD_H
 
+#include "GMThreadPool.h"
+
 class GMWorker;
 
 class GMWorkerThread : public FXThread {
@@ -71,6 +73,7 @@ class GMTaskManager;
 
 class GMTask {
 friend class GMTaskManager;
+friend class GMTaskGroup;
 private:
   GMTask(const GMTask&);
   GMTask &operator=(const GMTask&);
@@ -78,6 +81,7 @@ protected:
   GMTaskManager    * taskmanager;
   FXMessageChannel * mc;
   volatile FXbool    processing;
+  FXuchar            priority;
 protected:
   FXObject * target;
   FXSelector message;
@@ -88,6 +92,10 @@ public:
 
   void setSelector(FXSelector sel) { message=sel; }
 
+  void setPriority(FXuchar p) { priority=p; }
+
+  FXuchar getPriority() const { return priority; }
+
   virtual FXint run() = 0;
 
   virtual ~GMTask();
@@ -95,23 +103,39 @@ public:
 
 typedef FXArray<GMTask*> GMTaskList;
 
-class GMTaskManager : public FXThread {
+
+/*
+  Jobs spawned by a task on the thread pool. Cancelling
+  the task also cancels any jobs that haven't started yet.
+*/
+class GMTaskGroup : public GMJobGroup {
+public:
+  GMTaskGroup(GMTask * task) : GMJobGroup(task->priority,&task->processing) {}
+  };
+
+
+/*
+  Runs tasks on the application thread pool. Interactive tasks start
+  immediately, background tasks run one at a time in submission order
+  since they share the database connection.
+*/
+class GMTaskManager {
+  friend class GMTaskRunner;
 protected:
   FXMutex           mutex;
-  FXCondition       condition_task;
+  FXCondition       condition_done;
   volatile FXbool   processing;
-  FXbool            started;
+  FXbool            background;
 protected:
-  FXbool wait();
-  FXbool next();
-protected:
-  GMTask          * active;
   FXObject*         target;
   FXSelector        message;
   FXMessageChannel  mc;
   GMTaskList        tasks;
+  GMTaskList        active;
 protected:
-  FXint run();
+  void dispatch(GMTask*);
+  void schedule();
+  void execute(GMTask*);
 public:
   GMTaskManager(FXObject*tgt=nullptr,FXSelector sel=0);
 
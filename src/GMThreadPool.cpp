@@ -0,0 +1,322 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include "gmdefs.h"
+#include "gmutils.h"
+#include "GMThreadPool.h"
+#include "GMAudioPlayer.h"
+
+#include <FXWSQueue.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+
+class GMPoolJob {
+public:
+  FXRunnable * runnable;
+  GMJobGroup * group;
+  FXuchar      priority;
+public:
+  GMPoolJob(FXRunnable * r,GMJobGroup * g,FXuchar p) : runnable(r),group(g),priority(p) {}
+  };
+
+
+class GMPoolWorker : public FXThread {
+public:
+  GMThreadPool * pool;
+  FXWSQueue      deque;
+  FXbool         alive = false;
+public:
+  GMPoolWorker(GMThreadPool * p) : pool(p) {}
+  FXint run() override;
+  };
+
+
+FXint GMPoolWorker::run() {
+  GMPoolJob * job;
+  ap_set_thread_name("gm_worker");
+  GMThreadPool::current.set(this);
+  while((job=pool->next(this))!=nullptr) {
+    FXuchar priority = job->priority;
+    pool->execute(job);
+    pool->finished(priority);
+    }
+  GMThreadPool::current.set(nullptr);
+  return 0;
+  }
+
+
+
+GMJobGroup::GMJobGroup(FXuchar p,const volatile FXbool * a) : pool(GMThreadPool::instance()),active(a),cancelled(false),priority(p) {
+  }
+
+GMJobGroup::~GMJobGroup() {
+  wait();
+  }
+
+FXbool GMJobGroup::execute(FXRunnable * job) {
+  if (pool==nullptr) {
+    if (!isCancelled()) job->run();
+    return true;
+    }
+  completion.increment();
+  pool->submit(new GMPoolJob(job,this,priority));
+  return true;
+  }
+
+void GMJobGroup::wait() {
+  if (pool) pool->help(this);
+  completion.wait();
+  }
+
+
+
+GMThreadPool *         GMThreadPool::pool = nullptr;
+FXAutoThreadStorageKey GMThreadPool::current;
+
+
+GMThreadPool::GMThreadPool(FXint nthreads,FXTime e) : expiration(e) {
+  FXASSERT(pool==nullptr);
+  if (nthreads<=0) nthreads = FXMAX(1,(FXint)FXThread::processors());
+  maxbackground = FXMAX(1,nthreads-1);
+  workers.no(nthreads);
+  for (FXint i=0;i<nthreads;i++) {
+    workers[i] = new GMPoolWorker(this);
+    }
+  for (FXint i=0;i<TASK_PRIORITY_LAST;i++) head[i]=0;
+  pool=this;
+  }
+
+GMThreadPool::~GMThreadPool() {
+  shutdown();
+  for (FXint i=0;i<workers.no();i++) {
+    delete workers[i];
+    }
+  if (pool==this) pool=nullptr;
+  }
+
+
+void GMThreadPool::execute(FXRunnable * job,FXuchar priority) {
+  submit(new GMPoolJob(job,nullptr,priority));
+  }
+
+
+// Jobs from a worker go onto its own deque, everything else onto the global queue.
+void GMThreadPool::submit(GMPoolJob * job) {
+  GMPoolWorker * self = static_cast<GMPoolWorker*>(current.get());
+  if (!running) {
+    execute(job);
+    return;
+    }
+  if (self && job->group) {
+    if (!self->deque.push(job)) {
+      execute(job);
+      return;
+      }
+    mutex.lock();
+    }
+  else {
+    mutex.lock();
+    queue[job->priority].append(job);
+    }
+
+  if (nidle>0) {
+    condition.signal();
+    }
+  else {
+    for (FXint i=0;i<workers.no();i++) {
+      if (!workers[i]->alive) {
+        workers[i]->join();
+        workers[i]->alive=true;
+        workers[i]->start();
+        break;
+        }
+      }
+    }
+  mutex.unlock();
+  }
+
+
+void GMThreadPool::execute(GMPoolJob * job) {
+  GMJobGroup * group = job->group;
+  if (group) {
+    if (!group->isCancelled()) job->runnable->run();
+    }
+  else {
+    job->runnable->run();
+    delete job->runnable;
+    }
+  delete job;
+  if (group) group->completion.decrement();
+  }
+
+
+// Background job finished, let a waiting worker pick up the next one
+void GMThreadPool::finished(FXuchar priority) {
+  if (priority==TASK_PRIORITY_BACKGROUND) {
+    mutex.lock();
+    nbackground--;
+    if (nidle) condition.signal();
+    mutex.unlock();
+    }
+  }
+
+
+// Run jobs from our own deque until they're done. Jobs stolen by others will be waited on.
+void GMThreadPool::help(GMJobGroup * group) {
+  GMPoolWorker * self = static_cast<GMPoolWorker*>(current.get());
+  if (self) {
+    FXptr ptr;
+    while(!group->completion.done() && self->deque.pop(ptr)) {
+      execute(static_cast<GMPoolJob*>(ptr));
+      }
+    }
+  }
+
+
+FXbool GMThreadPool::dequeue(FXuchar priority,GMPoolJob *& job) {
+  if (head[priority]<queue[priority].no()) {
+    job = queue[priority][head[priority]++];
+    if (head[priority]==queue[priority].no()) {
+      queue[priority].clear();
+      head[priority]=0;
+      }
+    return true;
+    }
+  return false;
+  }
+
+
+FXbool GMThreadPool::steal(GMPoolWorker * self,GMPoolJob *& job) {
+  FXptr ptr;
+  for (FXint i=0;i<workers.no();i++) {
+    if (workers[i]!=self && workers[i]->deque.take(ptr)) {
+      job = static_cast<GMPoolJob*>(ptr);
+      return true;
+      }
+    }
+  return false;
+  }
+
+
+GMPoolJob * GMThreadPool::next(GMPoolWorker * self) {
+  GMPoolJob * job = nullptr;
+  FXptr ptr;
+
+  // Our own work first, without taking the lock
+  if (self->deque.pop(ptr)) {
+    job = static_cast<GMPoolJob*>(ptr);
+    if (job->priority==TASK_PRIORITY_BACKGROUND) {
+      mutex.lock();
+      nbackground++;
+      mutex.unlock();
+      }
+    return job;
+    }
+
+  FXScopedMutex lock(mutex);
+  while(running) {
+
+    if (dequeue(TASK_PRIORITY_INTERACTIVE,job))
+      return job;
+
+    // Deques mostly hold background work, so respect the background limit.
+    if (nbackground<maxbackground) {
+      if (steal(self,job) || dequeue(TASK_PRIORITY_BACKGROUND,job)) {
+        if (job->priority==TASK_PRIORITY_BACKGROUND) nbackground++;
+        return job;
+        }
+      }
+
+    nidle++;
+    FXbool signaled = condition.wait(mutex,expiration);
+    nidle--;
+    if (!signaled && head[TASK_PRIORITY_INTERACTIVE]==queue[TASK_PRIORITY_INTERACTIVE].no()
+                  && head[TASK_PRIORITY_BACKGROUND]==queue[TASK_PRIORITY_BACKGROUND].no()
+                  && self->deque.isEmpty()) {
+      break;
+      }
+    }
+  self->alive=false;
+  return nullptr;
+  }
+
+
+void GMThreadPool::shutdown() {
+  GMPoolJob * job;
+  mutex.lock();
+  running=false;
+  condition.broadcast();
+  mutex.unlock();
+  for (FXint i=0;i<workers.no();i++) {
+    workers[i]->join();
+    }
+  for (FXint p=0;p<TASK_PRIORITY_LAST;p++) {
+    while(dequeue(p,job)) discard(job);
+    }
+  for (FXint i=0;i<workers.no();i++) {
+    FXptr ptr;
+    while(workers[i]->deque.pop(ptr)) discard(static_cast<GMPoolJob*>(ptr));
+    }
+  }
+
+
+void GMThreadPool::discard(GMPoolJob * job) {
+  if (job->group) {
+    job->group->cancel();
+    job->group->completion.decrement();
+    }
+  else {
+    delete job->runnable;
+    }
+  delete job;
+  }
+
+
+GMIdlePriority::GMIdlePriority() {
+#if defined(__linux__) && defined(SCHED_IDLE)
+  struct sched_param param;
+  struct rlimit limit;
+  policy = sched_getscheduler(0);
+  if (policy==SCHED_OTHER && sched_getparam(0,&param)==0 && getrlimit(RLIMIT_NICE,&limit)==0) {
+    // Only the current nice value needs to be allowed to go back to normal scheduling
+    const FXint nice = getpriority(PRIO_PROCESS,0);
+    if (geteuid()==0 || limit.rlim_cur==RLIM_INFINITY || limit.rlim_cur>=(rlim_t)(20-nice)) {
+      priority = param.sched_priority;
+      param.sched_priority = 0;
+      lowered = (sched_setscheduler(0,SCHED_IDLE,&param)==0);
+      }
+    }
+#endif
+  }
+
+
+GMIdlePriority::~GMIdlePriority() {
+#if defined(__linux__) && defined(SCHED_IDLE)
+  if (lowered) {
+    struct sched_param param;
+    param.sched_priority = priority;
+    if (sched_setscheduler(0,policy,&param)!=0)
+      GM_DEBUG_PRINT("[pool] failed to restore scheduling policy\n");
+    }
+#endif
+  }
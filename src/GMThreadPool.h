@@ -0,0 +1,157 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef GMTHREADPOOL_H
+#define GMTHREADPOOL_H
+
+enum {
+  TASK_PRIORITY_BACKGROUND  = 0,  // import, export, loudness, waveforms, feed refresh
+  TASK_PRIORITY_INTERACTIVE = 1,  // covers, anything the user is waiting for
+  TASK_PRIORITY_LAST
+  };
+
+class GMThreadPool;
+class GMPoolWorker;
+class GMPoolJob;
+
+
+/*
+  A set of jobs executed on the thread pool that can be waited on or
+  cancelled together. Jobs that haven't started yet when the group is
+  cancelled are skipped. Running jobs should poll isCancelled().
+  Jobs are not owned by the group.
+*/
+class GMJobGroup {
+friend class GMThreadPool;
+private:
+  GMThreadPool          * pool;
+  FXCompletion            completion;
+  const volatile FXbool * active;
+  volatile FXbool         cancelled;
+  FXuchar                 priority;
+private:
+  GMJobGroup(const GMJobGroup&);
+  GMJobGroup &operator=(const GMJobGroup&);
+public:
+  /// Create group with given priority. Optionally tie cancellation to an external flag.
+  GMJobGroup(FXuchar priority=TASK_PRIORITY_BACKGROUND,const volatile FXbool * active=nullptr);
+
+  /// Get the priority
+  FXuchar getPriority() const { return priority; }
+
+  /// Queue job
+  FXbool execute(FXRunnable * job);
+
+  /// Help out running jobs and wait until all jobs have finished
+  void wait();
+
+  /// Skip any jobs that haven't been started yet
+  void cancel() { cancelled=true; }
+
+  /// Return true if the group was cancelled
+  FXbool isCancelled() const { return cancelled || (active && !(*active)); }
+
+  /// Wait for all jobs to finish
+  ~GMJobGroup();
+  };
+
+
+/*
+  Puts the calling thread on idle scheduling for the lifetime of the
+  object, so a worker can run a long job without competing with playback.
+  Leaving idle scheduling needs privileges or a sufficient RLIMIT_NICE,
+  so the thread is only lowered if it can be restored afterwards.
+*/
+class GMIdlePriority {
+private:
+  FXint  policy   = 0;
+  FXint  priority = 0;
+  FXbool lowered  = false;
+private:
+  GMIdlePriority(const GMIdlePriority&);
+  GMIdlePriority &operator=(const GMIdlePriority&);
+public:
+  GMIdlePriority();
+
+  /// Return true if the thread runs with idle priority
+  FXbool isLowered() const { return lowered; }
+
+  /// Restore the previous scheduling
+  ~GMIdlePriority();
+  };
+
+
+/*
+  Application wide work-stealing thread pool.
+
+  Jobs queued from outside the pool go into a global queue for their
+  priority. Jobs queued from a worker thread go onto that worker's
+  own deque and may be stolen by idle workers. Interactive jobs are always
+  picked up first and background jobs never occupy all workers, so there
+  is always a thread left for interactive work. Workers are started on demand
+  and expire after being idle for a while.
+*/
+class GMThreadPool {
+friend class GMPoolWorker;
+friend class GMJobGroup;
+private:
+  FXMutex                mutex;
+  FXCondition            condition;
+  FXArray<GMPoolJob*>    queue[TASK_PRIORITY_LAST];
+  FXint                  head[TASK_PRIORITY_LAST];
+  FXArray<GMPoolWorker*> workers;
+  FXint                  nidle       = 0;
+  FXint                  nbackground = 0;
+  FXint                  maxbackground;
+  FXTime                 expiration;
+  volatile FXbool        running     = true;
+private:
+  static GMThreadPool*          pool;
+  static FXAutoThreadStorageKey current;
+private:
+  void submit(GMPoolJob*);
+  void execute(GMPoolJob*);
+  void finished(FXuchar priority);
+  void discard(GMPoolJob*);
+  void help(GMJobGroup*);
+  FXbool steal(GMPoolWorker*,GMPoolJob*&);
+  FXbool dequeue(FXuchar priority,GMPoolJob*&);
+  GMPoolJob * next(GMPoolWorker*);
+private:
+  GMThreadPool(const GMThreadPool&);
+  GMThreadPool &operator=(const GMThreadPool&);
+public:
+  /// Create pool with nthreads workers, defaults to number of processors
+  GMThreadPool(FXint nthreads=0,FXTime expiration=30_s);
+
+  /// Queue a standalone job. Job is deleted after it has run.
+  void execute(FXRunnable * job,FXuchar priority);
+
+  /// Number of workers
+  FXint getMaximumThreads() const { return workers.no(); }
+
+  /// Return the application wide pool
+  static GMThreadPool * instance() { return pool; }
+
+  /// Finish all running jobs and stop all workers.
+  void shutdown();
+
+  ~GMThreadPool();
+  };
+
+#endif
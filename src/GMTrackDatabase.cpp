@@ -37,7 +37,9 @@
 #endif
 
 
-#define GOGGLESMM_DATABASE_SCHEMA_VERSION 2018  /* Lyrics */
+#define GOGGLESMM_DATABASE_SCHEMA_VERSION 2020  /* Loudness */
+#define GOGGLESMM_DATABASE_SCHEMA_V17     2019  /* Lyrics in separate table */
+#define GOGGLESMM_DATABASE_SCHEMA_V16     2018  /* Lyrics */
 #define GOGGLESMM_DATABASE_SCHEMA_V15     2017  /* Album Audio Quality*/
 #define GOGGLESMM_DATABASE_SCHEMA_V14     2016  /* add autodownload to feed table*/
 #define GOGGLESMM_DATABASE_SCHEMA_V13     2015  /* Fix empty tags and add foreign reference to feeds table*/
@@ -106,9 +108,29 @@ const FXchar create_tracks[]=         "CREATE TABLE tracks ( "
                                           "samplerate INTEGER,"
                                           "channels INTEGER,"
                                           "filetype INTEGER,"
-                                          "lyrics TEXT,"
                                           "PRIMARY KEY (id) );";
 
+/*
+  Large text is kept out of the tracks table, so scans and joins
+  on tracks only touch the small columns.
+*/
+const FXchar create_track_text[]=     "CREATE TABLE IF NOT EXISTS track_text ("
+                                          "track INTEGER NOT NULL REFERENCES tracks(id),"
+                                          "lyrics TEXT,"
+                                          "PRIMARY KEY (track) );";
+
+/*
+  EBU R128 analysis results. Gains are relative to -18 LUFS, peaks are true peaks.
+*/
+const FXchar create_track_loudness[]= "CREATE TABLE IF NOT EXISTS track_loudness ("
+                                          "track INTEGER NOT NULL REFERENCES tracks(id),"
+                                          "loudness REAL,"
+                                          "track_gain REAL,"
+                                          "track_peak REAL,"
+                                          "album_gain REAL,"
+                                          "album_peak REAL,"
+                                          "PRIMARY KEY (track) );";
+
 const FXchar create_tags[]=           "CREATE TABLE tags ("
                                           "id INTEGER NOT NULL,"
                                           "name TEXT NOT NULL UNIQUE,"
@@ -335,6 +357,27 @@ FXbool GMTrackDatabase::init_database() {
           execute("ALTER TABLE tracks ADD COLUMN lyrics TEXT");
           }
 
+        // fallthrough - intentionally no break
+
+      case GOGGLESMM_DATABASE_SCHEMA_V16  :
+
+        execute(create_track_text);
+        execute("INSERT INTO track_text SELECT id, lyrics FROM tracks WHERE lyrics IS NOT NULL AND lyrics != ''");
+
+        // Rebuild tracks without the lyrics column. Keep other tables referring to tracks.
+        execute("PRAGMA legacy_alter_table=ON");
+        execute("ALTER TABLE tracks RENAME TO old_tracks");
+        execute(create_tracks);
+        execute("INSERT INTO tracks SELECT id, collection, path, mrl, title, time, no, year, bitrate, album, artist, composer, conductor, playcount, playdate, importdate, rating, samplerate, channels, filetype FROM old_tracks");
+        execute("DROP TABLE old_tracks");
+        execute("PRAGMA legacy_alter_table=OFF");
+
+        // fallthrough - intentionally no break
+
+      case GOGGLESMM_DATABASE_SCHEMA_V17  :
+
+        execute(create_track_loudness);
+
         setVersion(GOGGLESMM_DATABASE_SCHEMA_VERSION);
         break;
 
@@ -342,6 +385,8 @@ FXbool GMTrackDatabase::init_database() {
       default                               :
         reset();
         execute(create_tracks);
+        execute(create_track_text);
+        execute(create_track_loudness);
         execute(create_tags);
         execute(create_track_tags);
         execute(create_albums);
@@ -380,7 +425,7 @@ FXbool GMTrackDatabase::init_queries() {
     query_artist                        = compile("SELECT id FROM artists WHERE name == ?;");
     query_path_name                     = compile("SELECT name FROM pathlist WHERE id == ?;");
 
-    query_track                         = compile("SELECT pathlist.name || '" PATHSEPSTRING "' || mrl, albums.name, a1.name, a2.name, composer_artist.name, conductor_artist.name,title, time, no, tracks.year, tracks.rating, tracks.samplerate, tracks.channels, tracks.filetype, tracks.bitrate, tracks.lyrics "
+    query_track                         = compile("SELECT pathlist.name || '" PATHSEPSTRING "' || mrl, albums.name, a1.name, a2.name, composer_artist.name, conductor_artist.name,title, time, no, tracks.year, tracks.rating, tracks.samplerate, tracks.channels, tracks.filetype, tracks.bitrate "
                                                   "FROM tracks LEFT JOIN artists AS composer_artist ON tracks.composer == composer_artist.id LEFT JOIN artists AS conductor_artist ON tracks.conductor == conductor_artist.id,pathlist, albums, artists AS a1, artists AS a2 "
                                                   "WHERE tracks.path == pathlist.id "
                                                     "AND albums.id == tracks.album "
@@ -388,7 +433,8 @@ FXbool GMTrackDatabase::init_queries() {
                                                     "AND a2.id == tracks.artist "
                                                     "AND tracks.id == ?;");
 
-    query_track_tags                    = compile("SELECT name FROM tags WHERE id IN (SELECT tag FROM track_tags WHERE track == ?) ORDER BY name;");
+    query_track_tags                    = compile("SELECT name FROM tags WHERE id IN (SELECT tag FROM track_tags WHERE track == ?) ORDER BY name COLLATE UNICODE;");
+    query_track_lyrics                  = compile("SELECT lyrics FROM track_text WHERE track == ?;");
 
 
 
@@ -407,6 +453,8 @@ FXbool GMTrackDatabase::init_queries() {
     delete_track = compile("DELETE FROM tracks WHERE id == ?;");
     delete_playlist_track = compile("DELETE FROM playlist_tracks WHERE track == ?;");
     delete_tag_track = compile("DELETE FROM track_tags WHERE track == ?;");
+    delete_text_track = compile("DELETE FROM track_text WHERE track == ?;");
+    delete_loudness_track = compile("DELETE FROM track_loudness WHERE track == ?;");
 
 
 
@@ -426,6 +474,8 @@ FXbool GMTrackDatabase::clearTracks(FXbool removeplaylists){
     GMLockTransaction transaction(this);
     execute("DELETE FROM playlist_tracks;");
     execute("DELETE FROM track_tags;");
+    execute("DELETE FROM track_text;");
+    execute("DELETE FROM track_loudness;");
     execute("DELETE FROM tracks;");
     execute("DELETE FROM pathlist;");
     execute("DELETE FROM albums;");
@@ -890,6 +940,24 @@ const FXString * GMTrackDatabase::getArtist(FXint aid) {
   return &empty;
   }
 
+/// Return collation key of artist;
+const FXString * GMTrackDatabase::getArtistKey(FXint aid) {
+  if (__likely(aid>0)) {
+    FXString * key = (FXString*)artistkeydict.at((void*)(FXival)aid);
+    if (__likely(key)) return key;
+    key = new FXString(gm_sort_key(*getArtist(aid),sortkeywords));
+    artistkeydict.insert((void*)(FXival)aid,key);
+    return key;
+    }
+  return &empty;
+  }
+
+
+void GMTrackDatabase::setSortKeywords(const FXStringList & keywords) {
+  sortkeywords = keywords;
+  clear_artist_keys();
+  }
+
 
 void GMTrackDatabase::getTrackPath(FXint id,FXString & path) {
   DEBUG_DB_GET();
@@ -969,7 +1037,8 @@ FXbool GMTrackDatabase::getTrack(FXint tid,GMTrack & track){
         track.sampleformat = 0;
         }
 
-      query_track.get_null(15,track.lyrics);
+      // Lyrics are loaded on demand by getTrackLyrics
+      track.lyrics.clear();
 
       ok=true;
       }
@@ -993,6 +1062,42 @@ FXbool GMTrackDatabase::getTrack(FXint tid,GMTrack & track){
   return ok;
   }
 
+FXbool GMTrackDatabase::getTrackLyrics(FXint tid,FXString & lyrics){
+  DEBUG_DB_GET();
+  try {
+    lyrics.clear();
+    query_track_lyrics.set(0,tid);
+    if (query_track_lyrics.row()) {
+      query_track_lyrics.get_null(0,lyrics);
+      }
+    query_track_lyrics.reset();
+    }
+  catch (GMDatabaseException &){
+    return false;
+    }
+  return true;
+  }
+
+FXbool GMTrackDatabase::getTrackLoudness(FXint tid,FXdouble & track_gain,FXdouble & track_peak,FXdouble & album_gain,FXdouble & album_peak){
+  DEBUG_DB_GET();
+  FXbool found=false;
+  try {
+    GMQuery query_track_loudness(this,"SELECT track_gain,track_peak,album_gain,album_peak FROM track_loudness WHERE track == ?;");
+    query_track_loudness.set(0,tid);
+    if (query_track_loudness.row()) {
+      query_track_loudness.get(0,track_gain);
+      query_track_loudness.get(1,track_peak);
+      query_track_loudness.get(2,album_gain);
+      query_track_loudness.get(3,album_peak);
+      found=true;
+      }
+    }
+  catch (GMDatabaseException &){
+    return false;
+    }
+  return found;
+  }
+
 FXbool GMTrackDatabase::getTracks(const FXIntList & tids,GMTrackArray & tracks){
   DEBUG_DB_GET();
   try {
@@ -1064,6 +1169,16 @@ FXbool GMTrackDatabase::removeArtist(FXint artist) {
     query.set(1,artist);
     query.execute();
 
+    query = compile("DELETE FROM track_text WHERE track IN (SELECT id FROM tracks WHERE artist == ? OR album IN (SELECT id FROM albums WHERE artist == ?))");
+    query.set(0,artist);
+    query.set(1,artist);
+    query.execute();
+
+    query = compile("DELETE FROM track_loudness WHERE track IN (SELECT id FROM tracks WHERE artist == ? OR album IN (SELECT id FROM albums WHERE artist == ?))");
+    query.set(0,artist);
+    query.set(1,artist);
+    query.execute();
+
     query = compile("DELETE FROM tracks WHERE artist == ? OR album IN ( SELECT id FROM albums WHERE artist == ?);");
     query.set(0,artist);
     query.set(1,artist);
@@ -1095,6 +1210,14 @@ FXbool GMTrackDatabase::removeAlbum(FXint album) {
     query = compile("DELETE FROM track_tags WHERE track IN (SELECT id FROM tracks WHERE album == ?);");
     query.update(album);
 
+    // Remove tracks from track_text
+    query = compile("DELETE FROM track_text WHERE track IN (SELECT id FROM tracks WHERE album == ?);");
+    query.update(album);
+
+    // Remove tracks from track_loudness
+    query = compile("DELETE FROM track_loudness WHERE track IN (SELECT id FROM tracks WHERE album == ?);");
+    query.update(album);
+
     /// Removes tracks with album
     query = compile("DELETE FROM tracks WHERE album == ?;");
     query.update(album);
@@ -1430,6 +1553,17 @@ void GMTrackDatabase::clear_artist_lookup() {
       }
     }
   artistdict.clear();
+  clear_artist_keys();
+  }
+
+void GMTrackDatabase::clear_artist_keys() {
+  for (FXint i=0;i<artistkeydict.no();i++) {
+    if (!artistkeydict.empty(i) && artistkeydict.data(i)!=nullptr) {
+      FXString * k = (FXString*)artistkeydict.data(i);
+      delete k;
+      }
+    }
+  artistkeydict.clear();
   }
 
 void GMTrackDatabase::initArtistLookup() {
@@ -1490,124 +1624,6 @@ FXbool GMTrackDatabase::vacuum() {
   }
 
 
-FXbool GMTrackDatabase::exportList(const FXString & filename,FXint playlist,FXuint filetype,FXuint opts){
-  DEBUG_DB_GET();
-  const FXchar * c_artist;
-  const FXchar * c_album;
-  const FXchar * c_title;
-  FXint time;
-  FXint no;
-  FXint cnt=1;
-  FXint year;
-  FILE * fp = nullptr;
-  FXString query;
-  FXString title;
-  FXString file;
-  FXString basepath=FXPath::directory(filename);
-  GMQuery list;
-  try {
-
-    if (playlist)
-      getPlaylistName(playlist,title);
-
-    query = "SELECT pathlist.name || '" PATHSEPSTRING "' || mrl,title,artists.name,albums.name,no,time,tracks.year "
-            "FROM tracks,pathlist, albums, artists";
-
-    if (playlist)
-      query+=", playlist_tracks";
-
-    query+=" WHERE "
-                  "albums.artist == artists.id AND "
-                  "tracks.album == albums.id AND "
-                  "pathlist.id == tracks.path ";
-
-    if (playlist) {
-      query+=" AND playlist_tracks.track == tracks.id";
-      query+=" AND playlist_tracks.playlist == "+FXString::value(playlist);
-      query+=" ORDER BY playlist_tracks.queue; ";
-      }
-    else {
-      query+=";";
-      }
-
-    list = compile(query);
-
-    fp = fopen(filename.text(),"w");
-    if (!fp) return false;
-
-    if (filetype==PLAYLIST_XSPF) {
-      fprintf(fp,"<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
-      fprintf(fp,"<playlist version=\"1\" xmlns=\"http://xspf.org/ns/0/\">\n");
-      if (!title.empty()) fprintf(fp,"\t<title>%s</title>\n",title.text());
-      fprintf(fp,"\t<trackList>\n");
-      }
-    else if (filetype==PLAYLIST_M3U_EXTENDED) {
-      fprintf(fp,"#EXTM3U\n");
-      }
-    else if (filetype==PLAYLIST_PLS) {
-      fprintf(fp,"[playlist]\n");
-      }
-    else if (filetype==PLAYLIST_CSV) {
-      fprintf(fp,"No,Title,Album,Artist,Genre,Duration,Year,Filename\n");
-      }
-
-    while(list.row()){
-      file  = list.get(0);
-      c_title = list.get(1);
-      c_artist = list.get(2);
-      c_album = list.get(3);
-      list.get(4,no);
-      list.get(5,time);
-      list.get(6,year);
-
-      if (opts&PLAYLIST_OPTIONS_RELATIVE)
-        file = FXPath::relative(basepath,file);
-
-      if (filetype==PLAYLIST_XSPF) {
-        fprintf(fp,"\t\t<track>\n");
-        fprintf(fp,"\t\t\t<location>%s</location>\n",FXURL::fileToURL(file).text());
-        fprintf(fp,"\t\t\t<creator>%s</creator>\n",c_artist);
-        fprintf(fp,"\t\t\t<album>%s</album>\n",c_album);
-        fprintf(fp,"\t\t\t<title>%s</title>\n",c_title);
-        fprintf(fp,"\t\t\t<duration>%d</duration>\n",time*1000);
-        fprintf(fp,"\t\t\t<trackNum>%u</trackNum>\n",no);
-        fprintf(fp,"\t\t</track>\n");
-        }
-      else if (filetype==PLAYLIST_M3U_EXTENDED) {
-        fprintf(fp,"#EXTINF:%d,%s - %s\n",time,c_artist,c_title);
-        fprintf(fp,"%s\n",file.text());
-        }
-      else if (filetype==PLAYLIST_M3U) {
-        fprintf(fp,"%s\n",file.text());
-        }
-      else if (filetype==PLAYLIST_PLS) {
-        fprintf(fp,"File%d=%s\n",cnt,file.text());
-        fprintf(fp,"Title%d=%s - %s\n",cnt,c_artist,c_title);
-        fprintf(fp,"Length%d=%d\n",cnt,time);
-        cnt++;
-        }
-      else if (filetype==PLAYLIST_CSV){
-        fprintf(fp,"%d,\"%s\",\"%s\",\"%s\",%d,%d,\"%s\"\n",no,c_title,c_album,c_artist,time,year,file.text());
-        }
-      }
-    if (filetype==PLAYLIST_XSPF) {
-      fprintf(fp,"\t</trackList>\n");
-      fprintf(fp,"</playlist>");
-      }
-    else if (filetype==PLAYLIST_PLS){
-      fprintf(fp,"Version=2\n");
-      fprintf(fp,"NumberOfEntries=%d",cnt-1);
-      }
-    fclose(fp);
-    fp=nullptr;
-    }
-  catch (GMDatabaseException & e){
-    if (fp) fclose(fp);
-    return false;
-    }
-  return true;
-  }
-
 /*********************************************/
 
 void GMTrackDatabase::setTrackImported(FXint track,FXlong tm){
@@ -1699,10 +1715,29 @@ void GMTrackDatabase::setTrackYear(const FXIntList & tracks,FXuint year){
 /// Set the name of a track
 void GMTrackDatabase::setTrackLyrics(FXint track,const FXString & lyrics){
   DEBUG_DB_SET();
-  GMQuery update_track_lyrics(this,"UPDATE tracks SET lyrics = ? WHERE id == ?;");
-  update_track_lyrics.set(0,lyrics);
-  update_track_lyrics.set(1,track);
-  update_track_lyrics.execute();
+  if (lyrics.empty()) {
+    delete_text_track.update(track);
+    }
+  else {
+    GMQuery update_track_lyrics(this,"INSERT OR REPLACE INTO track_text VALUES (?,?);");
+    update_track_lyrics.set(0,track);
+    update_track_lyrics.set(1,lyrics);
+    update_track_lyrics.execute();
+    }
+  }
+
+
+/// Store loudness analysis of a track
+void GMTrackDatabase::setTrackLoudness(FXint track,FXdouble loudness,FXdouble track_gain,FXdouble track_peak,FXdouble album_gain,FXdouble album_peak){
+  DEBUG_DB_SET();
+  GMQuery update_track_loudness(this,"INSERT OR REPLACE INTO track_loudness VALUES (?,?,?,?,?,?);");
+  update_track_loudness.set(0,track);
+  update_track_loudness.set(1,loudness);
+  update_track_loudness.set(2,track_gain);
+  update_track_loudness.set(3,track_peak);
+  update_track_loudness.set(4,album_gain);
+  update_track_loudness.set(5,album_peak);
+  update_track_loudness.execute();
   }
 
 
@@ -2012,6 +2047,12 @@ void GMTrackDatabase::removeTracks(const FXIntList & tracks) {
   for (FXint i=0;i<tracks.no();i++){
     delete_tag_track.update(tracks[i]);
     }
+  for (FXint i=0;i<tracks.no();i++){
+    delete_text_track.update(tracks[i]);
+    }
+  for (FXint i=0;i<tracks.no();i++){
+    delete_loudness_track.update(tracks[i]);
+    }
   for (FXint i=0;i<tracks.no();i++){
     delete_track.update(tracks[i]);
     }
@@ -2021,6 +2062,8 @@ void GMTrackDatabase::removeTracks(const FXIntList & tracks) {
 
 void GMTrackDatabase::removeTrack(FXint track) {
   DEBUG_DB_SET();
+  delete_text_track.update(track);
+  delete_loudness_track.update(track);
   delete_track.update(track);
   }
 
@@ -53,9 +53,11 @@ typedef FXArray<GMPlayListItem> GMPlayListItemList;
 
 class GMTrackDatabase : public GMDatabase {
 protected:
-  FXHash   pathdict;
-  FXHash   artistdict;
-  FXString empty;
+  FXHash       pathdict;
+  FXHash       artistdict;
+  FXHash       artistkeydict;
+  FXString     empty;
+  FXStringList sortkeywords;
 public:
   GMQuery insert_path;                  /// Insert Path
   GMQuery insert_artist;                /// Insert Artist;
@@ -66,6 +68,7 @@ public:
   GMQuery query_path_name;
   GMQuery query_track;                  /// Query track
   GMQuery query_track_tags;             /// Query track tags
+  GMQuery query_track_lyrics;           /// Query track lyrics
   //GMQuery query_playlist_queue;         /// Get the max playlist queue
   GMQuery query_track_filename;         /// Query filename by track id
   GMQuery query_album_artists;          /// Query artist and album for track
@@ -76,6 +79,8 @@ public:
   GMQuery delete_track;					/// Delete Track
   GMQuery delete_playlist_track;
   GMQuery delete_tag_track;
+  GMQuery delete_text_track;
+  GMQuery delete_loudness_track;
   GMQuery update_track_rating;          /// Update track rating
 private: /// Called from init()
   FXbool init_database();
@@ -92,6 +97,7 @@ protected:
   void clear_path_lookup();
   void setup_artist_lookup();
   void clear_artist_lookup();
+  void clear_artist_keys();
 
   void clean_tags();
 public:
@@ -111,9 +117,15 @@ public:
 
   FXbool getStream(FXint id,GMStream & info);
 
-  /// Return Track Info
+  /// Return Track Info. Lyrics are not included.
   FXbool getTrack(FXint id,GMTrack & info);
 
+  /// Return Track Lyrics
+  FXbool getTrackLyrics(FXint id,FXString & lyrics);
+
+  /// Return analyzed gains (dB) and true peaks. False if the track wasn't analyzed.
+  FXbool getTrackLoudness(FXint id,FXdouble & track_gain,FXdouble & track_peak,FXdouble & album_gain,FXdouble & album_peak);
+
   FXbool getTracks(const FXIntList &,GMTrackArray &);
 
   /// Return artist, album id
@@ -143,6 +155,12 @@ public:
   /// Return the track path;
   const FXString * getArtist(FXint aid);
 
+  /// Return collation key of artist
+  const FXString * getArtistKey(FXint aid);
+
+  /// Set keywords to skip in artist sort keys
+  void setSortKeywords(const FXStringList & keywords);
+
   /// Get the track stats
   void getTrackStats(FXint & ntracks,FXint & nartists,FXint & nalbums,FXint & ntime,FXint playlist=0);
 
@@ -248,6 +266,9 @@ public:
   /// Set Track Lyrics
   void setTrackLyrics(FXint id,const FXString & lyrics);
 
+  /// Set Track Loudness (LUFS), gains (dB) and true peaks
+  void setTrackLoudness(FXint id,FXdouble loudness,FXdouble track_gain,FXdouble track_peak,FXdouble album_gain,FXdouble album_peak);
+
   /// Set Track Album
   void setTrackAlbum(const FXIntList & ids,const FXString & name,FXbool sameartist);
 
@@ -323,7 +344,6 @@ public:
   /// List Album Paths
   FXbool listAlbumPaths(GMCoverPathList & list);
 
-  FXbool exportList(const FXString & filename,FXint playlist,FXuint format,FXuint opts=0);
 
   ///=======================================================================================
   ///  Sync API
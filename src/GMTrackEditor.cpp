@@ -117,7 +117,7 @@ FXint GMTagUpdateTask::run() {
      if (database->interrupt)
         transaction.pause();
 
-      if (!database->getTrack(tracks[i],info)) {
+      if (!database->getTrack(tracks[i],info) || !database->getTrackLyrics(tracks[i],info.lyrics)) {
         break;
         }
 
@@ -681,12 +681,12 @@ void GMEditTrackDialog::getTrackSelection() {
     GMLockTransaction transaction(db);
     GMPlayerManager::instance()->getTrackView()->getSelectedTracks(tracks);
     db->getTrack(tracks[0],info);
+    if (tracks.no()==1) db->getTrackLyrics(tracks[0],info.lyrics);
     infotags = list_concat(info.tags);
   }
 
   if (tracks.no()==1) {
     properties.load(info.url);
-
     if (info.hasMissingLyrics()) {
       GM_DEBUG_PRINT("[editor] missing lyrics: retrieving from file\n");
 
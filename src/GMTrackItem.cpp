@@ -37,7 +37,7 @@
 #define VALUE_SORT_ASC(a,b) (a>b) ? 1 : ((a<b) ? -1 : 0);
 #define VALUE_SORT_DSC(a,b) (a>b) ? -1 : ((a<b) ? 1 : 0);
 
-#define GET_ARTIST_STRING(x)  GMPlayerManager::instance()->getTrackDatabase()->getArtist(x)
+#define GET_ARTIST_KEY(x)     GMPlayerManager::instance()->getTrackDatabase()->getArtistKey(x)
 
 
 // return true if string starts with configured keyword
@@ -48,30 +48,10 @@ static inline FXbool begins_with_keyword(const FXString & t){
   return false;
   }
 
-// return true if string starts with configured keyword
-static inline FXbool begins_with_keyword_ptr(const FXString * t){
-  for (FXint i=0;i<GMPlayerManager::instance()->getPreferences().gui_sort_keywords.no();i++){
-    if (FXString::comparecase(*t,GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i],GMPlayerManager::instance()->getPreferences().gui_sort_keywords[i].length())==0) return true;
-    }
-  return false;
-  }
-
-// compare two string taking into account the configured keywords it needs to ignore
-static inline FXint keywordcompare(const FXString *a,const FXString *b) {
-  FXint pa,pb;
-
+// compare two collation keys
+static inline FXint keycompare(const FXString * a,const FXString * b) {
   if (a==b) return 0;
-
-  if (begins_with_keyword_ptr(a))
-    pa=FXMIN(a->length()-1,a->find(' ')+1);
-  else
-    pa=0;
-
-  if (begins_with_keyword_ptr(b))
-    pb=FXMIN(b->length()-1,b->find(' ')+1);
-  else
-    pb=0;
-  return FXString::comparecase(&((*a)[pa]),&((*b)[pb]));
+  return FXCollate::compareKeys(*a,*b);
   }
 
 // compare two string taking into account the configured keywords it needs to ignore
@@ -86,7 +66,7 @@ static inline FXint keywordcompare(const FXString & a,const FXString & b) {
     pb=FXMIN(b.length()-1,b.find(' ')+1);
   else
     pb=0;
-  return FXString::comparecase(&((a)[pa]),&((b)[pb]));
+  return FXCollate::compare(&((a)[pa]),&((b)[pb]));
   }
 
 
@@ -106,32 +86,8 @@ FXint GMDBTrackItem::max_digits(FXint num){
   }
 
 
-GMDBTrackItem::GMDBTrackItem(FXint track_id,FXint track_path,const FXchar * track_mrl,const FXchar * track_title,FXint track_artist,FXint track_album_artist,FXint track_composer,FXint track_conductor,FXint album_id,const FXchar * track_album,FXint track_time,FXuint track_no,FXint track_queue,FXushort track_year,FXushort track_album_year,FXushort track_playcount,FXuchar track_filetype,FXint track_bitrate,FXint track_samplerate,FXuchar track_channels,FXlong track_playdate,FXuchar track_rating) :
-  GMTrackItem(track_id), mrl(track_mrl),
-                 title(track_title),
-                 album(track_album),
-                 playdate(track_playdate),
-                 artist(track_artist),
-                 albumartist(track_album_artist),
-                 composer(track_composer),conductor(track_conductor),
-                 albumid(album_id),
-                 time(track_time),
-                 no(track_no),
-                 queue(track_queue),
-                 path(track_path),
-                 bitrate(track_bitrate),
-                 samplerate(track_samplerate),
-                 channels(track_channels),
-                 filetype(track_filetype),
-                 year(track_year),
-                 album_year(track_album_year),
-                 playcount(track_playcount),
-                 rating(track_rating) {
-
-  state|=GMTrackItem::DRAGGABLE;
-  }
-
-GMDBTrackItem::~GMDBTrackItem(){
+void GMDBTrackItem::destroy() {
+  store->unref();
   }
 
 
@@ -158,16 +114,19 @@ const FXchar * const filetypes[] = {
 
 const FXString * GMDBTrackItem::getColumnData(FXint type,FXString &text,FXuint & justify,FXint & max) const{
   const FXString * textptr;
+  const FXint bitrate   = this->bitrate();
+  const FXint rate      = samplerate();
+  const FXint nchannels = channels();
   justify=COLUMN_JUSTIFY_NORMAL;
   switch(type){
-    case HEADER_QUEUE         : text.format("%d",queue);
+    case HEADER_QUEUE         : text.format("%d",queue());
                                 textptr=&text;
                                 justify=COLUMN_JUSTIFY_LEFT_RIGHT_ALIGNED;
                                 max=GMDBTrackItem::max_queue;
                                 break;
 
-    case HEADER_TRACK         : if (GMTRACKNO((FXuint)(FXuval)no)>0) {
-                                  text.format("%d",GMTRACKNO((FXuint)(FXuval)no));
+    case HEADER_TRACK         : if (GMTRACKNO((FXuint)(FXuval)no())>0) {
+                                  text.format("%d",GMTRACKNO((FXuint)(FXuval)no()));
                                   textptr=&text;
                                   justify=COLUMN_JUSTIFY_LEFT_RIGHT_ALIGNED;
                                   max=GMDBTrackItem::max_trackno;
@@ -177,36 +136,40 @@ const FXString * GMDBTrackItem::getColumnData(FXint type,FXString &text,FXuint &
                                   }
                                 break;
 
-    case HEADER_DISC          : if (GMDISCNO((FXuint)(FXuval)no)>0) {
-                                  text.format("%d",GMDISCNO((FXuint)(FXuval)no));
+    case HEADER_DISC          : if (GMDISCNO((FXuint)(FXuval)no())>0) {
+                                  text.format("%d",GMDISCNO((FXuint)(FXuval)no()));
                                   textptr=&text;
                                   }
                                 else {
                                   textptr=nullptr;
                                   }
                                 break;
-    case HEADER_FILETYPE      : text=filetypes[filetype];
+    case HEADER_FILETYPE      : text=filetypes[filetype()];
                                 textptr = &text;
                                 break;
-    case HEADER_TITLE         : textptr = &title;  			break;
-    case HEADER_FILENAME      : text.format("%s/%s",GMPlayerManager::instance()->getTrackDatabase()->getTrackPath(path),mrl.text());
+    case HEADER_TITLE         : text.assign(store->text(store->title[row]),store->length(store->title[row]));
+                                textptr=&text;
+                                break;
+    case HEADER_FILENAME      : text.format("%s/%s",GMPlayerManager::instance()->getTrackDatabase()->getTrackPath(path()),mrl());
+                                textptr=&text;
+                                break;
+    case HEADER_ALBUM         : text.assign(store->text(store->album[row]),store->length(store->album[row]));
                                 textptr=&text;
                                 break;
-    case HEADER_ALBUM         : textptr = &album;  			break;
-    case HEADER_ARTIST        : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(artist);       break;
-    case HEADER_ALBUM_ARTIST  : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(albumartist);  break;
-    case HEADER_COMPOSER      : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(composer);     break;
-    case HEADER_CONDUCTOR     : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(conductor);    break;
+    case HEADER_ARTIST        : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(artist());       break;
+    case HEADER_ALBUM_ARTIST  : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(albumartist());  break;
+    case HEADER_COMPOSER      : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(composer());     break;
+    case HEADER_CONDUCTOR     : textptr = GMPlayerManager::instance()->getTrackDatabase()->getArtist(conductor());    break;
     case HEADER_YEAR          : justify=COLUMN_JUSTIFY_RIGHT; //justify=COLUMN_JUSTIFY_CENTER_RIGHT_ALIGNED;
                                 //max=9999;
-                                if (year>0) {text.format("%d",year); textptr=&text; } else textptr=nullptr; break;
+                                if (year()>0) {text.format("%d",year()); textptr=&text; } else textptr=nullptr; break;
 
     case HEADER_PLAYCOUNT     : justify=COLUMN_JUSTIFY_CENTER_RIGHT_ALIGNED;
                                 //max=9999;
-                                if (playcount>0) {text.format("%d",playcount); textptr=&text; } else textptr=nullptr; break;
+                                if (playcount()>0) {text.format("%d",playcount()); textptr=&text; } else textptr=nullptr; break;
 
-    case HEADER_PLAYDATE      : if (playdate>0) {
-                                text=FXSystem::localTime(playdate);
+    case HEADER_PLAYDATE      : if (playdate()>0) {
+                                text=FXSystem::localTime(playdate());
                                 textptr=&text;
                                 }
                                 else {
@@ -215,7 +178,7 @@ const FXString * GMDBTrackItem::getColumnData(FXint type,FXString &text,FXuint &
                                 break;
 
     case HEADER_TIME          : /*textptr = &timestring;*/
-                                text.format("%d:%.2d",time/60,time%60);
+                                text.format("%d:%.2d",time()/60,time()%60);
                                 textptr=&text;
                                 justify=COLUMN_JUSTIFY_CENTER_RIGHT_ALIGNED;
                                 max=GMDBTrackItem::max_time;
@@ -229,21 +192,21 @@ const FXString * GMDBTrackItem::getColumnData(FXint type,FXString &text,FXuint &
                                 justify=COLUMN_JUSTIFY_RIGHT;
                                 break;
     case HEADER_AUDIOFORMAT   :
-                                if (channels>2) {
-                                  if (bitrate>samplerate)
-                                    text.format("%s %dch %d bit %g kHz",filetypes[filetype],channels,bitrate/(samplerate*channels),(float)samplerate/1000.0f);
+                                if (nchannels>2) {
+                                  if (bitrate>rate)
+                                    text.format("%s %dch %d bit %g kHz",filetypes[filetype()],nchannels,bitrate/(rate*nchannels),(float)rate/1000.0f);
                                   else if (bitrate>0)
-                                    text.format("%s %dch %d kbps %g kHz",filetypes[filetype],channels,bitrate,(float)samplerate/1000.0f);
+                                    text.format("%s %dch %d kbps %g kHz",filetypes[filetype()],nchannels,bitrate,(float)rate/1000.0f);
                                   else
-                                    text.format("%s %dch %g kHz",filetypes[filetype],channels,(float)samplerate/1000.0f);
+                                    text.format("%s %dch %g kHz",filetypes[filetype()],nchannels,(float)rate/1000.0f);
                                   }
                                 else {
-                                  if (bitrate>samplerate)
-                                    text.format("%s %d bit %g kHz",filetypes[filetype],bitrate/(samplerate*channels),(float)samplerate/1000.0f);
+                                  if (bitrate>rate)
+                                    text.format("%s %d bit %g kHz",filetypes[filetype()],bitrate/(rate*nchannels),(float)rate/1000.0f);
                                   else if (bitrate>0)
-                                    text.format("%s %d kbps %g kHz",filetypes[filetype],bitrate,(float)samplerate/1000.0f);
+                                    text.format("%s %d kbps %g kHz",filetypes[filetype()],bitrate,(float)rate/1000.0f);
                                   else
-                                    text.format("%s %g kHz",filetypes[filetype],(float)samplerate/1000.0f);
+                                    text.format("%s %g kHz",filetypes[filetype()],(float)rate/1000.0f);
                                   }
                                 textptr=&text;
                                 justify=COLUMN_JUSTIFY_RIGHT;
@@ -253,7 +216,7 @@ const FXString * GMDBTrackItem::getColumnData(FXint type,FXString &text,FXuint &
 
     case HEADER_RATING        : //textptr = ratingStrings + ((rating <= sizeof(GMDBTrackItem::ratingStrings)/sizeof(FXString))?rating:0);
                                 textptr=nullptr;
-                                max=rating;
+                                max=rating();
                                 break;
     default							      : textptr=nullptr;			 			break;
     }
@@ -268,24 +231,24 @@ FXint GMDBTrackItem::list_sort(const GMTrackItem * pa,const GMTrackItem * pb){
   FXint x;
 
   if (GMTrackView::album_by_year) {
-    if (ta->album_year > tb->album_year)
+    if (ta->album_year() > tb->album_year())
       return (GMTrackView::reverse_album) ? -1 : 1;
-    else if (ta->album_year < tb->album_year)
+    else if (ta->album_year() < tb->album_year())
       return (GMTrackView::reverse_album) ? 1 : -1;
     }
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return (GMTrackView::reverse_album) ? -x : x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->albumartist),GET_ARTIST_STRING(tb->albumartist));
+  x = keycompare(GET_ARTIST_KEY(ta->albumartist()),GET_ARTIST_KEY(tb->albumartist()));
   if (x!=0) return (GMTrackView::reverse_artist) ? -x : x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  if (ta->no>tb->no) return 1;
-  else if (ta->no<tb->no) return -1;
+  if (ta->no()>tb->no()) return 1;
+  else if (ta->no()<tb->no()) return -1;
 
   return 0;
   }
@@ -296,25 +259,25 @@ FXint GMDBTrackItem::browse_sort(const GMTrackItem * pa,const GMTrackItem * pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
 
-  FXint x = keywordcompare(GET_ARTIST_STRING(ta->albumartist),GET_ARTIST_STRING(tb->albumartist));
+  FXint x = keycompare(GET_ARTIST_KEY(ta->albumartist()),GET_ARTIST_KEY(tb->albumartist()));
   if (x!=0) return (GMTrackView::reverse_album == !GMTrackView::reverse_artist) ? -x : x;
 
   if (GMTrackView::album_by_year) {
-    if (ta->album_year > tb->album_year)
+    if (ta->album_year() > tb->album_year())
       return GMTrackView::reverse_album ? -1 : 1;
-    else if (ta->album_year < tb->album_year)
+    else if (ta->album_year() < tb->album_year())
       return GMTrackView::reverse_album ? 1 : -1;
     }
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  if (ta->no>tb->no) return 1;
-  else if (ta->no<tb->no) return -1;
+  if (ta->no()>tb->no()) return 1;
+  else if (ta->no()<tb->no()) return -1;
 
   return 0;
   }
@@ -327,24 +290,24 @@ FXint GMDBTrackItem::browseSort(const GMTrackItem * pa,const GMTrackItem * pb){
   FXint x;
 
   if (GMTrackView::album_by_year) {
-    if (ta->album_year > tb->album_year)
+    if (ta->album_year() > tb->album_year())
       return (GMTrackView::reverse_album) ? -1 : 1;
-    else if (ta->album_year < tb->album_year)
+    else if (ta->album_year() < tb->album_year())
       return (GMTrackView::reverse_album) ? 1 : -1;
     }
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return (GMTrackView::reverse_album) ? -x : x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->albumartist),GET_ARTIST_STRING(tb->albumartist));
+  x = keycompare(GET_ARTIST_KEY(ta->albumartist()),GET_ARTIST_KEY(tb->albumartist()));
   if (x!=0) return (GMTrackView::reverse_artist) ? -x : x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  if (ta->no>tb->no) return 1;
-  else if (ta->no<tb->no) return -1;
+  if (ta->no()>tb->no()) return 1;
+  else if (ta->no()<tb->no()) return -1;
 
   return 0;
   }
@@ -353,175 +316,175 @@ FXint GMDBTrackItem::browseSort(const GMTrackItem * pa,const GMTrackItem * pb){
 FXint GMDBTrackItem::ascendingFilename(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  if (ta->path!=tb->path) {
+  if (ta->path()!=tb->path()) {
     GMTrackDatabase* const db = GMPlayerManager::instance()->getTrackDatabase();
-    FXint x = FXString::comparecase(db->getTrackPath(ta->path),db->getTrackPath(tb->path));
+    FXint x = FXString::comparecase(db->getTrackPath(ta->path()),db->getTrackPath(tb->path()));
     if (x!=0) return x;
     }
-  return FXString::comparecase(ta->mrl,tb->mrl);
+  return FXString::comparecase(ta->mrl(),tb->mrl());
   }
 
 
 FXint GMDBTrackItem::descendingFilename(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  if (ta->path!=tb->path) {
+  if (ta->path()!=tb->path()) {
     GMTrackDatabase* const db = GMPlayerManager::instance()->getTrackDatabase();
-    FXint x = FXString::comparecase(db->getTrackPath(ta->path),db->getTrackPath(tb->path));
+    FXint x = FXString::comparecase(db->getTrackPath(ta->path()),db->getTrackPath(tb->path()));
     if (x!=0) return -x;
     }
-  return -FXString::comparecase(ta->mrl,tb->mrl);
+  return -FXString::comparecase(ta->mrl(),tb->mrl());
   }
 
 
 FXint GMDBTrackItem::ascendingFiletype(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  return FXString::comparecase(FXPath::extension(ta->mrl),FXPath::extension(tb->mrl));
+  return FXString::comparecase(FXPath::extension(ta->mrl()),FXPath::extension(tb->mrl()));
   }
 
 
 FXint GMDBTrackItem::descendingFiletype(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  return -FXString::comparecase(FXPath::extension(ta->mrl),FXPath::extension(tb->mrl));
+  return -FXString::comparecase(FXPath::extension(ta->mrl()),FXPath::extension(tb->mrl()));
   }
 
 
 FXint GMDBTrackItem::ascendingTitle(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  return keywordcompare(ta->title,tb->title);
+  return ta->store->compareKeys(ta->titlekey(),tb->titlekey());
   }
 
 
 FXint GMDBTrackItem::descendingTitle(const GMTrackItem* pa,const GMTrackItem* pb){
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
-  return keywordcompare(tb->title,ta->title);
+  return tb->store->compareKeys(tb->titlekey(),ta->titlekey());
   }
 
 
 FXint GMDBTrackItem::ascendingTrack(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuint a=GMTRACKNO(static_cast<const GMDBTrackItem*>(pa)->no);
-  const FXuint b=GMTRACKNO(static_cast<const GMDBTrackItem*>(pb)->no);
+  const FXuint a=GMTRACKNO(static_cast<const GMDBTrackItem*>(pa)->no());
+  const FXuint b=GMTRACKNO(static_cast<const GMDBTrackItem*>(pb)->no());
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingTrack(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuint a=GMTRACKNO(static_cast<const GMDBTrackItem*>(pa)->no);
-  const FXuint b=GMTRACKNO(static_cast<const GMDBTrackItem*>(pb)->no);
+  const FXuint a=GMTRACKNO(static_cast<const GMDBTrackItem*>(pa)->no());
+  const FXuint b=GMTRACKNO(static_cast<const GMDBTrackItem*>(pb)->no());
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingDisc(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuint a=GMDISCNO(static_cast<const GMDBTrackItem*>(pa)->no);
-  const FXuint b=GMDISCNO(static_cast<const GMDBTrackItem*>(pb)->no);
+  const FXuint a=GMDISCNO(static_cast<const GMDBTrackItem*>(pa)->no());
+  const FXuint b=GMDISCNO(static_cast<const GMDBTrackItem*>(pb)->no());
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingDisc(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuint a=GMDISCNO(static_cast<const GMDBTrackItem*>(pa)->no);
-  const FXuint b=GMDISCNO(static_cast<const GMDBTrackItem*>(pb)->no);
+  const FXuint a=GMDISCNO(static_cast<const GMDBTrackItem*>(pa)->no());
+  const FXuint b=GMDISCNO(static_cast<const GMDBTrackItem*>(pb)->no());
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingQueue(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->queue;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->queue;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->queue();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->queue();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingQueue(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->queue;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->queue;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->queue();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->queue();
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingPlaycount(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->playcount;
-  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->playcount;
+  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->playcount();
+  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->playcount();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingPlaycount(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->playcount;
-  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->playcount;
+  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->playcount();
+  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->playcount();
   return VALUE_SORT_DSC(a,b);
   }
 
 FXint GMDBTrackItem::ascendingPlaydate(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXlong a=static_cast<const GMDBTrackItem*>(pa)->playdate;
-  const FXlong b=static_cast<const GMDBTrackItem*>(pb)->playdate;
+  const FXlong a=static_cast<const GMDBTrackItem*>(pa)->playdate();
+  const FXlong b=static_cast<const GMDBTrackItem*>(pb)->playdate();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingPlaydate(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXlong a=static_cast<const GMDBTrackItem*>(pa)->playdate;
-  const FXlong b=static_cast<const GMDBTrackItem*>(pb)->playdate;
+  const FXlong a=static_cast<const GMDBTrackItem*>(pa)->playdate();
+  const FXlong b=static_cast<const GMDBTrackItem*>(pb)->playdate();
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingYear(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->year;
-  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->year;
+  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->year();
+  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->year();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingYear(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->year;
-  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->year;
+  const FXushort a=static_cast<const GMDBTrackItem*>(pa)->year();
+  const FXushort b=static_cast<const GMDBTrackItem*>(pb)->year();
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingTime(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->time;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->time;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->time();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->time();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingTime(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->time;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->time;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->time();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->time();
   return VALUE_SORT_DSC(a,b);
   }
 
 
 FXint GMDBTrackItem::ascendingBitrate(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingBitrate(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate();
   return VALUE_SORT_DSC(a,b);
   }
 
 FXint GMDBTrackItem::ascendingFormat(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingFormat(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate;
-  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate;
+  const FXint a=static_cast<const GMDBTrackItem*>(pa)->bitrate();
+  const FXint b=static_cast<const GMDBTrackItem*>(pb)->bitrate();
   return VALUE_SORT_DSC(a,b);
   }
 
@@ -531,14 +494,14 @@ FXint GMDBTrackItem::ascendingAlbum(const GMTrackItem* pa,const GMTrackItem* pb)
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
 
-  FXint x = keywordcompare(ta->album,tb->album);
+  FXint x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -546,14 +509,14 @@ FXint GMDBTrackItem::descendingAlbum(const GMTrackItem* pa,const GMTrackItem* pb
   const GMDBTrackItem * const ta = static_cast<const GMDBTrackItem*>(pa);
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
 
-  FXint x = keywordcompare(tb->album,ta->album);
+  FXint x = tb->store->compareKeys(tb->albumkey(),ta->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return -1;
-  else if (ta->albumid<tb->albumid) return 1;
+  if (ta->albumid()>tb->albumid()) return -1;
+  else if (ta->albumid()<tb->albumid()) return 1;
 
   /// Track & Disc (keep track order ascending)
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -562,17 +525,17 @@ FXint GMDBTrackItem::ascendingArtist(const GMTrackItem* pa,const GMTrackItem* pb
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->artist),GET_ARTIST_STRING(tb->artist));
+  x = keycompare(GET_ARTIST_KEY(ta->artist()),GET_ARTIST_KEY(tb->artist()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -581,17 +544,17 @@ FXint GMDBTrackItem::descendingArtist(const GMTrackItem* pa,const GMTrackItem* p
   const GMDBTrackItem * const tb = static_cast<const GMDBTrackItem*>(pb);
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(tb->artist),GET_ARTIST_STRING(ta->artist));
+  x = keycompare(GET_ARTIST_KEY(tb->artist()),GET_ARTIST_KEY(ta->artist()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return -1;
-  else if (ta->albumid<tb->albumid) return 1;
+  if (ta->albumid()>tb->albumid()) return -1;
+  else if (ta->albumid()<tb->albumid()) return 1;
 
   /// Track & Disc (keep track order ascending)
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -601,18 +564,18 @@ FXint GMDBTrackItem::ascendingAlbumArtist(const GMTrackItem* pa,const GMTrackIte
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->albumartist),GET_ARTIST_STRING(tb->albumartist));
+  x = keycompare(GET_ARTIST_KEY(ta->albumartist()),GET_ARTIST_KEY(tb->albumartist()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
 
   /// Track & Disc
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -622,18 +585,18 @@ FXint GMDBTrackItem::descendingAlbumArtist(const GMTrackItem* pa,const GMTrackIt
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(tb->albumartist),GET_ARTIST_STRING(ta->albumartist));
+  x = keycompare(GET_ARTIST_KEY(tb->albumartist()),GET_ARTIST_KEY(ta->albumartist()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return -1;
-  else if (ta->albumid<tb->albumid) return 1;
+  if (ta->albumid()>tb->albumid()) return -1;
+  else if (ta->albumid()<tb->albumid()) return 1;
 
 
   /// Track & Disc (keep track order ascending)
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -643,17 +606,17 @@ FXint GMDBTrackItem::ascendingComposer(const GMTrackItem* pa,const GMTrackItem*
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->composer),GET_ARTIST_STRING(tb->composer));
+  x = keycompare(GET_ARTIST_KEY(ta->composer()),GET_ARTIST_KEY(tb->composer()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -663,17 +626,17 @@ FXint GMDBTrackItem::descendingComposer(const GMTrackItem* pa,const GMTrackItem*
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(tb->composer),GET_ARTIST_STRING(ta->composer));
+  x = keycompare(GET_ARTIST_KEY(tb->composer()),GET_ARTIST_KEY(ta->composer()));
   if (x!=0) return x;
 
-  x = keywordcompare(tb->album,ta->album);
+  x = tb->store->compareKeys(tb->albumkey(),ta->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return -1;
-  else if (ta->albumid<tb->albumid) return 1;
+  if (ta->albumid()>tb->albumid()) return -1;
+  else if (ta->albumid()<tb->albumid()) return 1;
 
   /// Track & Disc (keep track order ascending)
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -683,17 +646,17 @@ FXint GMDBTrackItem::ascendingConductor(const GMTrackItem* pa,const GMTrackItem*
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(ta->composer),GET_ARTIST_STRING(tb->composer));
+  x = keycompare(GET_ARTIST_KEY(ta->composer()),GET_ARTIST_KEY(tb->composer()));
   if (x!=0) return x;
 
-  x = keywordcompare(ta->album,tb->album);
+  x = ta->store->compareKeys(ta->albumkey(),tb->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return 1;
-  else if (ta->albumid<tb->albumid) return -1;
+  if (ta->albumid()>tb->albumid()) return 1;
+  else if (ta->albumid()<tb->albumid()) return -1;
 
   /// Track & Disc
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
@@ -703,31 +666,31 @@ FXint GMDBTrackItem::descendingConductor(const GMTrackItem* pa,const GMTrackItem
 
   FXint x;
 
-  x = keywordcompare(GET_ARTIST_STRING(tb->composer),GET_ARTIST_STRING(ta->composer));
+  x = keycompare(GET_ARTIST_KEY(tb->composer()),GET_ARTIST_KEY(ta->composer()));
   if (x!=0) return x;
 
-  x = keywordcompare(tb->album,ta->album);
+  x = tb->store->compareKeys(tb->albumkey(),ta->albumkey());
   if (x!=0) return x;
 
-  if (ta->albumid>tb->albumid) return -1;
-  else if (ta->albumid<tb->albumid) return 1;
+  if (ta->albumid()>tb->albumid()) return -1;
+  else if (ta->albumid()<tb->albumid()) return 1;
 
 
   /// Track & Disc (keep track order ascending)
-  return VALUE_SORT_ASC(ta->no,tb->no);
+  return VALUE_SORT_ASC(ta->no(),tb->no());
   }
 
 
 FXint GMDBTrackItem::ascendingRating(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuchar a=static_cast<const GMDBTrackItem*>(pa)->rating;
-  const FXuchar b=static_cast<const GMDBTrackItem*>(pb)->rating;
+  const FXuchar a=static_cast<const GMDBTrackItem*>(pa)->rating();
+  const FXuchar b=static_cast<const GMDBTrackItem*>(pb)->rating();
   return VALUE_SORT_ASC(a,b);
   }
 
 
 FXint GMDBTrackItem::descendingRating(const GMTrackItem* pa,const GMTrackItem* pb){
-  const FXuchar a=static_cast<const GMDBTrackItem*>(pa)->rating;
-  const FXuchar b=static_cast<const GMDBTrackItem*>(pb)->rating;
+  const FXuchar a=static_cast<const GMDBTrackItem*>(pa)->rating();
+  const FXuchar b=static_cast<const GMDBTrackItem*>(pb)->rating();
   return VALUE_SORT_DSC(a,b);
   }
 
@@ -789,7 +752,7 @@ FXint GMStreamTrackItem::ascendingGenre(const GMTrackItem* pa,const GMTrackItem*
   const GMStreamTrackItem * const ta = static_cast<const GMStreamTrackItem*>(pa);
   const GMStreamTrackItem * const tb = static_cast<const GMStreamTrackItem*>(pb);
   FXint x;
-  x = FXString::comparecase(ta->genre,tb->genre);
+  x = FXCollate::compare(ta->genre,tb->genre);
   if (x!=0) return x;
   return ascendingTrack(pa,pb);
   }
@@ -799,7 +762,7 @@ FXint GMStreamTrackItem::descendingGenre(const GMTrackItem* pa,const GMTrackItem
   const GMStreamTrackItem * const ta = static_cast<const GMStreamTrackItem*>(pa);
   const GMStreamTrackItem * const tb = static_cast<const GMStreamTrackItem*>(pb);
   FXint x;
-  x = FXString::comparecase(tb->genre,ta->genre);
+  x = FXCollate::compare(tb->genre,ta->genre);
   if (x!=0) return x;
   return ascendingTrack(pa,pb);
   }
@@ -824,7 +787,7 @@ FXint GMStreamTrackItem::ascendingTitle(const GMTrackItem* pa,const GMTrackItem*
   FXint a=0,b=0;
   if (begins_with_keyword(ta->title)) a=FXMIN(ta->title.length()-1,ta->title.find(' ')+1);
   if (begins_with_keyword(tb->title)) b=FXMIN(tb->title.length()-1,tb->title.find(' ')+1);
-  return FXString::comparecase(&ta->title[a],&tb->title[b]);
+  return FXCollate::compare(&ta->title[a],&tb->title[b]);
   }
 
 
@@ -834,7 +797,7 @@ FXint GMStreamTrackItem::descendingTitle(const GMTrackItem* pa,const GMTrackItem
   FXint a=0,b=0;
   if (begins_with_keyword(ta->title)) a=FXMIN(ta->title.length()-1,ta->title.find(' ')+1);
   if (begins_with_keyword(tb->title)) b=FXMIN(tb->title.length()-1,tb->title.find(' ')+1);
-  return -FXString::comparecase(&ta->title[a],&tb->title[b]);
+  return -FXCollate::compare(&ta->title[a],&tb->title[b]);
   }
 
 
@@ -1017,7 +980,7 @@ FXint GMFeedItem::ascendingTitle(const GMTrackItem* pa,const GMTrackItem* pb){
   FXint a=0,b=0;
   if (begins_with_keyword(ta->title)) a=FXMIN(ta->title.length()-1,ta->title.find(' ')+1);
   if (begins_with_keyword(tb->title)) b=FXMIN(tb->title.length()-1,tb->title.find(' ')+1);
-  return FXString::comparecase(&ta->title[a],&tb->title[b]);
+  return FXCollate::compare(&ta->title[a],&tb->title[b]);
   }
 
 
@@ -1027,5 +990,5 @@ FXint GMFeedItem::descendingTitle(const GMTrackItem* pa,const GMTrackItem* pb){
   FXint a=0,b=0;
   if (begins_with_keyword(ta->title)) a=FXMIN(ta->title.length()-1,ta->title.find(' ')+1);
   if (begins_with_keyword(tb->title)) b=FXMIN(tb->title.length()-1,tb->title.find(' ')+1);
-  return -FXString::comparecase(&ta->title[a],&tb->title[b]);
+  return -FXCollate::compare(&ta->title[a],&tb->title[b]);
   }
@@ -19,10 +19,11 @@
 #ifndef GMTRACKITEM_H
 #define GMTRACKITEM_H
 
-class GMTrackItem;
+#include "GMTrackStore.h"
 
 class GMDBTrackItem : public GMTrackItem {
 friend class GMDatabaseSource;
+friend class GMTrackStore;
 public:
   static FXint max_time;
   static FXint max_queue;
@@ -30,27 +31,30 @@ public:
   static FXint max_digits(FXint no);
   static const FXString ratingStrings[];
 protected:
-  FXString mrl;           /* 4 - 8 */
-  FXString title;         /* 4 - 8 */
-  FXString album;         /* 4 - 8 */
-  FXlong   playdate;      /* 8 - 8 */
-  FXint    artist;        /* 4 - 4 */ //FIXME pointer to FXString instead?
-  FXint    albumartist;   /* 4 - 4 */ //FIXME pointer to FXString instead?
-  FXint    composer;      /* 4 - 4 */ //FIXME pointer to FXString instead?
-  FXint    conductor;     /* 4 - 4 */ //FIXME pointer to FXString instead?
-  FXint    albumid;       /* 4 - 4 */
-  FXint    time;          /* 4 - 4 */
-  FXuint   no;            /* 4 - 4 */
-  FXint    queue;         /* 4 - 4 */
-  FXint    path;          /* 4 - 4 */ //FIXME pointer to FXString instead?
-  FXint    bitrate;       /* 4 - 4 */
-  FXint    samplerate;    /* 4 - 4 */
-  FXuchar  channels;      /* 1 - 1 */
-  FXuchar  filetype;      /* 1 - 1 */
-  FXushort year;          /* 2 - 2 */
-  FXushort album_year;    /* 2 - 2 */
-  FXushort playcount;     /* 2 - 2 */
-  FXuchar  rating;        /* 1 - 1 */
+  GMTrackStore * store = nullptr;
+  FXint          row   = 0;
+protected:
+  const FXchar * mrl() const { return store->text(store->mrl[row]); }
+  FXint titlekey() const { return store->titlekey[row]; }
+  FXint albumkey() const { return store->albumkey[row]; }
+  FXlong playdate() const { return store->playdate[row]; }
+  FXint artist() const { return store->artist[row]; }
+  FXint albumartist() const { return store->albumartist[row]; }
+  FXint composer() const { return store->composer[row]; }
+  FXint conductor() const { return store->conductor[row]; }
+  FXint albumid() const { return store->albumid[row]; }
+  FXint time() const { return store->time[row]; }
+  FXuint no() const { return store->no[row]; }
+  FXint queue() const { return store->queue[row]; }
+  FXint path() const { return store->path[row]; }
+  FXint bitrate() const { return store->bitrate[row]; }
+  FXint samplerate() const { return store->samplerate[row]; }
+  FXuchar channels() const { return store->channels[row]; }
+  FXuchar filetype() const { return store->filetype[row]; }
+  FXushort year() const { return store->year[row]; }
+  FXushort album_year() const { return store->album_year[row]; }
+  FXushort playcount() const { return store->playcount[row]; }
+  FXuchar rating() const { return store->rating[row]; }
 public:
   static FXint browse_sort(const GMTrackItem*,const GMTrackItem*);
   static FXint list_sort(const GMTrackItem*,const GMTrackItem*);
@@ -95,44 +99,20 @@ protected:
 protected:
   virtual const FXString * getColumnData(FXint i,FXString & t,FXuint &justify,FXint & max) const;
   virtual FXIcon* getIcon() const;
+  virtual void destroy();
 public:
-  GMDBTrackItem(FXint id,
-                FXint path,
-                const FXchar * mrl,
-                const FXchar * title,
-                FXint artist,
-                FXint albumartist,
-                FXint composer,
-                FXint conductor,
-                FXint albumid,
-                const FXchar * album,
-                FXint time,
-                FXuint no,
-                FXint queue,
-                FXushort track_year,
-                FXushort album_year,
-                FXushort aplaycount,
-                FXuchar filetype,
-                FXint bitrate,
-                FXint samplerate,
-                FXuchar channels,
-                FXlong aplaydate,
-                FXuchar track_rating);
-
-  void setTrackQueue(FXint q) { queue=q; }
-
-  FXint getTrackQueue() const { return queue; }
+  void setTrackQueue(FXint q) { store->queue[row]=q; }
+
+  FXint getTrackQueue() const { return queue(); }
 
   /// Return Track Number
-  FXint getTrackNumber() const { return no; }
+  FXint getTrackNumber() const { return no(); }
 
   /// Return Track Title
-  FXString getTrackTitle() const { return title; }
+  FXString getTrackTitle() const { return store->text(store->title[row]); }
 
   /// Sets rating
-  void setRating(FXuchar r) { rating = r; }
-
-  virtual ~GMDBTrackItem();
+  void setRating(FXuchar r) { store->rating[row] = r; }
   };
 
 
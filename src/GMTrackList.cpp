@@ -160,6 +160,7 @@ GMTrackList::GMTrackList(){
   ratingl=-1;
   state=false;
   sortMethod=HEADER_DEFAULT;
+  lookupdirty=false;
   }
 
 
@@ -197,6 +198,7 @@ GMTrackList::GMTrackList(FXComposite *p,FXObject* tgt,FXSelector sel,FXuint opts
   ratingl=-1;
   state=false;
   sortMethod=HEADER_DEFAULT;
+  lookupdirty=false;
 
   GMScrollArea::replaceScrollbars(this);
   }
@@ -549,7 +551,28 @@ void GMTrackList::makeItemVisible(FXint index){
   }
 
 /// Find Item by Id
+// Ids 0 and -1 cannot be used as hash key
+static inline FXbool lookup_key(FXint id) {
+  return id!=0 && id!=-1;
+  }
+
+
+// Map id to the first item with that id. Rebuild is done on demand after the list changed.
+void GMTrackList::rebuildLookup() const {
+  lookup.clear();
+  for (FXint i=0;i<items.no();i++){
+    if (lookup_key(items[i]->id) && lookup.at((FXptr)(FXival)items[i]->id)==nullptr)
+      lookup.insert((FXptr)(FXival)items[i]->id,(FXptr)(FXival)(i+1));
+    }
+  lookupdirty=false;
+  }
+
+
 FXint GMTrackList::findItemById(FXint id) const{
+  if (lookup_key(id)) {
+    if (lookupdirty) rebuildLookup();
+    return ((FXint)(FXival)lookup.at((FXptr)(FXival)id))-1;
+    }
   for (FXint i=0;i<items.no();i++){
     if (items[i]->id==id) return i;
     }
@@ -1123,6 +1146,7 @@ void GMTrackList::sortItems(){
         items[j-1]=v;
         }
       }
+    if(exch) lookupdirty=true;
     if(0<=current){
       for(i=0; i<items.no(); i++){
         if(items[i]==c){ current=i; break; }
@@ -1674,8 +1698,11 @@ FXint GMTrackList::setItem(FXint index,GMTrackItem* item,FXbool notify){
   // Copy the state over
   item->state=items[index]->state;
 
+  // Id may have changed
+  if(item->id!=items[index]->id) lookupdirty=true;
+
   // Delete old
-  delete items[index];
+  items[index]->destroy();
 
   // Add new
   items[index]=item;
@@ -1698,6 +1725,15 @@ FXint GMTrackList::insertItem(FXint index,GMTrackItem* item,FXbool notify){
   // Add item to list
   items.insert(index,item);
 
+  // Appending keeps the lookup valid
+  if(index==items.no()-1 && !lookupdirty){
+    if(lookup_key(item->id) && lookup.at((FXptr)(FXival)item->id)==nullptr)
+      lookup.insert((FXptr)(FXival)item->id,(FXptr)(FXival)items.no());
+    }
+  else{
+    lookupdirty=true;
+    }
+
   // Adjust indices
   if(anchor>=index)  anchor++;
   if(extent>=index)  extent++;
@@ -1735,6 +1771,40 @@ FXint GMTrackList::appendItem(GMTrackItem* item,FXbool notify){
   }
 
 
+// Append items
+void GMTrackList::appendItems(const GMTrackItemList & list,FXbool notify){
+  FXint index=items.no();
+  FXint old=current;
+
+  if(list.no()==0) return;
+
+  // Add items to list
+  items.append(list);
+  lookupdirty=true;
+
+  if(current<0 && index==0) current=0;
+
+  // Notify items have been inserted
+  if(notify && target){
+    for(FXint i=index;i<items.no();i++) target->tryHandle(this,FXSEL(SEL_INSERTED,message),(void*)(FXival)i);
+    }
+
+  // Current item may have changed
+  if(old!=current){
+    if(notify && target){target->tryHandle(this,FXSEL(SEL_CHANGED,message),(void*)(FXival)current);}
+    if(hasFocus()){
+      items[current]->setFocus(true);
+      }
+    if((options&SELECT_MASK)==TRACKLIST_BROWSESELECT){
+      selectItem(current,notify);
+      }
+    }
+
+  // Redo layout
+  recalc();
+  }
+
+
 // Prepend item
 FXint GMTrackList::prependItem(GMTrackItem* item,FXbool notify){
   return insertItem(0,item,notify);
@@ -1756,6 +1826,7 @@ FXint GMTrackList::moveItem(FXint newindex,FXint oldindex,FXbool notify){
     item=items[oldindex];
     items.erase(oldindex);
     items.insert(newindex,item);
+    lookupdirty=true;
 
     // Move item down
     if(newindex<oldindex){
@@ -1807,6 +1878,7 @@ GMTrackItem* GMTrackList::extractItem(FXint index,FXbool notify){
 
   // Remove from list
   items.erase(index);
+  lookupdirty=true;
 
   // Adjust indices
   if(anchor>index || anchor>=items.no())  anchor--;
@@ -1848,10 +1920,11 @@ void GMTrackList::removeItem(FXint index,FXbool notify){
   if(notify && target){target->tryHandle(this,FXSEL(SEL_DELETED,message),(void*)(FXival)index);}
 
   // Delete item
-  delete items[index];
+  items[index]->destroy();
 
   // Remove from list
   items.erase(index);
+  lookupdirty=true;
 
   // Adjust indices
   if(anchor>index || anchor>=items.no())  anchor--;
@@ -1886,11 +1959,13 @@ void GMTrackList::clearItems(FXbool notify){
   // Delete items
   for(FXint index=items.no()-1; 0<=index; index--){
     if(notify && target){target->tryHandle(this,FXSEL(SEL_DELETED,message),(void*)(FXival)index);}
-    delete items[index];
+    items[index]->destroy();
     }
 
   // Free array
   items.clear();
+  lookup.clear();
+  lookupdirty=false;
 
   // Adjust indices
   current=-1;
@@ -52,6 +52,7 @@ protected:
 protected:
   virtual const FXString * getColumnData(FXint,FXString &,FXuint &,FXint &) const { return nullptr; }
   virtual FXIcon * getIcon() const { return nullptr; }
+  virtual void destroy() { delete this; }
 public:
   enum {
     SELECTED      = 0x01,  /// Selected
@@ -161,8 +162,11 @@ protected:
   FXint              sortMethod;
   FXString           starset;
   FXString           starunset;
+  mutable FXHash     lookup;            // Item id to index+1
+  mutable FXbool     lookupdirty;       // Lookup needs to be rebuild
 protected:
   GMTrackList();
+  void rebuildLookup() const;
   void draw(FXDC& dc,FXEvent *event,FXint index,FXint x,FXint y,FXint w,FXint h,FXint dw) const;
   void recompute();
   virtual void moveContents(FXint x,FXint y);
@@ -229,7 +233,7 @@ public:
   /// Construct icon list with no items in it initially
   GMTrackList(FXComposite *p,FXObject* tgt=nullptr,FXSelector sel=0,FXuint opts=TRACKLIST_NORMAL,FXint x=0,FXint y=0,FXint w=0,FXint h=0);
 
-  /// Find Item by Id
+  /// Find Item by Id. If id occurs more than once, the first item is returned.
   FXint findItemById(FXint id) const;
 
   /// Get the unique item id
@@ -319,6 +323,9 @@ public:
   /// Append a [possibly subclassed] item to the end of the list
   FXint appendItem(GMTrackItem* item,FXbool notify=false);
 
+  /// Append a list of items to the end of the list
+  void appendItems(const GMTrackItemList & list,FXbool notify=false);
+
   /// Prepend a [possibly subclassed] item to the end of the list
   FXint prependItem(GMTrackItem* item,FXbool notify=false);
 
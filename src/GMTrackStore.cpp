@@ -0,0 +1,334 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include "gmdefs.h"
+#include "gmutils.h"
+#include "GMTrackList.h"
+#include "GMTrackItem.h"
+
+
+GMStringPool::GMStringPool() {
+  buffer.no(4096);
+  rehash(256);
+  }
+
+
+void GMStringPool::rehash(FXint nslots) {
+  FXArray<FXint> old(slots);
+  slots.no(nslots);
+  memset(slots.data(),0,sizeof(FXint)*nslots);
+  for (FXint i=0;i<old.no();i++) {
+    if (old[i]) {
+      FXuint p = FXString::hash(text(old[i]),length(old[i])) & (nslots-1);
+      while(slots[p]) p=(p+1)&(nslots-1);
+      slots[p]=old[i];
+      }
+    }
+  }
+
+
+FXint GMStringPool::intern(const FXchar * str,FXint len) {
+  if (str==nullptr) str="";
+  FXuint p = FXString::hash(str,len) & (slots.no()-1);
+
+  // Find existing
+  while(slots[p]) {
+    if (length(slots[p])==len && memcmp(text(slots[p]),str,len)==0)
+      return slots[p];
+    p=(p+1)&(slots.no()-1);
+    }
+
+  // Make room for length, text and nul
+  const FXival need = used+sizeof(FXint)+len+1;
+  if (need>buffer.no()) buffer.no(FXMAX(need,buffer.no()*2));
+
+  memcpy(&buffer[used],&len,sizeof(FXint));
+  const FXint ref = used+sizeof(FXint);
+  if (len) memcpy(&buffer[ref],str,len);
+  buffer[ref+len]='\0';
+  used=ref+len+1;
+
+  slots[p]=ref;
+  if (++nstrings*2>slots.no()) rehash(slots.no()*2);
+  return ref;
+  }
+
+
+
+// Length prefix, text and terminator all have to be inside the used part of the buffer
+FXbool GMStringPool::valid(FXint ref) const {
+  if (ref<(FXint)sizeof(FXint) || ref>=used) return false;
+  const FXint len = length(ref);
+  return len>=0 && len<used-ref && buffer[ref+len]=='\0';
+  }
+
+
+// The hash table is saved as well, so loading doesn't need to hash every string
+void GMStringPool::save(FXStream & store) const {
+  store << (FXlong)used;
+  store << nstrings;
+  store << (FXint)slots.no();
+  store.save(buffer.data(),used);
+  store.save(slots.data(),slots.no());
+  }
+
+
+FXbool GMStringPool::load(FXStream & store) {
+  FXlong nused;
+  FXint  nslots;
+  store >> nused;
+  store >> nstrings;
+  store >> nslots;
+  if (store.status()!=FXStreamOK || nused<(FXlong)sizeof(FXint) || nslots<=0 || (nslots&(nslots-1)) || nstrings*2>nslots)
+    return false;
+  if (!buffer.no(nused) || !slots.no(nslots))
+    return false;
+  used=nused;
+  store.load(buffer.data(),used);
+  store.load(slots.data(),nslots);
+  if (store.status()!=FXStreamOK)
+    return false;
+  for (FXint i=0;i<nslots;i++) {
+    if (slots[i] && !valid(slots[i])) return false;
+    }
+  return true;
+  }
+
+
+
+GMTrackStore::GMTrackStore(const FXStringList & kw) : keywords(kw), refcount(1) {
+  }
+
+
+GMTrackStore::~GMTrackStore() {
+  delete [] items;
+  }
+
+
+void GMTrackStore::unref() {
+  if (--refcount==0) delete this;
+  }
+
+
+void GMTrackStore::reserve(FXint n) {
+  id.no(n);
+  mrl.no(n);
+  title.no(n);
+  album.no(n);
+  titlekey.no(n);
+  albumkey.no(n);
+  playdate.no(n);
+  artist.no(n);
+  albumartist.no(n);
+  composer.no(n);
+  conductor.no(n);
+  albumid.no(n);
+  time.no(n);
+  no.no(n);
+  queue.no(n);
+  path.no(n);
+  bitrate.no(n);
+  samplerate.no(n);
+  channels.no(n);
+  filetype.no(n);
+  year.no(n);
+  album_year.no(n);
+  playcount.no(n);
+  rating.no(n);
+  }
+
+
+// Collation keys are interned as well, so equal strings share a key
+FXint GMTrackStore::sortkey(FXint ref) {
+  FXint key = (FXint)(FXival)sortkeys.at((const void*)(FXival)ref);
+  if (key==0) {
+    key = strings.intern(gm_sort_key(FXString(text(ref),length(ref)),keywords));
+    sortkeys.at((const void*)(FXival)ref) = (void*)(FXival)key;
+    }
+  return key;
+  }
+
+
+FXint GMTrackStore::compareKeys(FXint a,FXint b) const {
+  if (a==b) return 0;
+  return FXCollate::compareKeys(text(a),length(a),text(b),length(b));
+  }
+
+
+FXint GMTrackStore::append(FXint track_id,FXint track_path,const FXchar * track_mrl,const FXchar * track_title,FXint track_artist,FXint track_album_artist,FXint track_composer,FXint track_conductor,FXint album_id,const FXchar * track_album,FXint track_time,FXuint track_no,FXint track_queue,FXushort track_year,FXushort track_album_year,FXushort track_playcount,FXuchar track_filetype,FXint track_bitrate,FXint track_samplerate,FXuchar track_channels,FXlong track_playdate,FXuchar track_rating) {
+  FXASSERT(items==nullptr);
+  if (nrows==id.no()) reserve(FXMAX(256,nrows*2));
+  const FXint row = nrows++;
+  id[row]          = track_id;
+  mrl[row]         = strings.intern(track_mrl);
+  title[row]       = strings.intern(track_title);
+  titlekey[row]    = sortkey(title[row]);
+  album[row]       = strings.intern(track_album);
+  albumkey[row]    = sortkey(album[row]);
+  playdate[row]    = track_playdate;
+  artist[row]      = track_artist;
+  albumartist[row] = track_album_artist;
+  composer[row]    = track_composer;
+  conductor[row]   = track_conductor;
+  albumid[row]     = album_id;
+  time[row]        = track_time;
+  no[row]          = track_no;
+  queue[row]       = track_queue;
+  path[row]        = track_path;
+  bitrate[row]     = track_bitrate;
+  samplerate[row]  = track_samplerate;
+  channels[row]    = track_channels;
+  filetype[row]    = track_filetype;
+  year[row]        = track_year;
+  album_year[row]  = track_album_year;
+  playcount[row]   = track_playcount;
+  rating[row]      = track_rating;
+  return row;
+  }
+
+
+void GMTrackStore::setMrl(FXint row,const FXchar * str) {
+  mrl[row] = strings.intern(str);
+  }
+
+
+void GMTrackStore::setTitle(FXint row,const FXchar * str) {
+  title[row]    = strings.intern(str);
+  titlekey[row] = sortkey(title[row]);
+  }
+
+
+void GMTrackStore::setAlbum(FXint row,const FXchar * str) {
+  album[row]    = strings.intern(str);
+  albumkey[row] = sortkey(album[row]);
+  }
+
+
+template<typename T>
+static void save_column(FXStream & store,const FXArray<T> & column,FXint n) {
+  store.save(column.data(),n);
+  }
+
+
+template<typename T>
+static FXbool load_column(FXStream & store,FXArray<T> & column,FXint n) {
+  if (!column.no(n)) return false;
+  store.load(column.data(),n);
+  return true;
+  }
+
+
+// Check string references, so a damaged file can't point outside the pool or at a partial string
+static FXbool check_column(const GMStringPool & strings,const FXArray<FXint> & column,FXint n) {
+  for (FXint i=0;i<n;i++) {
+    if (!strings.valid(column[i])) return false;
+    }
+  return true;
+  }
+
+
+void GMTrackStore::save(FXStream & store) const {
+  strings.save(store);
+  store << nrows;
+  save_column(store,id,nrows);
+  save_column(store,mrl,nrows);
+  save_column(store,title,nrows);
+  save_column(store,album,nrows);
+  save_column(store,titlekey,nrows);
+  save_column(store,albumkey,nrows);
+  save_column(store,playdate,nrows);
+  save_column(store,artist,nrows);
+  save_column(store,albumartist,nrows);
+  save_column(store,composer,nrows);
+  save_column(store,conductor,nrows);
+  save_column(store,albumid,nrows);
+  save_column(store,time,nrows);
+  save_column(store,no,nrows);
+  save_column(store,queue,nrows);
+  save_column(store,path,nrows);
+  save_column(store,bitrate,nrows);
+  save_column(store,samplerate,nrows);
+  save_column(store,channels,nrows);
+  save_column(store,filetype,nrows);
+  save_column(store,year,nrows);
+  save_column(store,album_year,nrows);
+  save_column(store,playcount,nrows);
+  save_column(store,rating,nrows);
+  }
+
+
+FXbool GMTrackStore::load(FXStream & store) {
+  FXint n;
+  FXASSERT(nrows==0 && items==nullptr);
+  if (!strings.load(store))
+    return false;
+  store >> n;
+  if (store.status()!=FXStreamOK || n<0)
+    return false;
+  if (!load_column(store,id,n) ||
+      !load_column(store,mrl,n) ||
+      !load_column(store,title,n) ||
+      !load_column(store,album,n) ||
+      !load_column(store,titlekey,n) ||
+      !load_column(store,albumkey,n) ||
+      !load_column(store,playdate,n) ||
+      !load_column(store,artist,n) ||
+      !load_column(store,albumartist,n) ||
+      !load_column(store,composer,n) ||
+      !load_column(store,conductor,n) ||
+      !load_column(store,albumid,n) ||
+      !load_column(store,time,n) ||
+      !load_column(store,no,n) ||
+      !load_column(store,queue,n) ||
+      !load_column(store,path,n) ||
+      !load_column(store,bitrate,n) ||
+      !load_column(store,samplerate,n) ||
+      !load_column(store,channels,n) ||
+      !load_column(store,filetype,n) ||
+      !load_column(store,year,n) ||
+      !load_column(store,album_year,n) ||
+      !load_column(store,playcount,n) ||
+      !load_column(store,rating,n))
+    return false;
+  if (store.status()!=FXStreamOK)
+    return false;
+  if (!check_column(strings,mrl,n) ||
+      !check_column(strings,title,n) ||
+      !check_column(strings,album,n) ||
+      !check_column(strings,titlekey,n) ||
+      !check_column(strings,albumkey,n))
+    return false;
+  nrows=n;
+  return true;
+  }
+
+
+GMDBTrackItem * GMTrackStore::createItems() {
+  FXASSERT(items==nullptr);
+  if (nrows) {
+    items = new GMDBTrackItem[nrows];
+    for (FXint i=0;i<nrows;i++) {
+      items[i].id    = id[i];
+      items[i].state = GMTrackItem::DRAGGABLE;
+      items[i].store = this;
+      items[i].row   = i;
+      }
+    refcount+=nrows;
+    }
+  return items;
+  }
@@ -0,0 +1,182 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef GMTRACKSTORE_H
+#define GMTRACKSTORE_H
+
+class GMDBTrackItem;
+
+/*
+  Interned strings. All strings live in a single buffer, each stored as
+  length, text and a terminating nul, and are referred to by the offset
+  of their text. Equal strings share the same reference.
+*/
+class GMStringPool {
+protected:
+  FXArray<FXchar> buffer;
+  FXArray<FXint>  slots;     // open addressing hash table of references
+  FXival          used = 0;
+  FXint           nstrings = 0;
+protected:
+  void rehash(FXint nslots);
+private:
+  GMStringPool(const GMStringPool&);
+  GMStringPool &operator=(const GMStringPool&);
+public:
+  GMStringPool();
+
+  /// Return reference to str, adding it if needed
+  FXint intern(const FXchar * str,FXint len);
+
+  /// Return reference to str, adding it if needed
+  FXint intern(const FXchar * str) { return intern(str,str ? strlen(str) : 0); }
+
+  /// Return reference to str, adding it if needed
+  FXint intern(const FXString & str) { return intern(str.text(),str.length()); }
+
+  /// Return text of reference
+  const FXchar * text(FXint ref) const { return &buffer[ref]; }
+
+  /// Return length of reference
+  FXint length(FXint ref) const { FXint n; memcpy(&n,&buffer[ref-sizeof(FXint)],sizeof(FXint)); return n; }
+
+  /// Number of unique strings
+  FXint no() const { return nstrings; }
+
+  /// Number of bytes used
+  FXival size() const { return used; }
+
+  /// Return true if ref refers to a complete, nul terminated string in the pool
+  FXbool valid(FXint ref) const;
+
+  /// Save to stream
+  void save(FXStream & store) const;
+
+  /// Load from stream
+  FXbool load(FXStream & store);
+  };
+
+
+/*
+  Column store for a list of database tracks. Every column is a contiguous
+  array indexed by row and all strings are interned, so listing a large
+  library takes a handful of allocations instead of several per track.
+  The rows are handed to the track list as GMDBTrackItems, allocated in a
+  single block. The store is reference counted by its items and deletes
+  itself once the last item is released.
+*/
+class GMTrackStore {
+friend class GMDBTrackItem;
+protected:
+  GMStringPool      strings;
+  FXHash            sortkeys;     // string reference to collation key reference
+  FXStringList      keywords;
+  GMDBTrackItem *   items = nullptr;
+  FXint             nrows = 0;
+  FXint             refcount = 0;
+public:
+  FXArray<FXint>    id;
+  FXArray<FXint>    mrl;          // string references
+  FXArray<FXint>    title;
+  FXArray<FXint>    album;
+  FXArray<FXint>    titlekey;
+  FXArray<FXint>    albumkey;
+  FXArray<FXlong>   playdate;
+  FXArray<FXint>    artist;
+  FXArray<FXint>    albumartist;
+  FXArray<FXint>    composer;
+  FXArray<FXint>    conductor;
+  FXArray<FXint>    albumid;
+  FXArray<FXint>    time;
+  FXArray<FXuint>   no;
+  FXArray<FXint>    queue;
+  FXArray<FXint>    path;
+  FXArray<FXint>    bitrate;
+  FXArray<FXint>    samplerate;
+  FXArray<FXuchar>  channels;
+  FXArray<FXuchar>  filetype;
+  FXArray<FXushort> year;
+  FXArray<FXushort> album_year;
+  FXArray<FXushort> playcount;
+  FXArray<FXuchar>  rating;
+protected:
+  FXint sortkey(FXint ref);
+  void reserve(FXint n);
+private:
+  GMTrackStore(const GMTrackStore&);
+  GMTrackStore &operator=(const GMTrackStore&);
+  ~GMTrackStore();
+public:
+  /// Construct store, collation keys will skip the given keywords
+  GMTrackStore(const FXStringList & keywords);
+
+  /// Append a row
+  FXint append(FXint id,
+               FXint path,
+               const FXchar * mrl,
+               const FXchar * title,
+               FXint artist,
+               FXint albumartist,
+               FXint composer,
+               FXint conductor,
+               FXint albumid,
+               const FXchar * album,
+               FXint time,
+               FXuint no,
+               FXint queue,
+               FXushort track_year,
+               FXushort album_year,
+               FXushort playcount,
+               FXuchar filetype,
+               FXint bitrate,
+               FXint samplerate,
+               FXuchar channels,
+               FXlong playdate,
+               FXuchar rating);
+
+  /// Set strings of row. Title and album update their collation keys.
+  void setMrl(FXint row,const FXchar * mrl);
+  void setTitle(FXint row,const FXchar * title);
+  void setAlbum(FXint row,const FXchar * album);
+
+  /// Number of rows
+  FXint getNumRows() const { return nrows; }
+
+  /// Return string of reference
+  const FXchar * text(FXint ref) const { return strings.text(ref); }
+
+  /// Return length of string of reference
+  FXint length(FXint ref) const { return strings.length(ref); }
+
+  /// Compare two collation key references
+  FXint compareKeys(FXint a,FXint b) const;
+
+  /// Create the items for all rows. After this no more rows can be added.
+  GMDBTrackItem * createItems();
+
+  /// Save rows to stream
+  void save(FXStream & store) const;
+
+  /// Load rows from stream into an empty store
+  FXbool load(FXStream & store);
+
+  /// Release a reference. The store starts out with one for its creator.
+  void unref();
+  };
+
+#endif
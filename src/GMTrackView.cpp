@@ -32,6 +32,7 @@
 #include "GMClipboard.h"
 #include "GMSourceView.h"
 #include "GMColumnDialog.h"
+#include "GMTrackDatabase.h"
 #include "GMDatabaseSource.h"
 #include "GMPlayListSource.h"
 #include "GMPlayQueue.h"
@@ -151,6 +152,7 @@ FXDEFMAP(GMTrackView) GMTrackViewMap[]={
   FXMAPFUNC(SEL_COMMAND,GMTrackView::ID_COPY,GMTrackView::onCmdCopy),
   FXMAPFUNC(SEL_COMMAND,GMTrackView::ID_PASTE,GMTrackView::onCmdPaste),
   FXMAPFUNC(SEL_COMMAND,GMTrackView::ID_SHOW_CURRENT,GMTrackView::onCmdShowCurrent),
+  FXMAPFUNC(SEL_CHORE,GMTrackView::ID_RECONCILE,GMTrackView::onCmdReconcile),
 
   FXMAPFUNC(SEL_COMMAND,GMTrackView::ID_FILTER,GMTrackView::onCmdFilter),
   FXMAPFUNC(SEL_CHANGED,GMTrackView::ID_FILTER,GMTrackView::onCmdFilter),
@@ -322,7 +324,7 @@ GMTrackView::GMTrackView(FXComposite* p) : FXPacker(p,LAYOUT_FILL_X|LAYOUT_FILL_
   tracklist->dropEnable();
 
   taglist->setSortFunc(genre_list_sort);
-  artistlist->setSortFunc(generic_name_sort);
+  artistlist->setSortFunc(artist_list_sort);
   albumlist->setSortFunc(GMAlbumListItem::album_list_sort);
 
   taglistheader->setArrowState(ARROW_DOWN);
@@ -340,6 +342,7 @@ GMTrackView::GMTrackView(FXComposite* p) : FXPacker(p,LAYOUT_FILL_X|LAYOUT_FILL_
 
 GMTrackView::~GMTrackView(){
   getApp()->removeTimeout(this,ID_FILTER);
+  getApp()->removeChore(this,ID_RECONCILE);
   }
 
 
@@ -793,6 +796,8 @@ void GMTrackView::selectTrackItem(FXint item) {
 void GMTrackView::setSource(GMSource * src) {
   if (source!=src) {
 
+    getApp()->removeChore(this,ID_RECONCILE);
+
     if (source) {
 
       source->save(tracklist);
@@ -820,18 +825,7 @@ void GMTrackView::setSource(GMSource * src) {
 
       clear();
 
-      if (hasBrowser()) {
-        listTags();
-        initSelection(taglist,"genre-list-selection",source->settingKey());
-        listArtists();
-        initSelection(artistlist,"artist-list-selection",source->settingKey());
-        listAlbums();
-        initSelection(albumlist,"album-list-selection",source->settingKey());
-        listTracks();
-        }
-      else {
-        listTracks();
-        }
+      restoreView();
 
       tracklist->setPosition(tracklist_posx,tracklist_posy);
       }
@@ -904,6 +898,195 @@ void GMTrackView::initSelection(GMAlbumList * list,const FXchar * key,const FXSt
   }
 
 
+// List everything and restore the saved selection
+void GMTrackView::restoreView() {
+  if (hasBrowser()) {
+    listTags();
+    initSelection(taglist,"genre-list-selection",source->settingKey());
+    listArtists();
+    initSelection(artistlist,"artist-list-selection",source->settingKey());
+    listAlbums();
+    initSelection(albumlist,"album-list-selection",source->settingKey());
+    listTracks();
+    }
+  else {
+    listTracks();
+    }
+  }
+
+
+static FXString snapshot_keywords() {
+  const FXStringList & keywords = GMPlayerManager::instance()->getPreferences().gui_sort_keywords;
+  FXString result;
+  for (FXint i=0;i<keywords.no();i++) {
+    result+=keywords[i];
+    result+='\n';
+    }
+  return result;
+  }
+
+
+static void save_list(FXStream & store,const GMList * list) {
+  store << list->getNumItems();
+  for (FXint i=0;i<list->getNumItems();i++) {
+    const FXListItem * item = list->getItem(i);
+    store << item->getText();
+    store << (FXint)(FXival)item->getData();
+    store << (FXuchar)item->isDraggable();
+    }
+  }
+
+
+static FXbool load_list(FXStream & store,GMList * list,FXIcon * icon) {
+  FXString text;
+  FXint    data,n;
+  FXuchar  draggable;
+  store >> n;
+  if (store.status()!=FXStreamOK || n<0)
+    return false;
+  for (FXint i=0;i<n;i++) {
+    store >> text;
+    store >> data;
+    store >> draggable;
+    if (store.status()!=FXStreamOK)
+      return false;
+    GMListItem * item = new GMListItem(text,icon,(void*)(FXival)data);
+    item->setDraggable(draggable);
+    list->appendItem(item);
+    }
+  if (list->getNumItems()) {
+    list->setCurrentItem(0,false);
+    list->selectItem(0,false);
+    }
+  return true;
+  }
+
+
+/*
+  Snapshot of the lists, saved on exit and shown at the next start as long
+  as the database change counter still matches. The selection is restored
+  from the registry as usual.
+*/
+static const FXuint SNAPSHOT_FILE_VERSION = 1;
+static const FXchar SNAPSHOT_FILE[]       = PATHSEPSTRING "view.snapshot";
+
+
+FXbool GMTrackView::saveSnapshot(FXuint counter) const {
+  const FXString filename = GMApp::getCacheDirectory()+SNAPSHOT_FILE;
+  FXbool ok=false;
+  if (source && counter) {
+    FXFileStream store;
+    FXDir::createDirectories(GMApp::getCacheDirectory());
+    if (store.open(filename,FXStreamSave)) {
+      store << SNAPSHOT_FILE_VERSION;
+      store << counter;
+      store << source->settingKey();
+      store << snapshot_keywords();
+      store << (FXuchar)hasBrowser();
+      if (hasBrowser()) {
+        save_list(store,taglist);
+        save_list(store,artistlist);
+        albumlist->saveItems(store);
+        }
+      ok = source->saveTracks(tracklist,store) && store.status()==FXStreamOK;
+      store.close();
+      }
+    }
+  if (!ok) FXFile::remove(filename);
+  return ok;
+  }
+
+
+FXbool GMTrackView::loadSnapshot(FXuint counter) {
+  FXFileStream store;
+  if (counter && store.open(GMApp::getCacheDirectory()+SNAPSHOT_FILE,FXStreamLoad)) {
+    FXuint   version;
+    FXuint   changes;
+    FXString key;
+    FXString keywords;
+    FXuchar  browser;
+    store >> version;
+    if (version!=SNAPSHOT_FILE_VERSION)
+      return false;
+    store >> changes;
+    store >> key;
+    store >> keywords;
+    store >> browser;
+    if (store.status()!=FXStreamOK || changes!=counter || key!=source->settingKey() || keywords!=snapshot_keywords() || browser!=hasBrowser())
+      return false;
+
+    GM_TICKS_START();
+    if (hasBrowser()) {
+      if (!load_list(store,taglist,GMIconTheme::instance()->icon_genre) ||
+          !load_list(store,artistlist,GMIconTheme::instance()->icon_artist) ||
+          !albumlist->loadItems(store)) {
+        clear();
+        return false;
+        }
+      if (albumlist->getNumItems()) {
+        albumlist->setCurrentItem(0,false);
+        albumlist->selectItem(0,false);
+        }
+      }
+
+    tracklist->setActiveItem(-1);
+    if (!source->loadTracks(tracklist,store)) {
+      clear();
+      return false;
+      }
+    layout();
+    if (tracklist->getNumItems())
+      tracklist->setCurrentItem(0);
+    GM_TICKS_END();
+    return true;
+    }
+  return false;
+  }
+
+
+/*
+  The snapshot is exact as long as the change counter still matches, so the
+  live listing only runs when the database was modified since startup. It then
+  replaces the snapshot like a regular refresh, keeping selection and position.
+*/
+long GMTrackView::onCmdReconcile(FXObject*,FXSelector,void*){
+  GMTrackDatabase * database = GMPlayerManager::instance()->getTrackDatabase();
+  const FXuint counter = snapshot;
+  snapshot=0;
+  if (source && database && database->getChangeCounter()!=counter) {
+    GM_DEBUG_PRINT("[view] database changed since the snapshot was taken\n");
+    FXIntList tracks;
+    FXint current = tracklist->getCurrentItem();
+    FXint id = (current>=0) ? getTrack(current) : -1;
+    FXint x  = tracklist->getContentX();
+    FXint y  = tracklist->getContentY();
+
+    getSelectedTracks(tracks);
+
+    if (hasBrowser()){
+      saveSelection(taglist,"genre-list-selection",source->settingKey());
+      saveSelection(artistlist,"artist-list-selection",source->settingKey());
+      saveSelection(albumlist,"album-list-selection",source->settingKey());
+      }
+
+    clear();
+    restoreView();
+
+    if (tracks.no()) {
+      tracklist->killSelection();
+      for (FXint i=0;i<tracks.no();i++) {
+        FXint item = tracklist->findItemById(tracks[i]);
+        if (item>=0) tracklist->selectItem(item);
+        }
+      }
+    if (id>=0 && (current=tracklist->findItemById(id))>=0)
+      tracklist->setCurrentItem(current);
+    tracklist->setPosition(x,y);
+    }
+  return 1;
+  }
+
+
 void GMTrackView::init(GMSource * src) {
   FXASSERT(source==nullptr);
   FXASSERT(src);
@@ -918,17 +1101,20 @@ void GMTrackView::init(GMSource * src) {
 
   clear();
 
-  if (hasBrowser()) {
-    listTags();
-    initSelection(taglist,"genre-list-selection",source->settingKey());
-    listArtists();
-    initSelection(artistlist,"artist-list-selection",source->settingKey());
-    listAlbums();
-    initSelection(albumlist,"album-list-selection",source->settingKey());
-    listTracks();
+  // Show the lists from the last session if the database didn't change, checked again once idle
+  GMTrackDatabase * database = GMPlayerManager::instance()->getTrackDatabase();
+  const FXuint counter = database ? database->getChangeCounter() : 0;
+  if (loadSnapshot(counter)) {
+    snapshot=counter;
+    if (hasBrowser()) {
+      initSelection(taglist,"genre-list-selection",source->settingKey());
+      initSelection(artistlist,"artist-list-selection",source->settingKey());
+      initSelection(albumlist,"album-list-selection",source->settingKey());
+      }
+    getApp()->addChore(this,ID_RECONCILE);
     }
   else {
-    listTracks();
+    restoreView();
     }
 
   FXint active =  getApp()->reg().readIntEntry("window","track-list-current",-1);
@@ -1164,6 +1350,10 @@ void GMTrackView::sortTracks() const{
 
   }
 
+FXint GMTrackView::getSortMethod() const {
+  return tracklist->getSortMethod();
+  }
+
 void GMTrackView::setSortMethod(FXint def,FXbool reverse) {
 
   /// Tell source about pending sort
@@ -1223,11 +1413,11 @@ void GMTrackView::loadSettings(const FXString & key) {
 
   reverse_artist = getApp()->reg().readBoolEntry(key.text(),"artist-list-sort-reverse",false);
   if (reverse_artist) {
-    artistlist->setSortFunc(generic_name_sort_reverse);
+    artistlist->setSortFunc(artist_list_sort_reverse);
     artistlistheader->setArrowState(ARROW_UP);
     }
   else {
-    artistlist->setSortFunc(generic_name_sort);
+    artistlist->setSortFunc(artist_list_sort);
     artistlistheader->setArrowState(ARROW_DOWN);
     }
 
@@ -1362,7 +1552,7 @@ void GMTrackView::loadTrackSettings(const FXString & key) {
 
 void GMTrackView::saveSettings(const FXString & key) const {
   getApp()->reg().writeBoolEntry(key.text(),"genre-list-sort-reverse",taglist->getSortFunc()==genre_list_sort_reverse);
-  getApp()->reg().writeBoolEntry(key.text(),"artist-list-sort-reverse",artistlist->getSortFunc()==generic_name_sort_reverse);
+  getApp()->reg().writeBoolEntry(key.text(),"artist-list-sort-reverse",artistlist->getSortFunc()==artist_list_sort_reverse);
   getApp()->reg().writeBoolEntry(key.text(),"album-list-sort-reverse",albumlist->getSortFunc()==GMAlbumListItem::album_list_sort_reverse);
   getApp()->reg().writeBoolEntry(key.text(),"album-list-sort-by-year",album_by_year);
   getApp()->reg().writeBoolEntry(key.text(),"album-list-browser",(albumlist->getListStyle()&ALBUMLIST_BROWSER));
@@ -1564,13 +1754,13 @@ long GMTrackView::onCmdSortTagList(FXObject*,FXSelector,void*){
   }
 
 long GMTrackView::onCmdSortArtistList(FXObject*,FXSelector,void*){
-  if (artistlist->getSortFunc()==generic_name_sort) {
-    artistlist->setSortFunc(generic_name_sort_reverse);
+  if (artistlist->getSortFunc()==artist_list_sort) {
+    artistlist->setSortFunc(artist_list_sort_reverse);
     reverse_artist=true;
     artistlistheader->setArrowState(ARROW_UP);
     }
   else {
-    artistlist->setSortFunc(generic_name_sort);
+    artistlist->setSortFunc(artist_list_sort);
     reverse_artist=false;
     artistlistheader->setArrowState(ARROW_DOWN);
     }
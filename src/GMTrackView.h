@@ -65,6 +65,7 @@ protected:
   FXint tracklist_dropitem = 0;
   FXint tracklist_posx     = 0;
   FXint tracklist_posy     = 0;
+  FXuint snapshot          = 0;   // change counter of the snapshot being shown
 protected:
   GMTrackView(){}
   void initSelection(GMList * list,const FXchar *,const FXString & section="window");
@@ -72,6 +73,8 @@ protected:
   void saveSelection(GMList * list,const FXchar *,const FXString & section="window") const;
   void saveSelection(GMAlbumList * list,const FXchar *,const FXString & section="window") const;
   void configureView(FXuint);
+  void restoreView();
+  FXbool loadSnapshot(FXuint counter);
 protected:
   void init_track_context_menu(FXMenuPane *pane,FXbool selected);
   void setAlbumListSort();
@@ -117,6 +120,7 @@ public:
     ID_COVERSIZE_SMALL,
     ID_COVERSIZE_MEDIUM,
     ID_COVERSIZE_BIG,
+    ID_RECONCILE,
     ID_LAST,
     };
 public:
@@ -197,6 +201,8 @@ public:
   long onUpdCoverSize(FXObject*,FXSelector,void*);
 
   long onCmdConfigureColumns(FXObject*,FXSelector,void*);
+
+  long onCmdReconcile(FXObject*,FXSelector,void*);
 public:
   GMTrackView(FXComposite* p);
 
@@ -312,6 +318,8 @@ public:
 
   void setSortMethod(FXint hdr,FXbool reverse=false);
 
+  FXint getSortMethod() const;
+
   FXbool getSortReverse() const;
 
   void loadSettings(const FXString & key);
@@ -324,6 +332,8 @@ public:
 
   void saveView() const;
 
+  FXbool saveSnapshot(FXuint counter) const;
+
   FXbool focusNext();
 
   void selectNext();
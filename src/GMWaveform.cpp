@@ -0,0 +1,238 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#include <math.h>
+#include "gmdefs.h"
+#include "GMApp.h"
+#include "GMTaskManager.h"
+#include "GMAudioPlayer.h"
+#include "GMWaveform.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static const FXuint WAVEFORM_FILE_VERSION = 1;
+static const FXchar WAVEFORM_CACHE_DIR[]  = PATHSEPSTRING "waveforms";
+static const FXlong WAVEFORM_CACHE_SIZE   = 64*1024*1024;
+
+
+static inline FXuchar quantize(FXfloat v) {
+  return (FXuchar)FXCLAMP(0,lrintf((v+1.0f)*127.5f),255);
+  }
+
+
+FXString GMWaveform::cachefile(const FXString & filename) {
+  return GMApp::getCacheDirectory()+WAVEFORM_CACHE_DIR+PATHSEPSTRING+FXString::value("%08x.wave",filename.hash());
+  }
+
+
+FXbool GMWaveform::generate(const FXString & filename,const volatile FXbool * processing) {
+  ap::OfflineDecoder decoder;
+  peaks.clear();
+  if (decoder.open(filename)) {
+    const FXival nframes   = 4096;
+    const FXuint nchannels = decoder.channels();
+    const FXuint nsamples  = FXMAX(1,(decoder.rate()*interval)/1000)*nchannels;
+    FXArray<FXfloat> buffer(nframes*nchannels);
+    FXfloat lo=0.0f,hi=0.0f;
+    FXdouble sum=0.0;
+    FXuint count=0;
+    FXival n;
+
+    while((n=decoder.read(buffer.data(),nframes))>0) {
+      if (processing && !(*processing)) break;
+      for (FXival i=0;i<n*nchannels;i++) {
+        const FXfloat s = buffer[i];
+        lo   = FXMIN(lo,s);
+        hi   = FXMAX(hi,s);
+        sum += s*s;
+        if (++count==nsamples) {
+          peaks.append(quantize(lo));
+          peaks.append(quantize(hi));
+          peaks.append((FXuchar)FXCLAMP(0,lrint(sqrt(sum/count)*255.0),255));
+          lo=hi=0.0f;
+          sum=0.0;
+          count=0;
+          }
+        }
+      }
+    decoder.close();
+    return (n==0 && peaks.no()>0);
+    }
+  return false;
+  }
+
+
+FXbool GMWaveform::load(const FXString & filename) {
+  FXFileStream store;
+  if (store.open(cachefile(filename),FXStreamLoad)) {
+    FXuint   version;
+    FXString file;
+    FXTime   modified;
+    FXlong   size;
+    FXint    n;
+    store >> version;
+    if (version!=WAVEFORM_FILE_VERSION)
+      return false;
+    store >> file;
+    store >> modified;
+    store >> size;
+    if (file!=filename || modified!=FXStat::modified(filename) || size!=FXStat::size(filename))
+      return false;
+    store >> interval;
+    store >> n;
+    if (n<=0 || !peaks.no(n))
+      return false;
+    store.load(peaks.data(),n);
+    return store.status()==FXStreamOK;
+    }
+  return false;
+  }
+
+
+FXbool GMWaveform::save(const FXString & filename) const {
+  FXFileStream store;
+  FXDir::createDirectories(GMApp::getCacheDirectory()+WAVEFORM_CACHE_DIR);
+  if (store.open(cachefile(filename),FXStreamSave)) {
+    FXint n = peaks.no();
+    store << WAVEFORM_FILE_VERSION;
+    store << filename;
+    store << FXStat::modified(filename);
+    store << FXStat::size(filename);
+    store << interval;
+    store << n;
+    store.save(peaks.data(),n);
+    return store.status()==FXStreamOK;
+    }
+  return false;
+  }
+
+
+FXbool GMWaveform::cached(const FXString & filename) {
+  FXFileStream store;
+  if (store.open(cachefile(filename),FXStreamLoad)) {
+    FXuint   version;
+    FXString file;
+    FXTime   modified;
+    FXlong   size;
+    store >> version;
+    store >> file;
+    store >> modified;
+    store >> size;
+    return store.status()==FXStreamOK && version==WAVEFORM_FILE_VERSION && file==filename && modified==FXStat::modified(filename) && size==FXStat::size(filename);
+    }
+  return false;
+  }
+
+
+struct GMCacheFile {
+  FXTime modified;
+  FXlong size;
+  FXint  index;
+  };
+
+static FXint compare_cachefile(const void * a,const void * b) {
+  const FXTime ma = static_cast<const GMCacheFile*>(a)->modified;
+  const FXTime mb = static_cast<const GMCacheFile*>(b)->modified;
+  return (ma<mb) ? -1 : (ma>mb) ? 1 : 0;
+  }
+
+
+// Remove the oldest overviews until the cache fits in maxsize bytes
+void GMWaveform::prune(FXlong maxsize) {
+  const FXString path = GMApp::getCacheDirectory()+WAVEFORM_CACHE_DIR;
+  FXString * files = nullptr;
+  FXint nfiles = FXDir::listFiles(files,path,"*.wave",FXDir::NoDirs|FXDir::NoParent);
+  if (nfiles>0) {
+    FXArray<GMCacheFile> cache(nfiles);
+    FXlong total=0;
+    for (FXint i=0;i<nfiles;i++) {
+      FXStat info;
+      FXStat::statFile(path+PATHSEPSTRING+files[i],info);
+      cache[i].modified = info.modified();
+      cache[i].size     = info.size();
+      cache[i].index    = i;
+      total+=info.size();
+      }
+    if (total>maxsize) {
+      qsort(cache.data(),cache.no(),sizeof(GMCacheFile),compare_cachefile);
+      for (FXint i=0;i<nfiles && total>maxsize;i++) {
+        if (FXFile::remove(path+PATHSEPSTRING+files[cache[i].index]))
+          total-=cache[i].size;
+        }
+      GM_DEBUG_PRINT("[waveform] pruned cache to %ld bytes\n",total);
+      }
+    }
+  delete [] files;
+  }
+
+
+// Runs the task with idle priority when the pool worker can't be lowered and restored.
+// Nothing else is running on this thread, so it doesn't need to be restored.
+class GMWaveformThread : public FXThread {
+protected:
+  GMWaveformTask * task;
+public:
+  GMWaveformThread(GMWaveformTask * t) : task(t) {}
+  FXint run() {
+    ap_set_thread_name("gm_waveform");
+#if defined(__linux__) && defined(SCHED_IDLE)
+    struct sched_param param = {0};
+    sched_setscheduler(0,SCHED_IDLE,&param);
+#else
+    priority(PriorityMinimum);
+#endif
+    task->generate();
+    return 0;
+    }
+  };
+
+
+GMWaveformTask::GMWaveformTask(const FXStringList & f,FXObject*tgt,FXSelector sel) : GMTask(tgt,sel), files(f) {
+  }
+
+
+void GMWaveformTask::generate() {
+  for (FXint i=0;i<files.no() && processing;i++) {
+    if (files.no()>1)
+      taskmanager->setStatus(FXString::value("Generating Waveforms %d/%d",i+1,files.no()));
+    if (!GMWaveform::cached(files[i])) {
+      GMWaveform waveform;
+      if (waveform.generate(files[i],&processing))
+        waveform.save(files[i]);
+      }
+    }
+  }
+
+
+FXint GMWaveformTask::run() {
+  GMIdlePriority idle;
+  if (idle.isLowered()) {
+    generate();
+    }
+  else {
+    GMWaveformThread thread(this);
+    if (thread.start())
+      thread.join();
+    else
+      generate();
+    }
+  GMWaveform::prune(WAVEFORM_CACHE_SIZE);
+  return processing ? 0 : 1;
+  }
@@ -0,0 +1,76 @@
+/*******************************************************************************
+*                         Goggles Music Manager                                *
+********************************************************************************
+*           Copyright (C) 2006-2021 by Sander Jansen. All Rights Reserved      *
+*                               ---                                            *
+* This program is free software: you can redistribute it and/or modify         *
+* it under the terms of the GNU General Public License as published by         *
+* the Free Software Foundation, either version 3 of the License, or            *
+* (at your option) any later version.                                          *
+*                                                                              *
+* This program is distributed in the hope that it will be useful,              *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of               *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                *
+* GNU General Public License for more details.                                 *
+*                                                                              *
+* You should have received a copy of the GNU General Public License            *
+* along with this program.  If not, see http://www.gnu.org/licenses.           *
+********************************************************************************/
+#ifndef GMWAVEFORM_H
+#define GMWAVEFORM_H
+
+/*
+  Peak overview of a track. For every interval the minimum, maximum and
+  rms of all channels are stored as 3 bytes. Overviews are cached on disk
+  per file and are invalidated when the file changes. The oldest ones are
+  removed once the cache grows past its size limit.
+*/
+class GMWaveform {
+public:
+  FXArray<FXuchar> peaks;         // min, max, rms per interval
+  FXuint           interval = 20; // ms
+public:
+  /// Number of intervals
+  FXint no() const { return peaks.no()/3; }
+
+  /// Decode file and calculate the overview
+  FXbool generate(const FXString & filename,const volatile FXbool * processing=nullptr);
+
+  /// Load from cache. Fails if the file changed since it was cached.
+  FXbool load(const FXString & filename);
+
+  /// Save to cache
+  FXbool save(const FXString & filename) const;
+
+  /// Return true if a valid overview is cached for filename
+  static FXbool cached(const FXString & filename);
+
+  /// Cache file for filename
+  static FXString cachefile(const FXString & filename);
+
+  /// Remove the oldest cache files until the cache fits in maxsize bytes
+  static void prune(FXlong maxsize);
+  };
+
+
+/*
+  Generates waveform overviews for files that don't have one cached yet.
+  Files are decoded one at a time as a background task, with the worker
+  on idle scheduling so it never takes time away from playback. If the
+  worker can't be restored afterwards, a separate idle thread is used.
+*/
+class GMWaveformTask : public GMTask {
+friend class GMWaveformThread;
+protected:
+  FXStringList files;
+protected:
+  void generate();
+public:
+  FXint run();
+public:
+  GMWaveformTask(const FXStringList & files,FXObject*tgt=nullptr,FXSelector sel=0);
+
+  const FXStringList & getFiles() const { return files; }
+  };
+
+#endif
@@ -589,6 +589,7 @@ void GMWindow::reset() {
 
   trackslider->disable();
   trackslider->setProgress(0);
+  trackslider->clearWaveform();
 
   /// Reset Status Text
   statusbar->getStatusLine()->setNormalText("Ready.");
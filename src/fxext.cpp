@@ -2093,6 +2093,7 @@ GMProgressBar::GMProgressBar(FXComposite *p,FXObject* tgt,FXSelector sel,FXuint
 
 
 FXDEFMAP(GMTrackProgressBar) GMTrackProgressBarMap[]={
+  FXMAPFUNC(SEL_PAINT,0,GMTrackProgressBar::onPaint),
   FXMAPFUNC(SEL_MOTION,0,GMTrackProgressBar::onMotion),
   FXMAPFUNC(SEL_LEFTBUTTONPRESS,0,GMTrackProgressBar::onLeftBtnPress),
   FXMAPFUNC(SEL_LEFTBUTTONRELEASE,0,GMTrackProgressBar::onLeftBtnRelease)
@@ -2115,6 +2116,95 @@ GMTrackProgressBar::GMTrackProgressBar(FXComposite *p,FXObject* tgt,FXSelector s
   }
 
 
+void GMTrackProgressBar::setWaveform(const FXArray<FXuchar> & peaks) {
+  waveform=peaks;
+  if (barsize!=24) {
+    barsize=24;
+    recalc();
+    }
+  update();
+  }
+
+
+void GMTrackProgressBar::clearWaveform() {
+  if (waveform.no()) {
+    waveform.clear();
+    barsize=7;
+    recalc();
+    update();
+    }
+  }
+
+
+void GMTrackProgressBar::setProgress(FXuint value) {
+  if (waveform.no()) {
+    if (value>total) value=total;
+    if (value!=progress) {
+      progress=value;
+      if (xid) {
+        FXDCWindow dc(this);
+        drawWaveform(dc);
+        }
+      }
+    }
+  else {
+    FXProgressBar::setProgress(value);
+    }
+  }
+
+
+// Draw min/max and rms of each column, played part in the bar color.
+void GMTrackProgressBar::drawWaveform(FXDCWindow & dc) {
+  const FXint n          = waveform.no()/3;
+  const FXint barlength  = width-(border<<1)-padleft-padright;
+  const FXint barwidth   = height-(border<<1)-padtop-padbottom;
+  const FXint xx         = border+padleft;
+  const FXint yy         = border+padtop;
+  const FXint barfilled  = total ? (FXint)(barlength*((FXdouble)progress/(FXdouble)total)) : 0;
+  const FXColor played[2]   = {barColor,makeShadowColor(barColor,30)};
+  const FXColor unplayed[2] = {makeShadowColor(barBGColor,25),makeShadowColor(barBGColor,45)};
+
+  dc.setForeground(barBGColor);
+  dc.fillRectangle(xx,yy,barlength,barwidth);
+
+  if (n==0 || barlength<=0 || barwidth<=0) return;
+
+  for (FXint x=0;x<barlength;x++) {
+    FXint b = (FXint)(((FXlong)x*n)/barlength);
+    FXint e = FXMAX(b+1,(FXint)(((FXlong)(x+1)*n)/barlength));
+    FXuchar lo=255,hi=0,rms=0;
+    for (FXint i=b;i<e && i<n;i++) {
+      lo  = FXMIN(lo,waveform[3*i]);
+      hi  = FXMAX(hi,waveform[3*i+1]);
+      rms = FXMAX(rms,waveform[3*i+2]);
+      }
+    if (hi<lo) continue;
+    const FXColor * colors = (x<barfilled) ? played : unplayed;
+    const FXint top    = yy + ((255-hi)*(barwidth-1))/255;
+    const FXint bottom = yy + ((255-lo)*(barwidth-1))/255;
+    const FXint center = yy + (barwidth-1)/2;
+    const FXint r      = (rms*(barwidth-1))/510;
+    dc.setForeground(colors[0]);
+    dc.drawLine(xx+x,top,xx+x,bottom);
+    dc.setForeground(colors[1]);
+    dc.drawLine(xx+x,FXMAX(top,center-r),xx+x,FXMIN(bottom,center+r));
+    }
+  }
+
+
+long GMTrackProgressBar::onPaint(FXObject*,FXSelector,void*ptr) {
+  FXDCWindow dc(this,(FXEvent*)ptr);
+  dc.setForeground(baseColor);
+  dc.fillRectangle(0,0,width,height);
+  drawFrame(dc,padleft,padtop,width-padleft-padright,height-padtop-padbottom);
+  if (waveform.no())
+    drawWaveform(dc);
+  else
+    drawInterior(dc);
+  return 1;
+  }
+
+
 
 // Moving
 long GMTrackProgressBar::onMotion(FXObject*,FXSelector,void*){
@@ -480,18 +480,34 @@ public:
 
 class GMTrackProgressBar : public FXProgressBar {
   FXDECLARE(GMTrackProgressBar)
+protected:
+  FXArray<FXuchar> waveform;
 protected:
   GMTrackProgressBar();
+  void drawWaveform(FXDCWindow & dc);
 private:
   GMTrackProgressBar(const GMTrackProgressBar&);
   GMTrackProgressBar &operator=(const GMTrackProgressBar&);
 public:
+  long onPaint(FXObject*,FXSelector,void*);
   long onMotion(FXObject*,FXSelector,void*);
   long onLeftBtnPress(FXObject*,FXSelector,void*);
   long onLeftBtnRelease(FXObject*,FXSelector,void*);
 public:
   /// Construct progress bar
   GMTrackProgressBar(FXComposite* p,FXObject* target=nullptr,FXSelector sel=0,FXuint opts=PROGRESSBAR_NORMAL,FXint x=0,FXint y=0,FXint w=0,FXint h=0,FXint pl=DEFAULT_PAD,FXint pr=DEFAULT_PAD,FXint pt=DEFAULT_PAD,FXint pb=DEFAULT_PAD);
+
+  /// Set amount of progress made
+  void setProgress(FXuint value);
+
+  /// Show waveform overview (min,max,rms per interval) instead of a plain bar
+  void setWaveform(const FXArray<FXuchar> & peaks);
+
+  /// Remove waveform overview
+  void clearWaveform();
+
+  /// Return true if a waveform is shown
+  FXbool hasWaveform() const { return waveform.no()>0; }
   };
 
 
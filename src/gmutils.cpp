@@ -519,6 +519,17 @@ void gm_print_time(FXint time,FXString & result){
   }
 
 
+FXString gm_sort_key(const FXString & text,const FXStringList & keywords) {
+  for (FXint i=0;i<keywords.no();i++){
+    if (FXString::comparecase(text,keywords[i],keywords[i].length())==0) {
+      const FXint p = FXMIN(text.length()-1,text.find(' ')+1);
+      return FXCollate::sortKey(&text[p],text.length()-p);
+      }
+    }
+  return FXCollate::sortKey(text);
+  }
+
+
 void gm_bgra_to_rgba(FXColor * inbuf,FXColor * outbuf, FXint len) {
    FXuchar * in  = reinterpret_cast<FXuchar*>(inbuf);
    FXuchar * out = reinterpret_cast<FXuchar*>(outbuf);
@@ -93,6 +93,9 @@ extern FXbool gm_decode_base64(FXuchar * buffer,FXint & len);
 
 extern void gm_print_time(FXint nseconds,FXString & result);
 
+/// Collation key for text, skipping a leading sort keyword ("The ")
+extern FXString gm_sort_key(const FXString & text,const FXStringList & keywords);
+
 extern FXbool gm_parse_datetime(const FXString & str,FXTime & timestamp);
 
 #endif